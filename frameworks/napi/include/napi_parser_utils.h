@@ -19,6 +19,7 @@
 #include "napi/native_api.h"
 #include "napi/native_node_api.h"
 #include "napi_fusion_connectivity_error.h"
+#include "fcm_address_utils.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
@@ -53,10 +54,6 @@ constexpr int32_t PARAM2 = 2;
 constexpr int32_t PARAM3 = 3;
 constexpr int32_t PARAM4 = 4;
 
-constexpr size_t ADDRESS_LENGTH = 17;
-constexpr size_t ADDRESS_COLON_INDEX = 2;
-constexpr size_t ADDRESS_SEPARATOR_UNIT = 3;
-
 napi_status NapiIsObject(napi_env env, napi_value value);
 napi_status NapiIsString(napi_env env, napi_value value);
 napi_status NapiIsFunction(napi_env env, napi_value value);
@@ -81,7 +78,6 @@ napi_status NapiParseBoolObjectOptional(
 
 bool ParseString(napi_env env, std::string &param, napi_value args);
 bool ParseInt32(napi_env env, int32_t &param, napi_value args);
-bool IsValidAddress(const std::string &addr);
 
 void SetNamedPropertyByInteger(napi_env env, napi_value dstObj, int32_t objName, const char *propName);
 
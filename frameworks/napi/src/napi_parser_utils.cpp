@@ -240,31 +240,6 @@ bool ParseString(napi_env env, std::string &param, napi_value args)
     return true;
 }
 
-bool IsValidAddress(const std::string &addr)
-{
-    if (addr.empty() || addr.length() != ADDRESS_LENGTH) {
-        return false;
-    }
-    for (size_t i = 0; i < ADDRESS_LENGTH; i++) {
-        char c = addr[i];
-        switch (i % ADDRESS_SEPARATOR_UNIT) {
-            case 0:
-            case 1:
-                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
-                    break;
-                }
-                return false;
-            case ADDRESS_COLON_INDEX:
-            default:
-                if (c == ':') {
-                    break;
-                }
-                return false;
-        }
-    }
-    return true;
-}
-
 bool ParseInt32(napi_env env, int32_t &param, napi_value args)
 {
     napi_valuetype valuetype;
@@ -19,40 +19,10 @@
 
 #include "partner_device_address.h"
 
+#include "fcm_address_utils.h"
 #include "hilog/log.h"
 
 using OHOS::HiviewDFX::HiLog;
-namespace {
-constexpr size_t ADDRESS_LENGTH = 17;
-constexpr size_t ADDRESS_COLON_INDEX = 2;
-constexpr size_t ADDRESS_SEPARATOR_UNIT = 3;
-bool IsValidAddress(const std::string &addr)
-{
-    if (addr.empty() || addr.length() != ADDRESS_LENGTH) {
-        return false;
-    }
-    for (size_t i = 0; i < ADDRESS_LENGTH; i++) {
-        char c = addr[i];
-        switch (i % ADDRESS_SEPARATOR_UNIT) {
-            case 0:
-            case 1:
-                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
-                    break;
-                }
-                return false;
-            case ADDRESS_COLON_INDEX:
-            default:
-                if (c == ':') {
-                    break;
-                }
-                return false;
-        }
-    }
-    return true;
-}
-}  // namespace
-
-
 
 namespace OHOS {
 namespace FusionConnectivity {
@@ -36,6 +36,8 @@ enum FcmErrCode {
     FCM_ERR_DEVICE_NOT_PAIRED = 34900003,
     FCM_ERR_DEVICE_ALREADY_BOUNDED = 34900004,
     FCM_ERR_BLUETOOTH_IS_OFF = 34900005,
+    FCM_ERR_DEVICE_LIMIT_EXCEEDED = 34900006,
+    FCM_ERR_SERVICE_NOT_READY = 34900007,
     FCM_ERR_INTERNAL_ERROR = 34900099,
 
     // Inner error codes
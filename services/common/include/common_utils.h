@@ -17,10 +17,10 @@
 #define COMMON_UTILS_H
 
 #include <string>
+#include "fcm_address_utils.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
-bool IsValidAddress(const std::string &addr);
 int32_t GetCurrentActiveUserId();
 
 } // namespace FusionConnectivity
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FCM_ADDRESS_UTILS_H
+#define FCM_ADDRESS_UTILS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace AddressUtils {
+constexpr size_t MAC_STRING_LENGTH = 17;
+constexpr size_t MAC_BYTE_NUM = 6;
+constexpr size_t MAC_SEPARATOR_UNIT = 3;
+constexpr int MAC_BITS_PER_BYTE = 8;
+constexpr int MAC_BITS_PER_HEX = 4;
+constexpr int8_t INVALID_HEX = -1;
+
+constexpr std::array<int8_t, 256> MakeHexTable()
+{
+    std::array<int8_t, 256> table {};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = INVALID_HEX;
+    }
+    for (int i = 0; i < 10; i++) {  // '0' ~ '9'
+        table['0' + i] = static_cast<int8_t>(i);
+    }
+    for (int i = 0; i < 6; i++) {  // 'a' ~ 'f' and 'A' ~ 'F'
+        table['a' + i] = static_cast<int8_t>(10 + i);  // 'a' is 10
+        table['A' + i] = static_cast<int8_t>(10 + i);  // 'A' is 10
+    }
+    return table;
+}
+
+// Maps a char to its hex value, or INVALID_HEX if the char is not a hex digit.
+inline constexpr std::array<int8_t, 256> HEX_TABLE = MakeHexTable();
+}  // namespace AddressUtils
+
+/**
+ * @brief Parse the "XX:XX:XX:XX:XX:XX" address string into an integer, the hex digits are case insensitive.
+ *
+ * Branch free over the 17 chars: the hex values come from a 256-entry table, the invalid hex flags and the
+ * separator mismatches are accumulated and checked once at the end.
+ *
+ * @param addr The address string.
+ * @param value The parsed address, the first byte of the string is the most significant byte.
+ * @return Returns true if the address string is valid, otherwise false.
+ */
+inline bool ParseAddress(std::string_view addr, uint64_t &value)
+{
+    using namespace AddressUtils;
+    if (addr.length() != MAC_STRING_LENGTH) {
+        return false;
+    }
+    const unsigned char *str = reinterpret_cast<const unsigned char *>(addr.data());
+    uint64_t result = 0;
+    // Negative if any of the hex digits is invalid
+    int hexFlags = 0;
+    // Non-zero if any of the separators is not ':'
+    int separatorFlags = 0;
+    for (size_t i = 0; i < MAC_BYTE_NUM; i++) {
+        int8_t high = HEX_TABLE[str[i * MAC_SEPARATOR_UNIT]];
+        int8_t low = HEX_TABLE[str[i * MAC_SEPARATOR_UNIT + 1]];
+        hexFlags |= high | low;
+        result = (result << MAC_BITS_PER_BYTE) |
+            static_cast<uint64_t>((static_cast<uint8_t>(high) << MAC_BITS_PER_HEX) | static_cast<uint8_t>(low));
+    }
+    for (size_t i = MAC_SEPARATOR_UNIT - 1; i < MAC_STRING_LENGTH; i += MAC_SEPARATOR_UNIT) {
+        separatorFlags |= str[i] ^ ':';
+    }
+    if (hexFlags < 0 || separatorFlags != 0) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+/**
+ * @brief Check whether the address string is in the "XX:XX:XX:XX:XX:XX" format.
+ */
+inline bool IsValidAddress(std::string_view addr)
+{
+    uint64_t value = 0;
+    return ParseAddress(addr, value);
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // FCM_ADDRESS_UTILS_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FCM_JSON_STREAM_H
+#define FCM_JSON_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief Streaming JSON writer, appends the compact JSON text into one buffer without building a DOM.
+ *
+ * The commas are inserted by the writer, the caller only emits the keys and the values in order.
+ */
+class FcmJsonWriter {
+public:
+    FcmJsonWriter() = default;
+    ~FcmJsonWriter() = default;
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    void Key(std::string_view key);
+    void String(std::string_view value);
+    void Int(int64_t value);
+    void Bool(bool value);
+
+    /**
+     * @brief End a top-level value with '\n', used by the line-based journal.
+     */
+    void NewLine();
+
+    /**
+     * @brief Clear the buffer and keep its capacity, so that the buffer can be reused.
+     */
+    void Clear();
+
+    const std::string &GetBuffer() const;
+
+private:
+    void BeforeValue();
+
+    std::string buffer_;
+    // Whether the current container has any element, a comma is needed before the next one.
+    bool hasElement_ = false;
+};
+
+/**
+ * @brief Pull JSON reader, walks the text once without building a DOM.
+ *
+ * The typed reads return false without consuming anything if the next value is of another type, the caller may
+ * Skip() it. Malformed text puts the reader into the error state, all the later reads return false.
+ *
+ * Usage:
+ *   if (reader.BeginObject()) {
+ *       std::string_view key;
+ *       while (reader.NextKey(key)) {
+ *           ... read or skip the value of the key ...
+ *       }
+ *   }
+ *   bool isValid = !reader.HasError();
+ */
+class FcmJsonReader {
+public:
+    explicit FcmJsonReader(std::string_view content);
+    ~FcmJsonReader() = default;
+
+    bool BeginObject();
+    /**
+     * @brief Read the next key of the current object.
+     *
+     * The keys are returned as they are in the text, escaped keys never match the plain ones.
+     *
+     * @return Returns false at the end of the object or on error.
+     */
+    bool NextKey(std::string_view &key);
+    bool BeginArray();
+    /**
+     * @brief Move to the next element of the current array.
+     *
+     * @return Returns false at the end of the array or on error.
+     */
+    bool NextElement();
+
+    bool ReadString(std::string &value);
+    bool ReadInt(int64_t &value);
+    bool ReadBool(bool &value);
+    /**
+     * @brief Skip the next value, including the nested objects and arrays.
+     */
+    bool Skip();
+
+    /**
+     * @brief Whether only whitespaces are left.
+     */
+    bool IsEnd();
+    bool HasError() const;
+
+private:
+    char Peek();
+    bool Expect(char c);
+    bool SetError();
+    bool ScanString(std::string_view &raw, bool &hasEscape);
+    bool Unescape(std::string_view raw, std::string &value);
+    bool SkipLiteral(std::string_view literal);
+    bool SkipNumber();
+    bool SkipValue(int depth);
+
+    std::string_view content_;
+    size_t pos_ = 0;
+    bool isFirst_ = false;
+    bool hasError_ = false;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // FCM_JSON_STREAM_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FCM_MAC_ADDRESS_H
+#define FCM_MAC_ADDRESS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "fcm_address_utils.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief A 48-bit bluetooth MAC address packed into an uint64_t.
+ *
+ * Used as the key of the partner device registry and for the address compare in event dispatch, the string form
+ * "XX:XX:XX:XX:XX:XX" is only kept at the IDL/JS boundary.
+ */
+class FcmMacAddress {
+public:
+    static constexpr size_t STRING_LENGTH = AddressUtils::MAC_STRING_LENGTH;
+
+    constexpr FcmMacAddress() = default;
+    constexpr explicit FcmMacAddress(uint64_t value) : value_(value & VALUE_MASK) {}
+    ~FcmMacAddress() = default;
+
+    /**
+     * @brief Parse the "XX:XX:XX:XX:XX:XX" string, the hex digits are case insensitive.
+     *
+     * @param addr The address string.
+     * @param outAddr The parsed address.
+     * @return Returns true if the address string is valid, otherwise false.
+     */
+    static bool FromString(std::string_view addr, FcmMacAddress &outAddr)
+    {
+        uint64_t value = 0;
+        if (!ParseAddress(addr, value)) {
+            return false;
+        }
+        outAddr = FcmMacAddress(value);
+        return true;
+    }
+
+    /**
+     * @brief Format to the upper case "XX:XX:XX:XX:XX:XX" string.
+     */
+    std::string ToString() const
+    {
+        static constexpr char HEX_CHARS[] = "0123456789ABCDEF";
+        std::string out(STRING_LENGTH, ':');
+        for (size_t i = 0; i < BYTE_NUM; i++) {
+            uint8_t byte = GetByte(i);
+            out[i * SEPARATOR_UNIT] = HEX_CHARS[byte >> BITS_PER_HEX];
+            out[i * SEPARATOR_UNIT + 1] = HEX_CHARS[byte & HEX_MASK];
+        }
+        return out;
+    }
+
+    constexpr uint64_t GetValue() const
+    {
+        return value_;
+    }
+
+    constexpr bool operator==(const FcmMacAddress &other) const
+    {
+        return value_ == other.value_;
+    }
+    constexpr bool operator!=(const FcmMacAddress &other) const
+    {
+        return value_ != other.value_;
+    }
+    constexpr bool operator<(const FcmMacAddress &other) const
+    {
+        return value_ < other.value_;
+    }
+
+private:
+    static constexpr size_t BYTE_NUM = 6;
+    static constexpr size_t SEPARATOR_UNIT = 3;
+    static constexpr int BITS_PER_BYTE = 8;
+    static constexpr int BITS_PER_HEX = 4;
+    static constexpr uint8_t HEX_MASK = 0x0F;
+    static constexpr uint64_t VALUE_MASK = 0xFFFFFFFFFFFFULL;
+
+    // Byte 0 is the most significant byte, which is the first byte of the string form.
+    constexpr uint8_t GetByte(size_t index) const
+    {
+        return static_cast<uint8_t>(value_ >> ((BYTE_NUM - 1 - index) * BITS_PER_BYTE));
+    }
+
+    uint64_t value_ = 0;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+
+namespace std {
+template <>
+struct hash<OHOS::FusionConnectivity::FcmMacAddress> {
+    size_t operator()(const OHOS::FusionConnectivity::FcmMacAddress &addr) const noexcept
+    {
+        return hash<uint64_t>()(addr.GetValue());
+    }
+};
+}  // namespace std
+
+#endif  // FCM_MAC_ADDRESS_H
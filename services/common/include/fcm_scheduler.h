@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FCM_SCHEDULER_H
+#define FCM_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "ffrt_inner.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The clock and the runner of the delayed tasks behind the TimerManager and the delayed tasks of
+ * FcmThreadUtil.
+ */
+class FcmScheduler {
+public:
+    using TaskId = uint64_t;
+    static constexpr TaskId INVALID_TASK_ID = 0;
+
+    virtual ~FcmScheduler() = default;
+
+    /**
+     * @brief The monotonic time in ms.
+     */
+    virtual uint64_t GetNowMs() = 0;
+
+    /**
+     * @brief Run the task delayMs later.
+     *
+     * @return Returns the id to cancel the task, or INVALID_TASK_ID if it fails.
+     */
+    virtual TaskId PostDelayTask(const std::function<void()> &task, uint64_t delayMs, const std::string &name) = 0;
+
+    /**
+     * @brief Cancel the task if it isn't run yet, doesn't wait for a running task.
+     */
+    virtual void CancelTask(TaskId taskId) = 0;
+};
+
+/**
+ * @brief Runs the tasks on an ffrt queue by the steady clock. Destroying it waits for the running task.
+ */
+class FcmQueueScheduler : public FcmScheduler {
+public:
+    explicit FcmQueueScheduler(const char *name);
+    ~FcmQueueScheduler() override = default;
+
+    static uint64_t GetSteadyNowMs();
+
+    uint64_t GetNowMs() override;
+    TaskId PostDelayTask(const std::function<void()> &task, uint64_t delayMs, const std::string &name) override;
+    void CancelTask(TaskId taskId) override;
+
+private:
+    ffrt::mutex mutex_ {};
+    TaskId nextTaskId_ = INVALID_TASK_ID + 1;  // locked by mutex_
+    std::unordered_map<TaskId, ffrt::task_handle> handles_ {};  // the tasks not run yet, locked by mutex_
+    // Destroyed first, the running task may still lock mutex_.
+    ffrt::queue queue_;
+};
+
+/**
+ * @brief A virtual clock only advanced by the caller, for the tests and the simulations.
+ *
+ * The time doesn't pass by itself. AdvanceTo and AdvanceBy move the clock and run the due tasks on the calling
+ * thread in the order of their due time, the tasks due at the same time in the order of posting, so hours of timers
+ * run in milliseconds and always the same way. A task may post or cancel tasks, the tasks it posts run in the same
+ * advance if they are due. Thread safe, but only one thread should advance the clock.
+ */
+class FcmVirtualScheduler : public FcmScheduler {
+public:
+    explicit FcmVirtualScheduler(uint64_t nowMs = 0) : nowMs_(nowMs) {}
+    ~FcmVirtualScheduler() override = default;
+
+    uint64_t GetNowMs() override;
+    TaskId PostDelayTask(const std::function<void()> &task, uint64_t delayMs, const std::string &name) override;
+    void CancelTask(TaskId taskId) override;
+
+    /**
+     * @brief Advance the clock to the time and run the tasks due by then. A time already passed runs the due tasks
+     * only.
+     *
+     * @return Returns the number of the run tasks.
+     */
+    size_t AdvanceTo(uint64_t nowMs);
+    size_t AdvanceBy(uint64_t deltaMs);
+
+    /**
+     * @brief The due time of the next task, or UINT64_MAX if there is no task.
+     */
+    uint64_t GetNextDueMs();
+    size_t GetTaskNum();
+
+private:
+    using TaskKey = std::pair<uint64_t, TaskId>;  // the due time and the id in the order of posting
+
+    std::mutex mutex_ {};
+    uint64_t nowMs_ = 0;  // locked by mutex_
+    TaskId nextTaskId_ = INVALID_TASK_ID + 1;  // locked by mutex_
+    std::map<TaskKey, std::function<void()>> tasks_ {};  // locked by mutex_
+    std::unordered_map<TaskId, uint64_t> taskDueMs_ {};  // locked by mutex_
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // FCM_SCHEDULER_H
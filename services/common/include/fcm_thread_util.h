@@ -18,7 +18,9 @@
 
 #include <functional>
 #include "fcm_safe_map.h" // SafeMap
+#include <memory>
 #include <mutex>
+#include "fcm_scheduler.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
@@ -46,6 +48,12 @@ public:
     void RemoveTask(int threadId, const std::string &name);
     void ClearThreadStateMap();
     void InitThreadStateMap();
+    /**
+     * Post the delayed tasks to the scheduler instead of the thread, or restore if nullptr. Only for test.
+     *
+     * @param scheduler The scheduler running the delayed tasks, a virtual one runs them on the advancing thread.
+     */
+    void SetScheduler(std::shared_ptr<FcmScheduler> scheduler);
 
     static FcmThreadUtil &GetInstance();
 
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FCM_TIMING_WHEEL_H
+#define FCM_TIMING_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief A hierarchical timing wheel of intrusive nodes, counted in ticks.
+ *
+ * LEVEL_NUM levels of SLOT_NUM slots, the level 0 slot of a node expiring within SLOT_NUM ticks is its expire tick,
+ * a node expiring later sits in a higher level and cascades down when the lower level wraps around. Add and Remove
+ * are O(1), Advance is O(1) per tick plus the cascades, amortized O(1) per node and level. The nodes are owned by
+ * the caller and linked in place, so arming a timer again never allocates.
+ *
+ * A delay beyond the range of the wheel, SLOT_NUM ^ LEVEL_NUM ticks, is kept in the top level and cascaded again
+ * until it expires. The tick length is up to the caller. Not thread safe.
+ *
+ * A node may have a slack, it expires at any tick within [expireTick, expireTick + slackTicks]. It's linked by its
+ * expire tick, so Advance expires every node whose window has opened, while GetNextDueTick reports the end of the
+ * earliest window: a caller sleeping until then expires all the nodes whose windows overlap in one go.
+ */
+class FcmTimingWheel {
+public:
+    struct Node {
+        Node *prev = nullptr;
+        Node *next = nullptr;
+        uint64_t expireTick = 0;
+        uint64_t slackTicks = 0;
+
+        bool IsLinked() const
+        {
+            return next != nullptr;
+        }
+    };
+
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOT_NUM = 1 << SLOT_BITS;
+    static constexpr uint32_t LEVEL_NUM = 4;
+    static constexpr uint64_t INVALID_TICK = UINT64_MAX;
+
+    explicit FcmTimingWheel(uint64_t nowTick = 0);
+    ~FcmTimingWheel() = default;
+
+    /**
+     * @brief Link the node to expire at the tick or up to slackTicks later, a tick already passed expires at the
+     * next Advance. The node must not be linked.
+     */
+    void Add(Node &node, uint64_t expireTick, uint64_t slackTicks = 0);
+
+    /**
+     * @brief Unlink the node if it's linked.
+     */
+    void Remove(Node &node);
+
+    /**
+     * @brief Advance the wheel through the tick, unlink the expired nodes and pass them to the function in the order
+     * of their expire ticks. The function may add the node again.
+     */
+    void Advance(uint64_t nowTick, const std::function<void(Node &)> &onExpired);
+
+    /**
+     * @brief The next tick the wheel has work at, either a node expiring or a higher level slot cascading down, or
+     * INVALID_TICK if the wheel is empty. Not earlier than the current tick.
+     */
+    uint64_t GetNextTick() const;
+
+    /**
+     * @brief The earliest tick a node is due, the end of its window and not earlier than the current tick, or
+     * INVALID_TICK if the wheel is empty. Unlike GetNextTick it skips the cascades, a caller sleeping until then
+     * advances through them in one go. Counts the nodes due at the tick into dueNum if given. Only the slots starting
+     * not later than the tick found are scanned.
+     */
+    uint64_t GetNextDueTick(size_t *dueNum = nullptr) const;
+
+    /**
+     * @brief The tick the linked node is due, see GetNextDueTick.
+     */
+    uint64_t GetDueTick(const Node &node) const
+    {
+        uint64_t dueTick = node.expireTick + node.slackTicks;
+        if (dueTick < node.expireTick || dueTick == INVALID_TICK) {
+            dueTick = INVALID_TICK - 1;
+        }
+        return dueTick > currentTick_ ? dueTick : currentTick_;
+    }
+
+    /**
+     * @brief Unlink all the nodes.
+     */
+    void Clear();
+
+    /**
+     * @brief Unlink all the nodes and restart the wheel at the tick, for a new clock.
+     */
+    void Reset(uint64_t nowTick);
+
+    uint64_t GetCurrentTick() const
+    {
+        return currentTick_;
+    }
+
+    size_t GetSize() const
+    {
+        return size_;
+    }
+
+private:
+    static uint32_t GetSlotIndex(uint64_t tick, uint32_t level)
+    {
+        return static_cast<uint32_t>(tick >> (level * SLOT_BITS)) & (SLOT_NUM - 1);
+    }
+
+    void Link(Node &node);
+    void Cascade(uint32_t level);
+    void ScanDueSlot(const Node &sentinel, uint64_t &dueTick, size_t &dueNum) const;
+
+    // The ticks before it are processed.
+    uint64_t currentTick_ = 0;
+    size_t size_ = 0;
+    // The sentinels of the circular lists of the slots.
+    Node slots_[LEVEL_NUM][SLOT_NUM];
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // FCM_TIMING_WHEEL_H
@@ -22,6 +22,7 @@
 namespace OHOS {
 namespace FusionConnectivity {
 constexpr static const char *PERMISSION_ACCESS_BLUETOOTH = "ohos.permission.ACCESS_BLUETOOTH";
+constexpr static int32_t INVALID_USER_ID = -1;
 
 #define NO_NEED_CHECK_PERMISSION PermissionItem(std::set<std::string>{})
 
@@ -35,6 +36,9 @@ public:
     static std::string GetCallingName();
     static bool IsHapApp(uint32_t tokenId);
     static bool IsNeedAddPermissionUsedRecord(const std::string &permission, uint32_t tokenId);
+    // Get the user of the HAP token. Returns false if the token doesn't exist, userId is INVALID_USER_ID if the query
+    // fails for other reasons.
+    static bool GetHapUserId(uint32_t tokenId, int32_t &userId);
 };
 }  // namespace FusionConnectivity
 }  // namespace OHOS
@@ -20,9 +20,28 @@
 #include <atomic>
 #include <mutex>
 #include <functional>
+#include "fcm_timing_wheel.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
+/**
+ * @brief The node of a timer in the timing wheel of the TimerManager, embedded in the timer.
+ */
+struct TimerNode : public FcmTimingWheel::Node {
+    std::function<void()> callback {};
+    uint64_t periodTicks = 0;  // 0 for a one-shot timer
+};
+
+/**
+ * @brief A timer driven by the timing wheel of the TimerManager.
+ *
+ * The timer is linked into the wheel in place, starting, stopping and restarting it never allocate, so an owner
+ * arming a timer repeatedly keeps one Timer and restarts it instead of creating a new one. The callback runs on the
+ * timer queue and may destroy or restart the timer. Stop doesn't wait for a running callback.
+ *
+ * A timer started with a slack may fire up to slackMs late, so that the timers expiring close to each other fire in
+ * one wakeup. A timer whose exact expiry doesn't matter, like the exit delay of a device, should give a slack.
+ */
 class Timer {
 public:
     /**
@@ -45,10 +64,21 @@ public:
      *
      * @param ms Countdown time.
      * @param isPeriodic Timer isPeriodic.
+     * @param slackMs The timer may fire up to slackMs later than ms to be batched with other timers.
      * @return Success set timer return true, else return false.
      * @since 6
      */
-    bool Start(int ms, bool isPeriodic = false);
+    bool Start(int ms, bool isPeriodic = false, int slackMs = 0);
+
+    /**
+     * @brief Stop the timer if it's started and start it again.
+     *
+     * @param ms Countdown time.
+     * @param isPeriodic Timer isPeriodic.
+     * @param slackMs The timer may fire up to slackMs later than ms to be batched with other timers.
+     * @return Success set timer return true, else return false.
+     */
+    bool Restart(int ms, bool isPeriodic = false, int slackMs = 0);
 
     /**
      * @brief Stop Running Timer.
@@ -64,11 +94,7 @@ public:
     bool IsStarted(void);
 
 private:
-    std::atomic_bool isPeriodic_ {false};
-    std::function<void()> callback_ {};
-
-    const uint64_t INVALID_TIMER_ID = 0;
-    uint64_t timerId_ {INVALID_TIMER_ID};
+    TimerNode node_ {};
 
     FCM_DISALLOW_COPY_AND_ASSIGN(Timer);
 };
@@ -78,6 +104,12 @@ private:
  * @details 此函数用于关闭所有正在运行的定时器，仅用于DT测试用例使用
  */
 void CloseAllTimer(void);
+
+/**
+ * @brief The time of the timer clock in ms, a caller comparing the time with its timer expiry reads it here so that
+ * both run on the same clock, virtual in the tests.
+ */
+int64_t GetTimerClockMs(void);
 } // namespace FusionConnectivity
 } // namespace OHOS
 
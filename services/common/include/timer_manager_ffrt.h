@@ -16,34 +16,83 @@
 #ifndef TIMER_MANAGER_FFRT_H
 #define TIMER_MANAGER_FFRT_H
 
-#include <atomic>
-#include "safe_map.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include "ffrt_inner.h"
+#include "fcm_scheduler.h"
+#include "fcm_timing_wheel.h"
+#include "timer_manager.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
+/**
+ * @brief Runs the timers on a hierarchical timing wheel driven by one delayed task of the scheduler.
+ *
+ * The scheduler is an FcmQueueScheduler on the steady clock unless given, a test passes an FcmVirtualScheduler to
+ * run the timers in virtual time. The task is armed at the earliest timer expiry, the cascades of the wheel run
+ * within that wakeup. Starting a timer only re-arms the task when the timer expires earlier, stopping a timer only
+ * when it's the last one the task waits for, so a timer stopped before it expires costs no wakeup. The expiry is
+ * rounded up to the tick, a timer never fires early and fires at most one tick late. The callbacks run on the
+ * scheduler in the order of their expiry, outside the lock.
+ *
+ * Coalescing: a timer with a slack may expire at any tick within [expiry, expiry + slack]. The task is armed at the
+ * end of the earliest window and every timer whose window has opened by then expires in that wakeup, so the timers
+ * whose windows overlap fire together. All the timers expiring at a wakeup are handed over as one batch and their
+ * callbacks run in one scheduler task.
+ */
 class TimerManager {
 public:
+    static constexpr uint32_t DEFAULT_TICK_MS = 10;
+
+    struct Stats {
+        uint64_t wakeupNum = 0;  // the driver task runs
+        uint64_t idleWakeupNum = 0;  // the driver task runs without any timer expiring
+        uint64_t firedNum = 0;  // the timer callbacks run
+    };
+
     static TimerManager *GetInstance();
 
-    uint64_t StartTimer(std::function<void(void)> func, int delayMs, bool isPeriodic);
-    void StopTimer(uint64_t timerId);
-    bool IsTimerStarted(uint64_t timerId);
+    explicit TimerManager(uint32_t tickMs, std::shared_ptr<FcmScheduler> scheduler = nullptr);
+    ~TimerManager();
+
+    bool StartTimer(TimerNode &node, int delayMs, bool isPeriodic, int slackMs = 0);
+    void StopTimer(TimerNode &node);
+    bool IsTimerStarted(const TimerNode &node);
     void ShutDown(void);
+    Stats GetStats();
 
-private:
-    TimerManager();
-    ~TimerManager() = default;
+    /**
+     * @brief Replace the scheduler, or restore the default one if nullptr, the started timers are stopped. Only for
+     * test.
+     */
+    void SetScheduler(std::shared_ptr<FcmScheduler> scheduler);
+
+    /**
+     * @brief The time of the scheduler clock in ms, the time the timers expire by.
+     */
+    uint64_t GetNowMs();
 
-    bool StartTimerInner(uint64_t timerId, std::function<void(void)> func, int delayMs, bool isPeriodic);
+    uint32_t GetTickMs() const
+    {
+        return tickMs_;
+    }
+
+private:
+    static std::shared_ptr<FcmScheduler> CreateDefaultScheduler();
 
-    const uint16_t MILLISEC_2_MICROSEC = 1000;
-    ffrt::mutex queueMutex_ {};
-    std::unique_ptr<ffrt::queue> queue_ { nullptr };  // locked by queueMutex_
+    void ArmDriverLocked(uint64_t tick, size_t dueNum);
+    void OnDriverTimeout(uint64_t seq);
 
-    const uint64_t INVALID_TIMER_ID = 0;
-    std::atomic_uint64_t timerCount_ = 1;
-    OHOS::SafeMap<uint64_t, std::shared_ptr<ffrt::task_handle>> taskHandleMap_ {};
+    const uint32_t tickMs_;
+    ffrt::mutex mutex_ {};
+    std::shared_ptr<FcmScheduler> scheduler_ { nullptr };  // nullptr after shut down, locked by mutex_
+    FcmTimingWheel wheel_;  // locked by mutex_
+    FcmScheduler::TaskId driverTaskId_ = FcmScheduler::INVALID_TASK_ID;  // locked by mutex_
+    uint64_t driverTick_ = FcmTimingWheel::INVALID_TICK;  // the tick the driver task is armed at, locked by mutex_
+    size_t driverDueNum_ = 0;  // the timers due at driverTick_, locked by mutex_
+    uint64_t driverSeq_ = 0;  // identifies the armed driver task, locked by mutex_
+    Stats stats_ {};  // locked by mutex_
 };
 } // namespace FusionConnectivity
 } // namespace OHOS
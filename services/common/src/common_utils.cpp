@@ -20,39 +20,10 @@
 namespace OHOS {
 namespace FusionConnectivity {
 namespace {
-constexpr size_t ADDRESS_LENGTH = 17;
-constexpr size_t ADDRESS_COLON_INDEX = 2;
-constexpr size_t ADDRESS_SEPARATOR_UNIT = 3;
-
 constexpr int32_t DEFAULT_USER_ID = 100; // 100是指主用户空间
 constexpr int32_t USER_ID_INIT = -1;
 }  // namespace
 
-bool IsValidAddress(const std::string &addr)
-{
-    if (addr.empty() || addr.length() != ADDRESS_LENGTH) {
-        return false;
-    }
-    for (size_t i = 0; i < ADDRESS_LENGTH; i++) {
-        char c = addr[i];
-        switch (i % ADDRESS_SEPARATOR_UNIT) {
-            case 0:
-            case 1:
-                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
-                    break;
-                }
-                return false;
-            case ADDRESS_COLON_INDEX:
-            default:
-                if (c == ':') {
-                    break;
-                }
-                return false;
-        }
-    }
-    return true;
-}
-
 int32_t GetCurrentActiveUserId()
 {
     int32_t userId = USER_ID_INIT;
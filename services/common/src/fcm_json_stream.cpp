@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fcm_json_stream.h"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr size_t INT_BUFFER_SIZE = 24;  // enough for the int64_t and the sign
+constexpr size_t NUMBER_MAX_LENGTH = 32;
+constexpr int SKIP_MAX_DEPTH = 32;
+constexpr size_t UNICODE_HEX_LENGTH = 4;
+constexpr int HEX_BASE = 16;
+constexpr unsigned char CONTROL_CHAR_END = 0x20;
+constexpr uint32_t HIGH_SURROGATE_BEGIN = 0xD800;
+constexpr uint32_t LOW_SURROGATE_BEGIN = 0xDC00;
+constexpr uint32_t LOW_SURROGATE_END = 0xE000;
+constexpr uint32_t SURROGATE_OFFSET = 0x10000;
+constexpr int SURROGATE_SHIFT = 10;
+constexpr const char HEX_DIGITS[] = "0123456789abcdef";
+
+bool IsNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// 将码点编码为 UTF-8
+void AppendUtf8(uint32_t codePoint, std::string &value)
+{
+    const uint32_t oneByteEnd = 0x80;
+    const uint32_t twoBytesEnd = 0x800;
+    const uint32_t threeBytesEnd = 0x10000;
+    const int bitsPerByte = 6;
+    const uint32_t lowBitsMask = 0x3F;
+    const uint32_t continuationByte = 0x80;
+    if (codePoint < oneByteEnd) {
+        value += static_cast<char>(codePoint);
+    } else if (codePoint < twoBytesEnd) {
+        value += static_cast<char>(0xC0 | (codePoint >> bitsPerByte));
+        value += static_cast<char>(continuationByte | (codePoint & lowBitsMask));
+    } else if (codePoint < threeBytesEnd) {
+        value += static_cast<char>(0xE0 | (codePoint >> (bitsPerByte * 2)));  // 2: the third byte from the end
+        value += static_cast<char>(continuationByte | ((codePoint >> bitsPerByte) & lowBitsMask));
+        value += static_cast<char>(continuationByte | (codePoint & lowBitsMask));
+    } else {
+        value += static_cast<char>(0xF0 | (codePoint >> (bitsPerByte * 3)));  // 3: the fourth byte from the end
+        value += static_cast<char>(continuationByte | ((codePoint >> (bitsPerByte * 2)) & lowBitsMask));  // 2
+        value += static_cast<char>(continuationByte | ((codePoint >> bitsPerByte) & lowBitsMask));
+        value += static_cast<char>(continuationByte | (codePoint & lowBitsMask));
+    }
+}
+
+bool ParseHex4(std::string_view raw, size_t pos, uint32_t &value)
+{
+    if (pos + UNICODE_HEX_LENGTH > raw.size()) {
+        return false;
+    }
+    auto result = std::from_chars(raw.data() + pos, raw.data() + pos + UNICODE_HEX_LENGTH, value, HEX_BASE);
+    return result.ec == std::errc() && result.ptr == raw.data() + pos + UNICODE_HEX_LENGTH;
+}
+}  // namespace
+
+void FcmJsonWriter::BeforeValue()
+{
+    if (hasElement_) {
+        buffer_ += ',';
+    }
+    hasElement_ = true;
+}
+
+void FcmJsonWriter::BeginObject()
+{
+    BeforeValue();
+    buffer_ += '{';
+    hasElement_ = false;
+}
+
+void FcmJsonWriter::EndObject()
+{
+    buffer_ += '}';
+    hasElement_ = true;
+}
+
+void FcmJsonWriter::BeginArray()
+{
+    BeforeValue();
+    buffer_ += '[';
+    hasElement_ = false;
+}
+
+void FcmJsonWriter::EndArray()
+{
+    buffer_ += ']';
+    hasElement_ = true;
+}
+
+void FcmJsonWriter::Key(std::string_view key)
+{
+    String(key);
+    buffer_ += ':';
+    // 键与值之间不需要逗号
+    hasElement_ = false;
+}
+
+void FcmJsonWriter::String(std::string_view value)
+{
+    BeforeValue();
+    buffer_ += '"';
+    size_t runBegin = 0;
+    for (size_t i = 0; i < value.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c != '"' && c != '\\' && c >= CONTROL_CHAR_END) {
+            continue;
+        }
+        // 连续的普通字符一次追加
+        buffer_.append(value.data() + runBegin, i - runBegin);
+        runBegin = i + 1;
+        switch (c) {
+            case '"': buffer_ += "\\\""; break;
+            case '\\': buffer_ += "\\\\"; break;
+            case '\n': buffer_ += "\\n"; break;
+            case '\r': buffer_ += "\\r"; break;
+            case '\t': buffer_ += "\\t"; break;
+            default:
+                buffer_ += "\\u00";
+                buffer_ += HEX_DIGITS[c >> 4];  // 4: the high hex digit
+                buffer_ += HEX_DIGITS[c & 0xF];
+                break;
+        }
+    }
+    buffer_.append(value.data() + runBegin, value.size() - runBegin);
+    buffer_ += '"';
+}
+
+void FcmJsonWriter::Int(int64_t value)
+{
+    BeforeValue();
+    char buf[INT_BUFFER_SIZE];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer_.append(buf, result.ptr - buf);
+}
+
+void FcmJsonWriter::Bool(bool value)
+{
+    BeforeValue();
+    buffer_ += value ? "true" : "false";
+}
+
+void FcmJsonWriter::NewLine()
+{
+    buffer_ += '\n';
+    hasElement_ = false;
+}
+
+void FcmJsonWriter::Clear()
+{
+    buffer_.clear();
+    hasElement_ = false;
+}
+
+const std::string &FcmJsonWriter::GetBuffer() const
+{
+    return buffer_;
+}
+
+FcmJsonReader::FcmJsonReader(std::string_view content) : content_(content)
+{}
+
+char FcmJsonReader::Peek()
+{
+    while (pos_ < content_.size() &&
+        (content_[pos_] == ' ' || content_[pos_] == '\n' || content_[pos_] == '\r' || content_[pos_] == '\t')) {
+        pos_++;
+    }
+    return pos_ < content_.size() ? content_[pos_] : '\0';
+}
+
+bool FcmJsonReader::Expect(char c)
+{
+    if (Peek() != c || pos_ >= content_.size()) {
+        return SetError();
+    }
+    pos_++;
+    return true;
+}
+
+bool FcmJsonReader::SetError()
+{
+    hasError_ = true;
+    return false;
+}
+
+bool FcmJsonReader::HasError() const
+{
+    return hasError_;
+}
+
+bool FcmJsonReader::IsEnd()
+{
+    (void)Peek();
+    return pos_ >= content_.size();
+}
+
+bool FcmJsonReader::BeginObject()
+{
+    if (hasError_ || Peek() != '{') {
+        return false;
+    }
+    pos_++;
+    isFirst_ = true;
+    return true;
+}
+
+bool FcmJsonReader::NextKey(std::string_view &key)
+{
+    if (hasError_) {
+        return false;
+    }
+    char c = Peek();
+    if (c == '}') {
+        pos_++;
+        isFirst_ = false;
+        return false;
+    }
+    if (!isFirst_ && !Expect(',')) {
+        return false;
+    }
+    isFirst_ = false;
+    bool hasEscape = false;
+    if (Peek() != '"' || !ScanString(key, hasEscape)) {
+        return SetError();
+    }
+    return Expect(':');
+}
+
+bool FcmJsonReader::BeginArray()
+{
+    if (hasError_ || Peek() != '[') {
+        return false;
+    }
+    pos_++;
+    isFirst_ = true;
+    return true;
+}
+
+bool FcmJsonReader::NextElement()
+{
+    if (hasError_) {
+        return false;
+    }
+    char c = Peek();
+    if (c == ']') {
+        pos_++;
+        isFirst_ = false;
+        return false;
+    }
+    if (!isFirst_ && !Expect(',')) {
+        return false;
+    }
+    isFirst_ = false;
+    // 逗号后必须有元素
+    if (Peek() == ']' || pos_ >= content_.size()) {
+        return SetError();
+    }
+    return true;
+}
+
+bool FcmJsonReader::ScanString(std::string_view &raw, bool &hasEscape)
+{
+    // 调用者保证当前字符为 '"'
+    size_t begin = ++pos_;
+    while (pos_ < content_.size()) {
+        unsigned char c = static_cast<unsigned char>(content_[pos_]);
+        if (c == '"') {
+            raw = content_.substr(begin, pos_ - begin);
+            pos_++;
+            return true;
+        }
+        if (c < CONTROL_CHAR_END) {
+            return SetError();
+        }
+        if (c == '\\') {
+            hasEscape = true;
+            pos_++;
+        }
+        pos_++;
+    }
+    return SetError();
+}
+
+bool FcmJsonReader::Unescape(std::string_view raw, std::string &value)
+{
+    value.clear();
+    for (size_t i = 0; i < raw.size(); i++) {
+        if (raw[i] != '\\') {
+            value += raw[i];
+            continue;
+        }
+        char c = raw[++i];
+        switch (c) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!ParseHex4(raw, i + 1, codePoint)) {
+                    return SetError();
+                }
+                i += UNICODE_HEX_LENGTH;
+                // 高代理项后必须紧跟低代理项
+                if (codePoint >= HIGH_SURROGATE_BEGIN && codePoint < LOW_SURROGATE_END) {
+                    uint32_t low = 0;
+                    if (codePoint >= LOW_SURROGATE_BEGIN || i + 2 >= raw.size() || raw[i + 1] != '\\' ||  // 2: "\u"
+                        raw[i + 2] != 'u' || !ParseHex4(raw, i + 3, low) ||  // 2, 3: skip "\u"
+                        low < LOW_SURROGATE_BEGIN || low >= LOW_SURROGATE_END) {
+                        return SetError();
+                    }
+                    i += UNICODE_HEX_LENGTH + 2;  // 2: "\u"
+                    codePoint = SURROGATE_OFFSET + ((codePoint - HIGH_SURROGATE_BEGIN) << SURROGATE_SHIFT) +
+                        (low - LOW_SURROGATE_BEGIN);
+                }
+                AppendUtf8(codePoint, value);
+                break;
+            }
+            default:
+                return SetError();
+        }
+    }
+    return true;
+}
+
+bool FcmJsonReader::ReadString(std::string &value)
+{
+    if (hasError_ || Peek() != '"') {
+        return false;
+    }
+    std::string_view raw;
+    bool hasEscape = false;
+    if (!ScanString(raw, hasEscape)) {
+        return false;
+    }
+    if (!hasEscape) {
+        value.assign(raw.data(), raw.size());
+        return true;
+    }
+    return Unescape(raw, value);
+}
+
+bool FcmJsonReader::ReadInt(int64_t &value)
+{
+    if (hasError_) {
+        return false;
+    }
+    char c = Peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return false;
+    }
+    size_t begin = pos_;
+    if (!SkipNumber()) {
+        return false;
+    }
+    const char *first = content_.data() + begin;
+    const char *last = content_.data() + pos_;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec == std::errc() && result.ptr == last) {
+        return true;
+    }
+    // 兼容 cJSON 以浮点格式输出的整数，如 1e+15
+    char buf[NUMBER_MAX_LENGTH + 1] = { 0 };
+    if (static_cast<size_t>(last - first) > NUMBER_MAX_LENGTH) {
+        return SetError();
+    }
+    std::copy(first, last, buf);
+    char *end = nullptr;
+    double number = strtod(buf, &end);
+    if (end != buf + (last - first) || std::trunc(number) != number ||
+        number < static_cast<double>(std::numeric_limits<int64_t>::min()) ||
+        number >= static_cast<double>(std::numeric_limits<int64_t>::max())) {
+        return SetError();
+    }
+    value = static_cast<int64_t>(number);
+    return true;
+}
+
+bool FcmJsonReader::ReadBool(bool &value)
+{
+    if (hasError_) {
+        return false;
+    }
+    char c = Peek();
+    if (c == 't' && SkipLiteral("true")) {
+        value = true;
+        return true;
+    }
+    if (c == 'f' && SkipLiteral("false")) {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool FcmJsonReader::SkipLiteral(std::string_view literal)
+{
+    if (content_.substr(pos_, literal.size()) != literal) {
+        return SetError();
+    }
+    pos_ += literal.size();
+    return true;
+}
+
+bool FcmJsonReader::SkipNumber()
+{
+    size_t begin = pos_;
+    while (pos_ < content_.size() && IsNumberChar(content_[pos_])) {
+        pos_++;
+    }
+    return pos_ > begin ? true : SetError();
+}
+
+bool FcmJsonReader::Skip()
+{
+    return SkipValue(0);
+}
+
+bool FcmJsonReader::SkipValue(int depth)
+{
+    if (hasError_) {
+        return false;
+    }
+    if (depth > SKIP_MAX_DEPTH) {
+        return SetError();
+    }
+    std::string_view raw;
+    bool hasEscape = false;
+    switch (Peek()) {
+        case '{':
+            (void)BeginObject();
+            while (NextKey(raw)) {
+                if (!SkipValue(depth + 1)) {
+                    return false;
+                }
+            }
+            break;
+        case '[':
+            (void)BeginArray();
+            while (NextElement()) {
+                if (!SkipValue(depth + 1)) {
+                    return false;
+                }
+            }
+            break;
+        case '"': (void)ScanString(raw, hasEscape); break;
+        case 't': (void)SkipLiteral("true"); break;
+        case 'f': (void)SkipLiteral("false"); break;
+        case 'n': (void)SkipLiteral("null"); break;
+        default: (void)SkipNumber(); break;
+    }
+    return !hasError_;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "FcmScheduler"
+#endif
+
+#include "fcm_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include "log.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+const uint64_t MILLISEC_TO_MICROSEC = 1000;
+}  // namespace
+
+FcmQueueScheduler::FcmQueueScheduler(const char *name) : queue_(name)
+{}
+
+uint64_t FcmQueueScheduler::GetSteadyNowMs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t FcmQueueScheduler::GetNowMs()
+{
+    return GetSteadyNowMs();
+}
+
+FcmScheduler::TaskId FcmQueueScheduler::PostDelayTask(const std::function<void()> &task, uint64_t delayMs,
+    const std::string &name)
+{
+    // 提交和记录句柄在同一把锁内，任务执行时一定能找到并删除自己的句柄
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    TaskId taskId = nextTaskId_++;
+    ffrt::task_attr taskAttr;
+    taskAttr.name(name.c_str()).delay(delayMs * MILLISEC_TO_MICROSEC);
+    auto handle = queue_.submit_h([this, taskId, task]() {
+        {
+            std::lock_guard<ffrt::mutex> lock(mutex_);
+            handles_.erase(taskId);
+        }
+        task();
+    }, taskAttr);
+    if (handle == nullptr) {
+        HILOGE("ffrt queue submit failed");
+        return INVALID_TASK_ID;
+    }
+    handles_.emplace(taskId, std::move(handle));
+    return taskId;
+}
+
+void FcmQueueScheduler::CancelTask(TaskId taskId)
+{
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    auto it = handles_.find(taskId);
+    if (it == handles_.end()) {
+        return;
+    }
+    queue_.cancel(it->second);
+    handles_.erase(it);
+}
+
+uint64_t FcmVirtualScheduler::GetNowMs()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nowMs_;
+}
+
+FcmScheduler::TaskId FcmVirtualScheduler::PostDelayTask(const std::function<void()> &task, uint64_t delayMs,
+    const std::string &)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    TaskId taskId = nextTaskId_++;
+    uint64_t dueMs = delayMs > UINT64_MAX - nowMs_ ? UINT64_MAX : nowMs_ + delayMs;
+    tasks_.emplace(TaskKey(dueMs, taskId), task);
+    taskDueMs_.emplace(taskId, dueMs);
+    return taskId;
+}
+
+void FcmVirtualScheduler::CancelTask(TaskId taskId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = taskDueMs_.find(taskId);
+    if (it == taskDueMs_.end()) {
+        return;
+    }
+    tasks_.erase(TaskKey(it->second, taskId));
+    taskDueMs_.erase(it);
+}
+
+size_t FcmVirtualScheduler::AdvanceTo(uint64_t nowMs)
+{
+    size_t runNum = 0;
+    while (true) {
+        std::function<void()> task = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = tasks_.begin();
+            if (it == tasks_.end() || it->first.first > nowMs) {
+                nowMs_ = std::max(nowMs_, nowMs);
+                return runNum;
+            }
+            // 时钟停在任务的到期时刻执行任务，任务中读到的时间与实际时钟一致
+            nowMs_ = std::max(nowMs_, it->first.first);
+            task = std::move(it->second);
+            taskDueMs_.erase(it->first.second);
+            tasks_.erase(it);
+        }
+        // 在锁外执行，任务中可以提交和取消任务
+        if (task) {
+            task();
+        }
+        runNum++;
+    }
+}
+
+size_t FcmVirtualScheduler::AdvanceBy(uint64_t deltaMs)
+{
+    uint64_t nowMs = GetNowMs();
+    return AdvanceTo(deltaMs > UINT64_MAX - nowMs ? UINT64_MAX : nowMs + deltaMs);
+}
+
+uint64_t FcmVirtualScheduler::GetNextDueMs()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.empty() ? UINT64_MAX : tasks_.begin()->first.first;
+}
+
+size_t FcmVirtualScheduler::GetTaskNum()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
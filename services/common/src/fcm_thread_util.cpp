@@ -75,18 +75,25 @@ struct FcmThreadUtil::impl {
         std::string name = "";
         std::atomic_bool trigger = false;
         ffrt::task_handle taskHandle = nullptr;
+        // Set if the task is posted to a scheduler for test, the scheduler owns the task.
+        std::weak_ptr<FcmScheduler> scheduler {};
+        FcmScheduler::TaskId taskId = FcmScheduler::INVALID_TASK_ID;
     };
     class TaskQueue {
     public:
         explicit TaskQueue(const char *name) : queue_(name, ffrt::queue_attr().qos(ffrt::qos_user_interactive)) {}
         ~TaskQueue() = default;
 
-        void PostTask(const ThreadUtilFunc &func, uint64_t delayTime, const std::string &name);
-        void PostDelayTask(const ThreadUtilFunc &func, uint64_t delayTime, const std::string &name);
+        void PostTask(const ThreadUtilFunc &func, uint64_t delayTime, const std::string &name,
+            const std::shared_ptr<FcmScheduler> &scheduler);
+        void PostDelayTask(const ThreadUtilFunc &func, uint64_t delayTime, const std::string &name,
+            const std::shared_ptr<FcmScheduler> &scheduler);
         void RemoveTask(const std::string &name);
         int GetQueueId(void);
 
     private:
+        void CancelDelayTask(const DelayTask &delayTask);
+
         ffrt::queue queue_;
         ffrt::mutex delayTaskVecMutex_ {};
         std::vector<std::shared_ptr<DelayTask>> delayTaskVec_ {};
@@ -95,8 +102,11 @@ struct FcmThreadUtil::impl {
     impl();
     ~impl() = default;
     std::shared_ptr<TaskQueue> CreateTaskQueue(int threadId);
+    std::shared_ptr<FcmScheduler> GetScheduler();
 
     FcmSafeMap<int, std::shared_ptr<TaskQueue>> taskQueueMap_ {};
+    ffrt::mutex schedulerMutex_ {};
+    std::shared_ptr<FcmScheduler> scheduler_ { nullptr };  // only for test, locked by schedulerMutex_
 };
 
 FcmThreadUtil::impl::impl()
@@ -114,8 +124,20 @@ FcmThreadUtil::~FcmThreadUtil()
     threadStateMap_.Clear();
 }
 
+void FcmThreadUtil::impl::TaskQueue::CancelDelayTask(const DelayTask &delayTask)
+{
+    if (delayTask.taskId != FcmScheduler::INVALID_TASK_ID) {
+        auto scheduler = delayTask.scheduler.lock();
+        if (scheduler != nullptr) {
+            scheduler->CancelTask(delayTask.taskId);
+        }
+        return;
+    }
+    queue_.cancel(delayTask.taskHandle);
+}
+
 void FcmThreadUtil::impl::TaskQueue::PostDelayTask(const ThreadUtilFunc &func,
-    uint64_t delayTime, const std::string &name)
+    uint64_t delayTime, const std::string &name, const std::shared_ptr<FcmScheduler> &scheduler)
 {
     FCM_CHECK_RETURN(delayTime < DELAY_TIME_MS_MAX, "Invalid delaytime(%{public}lu), taskName(%{public}s)",
         delayTime, name.c_str());
@@ -125,7 +147,7 @@ void FcmThreadUtil::impl::TaskQueue::PostDelayTask(const ThreadUtilFunc &func,
         // Remove the delayed task if it's triggered, or it's a same task.
         for (auto it = delayTaskVec_.begin(); it != delayTaskVec_.end();) {
             if ((*it)->name == name || (*it)->trigger.load()) {
-                queue_.cancel((*it)->taskHandle);
+                CancelDelayTask(**it);
                 it = delayTaskVec_.erase(it);
             } else {
                 it++;
@@ -137,17 +159,26 @@ void FcmThreadUtil::impl::TaskQueue::PostDelayTask(const ThreadUtilFunc &func,
     std::shared_ptr<DelayTask> delayTask = std::make_shared<DelayTask>();
     FCM_CHECK_RETURN(delayTask, "delayTask is nullptr");
 
-    ffrt::task_attr taskAttr;
-    taskAttr.name(name.c_str()).delay(delayTime * MILLISEC_TO_MICROSEC);
     auto taskFunc = [delayTask, func]() {
         delayTask->trigger = true;
         func();
     };
+    delayTask->name = name;
+    if (scheduler != nullptr) {
+        // The scheduler for test runs the task instead of the thread.
+        delayTask->taskId = scheduler->PostDelayTask(taskFunc, delayTime, name);
+        FCM_CHECK_RETURN(delayTask->taskId != FcmScheduler::INVALID_TASK_ID, "scheduler post task failed");
+        delayTask->scheduler = scheduler;
+        std::lock_guard<ffrt::mutex> lock(delayTaskVecMutex_);
+        delayTaskVec_.push_back(delayTask);
+        return;
+    }
 
+    ffrt::task_attr taskAttr;
+    taskAttr.name(name.c_str()).delay(delayTime * MILLISEC_TO_MICROSEC);
     auto taskHandle = queue_.submit_h(taskFunc, taskAttr);
     FCM_CHECK_RETURN(taskHandle, "ffrt submit task failed");
 
-    delayTask->name = name;
     delayTask->taskHandle = std::move(taskHandle);
 
     std::lock_guard<ffrt::mutex> lock(delayTaskVecMutex_);
@@ -155,10 +186,10 @@ void FcmThreadUtil::impl::TaskQueue::PostDelayTask(const ThreadUtilFunc &func,
 }
 
 void FcmThreadUtil::impl::TaskQueue::PostTask(const ThreadUtilFunc &func,
-    uint64_t delayTime, const std::string &name)
+    uint64_t delayTime, const std::string &name, const std::shared_ptr<FcmScheduler> &scheduler)
 {
     if (delayTime > 0) {
-        PostDelayTask(func, delayTime, name);
+        PostDelayTask(func, delayTime, name, scheduler);
         return;
     }
 
@@ -174,7 +205,7 @@ void FcmThreadUtil::impl::TaskQueue::RemoveTask(const std::string &name)
         return;
     }
 
-    queue_.cancel((*it)->taskHandle);
+    CancelDelayTask(**it);
     delayTaskVec_.erase(it);
 }
 
@@ -200,16 +231,17 @@ void FcmThreadUtil::PostTask(int threadId, const ThreadUtilFunc &func, uint64_t
     FCM_CHECK_RETURN(state == ThreadState::ENABLED, "threadId %{public}s is no enabled",
         GetThreadName(threadId).c_str());
 
+    std::shared_ptr<FcmScheduler> scheduler = pimpl->GetScheduler();
     std::shared_ptr<impl::TaskQueue> taskQueue = nullptr;
     if (pimpl->taskQueueMap_.GetValue(threadId, taskQueue) && taskQueue != nullptr) {
-        taskQueue->PostTask(func, delayTime, name);
+        taskQueue->PostTask(func, delayTime, name, scheduler);
         return;
     }
     // If the thread not found, create it.
     taskQueue = pimpl->CreateTaskQueue(threadId);
     // Execute the first task.
     if (taskQueue) {
-        taskQueue->PostTask(func, delayTime, name);
+        taskQueue->PostTask(func, delayTime, name, scheduler);
     }
 }
 
@@ -222,6 +254,19 @@ void FcmThreadUtil::RemoveTask(int threadId, const std::string &name)
     }
 }
 
+// Only for test.
+void FcmThreadUtil::SetScheduler(std::shared_ptr<FcmScheduler> scheduler)
+{
+    std::lock_guard<ffrt::mutex> lock(pimpl->schedulerMutex_);
+    pimpl->scheduler_ = std::move(scheduler);
+}
+
+std::shared_ptr<FcmScheduler> FcmThreadUtil::impl::GetScheduler()
+{
+    std::lock_guard<ffrt::mutex> lock(schedulerMutex_);
+    return scheduler_;
+}
+
 std::shared_ptr<FcmThreadUtil::impl::TaskQueue> FcmThreadUtil::impl::CreateTaskQueue(int threadId)
 {
     std::string threadName = GetThreadName(threadId);
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fcm_timing_wheel.h"
+#include <algorithm>
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+void ResetSentinel(FcmTimingWheel::Node &sentinel)
+{
+    sentinel.prev = &sentinel;
+    sentinel.next = &sentinel;
+}
+
+// 把链表整体移交给 to，from 置空，避免在遍历中修改链表
+void MoveList(FcmTimingWheel::Node &from, FcmTimingWheel::Node &to)
+{
+    if (from.next == &from) {
+        ResetSentinel(to);
+        return;
+    }
+    to.next = from.next;
+    to.prev = from.prev;
+    to.next->prev = &to;
+    to.prev->next = &to;
+    ResetSentinel(from);
+}
+}  // namespace
+
+FcmTimingWheel::FcmTimingWheel(uint64_t nowTick) : currentTick_(nowTick)
+{
+    for (auto &level : slots_) {
+        for (auto &slot : level) {
+            ResetSentinel(slot);
+        }
+    }
+}
+
+void FcmTimingWheel::Add(Node &node, uint64_t expireTick, uint64_t slackTicks)
+{
+    node.expireTick = expireTick;
+    node.slackTicks = slackTicks;
+    Link(node);
+    size_++;
+}
+
+void FcmTimingWheel::Link(Node &node)
+{
+    // 已过期的节点在下一次推进时超时
+    uint64_t tick = std::max(node.expireTick, currentTick_);
+    uint64_t delta = tick - currentTick_;
+    uint32_t level = 0;
+    while (level < LEVEL_NUM - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+    // 超出时间轮范围的节点放在最高层的最远槽位，级联时重新放置
+    uint64_t maxDelta = (1ULL << (LEVEL_NUM * SLOT_BITS)) - 1;
+    if (delta > maxDelta) {
+        tick = currentTick_ + maxDelta;
+    }
+    Node &sentinel = slots_[level][GetSlotIndex(tick, level)];
+    node.prev = sentinel.prev;
+    node.next = &sentinel;
+    sentinel.prev->next = &node;
+    sentinel.prev = &node;
+}
+
+void FcmTimingWheel::Remove(Node &node)
+{
+    if (!node.IsLinked()) {
+        return;
+    }
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = nullptr;
+    node.next = nullptr;
+    size_--;
+}
+
+void FcmTimingWheel::Cascade(uint32_t level)
+{
+    Node list;
+    MoveList(slots_[level][GetSlotIndex(currentTick_, level)], list);
+    while (list.next != &list) {
+        Node *node = list.next;
+        list.next = node->next;
+        node->next->prev = &list;
+        Link(*node);
+    }
+}
+
+void FcmTimingWheel::Advance(uint64_t nowTick, const std::function<void(Node &)> &onExpired)
+{
+    while (currentTick_ <= nowTick) {
+        // 跳过没有节点超时也没有级联的时刻，空闲较久后推进不逐个时刻遍历
+        uint64_t nextTick = GetNextTick();
+        if (nextTick > nowTick) {
+            currentTick_ = nowTick + 1;
+            return;
+        }
+        currentTick_ = nextTick;
+        // 低层回绕时，上一层当前槽位的节点级联到低层
+        for (uint32_t level = 1; level < LEVEL_NUM && GetSlotIndex(currentTick_, level - 1) == 0; level++) {
+            Cascade(level);
+        }
+        Node expired;
+        MoveList(slots_[0][GetSlotIndex(currentTick_, 0)], expired);
+        currentTick_++;
+        while (expired.next != &expired) {
+            Node *node = expired.next;
+            expired.next = node->next;
+            node->next->prev = &expired;
+            node->prev = nullptr;
+            node->next = nullptr;
+            size_--;
+            onExpired(*node);
+        }
+    }
+}
+
+uint64_t FcmTimingWheel::GetNextTick() const
+{
+    if (size_ == 0) {
+        return INVALID_TICK;
+    }
+    // 第0层的节点在 SLOT_NUM 个时刻内超时，每个槽位对应唯一的时刻
+    uint64_t nextTick = INVALID_TICK;
+    for (uint64_t tick = currentTick_; tick < currentTick_ + SLOT_NUM; tick++) {
+        const Node &sentinel = slots_[0][GetSlotIndex(tick, 0)];
+        if (sentinel.next != &sentinel) {
+            nextTick = tick;
+            break;
+        }
+    }
+    // 高层的非空槽位在其下一层回绕时级联
+    for (uint32_t level = 1; level < LEVEL_NUM; level++) {
+        uint32_t shift = level * SLOT_BITS;
+        uint64_t cascadeTick = ((currentTick_ + (1ULL << shift) - 1) >> shift) << shift;
+        for (uint32_t i = 0; i < SLOT_NUM && cascadeTick < nextTick; i++, cascadeTick += (1ULL << shift)) {
+            const Node &sentinel = slots_[level][GetSlotIndex(cascadeTick, level)];
+            if (sentinel.next != &sentinel) {
+                nextTick = cascadeTick;
+                break;
+            }
+        }
+    }
+    return nextTick;
+}
+
+void FcmTimingWheel::ScanDueSlot(const Node &sentinel, uint64_t &dueTick, size_t &dueNum) const
+{
+    for (const Node *node = sentinel.next; node != &sentinel; node = node->next) {
+        uint64_t tick = GetDueTick(*node);
+        if (tick < dueTick) {
+            dueTick = tick;
+            dueNum = 1;
+        } else if (tick == dueTick) {
+            dueNum++;
+        }
+    }
+}
+
+uint64_t FcmTimingWheel::GetNextDueTick(size_t *dueNum) const
+{
+    uint64_t dueTick = INVALID_TICK;
+    size_t num = 0;
+    if (size_ > 0) {
+        // 节点不早于所在槽位的时刻到期，槽位时刻晚于已找到的到期时刻时不再扫描
+        for (uint64_t tick = currentTick_; tick < currentTick_ + SLOT_NUM && tick <= dueTick; tick++) {
+            ScanDueSlot(slots_[0][GetSlotIndex(tick, 0)], dueTick, num);
+        }
+        // 高层槽位中的节点不早于其级联时刻到期
+        for (uint32_t level = 1; level < LEVEL_NUM; level++) {
+            uint32_t shift = level * SLOT_BITS;
+            uint64_t cascadeTick = ((currentTick_ + (1ULL << shift) - 1) >> shift) << shift;
+            for (uint32_t i = 0; i < SLOT_NUM && cascadeTick <= dueTick; i++, cascadeTick += (1ULL << shift)) {
+                ScanDueSlot(slots_[level][GetSlotIndex(cascadeTick, level)], dueTick, num);
+            }
+        }
+    }
+    if (dueNum != nullptr) {
+        *dueNum = num;
+    }
+    return dueTick;
+}
+
+void FcmTimingWheel::Clear()
+{
+    for (auto &level : slots_) {
+        for (auto &sentinel : level) {
+            while (sentinel.next != &sentinel) {
+                Node *node = sentinel.next;
+                sentinel.next = node->next;
+                node->prev = nullptr;
+                node->next = nullptr;
+            }
+            ResetSentinel(sentinel);
+        }
+    }
+    size_ = 0;
+}
+
+void FcmTimingWheel::Reset(uint64_t nowTick)
+{
+    Clear();
+    currentTick_ = nowTick;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -15,6 +15,7 @@
 
 #include "permission_manager.h"
 
+#include "access_token_error.h"
 #include "accesstoken_kit.h"
 #include "ipc_skeleton.h"
 #include "tokenid_kit.h"
@@ -36,6 +37,22 @@ bool PermissionManager::IsNeedAddPermissionUsedRecord(const std::string &permiss
     return (permission == PERMISSION_ACCESS_BLUETOOTH) && IsHapApp(tokenId);
 }
 
+bool PermissionManager::GetHapUserId(uint32_t tokenId, int32_t &userId)
+{
+    HapTokenInfo hapTokenInfo;
+    int ret = AccessTokenKit::GetHapTokenInfo(tokenId, hapTokenInfo);
+    if (ret == ERR_TOKENID_NOT_EXIST) {
+        return false;
+    }
+    if (ret != AccessTokenKitRet::RET_SUCCESS) {
+        HILOGE("GetHapTokenInfo failed, ret is %{public}d", ret);
+        userId = INVALID_USER_ID;
+        return true;
+    }
+    userId = hapTokenInfo.userID;
+    return true;
+}
+
 bool PermissionManager::VerifyPermission(const std::string &permission)
 {
     uint32_t tokenId = IPCSkeleton::GetCallingTokenID();
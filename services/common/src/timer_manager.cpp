@@ -19,83 +19,195 @@
 #include "timer_manager.h"
 #include "timer_manager_ffrt.h"
 
+#include <vector>
 #include "log.h"
-#include "securec.h"
-#include "ffrt_inner.h"
-#include "safe_map.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
-TimerManager::TimerManager()
+TimerManager::TimerManager(uint32_t tickMs, std::shared_ptr<FcmScheduler> scheduler)
+    : tickMs_(tickMs > 0 ? tickMs : DEFAULT_TICK_MS),
+    scheduler_(scheduler != nullptr ? std::move(scheduler) : CreateDefaultScheduler()),
+    wheel_(scheduler_->GetNowMs() / tickMs_)
+{}
+
+TimerManager::~TimerManager()
 {
-    queue_ = std::make_unique<ffrt::queue>("fcm_timer");
+    ShutDown();
 }
 
 TimerManager *TimerManager::GetInstance()
 {
-    static TimerManager instance;
+    static TimerManager instance(DEFAULT_TICK_MS);
     return &instance;
 }
 
-bool TimerManager::StartTimerInner(uint64_t timerId, std::function<void(void)> func, int delayMs, bool isPeriodic)
+std::shared_ptr<FcmScheduler> TimerManager::CreateDefaultScheduler()
 {
-    auto ffrtFunc = [this, timerId, func, delayMs, isPeriodic]() {
-        do {
-            // 处理周期定时器
-            if (isPeriodic && StartTimerInner(timerId, func, delayMs, isPeriodic)) {
-                break;
-            }
-            // 单次定时器触发超时后，清理资源
-            taskHandleMap_.Erase(timerId);
-        } while (0);
-        // 执行定时器超时函数
-        func();
-    };
-
-    std::lock_guard<ffrt::mutex> lock(queueMutex_);
-    ffrt::task_attr taskAttr;
-    taskAttr.name("bt_service_timer").delay(static_cast<uint64_t>(delayMs) * MILLISEC_2_MICROSEC);
-    if (queue_) {
-        auto handle = queue_->submit_h(ffrtFunc, taskAttr);
-        if (handle == nullptr) {
-            HILOGE("ffrt queue submit failed");
-            return false;
-        }
-        auto handlePtr = std::make_shared<ffrt::task_handle>(std::move(handle));
-        taskHandleMap_.EnsureInsert(timerId, handlePtr);
+    return std::make_shared<FcmQueueScheduler>("fcm_timer");
+}
+
+uint64_t TimerManager::GetNowMs()
+{
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    // 关闭后不再有定时器，按单调时钟返回
+    return scheduler_ ? scheduler_->GetNowMs() : FcmQueueScheduler::GetSteadyNowMs();
+}
+
+bool TimerManager::StartTimer(TimerNode &node, int delayMs, bool isPeriodic, int slackMs)
+{
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    if (!scheduler_ || node.IsLinked()) {
+        return false;
+    }
+    uint64_t delay = static_cast<uint64_t>(std::max(delayMs, 0));
+    // 超时时刻向上取整到tick，定时器不会提前超时；宽限向下取整，不会超过允许的延后
+    uint64_t expireTick = (scheduler_->GetNowMs() + delay + tickMs_ - 1) / tickMs_;
+    node.periodTicks = isPeriodic ? std::max<uint64_t>((delay + tickMs_ - 1) / tickMs_, 1) : 0;
+    uint64_t slackTicks = static_cast<uint64_t>(std::max(slackMs, 0)) / tickMs_;
+    wheel_.Add(node, expireTick, slackTicks);
+    // 只在新定时器的窗口在驱动任务之前结束时重新提交驱动任务，窗口包含驱动时刻的定时器随驱动任务一起超时
+    uint64_t dueTick = wheel_.GetDueTick(node);
+    if (dueTick < driverTick_) {
+        ArmDriverLocked(dueTick, 1);
+    } else if (dueTick == driverTick_) {
+        driverDueNum_++;
     }
     return true;
 }
 
-uint64_t TimerManager::StartTimer(std::function<void(void)> func, int delayMs, bool isPeriodic)
+void TimerManager::StopTimer(TimerNode &node)
 {
-    uint64_t timerId = timerCount_++;
-    bool ret = StartTimerInner(timerId, func, delayMs, isPeriodic);
-    return ret ? timerId : INVALID_TIMER_ID;
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    if (!node.IsLinked()) {
+        return;
+    }
+    uint64_t dueTick = wheel_.GetDueTick(node);
+    wheel_.Remove(node);
+    // 驱动任务等待的定时器全部停止时，按下一个到期时刻重新提交或取消驱动任务，避免空唤醒
+    if (dueTick == driverTick_ && driverDueNum_ > 0 && --driverDueNum_ == 0) {
+        size_t dueNum = 0;
+        uint64_t nextTick = wheel_.GetNextDueTick(&dueNum);
+        ArmDriverLocked(nextTick, dueNum);
+    }
+}
+
+bool TimerManager::IsTimerStarted(const TimerNode &node)
+{
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    return node.IsLinked();
 }
 
-void TimerManager::StopTimer(uint64_t timerId)
+void TimerManager::ArmDriverLocked(uint64_t tick, size_t dueNum)
 {
-    std::lock_guard<ffrt::mutex> lock(queueMutex_);
-    std::shared_ptr<ffrt::task_handle> handlePtr = nullptr;
-    taskHandleMap_.Find(timerId, handlePtr);
-    if (queue_ && handlePtr) {
-        queue_->cancel(*handlePtr);
+    if (driverTaskId_ != FcmScheduler::INVALID_TASK_ID) {
+        scheduler_->CancelTask(driverTaskId_);
+        driverTaskId_ = FcmScheduler::INVALID_TASK_ID;
+    }
+    // 取消失败时旧的驱动任务可能已在执行，按序号识别后丢弃
+    driverSeq_++;
+    driverTick_ = tick;
+    driverDueNum_ = dueNum;
+    if (tick == FcmTimingWheel::INVALID_TICK) {
+        return;
+    }
+    uint64_t nowMs = scheduler_->GetNowMs();
+    uint64_t tickMs = tick * tickMs_;
+    uint64_t delayMs = tickMs > nowMs ? tickMs - nowMs : 0;
+    uint64_t seq = driverSeq_;
+    driverTaskId_ = scheduler_->PostDelayTask([this, seq]() { OnDriverTimeout(seq); }, delayMs, "bt_service_timer");
+    if (driverTaskId_ == FcmScheduler::INVALID_TASK_ID) {
+        driverTick_ = FcmTimingWheel::INVALID_TICK;
+        driverDueNum_ = 0;
+    }
+}
+
+void TimerManager::OnDriverTimeout(uint64_t seq)
+{
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<ffrt::mutex> lock(mutex_);
+        if (!scheduler_) {
+            return;
+        }
+        if (seq != driverSeq_) {
+            stats_.wakeupNum++;
+            stats_.idleWakeupNum++;
+            return;
+        }
+        driverTaskId_ = FcmScheduler::INVALID_TASK_ID;
+        uint64_t nowTick = scheduler_->GetNowMs() / tickMs_;
+        wheel_.Advance(nowTick, [this, nowTick, &callbacks](FcmTimingWheel::Node &node) {
+            auto &timerNode = static_cast<TimerNode &>(node);
+            // 周期定时器在回调前重新加入时间轮，回调中可以停止
+            if (timerNode.periodTicks > 0) {
+                wheel_.Add(timerNode, std::max(timerNode.expireTick, nowTick) + timerNode.periodTicks,
+                    timerNode.slackTicks);
+            }
+            // 回调可能销毁定时器，复制后在锁外执行
+            callbacks.push_back(timerNode.callback);
+        });
+        // 驱动任务在最早结束的窗口唤醒，推进时窗口已开始的定时器一并超时，级联也在推进时完成
+        size_t dueNum = 0;
+        uint64_t nextTick = wheel_.GetNextDueTick(&dueNum);
+        ArmDriverLocked(nextTick, dueNum);
+        // 同一次唤醒中超时的定时器作为一批，在同一个队列任务中执行回调
+        stats_.wakeupNum++;
+        stats_.idleWakeupNum += callbacks.empty() ? 1 : 0;
+        stats_.firedNum += callbacks.size();
+    }
+    for (auto &callback : callbacks) {
+        if (callback) {
+            callback();
+        }
     }
-    taskHandleMap_.Erase(timerId);
 }
 
-bool TimerManager::IsTimerStarted(uint64_t timerId)
+TimerManager::Stats TimerManager::GetStats()
 {
-    std::shared_ptr<ffrt::task_handle> handlePtr = nullptr;
-    return taskHandleMap_.Find(timerId, handlePtr) && handlePtr != nullptr;
+    std::lock_guard<ffrt::mutex> lock(mutex_);
+    return stats_;
+}
+
+void TimerManager::SetScheduler(std::shared_ptr<FcmScheduler> scheduler)
+{
+    if (scheduler == nullptr) {
+        scheduler = CreateDefaultScheduler();
+    }
+    std::shared_ptr<FcmScheduler> oldScheduler = nullptr;
+    {
+        std::lock_guard<ffrt::mutex> lock(mutex_);
+        if (scheduler_ && driverTaskId_ != FcmScheduler::INVALID_TASK_ID) {
+            scheduler_->CancelTask(driverTaskId_);
+        }
+        driverTaskId_ = FcmScheduler::INVALID_TASK_ID;
+        driverTick_ = FcmTimingWheel::INVALID_TICK;
+        driverDueNum_ = 0;
+        driverSeq_++;
+        oldScheduler = std::move(scheduler_);
+        scheduler_ = std::move(scheduler);
+        // 新旧时钟的时间不连续，停止所有定时器并从新时钟的当前时刻开始
+        wheel_.Reset(scheduler_->GetNowMs() / tickMs_);
+    }
+    oldScheduler = nullptr;
 }
 
 void TimerManager::ShutDown(void)
 {
-    std::lock_guard<ffrt::mutex> lock(queueMutex_);
-    taskHandleMap_.Clear();
-    queue_ = nullptr;
+    std::shared_ptr<FcmScheduler> scheduler = nullptr;
+    {
+        std::lock_guard<ffrt::mutex> lock(mutex_);
+        wheel_.Clear();
+        if (scheduler_ && driverTaskId_ != FcmScheduler::INVALID_TASK_ID) {
+            scheduler_->CancelTask(driverTaskId_);
+        }
+        driverTaskId_ = FcmScheduler::INVALID_TASK_ID;
+        driverTick_ = FcmTimingWheel::INVALID_TICK;
+        driverDueNum_ = 0;
+        driverSeq_++;
+        scheduler = std::move(scheduler_);
+    }
+    // 在锁外销毁调度器，等待正在执行的驱动任务结束
+    scheduler = nullptr;
 }
 
 void CloseAllTimer(void)
@@ -103,42 +215,44 @@ void CloseAllTimer(void)
     TimerManager::GetInstance()->ShutDown();
 }
 
-Timer::Timer(const std::function<void()> &callback) : isPeriodic_(false), callback_(callback)
-{}
+int64_t GetTimerClockMs(void)
+{
+    return static_cast<int64_t>(TimerManager::GetInstance()->GetNowMs());
+}
+
+Timer::Timer(const std::function<void()> &callback)
+{
+    node_.callback = callback;
+}
 
 Timer::~Timer()
 {
     Stop();
 }
 
-bool Timer::Start(int ms, bool isPeriodic)
+bool Timer::Start(int ms, bool isPeriodic, int slackMs)
 {
-    if (IsStarted()) {
-        HILOGD("timer is started");
-        return false;
-    }
-
-    timerId_ = TimerManager::GetInstance()->StartTimer(callback_, ms, isPeriodic);
-    if (timerId_ == INVALID_TIMER_ID) {
-        HILOGE("start timer failed");
+    if (!TimerManager::GetInstance()->StartTimer(node_, ms, isPeriodic, slackMs)) {
+        HILOGD("timer is started or the timer manager is shut down");
         return false;
     }
     return true;
 }
 
-void Timer::Stop()
+bool Timer::Restart(int ms, bool isPeriodic, int slackMs)
 {
-    if (!IsStarted()) {
-        HILOGD("timer is stopped");
-        return;
-    }
+    Stop();
+    return Start(ms, isPeriodic, slackMs);
+}
 
-    TimerManager::GetInstance()->StopTimer(timerId_);
+void Timer::Stop()
+{
+    TimerManager::GetInstance()->StopTimer(node_);
 }
 
 bool Timer::IsStarted(void)
 {
-    return TimerManager::GetInstance()->IsTimerStarted(timerId_);
+    return TimerManager::GetInstance()->IsTimerStarted(node_);
 }
 } // namespace FusionConnectivity
 } // namespace OHOS
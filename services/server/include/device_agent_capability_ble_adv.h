@@ -20,15 +20,19 @@
 #include <atomic>
 #include <mutex>
 #include "timer_manager.h"
-#include "bluetooth_ble_central_manager.h"
+#include "partner_device_presence_filter.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_scan_scheduler.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
 class DeviceAgentCapabilityBleAdv : public IDeviceAgentCapability,
                                     public std::enable_shared_from_this<DeviceAgentCapabilityBleAdv> {
 public:
-    DeviceAgentCapabilityBleAdv(DependencyFuncs funcs, std::weak_ptr<PartnerDevice> ownerWptr)
-        : IDeviceAgentCapability(funcs, ownerWptr) {}
+    DeviceAgentCapabilityBleAdv(DependencyFuncs funcs, std::weak_ptr<PartnerDevice> ownerWptr,
+        const PartnerDevicePresenceFilter::Config &presenceConfig = PartnerDevicePresenceFilter::Config(),
+        const PartnerDeviceScanScheduler &scanScheduler = PartnerDeviceScanScheduler())
+        : IDeviceAgentCapability(funcs, ownerWptr), presenceFilter_(presenceConfig), scanScheduler_(scanScheduler) {}
     ~DeviceAgentCapabilityBleAdv() override = default;
 
     void Init(const std::string &addr) override;
@@ -39,32 +43,49 @@ public:
     void OnScreenOff() override;
     void OnExtensionDestroy() override;
 
-private:
-    class BluetoothScanCallback : public Bluetooth::BleCentralManagerCallback {
-    public:
-        BluetoothScanCallback(std::weak_ptr<DeviceAgentCapabilityBleAdv> ownerWptr) : ownerWptr_(ownerWptr) {}
-        ~BluetoothScanCallback() override = default;
-        void OnScanCallback(const Bluetooth::BleScanResult &result) override;
-        void OnFoundOrLostCallback(const Bluetooth::BleScanResult &result, uint8_t callbackType) override {}
-        void OnBleBatchScanResultsEvent(const std::vector<Bluetooth::BleScanResult> &results) override {}
-        void OnStartOrStopScanEvent(int resultCode, bool isStartScan) override {}
-
-        std::weak_ptr<DeviceAgentCapabilityBleAdv> ownerWptr_;
-    };
+    /**
+     * @brief The presence history learned by the scan, handed over to the next BLE capability of the address.
+     */
+    PartnerDeviceScanScheduler GetScanScheduler();
 
+private:
+    void OnScanEvent(const Bluetooth::BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event);
+    void OnScanResult(const Bluetooth::BleScanResult &result);
+    void OnDeviceFound(const Bluetooth::BleScanResult &result);
+    void OnDeviceLost(const Bluetooth::BleScanResult &result);
     void StartBleScan();
     void StopBleScan();
+    void ResumeBleScanLocked();
+    void RemoveScanFilterLocked();
+    void ArmDutyCycleTimerLocked(int64_t delayMs, void (DeviceAgentCapabilityBleAdv::*handler)());
+    void StopDutyCycleTimerLocked();
+    void OnDutyCycleTimeout();
+    void ArmScanWindowLocked();
+    void OnScanWindowExpiredLocked();
+    void OnScanPauseExpiredLocked();
+    void EnterLocked();
+    void ArmExitTimer();
+    void StopExitTimerLocked();
+    void OnExitTimeout();
 
     std::atomic_bool isScanStarted_ = false;
     std::string address_ = "";
-    std::atomic_int curScanMode_ = Bluetooth::SCAN_MODE_OP_P10_60_600;
     std::mutex bleScanMutex_;
-    std::shared_ptr<BluetoothScanCallback> bluetoothScanCallback_ { nullptr };
-    std::unique_ptr<Bluetooth::BleCentralManager> bleCentralManager_ { nullptr };
+    bool isInited_ = false;  // locked by bleScanMutex_
+    // The filter of this device in the shared scan engine, locked by bleScanMutex_.
+    uint64_t scanFilterId_ = PartnerDeviceScanEngine::INVALID_FILTER_ID;
+    // Decides when the device enters and exits from the scan results, locked by bleScanMutex_.
+    PartnerDevicePresenceFilter presenceFilter_;
+    // The adaptive duty cycle of the scan, learned from the presence of the device, locked by bleScanMutex_.
+    PartnerDeviceScanScheduler scanScheduler_;
+    // The timer of the current scan window, or the back-off pause while the filter is removed, created once and
+    // restarted, locked by bleScanMutex_. The handler is the armed one or nullptr, it drops the callback of a stopped
+    // or restarted timer, which may be running while it's stopped.
+    std::unique_ptr<Timer> dutyCycleTimer_ { nullptr };
+    void (DeviceAgentCapabilityBleAdv::*dutyCycleHandler_)() = nullptr;
 
     std::mutex timerMutex_;
-    int extensionKeepAliveTimeout_ = 3 * 60 * 1000;  // 3min
-    std::unique_ptr<Timer> scanTimer_ { nullptr };  // BLE扫描到设备，但未触发ACL连接的超时定时器
+    std::unique_ptr<Timer> scanTimer_ { nullptr };  // BLE扫描到设备，但未触发ACL连接时设备退出的定时器，创建后复用
 };
 }  // namespace FusionConnectivity
 }  // namespace OHOS
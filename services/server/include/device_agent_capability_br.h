@@ -19,14 +19,16 @@
 #include "i_device_agent_capability.h"
 #include <mutex>
 #include "timer_manager.h"
+#include "partner_device_presence_filter.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
 class DeviceAgentCapabilityBr : public IDeviceAgentCapability,
                                 public std::enable_shared_from_this<DeviceAgentCapabilityBr> {
 public:
-    DeviceAgentCapabilityBr(DependencyFuncs funcs, std::weak_ptr<PartnerDevice> ownerWptr)
-        : IDeviceAgentCapability(funcs, ownerWptr) {}
+    DeviceAgentCapabilityBr(DependencyFuncs funcs, std::weak_ptr<PartnerDevice> ownerWptr,
+        const PartnerDevicePresenceFilter::Config &presenceConfig = PartnerDevicePresenceFilter::Config())
+        : IDeviceAgentCapability(funcs, ownerWptr), presenceFilter_(presenceConfig) {}
     ~DeviceAgentCapabilityBr() override = default;
 
     void Init(const std::string &addr) override;
@@ -38,11 +40,16 @@ public:
     void OnExtensionDestroy() override {}
 
 private:
+    void ArmExitTimerLocked(int64_t nowMs);
+    void StopExitTimerLocked();
+    void OnExitTimeout();
+
     std::atomic_bool isInit_ { false };
 
     std::mutex timerMutex_;
-    int extensionKeepAliveTimeout_ = 3 * 60 * 1000;  // 3min
-    std::unique_ptr<Timer> aclDisconnectTimer_ { nullptr };
+    // The presence of the device tracked by the ACL connection, locked by timerMutex_.
+    PartnerDevicePresenceFilter presenceFilter_;
+    std::unique_ptr<Timer> aclDisconnectTimer_ { nullptr };  // created once and restarted, locked by timerMutex_
 };
 }  // namespace FusionConnectivity
 }  // namespace OHOS
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef I_BLE_SCANNER_H
+#define I_BLE_SCANNER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "bluetooth_ble_central_manager.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief A BLE scan session, reports the scan results to the callback it's created with.
+ *
+ * Implemented by BleCentralManager, replaced by a fake in the tests.
+ */
+class IBleScanner {
+public:
+    using Factory =
+        std::function<std::unique_ptr<IBleScanner>(std::shared_ptr<Bluetooth::BleCentralManagerCallback> callback)>;
+
+    virtual ~IBleScanner() = default;
+
+    virtual int StartScan(
+        const Bluetooth::BleScanSettings &settings, const std::vector<Bluetooth::BleScanFilter> &filters) = 0;
+    virtual int StopScan() = 0;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // I_BLE_SCANNER_H
@@ -16,18 +16,21 @@
 #ifndef PARTNER_DEVICE_H
 #define PARTNER_DEVICE_H
 
+#include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_set>
 #include "ifusion_connectivity_types.h"
-#include "fcm_common_event_subscriber.h"
 #include "partner_device_address.h"
+#include "fcm_mac_address.h"
 #include "timer_manager.h"
 #include "i_device_agent_capability.h"
+#include "partner_device_presence_engine.h"
+#include "partner_device_registry.h"
 #include "bluetooth_host.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
-class FcmCommonEventSubscriber;
 enum PartnerAgentExtensionAbilityDestroyReason {
     ABILITY_DESTROY_UNKNOWN_REASON = 0,
     ABILITY_DESTROY_USER_CLOSED_ABILITY = 1,
@@ -36,17 +39,29 @@ enum PartnerAgentExtensionAbilityDestroyReason {
     ABILITY_DESTROY_BLUETOOTH_DISABLED = 4,
 };
 
+/**
+ * @brief The addresses of the paired devices, got at once to replace querying the pair state of each device.
+ */
+struct PairedDevices {
+    // False if getting the paired devices failed, then Contains queries the pair state of the device.
+    bool isValid = false;
+    std::unordered_set<FcmMacAddress> addresses;
+
+    static PairedDevices Get();
+    bool Contains(const FcmMacAddress &address) const;
+};
+
 class PartnerDevice : public std::enable_shared_from_this<PartnerDevice> {
 public:
-    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC =
-        "usual.event.bluetooth.remotedevice.ACL_CONNECTED_REALMAC";
-    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC =
-        "usual.event.bluetooth.remotedevice.ACL_DISCONNECTED_REALMAC";
-    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC =
-        "usual.event.bluetooth.remotedevice.PAIR_STATE_CHANGE_REALMAC";
+    enum BondState : int {
+        BOND_STATE_NONE = 0,
+        BOND_STATE_BONDING = 1,
+        BOND_STATE_BONDED = 2
+    };
 
     struct DependencyFuncs {
-        std::function<void(void)> updateConfig;
+        // Called with the registry key of the device whose config changed.
+        std::function<void(const PartnerDeviceMapKey &)> updateConfig;
         std::function<void(std::string, std::string, PartnerDeviceAddress)> discoverExtension;
         std::function<void(std::string, std::string, int)> destroyExtension;
     };
@@ -61,17 +76,35 @@ public:
         bool isUserEnabled = true;
         DeviceCapability capability;
         BusinessCapability businessCapability;
+        // The presence thresholds of the device, not persisted, set by the server when the device is created.
+        PartnerDevicePresenceFilter::Config presenceConfig;
     };
 
+    /**
+     * @brief Create a device, isPaired and isBluetoothOn are sampled by the caller once for all the devices created
+     * together, so creating a device makes no IPC.
+     *
+     * @return Returns nullptr if the device address is invalid.
+     */
     static std::shared_ptr<PartnerDevice> CreateInstance(
-        const DeviceInfo &deviceInfo, DependencyFuncs funcs);
+        const DeviceInfo &deviceInfo, DependencyFuncs funcs, bool isPaired, bool isBluetoothOn);
 
     void Close();
+    // The registry key of the device, the tokenId and the packed form of the device address.
+    const PartnerDeviceMapKey &GetKey() const
+    {
+        return key_;
+    }
     DeviceInfo GetDeviceInfo()
     {
         std::lock_guard<std::mutex> lock(deviceInfoMutex_);
         return deviceInfo_;
     }
+    PartnerDeviceAddress GetDeviceAddress()
+    {
+        std::lock_guard<std::mutex> lock(deviceInfoMutex_);
+        return deviceInfo_.deviceAddress;
+    }
     void SetUserEnableAbility(bool isEnabled);
     bool IsUserEnableAbility()
     {
@@ -79,39 +112,42 @@ public:
         return deviceInfo_.isUserEnabled;
     }
 
+    // The event handlers, called by PartnerDeviceEventDispatcher with the events of this device. The ACL and screen
+    // events are handled by the presence engine of the address.
+    void OnBluetoothDevicePairStateChange(int state);
+    // isPaired is looked up in the paired devices got once for all the devices when Bluetooth turns on.
+    void OnBluetoothTurnOn(bool isPaired);
+    void OnBluetoothTurnOff();
+
 private:
-    class BluetoothStateObserver : public Bluetooth::BluetoothHostObserver {
-    public:
-        BluetoothStateObserver(std::weak_ptr<PartnerDevice> ownerWptr) : ownerWptr_(ownerWptr) {}
-        ~BluetoothStateObserver() override = default;
-
-        void OnStateChanged(const int transport, const int status) override;
-        void OnDiscoveryStateChanged(int status) override {}
-        void OnDiscoveryResult(const Bluetooth::BluetoothRemoteDevice &device,
-            int rssi, const std::string deviceName, int deviceClass) override {}
-        void OnPairRequested(const Bluetooth::BluetoothRemoteDevice &device) override {}
-        void OnPairConfirmed(const Bluetooth::BluetoothRemoteDevice &device, int reqType, int number) override {}
-        void OnScanModeChanged(int mode) override {}
-        void OnDeviceNameChanged(const std::string &deviceName) override {}
-        void OnDeviceAddrChanged(const std::string &address) override {}
-
-    private:
-        std::weak_ptr<PartnerDevice> ownerWptr_;
+    /**
+     * @brief The runtime of an active device: the subscription to the presence engine of the address.
+     *
+     * A device is active only when it's allowed (paired and enabled by the user) and Bluetooth is on, otherwise it's
+     * dormant, only keeps the device info and ignores the events other than the pair and Bluetooth state changes.
+     */
+    struct Runtime {
+        std::shared_ptr<PartnerDevicePresenceEngine> presenceEngine;
+        uint64_t subscriberId = 0;
     };
 
-    PartnerDevice(const DeviceInfo &deviceInfo, DependencyFuncs funcs)
-        : deviceInfo_(deviceInfo), dependencyFuncs_(funcs) {}
-
-    void Init();
-    void UpdatePartnerDeviceIsAllowStarted(const DeviceInfo &info);
-    void InitDeviceAgentCapability(const std::string &addr, bool isSupportBleAdvertiser);
-    void CloseDeviceAgentCapability(int destroyReason);
-    void OnCommonEventReceived(const OHOS::EventFwk::CommonEventData &data);
-    void OnBluetoothDeviceAclStateChange(const OHOS::EventFwk::CommonEventData &data, bool isConnect);
-    void OnBluetoothDevicePairStateChange(const OHOS::EventFwk::CommonEventData &data);
-    void OnScreenStateChange(bool isScreenOn);
-    void SubscribeCommonEvent(const std::vector<std::string> &eventVec,
-    const std::vector<std::string> &permissionVec, std::shared_ptr<FcmCommonEventSubscriber> &eventSubscribe);
+    PartnerDevice(const DeviceInfo &deviceInfo, const FcmMacAddress &macAddress, DependencyFuncs funcs)
+        : key_(deviceInfo.tokenId, macAddress), deviceInfo_(deviceInfo), dependencyFuncs_(funcs) {}
+
+    void Init(bool isPaired, bool isBluetoothOn);
+    void UpdatePartnerDeviceIsAllowStarted(const DeviceInfo &info, bool isPaired);
+    // Returns true if the extension started by the closed runtime needs to be destroyed, the caller calls
+    // DestroyExtension after unlocking runtimeMutex_.
+    bool UpdateRuntimeLocked();
+    std::shared_ptr<Runtime> CreateRuntime();
+    // Returns true if the extension of the device has been started by the presence engine.
+    bool CloseRuntime(const std::shared_ptr<Runtime> &runtime);
+    void DestroyExtension(int destroyReason);
+    std::shared_ptr<Runtime> GetRuntime()
+    {
+        std::lock_guard<std::mutex> lock(runtimeMutex_);
+        return runtime_;
+    }
     bool IsPairedDevice(const std::string &address);
 
     void UpdateLostTimestamp(int64_t lostTimestamp)
@@ -120,30 +156,28 @@ private:
         deviceInfo_.lostTimestamp = lostTimestamp;
     }
 
+    // The tokenId and the address never change, so the key can be read without locking deviceInfoMutex_.
+    const PartnerDeviceMapKey key_;
     std::mutex deviceInfoMutex_;
     DeviceInfo deviceInfo_;
 
-    std::shared_ptr<FcmCommonEventSubscriber> bluetoothEventSubscribe_ { nullptr };
-    std::shared_ptr<FcmCommonEventSubscriber> screenEventSubscribe_ { nullptr };
-
     DependencyFuncs dependencyFuncs_;
 
-    std::atomic_bool isAllowed_ { true };
-
-    const std::string CAPABILITY_BLE_ADV_KEY = "CapabilityBleAdvKey";
-    const std::string CAPABILITY_BR_KEY = "CapabilityBrKey";
-    // 该变量仅初始化创建一次，后续都是读操作
-    std::map<std::string, std::shared_ptr<IDeviceAgentCapability>> deviceAgentCapabilityMap_;
-
-    std::shared_ptr<BluetoothStateObserver> bluetoothStateObserver_ { nullptr };
+    // Serializes the activation and deactivation of the device.
+    std::mutex runtimeMutex_;
+    std::atomic_bool isAllowed_ { false };
+    // Sampled when created and kept by the Bluetooth state changes, locked by runtimeMutex_.
+    bool isBluetoothOn_ = false;
+    // Created while the device is active.
+    std::shared_ptr<Runtime> runtime_ { nullptr };
 
     // The passkey pattern of C++
     struct PassKey {
         PassKey() {};
     };
 public:
-    explicit PartnerDevice(PassKey, const DeviceInfo &deviceInfo, DependencyFuncs funcs)
-        : PartnerDevice(deviceInfo, funcs) {};
+    explicit PartnerDevice(PassKey, const DeviceInfo &deviceInfo, const FcmMacAddress &macAddress,
+        DependencyFuncs funcs) : PartnerDevice(deviceInfo, macAddress, funcs) {};
     ~PartnerDevice();
 };
 
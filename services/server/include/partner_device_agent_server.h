@@ -16,7 +16,11 @@
 #ifndef OHOS_PARTNER_DEVICE_AGENT_SERVER_H
 #define OHOS_PARTNER_DEVICE_AGENT_SERVER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include "base_def.h"
+#include "ffrt_inner.h"
 #include "iservice_registry.h"
 #include "if_system_ability_manager.h"
 #include "system_ability.h"
@@ -24,13 +28,13 @@
 #include "permission_manager.h"
 #include "fusion_conn_load_utils.h"
 #include "partner_device.h"
-#include "safe_map.h"
+#include "partner_device_registry.h"
+#include "partner_device_config_persister.h"
+#include "partner_device_event_dispatcher.h"
+#include "partner_device_quota.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
-using PartnerDeviceMapKey = std::pair<uint32_t, std::string>;
-using PartnerDeviceMap = SafeMap<PartnerDeviceMapKey, std::shared_ptr<PartnerDevice>>;
-
 class PartnerDeviceAgentServer : public SystemAbility, public PartnerDeviceAgentStub {
     DECLARE_SYSTEM_ABILITY(PartnerDeviceAgentServer);
 public:
@@ -39,6 +43,7 @@ public:
     void OnStart() override;
     void OnStop() override;
     int32_t OnIdle(const SystemAbilityOnDemandReason& idleReason) override;
+    int Dump(int fd, const std::vector<std::u16string> &args) override;
     // Before IPC OnRemoteRequestInner, Used for check permission
     int32_t CallbackEnter(uint32_t code) override;
     // After IPC OnRemoteRequestInner
@@ -61,14 +66,22 @@ private:
     int32_t OnDestroyWithReasonExtensionService(
         const std::string &bundleName, const std::string &abilityName, int destroyReason);
 
-    bool IsDeviceBoundByCallingApp(const PartnerDeviceAddress &deviceAddress);
-    bool IsDeviceBoundByAll(const PartnerDeviceAddress &deviceAddress);
+    // The address has been validated at the IDL/JS boundary, an invalid one is still rejected here.
+    static bool ParseMacAddress(const PartnerDeviceAddress &deviceAddress, FcmMacAddress &macAddress);
+    bool IsDeviceBoundByCallingApp(const FcmMacAddress &macAddress);
     bool IsPairedDevice(const PartnerDeviceAddress &deviceAddress);
 
-    void Init();
-    std::shared_ptr<PartnerDevice> CreatePartnerDeviceInstance(PartnerDevice::DeviceInfo &deviceInfo);
+    void InitParameters();
+    void InitPresenceParameters();
+    // Load the bound devices, runs in the background after the SA is published. Returns false if stopped before.
+    bool Init();
+    void SetReady();
+    // Wait until the bound devices are loaded, returns false on timeout.
+    bool WaitReady(int64_t timeoutMs);
+    std::shared_ptr<PartnerDevice> CreatePartnerDeviceInstance(PartnerDevice::DeviceInfo &deviceInfo, bool isPaired,
+        bool isBluetoothOn);
     void AttemptUnloadPartnerAgent();
-    int ChangeDeviceControlState(const std::string &addr, bool isEnabled);
+    int ChangeDeviceControlState(const FcmMacAddress &addr, bool isEnabled);
 
     std::map<int, PermissionItem> permissionsMap_ {};
 
@@ -77,7 +90,25 @@ private:
 
     std::atomic<bool> partnerAgentExtensionLoaded_ = false;
     std::shared_ptr<FusionConnectivityLoadUtils> partnerAgentExtensionHandler_;
-    PartnerDeviceMap partnerDeviceMap_;
+    PartnerDeviceRegistry partnerDeviceMap_;
+    // Routes the common events to the devices of partnerDeviceMap_.
+    PartnerDeviceEventDispatcher eventDispatcher_ { partnerDeviceMap_ };
+    // Set in InitParameters before any device is loaded or bound.
+    PartnerDeviceQuota deviceQuota_;
+    // The presence thresholds of the devices, set in InitParameters before any device is loaded or bound.
+    PartnerDevicePresenceFilter::Config presenceConfig_;
+
+    // The background task running Init, waited in OnStop since it captures this.
+    ffrt::task_handle initTask_ = nullptr;
+    // Set in OnStop, Init checks it between the steps and stops early.
+    std::atomic<bool> isStopping_ = false;
+    // The readiness latch, opened once the bound devices are loaded. IPCs arriving earlier wait briefly in
+    // CallbackEnter and are rejected with FCM_ERR_SERVICE_NOT_READY if still not ready.
+    std::mutex readyMutex_;
+    std::condition_variable readyCondition_;
+    bool isReady_ = false;  // locked by readyMutex_
+    // Declared after partnerDeviceMap_, the pending write is finished before the registry is destroyed.
+    PartnerDeviceConfigPersister configPersister_;
 
     DECLARE_IMPL();
 };
@@ -16,7 +16,9 @@
 #ifndef PARTNER_DEVICE_AGENT_SERVER_H
 #define PARTNER_DEVICE_AGENT_SERVER_H
 
+#include <set>
 #include "partner_device_agent_server.h"
+#include "partner_device_quota.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
@@ -25,11 +27,20 @@ namespace FusionConnectivity {
 extern "C" {
 #endif
 
-using CreatePartnerDeviceFunc = std::function<std::shared_ptr<PartnerDevice>(PartnerDevice::DeviceInfo &)>;
-
-void UpdatePartnerDeviceConfig(PartnerDeviceMap &deviceMap);
-void LoadPartnerDeviceConfig(PartnerDeviceMap &deviceMap, CreatePartnerDeviceFunc createPartnerDeviceFunc);
+// isPaired and isBluetoothOn are sampled once for all the loaded devices.
+using CreatePartnerDeviceFunc =
+    std::function<std::shared_ptr<PartnerDevice>(PartnerDevice::DeviceInfo &, bool isPaired, bool isBluetoothOn)>;
+
+// Rewrite the whole config snapshot and reset the journal.
+void UpdatePartnerDeviceConfig(PartnerDeviceRegistry &deviceMap);
+// Append the changed devices to the journal, the journal is compacted into the snapshot when it grows too large.
+void AppendPartnerDeviceJournal(PartnerDeviceRegistry &deviceMap, const std::set<PartnerDeviceMapKey> &dirtyKeys);
+// Load the bound devices, the devices over the quota of their app or user are dropped, the earliest bound are kept.
+void LoadPartnerDeviceConfig(PartnerDeviceRegistry &deviceMap, const PartnerDeviceQuota &quota,
+    CreatePartnerDeviceFunc createPartnerDeviceFunc);
 void ClearPartnerDeviceConfig();
+// Export the bound devices as a JSON array for debugging, the addresses are masked and the tokenIds are zeroed.
+void DumpPartnerDeviceConfig(PartnerDeviceRegistry &deviceMap, std::string &content);
 
 #ifdef __cplusplus
 }
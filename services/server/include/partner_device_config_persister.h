@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_CONFIG_PERSISTER_H
+#define PARTNER_DEVICE_CONFIG_PERSISTER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include "ffrt_inner.h"
+#include "partner_device_registry.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief Write-behind persister of the partner device config.
+ *
+ * The callers only mark the changed devices dirty, a burst of changes within the coalesce window is written once by
+ * the persister's own serial queue, so that the binder threads never block on the disk I/O and the writes to the
+ * config file never race with each other.
+ */
+class PartnerDeviceConfigPersister {
+public:
+    static constexpr uint32_t DEFAULT_COALESCE_WINDOW_MS = 500;
+
+    /**
+     * @param dirtyKeys The devices changed since the last write.
+     */
+    using PersistFunc = std::function<void(const std::set<PartnerDeviceMapKey> &dirtyKeys)>;
+
+    /**
+     * @brief Construct a new persister.
+     *
+     * @param persistFunc Writes the current config to the disk, always called in the persister's queue.
+     * @param coalesceWindowMs The changes marked within the window are written once.
+     */
+    explicit PartnerDeviceConfigPersister(
+        const PersistFunc &persistFunc, uint32_t coalesceWindowMs = DEFAULT_COALESCE_WINDOW_MS);
+    ~PartnerDeviceConfigPersister();
+
+    /**
+     * @brief Mark the device dirty, the write is scheduled at the end of the coalesce window. Never blocks on I/O.
+     */
+    void MarkDirty(const PartnerDeviceMapKey &key);
+
+    /**
+     * @brief Write the dirty config immediately and wait for the write to complete, used when the SA stops.
+     */
+    void Flush();
+
+    void SetCoalesceWindow(uint32_t coalesceWindowMs);
+
+    /**
+     * @brief Get the number of writes done by the persister.
+     */
+    uint64_t GetWriteCount() const;
+
+private:
+    void ScheduleWrite();
+    void WriteIfDirty();
+
+    PersistFunc persistFunc_;
+    std::atomic<uint32_t> coalesceWindowMs_;
+    std::mutex dirtyMutex_;
+    std::set<PartnerDeviceMapKey> dirtyKeys_ {};  // locked by dirtyMutex_
+    // Whether a delayed write has been submitted and not started yet.
+    std::atomic_bool isScheduled_ = false;
+    std::atomic_uint64_t writeCount_ = 0;
+    std::unique_ptr<ffrt::queue> queue_ { nullptr };
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_CONFIG_PERSISTER_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PARTNER_DEVICE_EVENT_DISPATCHER_H
+#define PARTNER_DEVICE_EVENT_DISPATCHER_H
+
+#include <memory>
+#include <mutex>
+#include "bluetooth_host.h"
+#include "fcm_common_event_subscriber.h"
+#include "ffrt_inner.h"
+#include "partner_device_registry.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The single common event subscriber and Bluetooth host observer of the service, parses each event once and
+ * routes it to the devices.
+ *
+ * The pair state changes are routed by the address through the address index of the registry, only to the devices
+ * bound with the address, so an event costs O(k) where k is the number of apps which bound the address, instead of
+ * O(n) of all the bound devices. The ACL state changes go to the presence engine of the address once, however many
+ * apps bound it, and the screen events to each presence engine once. The Bluetooth state changes are fanned out to
+ * all the bound devices from a single task, the paired devices are got once for the batch when Bluetooth turns on.
+ * The screen, thermal and battery events also update the scan policy once for the shared scan session.
+ *
+ * The events are handled in order on the queue of the dispatcher, never on the callback threads of the common event
+ * service and the Bluetooth framework.
+ */
+class PartnerDeviceEventDispatcher {
+public:
+    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC =
+        "usual.event.bluetooth.remotedevice.ACL_CONNECTED_REALMAC";
+    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC =
+        "usual.event.bluetooth.remotedevice.ACL_DISCONNECTED_REALMAC";
+    static constexpr const char* COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC =
+        "usual.event.bluetooth.remotedevice.PAIR_STATE_CHANGE_REALMAC";
+
+    explicit PartnerDeviceEventDispatcher(const PartnerDeviceRegistry &registry);
+    ~PartnerDeviceEventDispatcher() = default;
+
+    /**
+     * @brief Subscribe the Bluetooth, screen and power common events and register the Bluetooth host observer, does
+     * nothing if already subscribed.
+     */
+    void Subscribe();
+
+    /**
+     * @brief Unsubscribe the common events and deregister the Bluetooth host observer.
+     */
+    void UnSubscribe();
+
+    /**
+     * @brief Route a received common event to the bound devices, runs in the task submitted for the event.
+     */
+    void Dispatch(const OHOS::EventFwk::CommonEventData &data);
+
+private:
+    class BluetoothStateObserver : public Bluetooth::BluetoothHostObserver {
+    public:
+        explicit BluetoothStateObserver(PartnerDeviceEventDispatcher &owner) : owner_(owner) {}
+        ~BluetoothStateObserver() override = default;
+
+        void OnStateChanged(const int transport, const int status) override;
+        void OnDiscoveryStateChanged(int status) override {}
+        void OnDiscoveryResult(const Bluetooth::BluetoothRemoteDevice &device,
+            int rssi, const std::string deviceName, int deviceClass) override {}
+        void OnPairRequested(const Bluetooth::BluetoothRemoteDevice &device) override {}
+        void OnPairConfirmed(const Bluetooth::BluetoothRemoteDevice &device, int reqType, int number) override {}
+        void OnScanModeChanged(int mode) override {}
+        void OnDeviceNameChanged(const std::string &deviceName) override {}
+        void OnDeviceAddrChanged(const std::string &address) override {}
+
+    private:
+        PartnerDeviceEventDispatcher &owner_;
+    };
+
+    void SubscribeCommonEvent(const std::vector<std::string> &eventVec,
+        const std::vector<std::string> &permissionVec, std::shared_ptr<FcmCommonEventSubscriber> &eventSubscribe);
+    void DispatchAclStateChange(const AAFwk::Want &want, bool isConnect);
+    void DispatchPairStateChange(const AAFwk::Want &want);
+    void DispatchScreenStateChange(bool isScreenOn);
+    void DispatchThermalLevelChange(const AAFwk::Want &want);
+    void DispatchBluetoothStateChange(int transport, int status);
+
+    const PartnerDeviceRegistry &registry_;
+    std::mutex subscribeMutex_;
+    std::shared_ptr<FcmCommonEventSubscriber> bluetoothEventSubscribe_ { nullptr };
+    std::shared_ptr<FcmCommonEventSubscriber> screenEventSubscribe_ { nullptr };
+    std::shared_ptr<FcmCommonEventSubscriber> powerEventSubscribe_ { nullptr };
+    std::shared_ptr<BluetoothStateObserver> bluetoothStateObserver_ { nullptr };
+    std::unique_ptr<ffrt::queue> queue_ { nullptr };
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_EVENT_DISPATCHER_H
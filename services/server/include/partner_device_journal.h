@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_JOURNAL_H
+#define PARTNER_DEVICE_JOURNAL_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "fcm_json_stream.h"
+#include "partner_device_json.h"
+#include "partner_device_registry.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief Append-only journal of the partner device config.
+ *
+ * The journal lives next to the config snapshot, each line is a record:
+ *   {"op":"base","checksum":"<hex>"}          the header, the checksum of the snapshot the journal applies to
+ *   {"op":"put","device":{<device item>}}      a device is bound or its state is changed
+ *   {"op":"del","tokenId":<id>,"address":"XX:XX:XX:XX:XX:XX"}  a device is unbound
+ *
+ * A record only counts when its line is terminated, so a journal truncated by a crash is replayed up to the last
+ * complete record. The journal is reset together with the snapshot when compacted, a journal whose header doesn't
+ * match the snapshot belongs to an older snapshot and is ignored.
+ */
+class PartnerDeviceJournal {
+public:
+    /**
+     * @brief The final state of the devices changed by the journal, the device item or nullopt if it's unbound.
+     */
+    using Overlay = std::map<PartnerDeviceMapKey, std::optional<PartnerDeviceJsonItem>>;
+
+    /**
+     * @brief Append the header line of a new journal applied to the snapshot.
+     */
+    static void AppendHeader(FcmJsonWriter &writer, std::string_view snapshotContent);
+
+    /**
+     * @brief Append the record line of a bound or changed device.
+     */
+    static void AppendPutRecord(FcmJsonWriter &writer, const PartnerDeviceRecord &record);
+
+    /**
+     * @brief Append the record line of an unbound device.
+     */
+    static void AppendDelRecord(FcmJsonWriter &writer, uint32_t tokenId, std::string_view address);
+
+    /**
+     * @brief Replay the journal into the final state of the changed devices, applied over the snapshot records.
+     *
+     * @return Returns the number of replayed records.
+     */
+    static int Replay(std::string_view snapshotContent, std::string_view journalContent, Overlay &overlay);
+
+private:
+    static bool IsHeaderMatched(std::string_view line, std::string_view snapshotContent);
+    static bool ApplyRecord(std::string_view line, Overlay &overlay);
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_JOURNAL_H
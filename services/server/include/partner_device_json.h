@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_JSON_H
+#define PARTNER_DEVICE_JSON_H
+
+#include <string>
+#include "fcm_json_stream.h"
+#include "partner_device_snapshot.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief A device item read from JSON, owns the strings of the record.
+ */
+struct PartnerDeviceJsonItem {
+    std::string bundleName;
+    std::string abilityName;
+    std::string address;
+    // The fields other than the strings.
+    PartnerDeviceRecord fields;
+
+    /**
+     * @brief Get the record, the strings point into this item.
+     */
+    PartnerDeviceRecord GetRecord() const;
+};
+
+/**
+ * @brief The JSON form of a device item, used by the journal, the debug export and the legacy config file:
+ *   {"version":"1.0","bundleName":"..","abilityName":"..",
+ *    "addressInfo":{"address":"XX:XX:XX:XX:XX:XX","addressType":0,"rawAddressType":0},
+ *    "tokenId":0,"registerTimestamp":0,"lostTimestamp":0,"isUserEnabled":true,
+ *    "capability":{"isSupportBR":true,"isSupportBleAdvertiser":true},
+ *    "businessCapability":{"isSupportMediaControl":true,"isSupportTelephonyControl":true}}
+ * rawAddressType and lostTimestamp are optional, the unknown fields are skipped.
+ */
+class PartnerDeviceJson {
+public:
+    static void WriteDevice(FcmJsonWriter &writer, const PartnerDeviceRecord &record);
+
+    /**
+     * @brief Read a device item. The item is consumed even if it's invalid, as long as the text is well-formed.
+     *
+     * @return Returns false if any of the required fields is missing or of a wrong type, or the text is malformed.
+     */
+    static bool ReadDevice(FcmJsonReader &reader, PartnerDeviceJsonItem &item);
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_JSON_H
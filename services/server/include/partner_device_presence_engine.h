@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_PRESENCE_ENGINE_H
+#define PARTNER_DEVICE_PRESENCE_ENGINE_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "fcm_mac_address.h"
+#include "i_device_agent_capability.h"
+#include "partner_device_presence_filter.h"
+#include "partner_device_presence_state_machine.h"
+#include "partner_device_scan_scheduler.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The presence engine of a physical device, shared by all the apps binding the address.
+ *
+ * The registry key of a device is (tokenId, address), so several apps binding one accessory create several devices.
+ * The engine owns the agent capabilities of the address, the BLE scan filter, the ACL handling and the timers run once
+ * for the radio peer, and the start and destroy decisions are fanned out to every subscribed binding. The scan load
+ * and the event handling scale with the number of physical devices instead of the number of bindings.
+ *
+ * An engine is created by the first active binding of the address and closed when the last one unsubscribes. The
+ * capabilities are created with the presence thresholds of the first subscriber, the BLE capability exists while any
+ * subscriber supports the BLE advertiser.
+ *
+ * The enter and exit of the capabilities and the ACL events drive one presence state machine, the extensions are
+ * started when the device gets present and destroyed when it gets absent, once per episode whichever capabilities
+ * signal it. The capabilities are notified of the destroy to discover the device again.
+ *
+ * The presence history learned by the BLE scan belongs to the address rather than to a capability or an engine. It's
+ * handed over to the next BLE capability when the capability is recreated. The engine gives it back when the last
+ * subscriber unsubscribes, before the engine can be released, and takes it again with the next first subscriber of
+ * the address, e.g. after Bluetooth is turned on, until the last binding of the address is removed.
+ */
+class PartnerDevicePresenceEngine : public std::enable_shared_from_this<PartnerDevicePresenceEngine> {
+public:
+    struct Subscriber {
+        IDeviceAgentCapability::DependencyFuncs funcs;
+        bool isSupportBleAdvertiser = false;
+        PartnerDevicePresenceFilter::Config presenceConfig;
+    };
+
+    using EngineSptr = std::shared_ptr<PartnerDevicePresenceEngine>;
+
+    /**
+     * @brief Get the engine of the address, create it if none of the bindings of the address is active.
+     */
+    static EngineSptr Acquire(const FcmMacAddress &address);
+
+    /**
+     * @brief Get the engine of the address, or nullptr if none of the bindings of the address is active.
+     */
+    static EngineSptr Find(const FcmMacAddress &address);
+
+    /**
+     * @brief Call the function with each engine, outside the lock of the engines.
+     */
+    static void Iterate(const std::function<void(const EngineSptr &)> &func);
+
+    /**
+     * @brief Forget the presence history of the address, called when the last binding of the address is removed.
+     */
+    static void ClearScanHistory(const FcmMacAddress &address);
+
+    explicit PartnerDevicePresenceEngine(const FcmMacAddress &address) : address_(address) {}
+    ~PartnerDevicePresenceEngine();
+
+    /**
+     * @brief Subscribe a binding, creates the capabilities for the first one. A binding subscribing while the device
+     * is present gets its extension started at once.
+     *
+     * @return Returns the id to unsubscribe.
+     */
+    uint64_t Subscribe(const Subscriber &subscriber);
+
+    /**
+     * @brief Unsubscribe a binding, closes the capabilities after the last one.
+     *
+     * @return Returns true if the extension of the binding has been started, i.e. the device is present, then the
+     * caller destroys it.
+     */
+    bool Unsubscribe(uint64_t subscriberId);
+
+    size_t GetSubscriberCount();
+
+    void OnBluetoothDeviceAclStateChange(bool isConnect);
+    void OnScreenStateChange(bool isScreenOn);
+
+private:
+    using CapabilityMap = std::map<std::string, std::shared_ptr<IDeviceAgentCapability>>;
+
+    void UpdateCapabilitiesLocked();
+    void SaveScanHistoryLocked(const std::shared_ptr<IDeviceAgentCapability> &capability);
+    CapabilityMap GetCapabilities();
+    using StateMachine = PartnerDevicePresenceStateMachine;
+    using Event = PartnerDevicePresenceStateMachine::Event;
+
+    void OnPresenceEvent(Event event, int destroyReason);
+
+    const FcmMacAddress address_;
+    std::mutex mutex_;
+    std::map<uint64_t, Subscriber> subscribers_;  // locked by mutex_
+    uint64_t nextSubscriberId_ = 1;  // locked by mutex_
+    CapabilityMap capabilityMap_;  // locked by mutex_
+    // A new subscriber starts its extension at once if the device is present, locked by mutex_.
+    StateMachine stateMachine_;
+    // The presence history while subscribed and the BLE capability is closed, the capability owns it while it exists,
+    // locked by mutex_.
+    PartnerDeviceScanScheduler scanScheduler_;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_PRESENCE_ENGINE_H
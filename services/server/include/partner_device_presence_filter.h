@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_PRESENCE_FILTER_H
+#define PARTNER_DEVICE_PRESENCE_FILTER_H
+
+#include <cstdint>
+#include <deque>
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief Decides when a device enters and exits the presence from its sightings, so that a device at the edge of
+ * the range doesn't start and destroy the extension repeatedly.
+ *
+ * Entering: the device enters when sightingNum of its last windowNum sightings within windowMs are not weaker than
+ * enterRssi, or when a tracking source starts. Exiting: once present, a sighting not weaker than the lower exitRssi
+ * keeps the device present, and a tracking source (the ACL connection, or the controller tracking the device between
+ * found and lost) holds it present. The device exits exitDelayMs after the last sighting or tracking keeping it
+ * present.
+ *
+ * The filter owns no timer or clock, the caller passes the time and checks the exit at GetExitTimeMs, the exit timer
+ * may fire up to exitSlackMs later. Not thread safe.
+ */
+class PartnerDevicePresenceFilter {
+public:
+    struct Config {
+        int enterRssi = -80;  // dBm
+        int exitRssi = -90;  // dBm, not greater than enterRssi
+        uint32_t sightingNum = 2;
+        uint32_t windowNum = 4;  // not less than sightingNum
+        // 20s, not less than twice the largest batch report delay, the scan engine dispatches one sighting of a
+        // device per batch, so the sightings of batched scans are a report delay apart.
+        int64_t windowMs = 20 * 1000;
+        int64_t exitDelayMs = 3 * 60 * 1000;  // 3min
+        int64_t exitSlackMs = 5 * 1000;  // 5s, the exit may be delayed by up to it to batch the devices lost together
+
+        bool IsValid() const
+        {
+            return exitRssi <= enterRssi && sightingNum > 0 && windowNum >= sightingNum && windowMs > 0 &&
+                exitDelayMs >= 0 && exitSlackMs >= 0;
+        }
+    };
+
+    enum Transition {
+        TRANSITION_NONE = 0,
+        TRANSITION_ENTER,
+        TRANSITION_EXIT,
+    };
+
+    PartnerDevicePresenceFilter() = default;
+    explicit PartnerDevicePresenceFilter(const Config &config) : config_(config) {}
+    ~PartnerDevicePresenceFilter() = default;
+
+    Transition OnSighting(int rssi, int64_t nowMs);
+
+    /**
+     * @brief A tracking source starts or stops proving the presence, the RSSI isn't checked.
+     */
+    Transition OnTrackStart(int64_t nowMs);
+    void OnTrackStop(int64_t nowMs);
+
+    /**
+     * @brief The controller found the device and tracks it until lost. The controller matches the device before
+     * reporting it, so a found not weaker than enterRssi, or exitRssi once present, starts the tracking at once. A
+     * weaker found is only a weak sighting and the controller isn't a tracking source, the lost after it is ignored.
+     */
+    Transition OnFound(int rssi, int64_t nowMs);
+
+    /**
+     * @brief Check whether the device exits at the time.
+     */
+    Transition OnTimeout(int64_t nowMs);
+
+    /**
+     * @brief The time the device exits unless kept present, or -1 if it's absent or tracked.
+     */
+    int64_t GetExitTimeMs() const;
+
+    bool IsPresent() const
+    {
+        return isPresent_;
+    }
+
+    const Config &GetConfig() const
+    {
+        return config_;
+    }
+
+    /**
+     * @brief Forget the sightings and make the device absent without a transition.
+     */
+    void Reset();
+
+private:
+    Transition Enter(int64_t nowMs);
+
+    struct Sighting {
+        int64_t timeMs = 0;
+        bool isStrong = false;
+    };
+
+    Config config_;
+    // The last windowNum sightings while absent.
+    std::deque<Sighting> sightings_;
+    bool isPresent_ = false;
+    bool isTracked_ = false;
+    // The last time a sighting or tracking kept the device present.
+    int64_t keepTimeMs_ = 0;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_PRESENCE_FILTER_H
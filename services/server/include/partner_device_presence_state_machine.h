@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_PRESENCE_STATE_MACHINE_H
+#define PARTNER_DEVICE_PRESENCE_STATE_MACHINE_H
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The presence of a device merged from the signals of all the agent capabilities, one episode from the first
+ * signal to the last one emits exactly one start and one destroy of the extension.
+ *
+ *   ABSENT     --BLE seen-->        SEEN       start
+ *   ABSENT     --ACL connected-->   CONNECTED  start
+ *   SEEN       --ACL connected-->   CONNECTED
+ *   SEEN       --BLE lost-->        ABSENT     destroy
+ *   CONNECTED  --ACL disconnected-> LINGER
+ *   LINGER     --ACL connected-->   CONNECTED
+ *   LINGER     --link lost-->       SEEN if seen by BLE while lingering, or ABSENT with destroy
+ *
+ * The BLE signals are the enter and exit of the BLE capability, the link lost is the exit of the BR capability after
+ * its exit delay. Any other event keeps the state and emits nothing, so a signal repeated by several capabilities or
+ * several times is harmless. Not thread safe.
+ */
+class PartnerDevicePresenceStateMachine {
+public:
+    enum State {
+        STATE_ABSENT = 0,
+        STATE_SEEN,
+        STATE_CONNECTED,
+        STATE_LINGER,
+    };
+
+    enum Event {
+        EVENT_BLE_SEEN = 0,
+        EVENT_BLE_LOST,
+        EVENT_ACL_CONNECTED,
+        EVENT_ACL_DISCONNECTED,
+        EVENT_LINK_LOST,
+    };
+
+    enum Action {
+        ACTION_NONE = 0,
+        ACTION_START,
+        ACTION_DESTROY,
+    };
+
+    PartnerDevicePresenceStateMachine() = default;
+    ~PartnerDevicePresenceStateMachine() = default;
+
+    Action OnEvent(Event event);
+
+    State GetState() const
+    {
+        return state_;
+    }
+
+    bool IsPresent() const
+    {
+        return state_ != STATE_ABSENT;
+    }
+
+    static const char *ToString(State state);
+    static const char *ToString(Event event);
+
+private:
+    State state_ = STATE_ABSENT;
+    // The BLE capability sees the device while it's connected or lingering.
+    bool isBleSeen_ = false;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_PRESENCE_STATE_MACHINE_H
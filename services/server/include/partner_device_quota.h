@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_QUOTA_H
+#define PARTNER_DEVICE_QUOTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "partner_device_registry.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The quota of the bound partner devices, per app and per user.
+ *
+ * An app or a user reaching its quota can't bind more devices, the devices of the other apps and users are not
+ * affected.
+ */
+class PartnerDeviceQuota {
+public:
+    static constexpr size_t DEFAULT_MAX_DEVICES_PER_APP = 1000;
+    static constexpr size_t DEFAULT_MAX_DEVICES_PER_USER = 10000;
+
+    PartnerDeviceQuota() = default;
+    PartnerDeviceQuota(size_t maxDevicesPerApp, size_t maxDevicesPerUser);
+
+    size_t GetMaxDevicesPerApp() const;
+    size_t GetMaxDevicesPerUser() const;
+
+    /**
+     * @brief Insert the device into the registry if the app and the user of the entry are within their quotas.
+     * The check and the insertion are one atomic step, so the concurrent binds can't exceed the quota.
+     *
+     * @return Returns false if the app or the user has reached its quota, the device is not inserted.
+     */
+    bool TryBind(PartnerDeviceRegistry &registry, const PartnerDeviceRegistry::Entry &entry) const;
+
+    /**
+     * @brief Counts the devices accepted in a batch before they are inserted into the registry, used when loading
+     * the config.
+     */
+    class Counter {
+    public:
+        explicit Counter(const PartnerDeviceQuota &quota);
+
+        /**
+         * @brief Accept one more device of the app of the user.
+         *
+         * @return Returns false if the app or the user has reached its quota, the device is not counted.
+         */
+        bool TryAccept(uint32_t tokenId, int32_t userId);
+
+    private:
+        const PartnerDeviceQuota &quota_;
+        std::unordered_map<uint32_t, size_t> appDeviceCounts_ {};
+        std::unordered_map<int32_t, size_t> userDeviceCounts_ {};
+    };
+
+private:
+    size_t maxDevicesPerApp_ = DEFAULT_MAX_DEVICES_PER_APP;
+    size_t maxDevicesPerUser_ = DEFAULT_MAX_DEVICES_PER_USER;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_QUOTA_H
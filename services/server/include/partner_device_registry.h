@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_REGISTRY_H
+#define PARTNER_DEVICE_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "fcm_mac_address.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+class PartnerDevice;
+
+using PartnerDeviceMapKey = std::pair<uint32_t, FcmMacAddress>;
+
+/**
+ * @brief A thread-safe registry of the bound partner devices.
+ *
+ * The devices are indexed by address, address -> (tokenId -> device), and by app, tokenId -> (address -> device),
+ * so that the per-address and per-app queries don't need to scan the whole registry. The number of devices of
+ * each user is counted for the quota check.
+ *
+ * The registry is read-mostly: readers atomically load an immutable snapshot without taking any lock,
+ * writers copy the current snapshot, modify the copy and publish it. Writers are serialized by writeMutex_.
+ * The address index is split into shards by the address hash and the app index is split by app, each part is
+ * shared between the snapshots until it's modified, so a write only copies one shard and the devices of one app
+ * instead of the whole registry.
+ */
+class PartnerDeviceRegistry {
+public:
+    using DeviceSptr = std::shared_ptr<PartnerDevice>;
+
+    static constexpr size_t SHARD_NUM = 64;
+
+    // address <-> (tokenId <-> device)
+    using AddressShard = std::unordered_map<FcmMacAddress, std::map<uint32_t, DeviceSptr>>;
+    // address <-> device, the devices bound by an app
+    using TokenDevices = std::map<FcmMacAddress, DeviceSptr>;
+
+    struct Snapshot {
+        std::array<std::shared_ptr<const AddressShard>, SHARD_NUM> addressShards;
+        // tokenId <-> devices
+        std::unordered_map<uint32_t, std::shared_ptr<const TokenDevices>> tokenIndex;
+        // tokenId <-> userId, an app token always belongs to one user
+        std::unordered_map<uint32_t, int32_t> tokenUserIds;
+        // userId <-> number of devices
+        std::unordered_map<int32_t, size_t> userDeviceCounts;
+        size_t size = 0;
+    };
+
+    struct Entry {
+        PartnerDeviceMapKey key;
+        int32_t userId = 0;
+        DeviceSptr device;
+    };
+
+    PartnerDeviceRegistry();
+    ~PartnerDeviceRegistry() = default;
+
+    /**
+     * @brief Get the current immutable snapshot, lock free.
+     */
+    std::shared_ptr<const Snapshot> GetSnapshot() const;
+
+    /**
+     * @brief Get the number of bound devices.
+     */
+    int Size() const;
+
+    /**
+     * @brief Checks if the registry has no bound devices.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Inserts a bound device of the user. If the key already exists, the old device is replaced.
+     */
+    void EnsureInsert(const PartnerDeviceMapKey &key, int32_t userId, const DeviceSptr &device);
+
+    /**
+     * @brief Inserts a batch of bound devices with a single snapshot publication, used when loading the config.
+     */
+    void EnsureInsertBatch(const std::vector<Entry> &entries);
+
+    /**
+     * @brief Inserts a bound device only if the check on the current snapshot passes, the check and the insertion
+     * are atomic against the other writers.
+     *
+     * @return Returns false if the check fails, the registry is not modified.
+     */
+    bool InsertIf(const Entry &entry, const std::function<bool(const Snapshot &)> &check);
+
+    /**
+     * @brief Erases the bound device by a key.
+     */
+    void Erase(const PartnerDeviceMapKey &key);
+
+    /**
+     * @brief Erases all bound devices.
+     */
+    void Clear();
+
+    /**
+     * @brief Get the bound device by a key.
+     *
+     * @return Returns true if the key is found, otherwise false.
+     */
+    bool Find(const PartnerDeviceMapKey &key, DeviceSptr &device) const;
+
+    /**
+     * @brief Iterate through all bound devices of the current snapshot.
+     */
+    void Iterate(const std::function<void(const PartnerDeviceMapKey &, const DeviceSptr &)> &callback) const;
+
+    /**
+     * @brief Check whether the address is bound by any app. O(1).
+     */
+    bool IsAddressBound(const FcmMacAddress &address) const;
+
+    /**
+     * @brief Iterate through the devices bound with the address, O(k) where k is the number of apps
+     * which bound the address.
+     */
+    void IterateByAddress(
+        const FcmMacAddress &address, const std::function<void(uint32_t, const DeviceSptr &)> &callback) const;
+
+    /**
+     * @brief Iterate through the devices bound by the app, O(k) where k is the number of devices bound by the app.
+     */
+    void IterateByTokenId(
+        uint32_t tokenId, const std::function<void(const FcmMacAddress &, const DeviceSptr &)> &callback) const;
+
+    /**
+     * @brief Get the number of devices bound by the app, O(1).
+     */
+    size_t CountByTokenId(uint32_t tokenId) const;
+
+    /**
+     * @brief Get the number of devices bound by all the apps of the user, O(1).
+     */
+    size_t CountByUserId(int32_t userId) const;
+
+private:
+    // The shards and the app devices modified by a write, copied from the current snapshot at the first write.
+    struct WriteContext {
+        std::array<std::shared_ptr<AddressShard>, SHARD_NUM> addressShards;
+        std::unordered_map<uint32_t, std::shared_ptr<TokenDevices>> tokenDevices;
+    };
+
+    static size_t GetShardIndex(const FcmMacAddress &address);
+    static AddressShard &GetWritableShard(Snapshot &snapshot, WriteContext &context, const FcmMacAddress &address);
+    static TokenDevices &GetWritableTokenDevices(Snapshot &snapshot, WriteContext &context, uint32_t tokenId);
+    static void InsertIndex(Snapshot &snapshot, WriteContext &context, const Entry &entry);
+    static void EraseIndex(Snapshot &snapshot, WriteContext &context, const PartnerDeviceMapKey &key);
+    void Publish(std::shared_ptr<const Snapshot> snapshot);
+
+    std::mutex writeMutex_;
+    // Only replaced as a whole by std::atomic_store, never modified in place.
+    std::shared_ptr<const Snapshot> snapshot_;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_REGISTRY_H
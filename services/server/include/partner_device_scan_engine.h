@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PARTNER_DEVICE_SCAN_ENGINE_H
+#define PARTNER_DEVICE_SCAN_ENGINE_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "ffrt_inner.h"
+#include "fcm_mac_address.h"
+#include "i_ble_scanner.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The BLE scan engine shared by all the bound devices.
+ *
+ * Each device adds a filter of its address when it starts scanning and removes it when it stops, all the filters are
+ * merged into one scan session instead of a scanner per device. The filter changes within the apply delay, such as
+ * the devices activated together when Bluetooth turns on, restart the session once; the session is stopped when no
+ * filter is left. The scan results are routed by the address to the callbacks of the matching filters.
+ *
+ * The session reports in one of two modes, picked by the engine's policy when the filters are applied:
+ *   found/lost  the controller tracks the filtered devices and only reports when one appears or disappears, the
+ *               application processor is not woken by every advertisement. Used while the number of addresses
+ *               fits in the controller's tracking budget.
+ *   continuous  every matched advertisement is reported. The fallback when the budget is exceeded, the offload
+ *               is disabled, or the controller rejects the found/lost settings.
+ *
+ * Restarting the session reconfigures the controller, the restarts are rate limited to one per min restart interval,
+ * a change arriving earlier is applied when the interval expires, together with the later changes.
+ *
+ * The scan session is only touched on the engine's own serial queue, the results are also dispatched on the queue,
+ * never on the callback thread of the Bluetooth framework.
+ */
+class PartnerDeviceScanEngine {
+public:
+    enum ReportMode : int {
+        REPORT_MODE_CONTINUOUS = 0,
+        REPORT_MODE_FOUND_LOST,
+    };
+
+    enum ScanEvent : int {
+        // An advertisement is matched in the continuous mode.
+        SCAN_EVENT_RESULT = 0,
+        // The device appears or disappears in the found/lost mode.
+        SCAN_EVENT_FOUND,
+        SCAN_EVENT_LOST,
+    };
+
+    using ScanResultCallback = std::function<void(const Bluetooth::BleScanResult &result, ScanEvent event)>;
+
+    /**
+     * @brief The parameters of the scan session shared by all the devices, owned by the scan policy.
+     */
+    struct ScanParams {
+        // One of Bluetooth::SCAN_MODE_*.
+        int scanMode = Bluetooth::SCAN_MODE_OP_P10_60_600;
+        // The report delay of the continuous mode, the controller reports the results in a batch every delay instead
+        // of one by one. 0 disables the batching, the found/lost mode never batches.
+        uint32_t reportDelayMs = 0;
+
+        bool operator==(const ScanParams &other) const
+        {
+            return scanMode == other.scanMode && reportDelayMs == other.reportDelayMs;
+        }
+        bool operator!=(const ScanParams &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    struct Metrics {
+        uint64_t startNum = 0;
+        // The restarts of a running session, each one reconfigures the controller.
+        uint64_t restartNum = 0;
+        uint64_t stopNum = 0;
+        // The applies deferred by the min restart interval.
+        uint64_t rateLimitedNum = 0;
+        size_t restartNumInLastHour = 0;
+    };
+
+    static constexpr uint64_t INVALID_FILTER_ID = 0;
+    static constexpr uint32_t DEFAULT_APPLY_DELAY_MS = 50;
+    static constexpr uint32_t DEFAULT_MIN_RESTART_INTERVAL_MS = 1000;
+    // The number of devices the controller is expected to track in the found/lost mode.
+    static constexpr size_t DEFAULT_MAX_FOUND_LOST_FILTER_NUM = 16;
+
+    static PartnerDeviceScanEngine &GetInstance();
+
+    /**
+     * @brief Construct a new scan engine.
+     *
+     * @param scannerFactory Creates the scan session when the first filter is added.
+     * @param applyDelayMs The filter changes within the delay are applied to the scan session once.
+     * @param minRestartIntervalMs The min interval between two starts of a running session.
+     */
+    explicit PartnerDeviceScanEngine(const IBleScanner::Factory &scannerFactory,
+        uint32_t applyDelayMs = DEFAULT_APPLY_DELAY_MS,
+        uint32_t minRestartIntervalMs = DEFAULT_MIN_RESTART_INTERVAL_MS);
+    ~PartnerDeviceScanEngine();
+
+    /**
+     * @brief Add a filter of the address, the results of the address are reported to the callback until the filter
+     * is removed.
+     *
+     * @return Returns the id of the filter.
+     */
+    uint64_t AddFilter(const FcmMacAddress &address, const ScanResultCallback &callback);
+
+    /**
+     * @brief Remove the filter, does nothing if it's already removed.
+     */
+    void RemoveFilter(uint64_t filterId);
+
+    /**
+     * @brief Set the parameters of the session. The results of a batch are deduplicated by the address, each device
+     * receives at most one SCAN_EVENT_RESULT per batch.
+     */
+    void SetScanParams(const ScanParams &params);
+
+    /**
+     * @brief Set the max number of addresses scanned in the found/lost mode, the continuous mode is used above it.
+     * 0 disables the found/lost mode.
+     */
+    void SetMaxFoundLostFilterNum(size_t filterNum);
+
+    /**
+     * @brief Apply the pending changes to the scan session immediately unless the restart is rate limited, and wait
+     * for the queued results to be dispatched.
+     */
+    void Flush();
+
+    /**
+     * @brief Get the number of filters, including the filters of the same address.
+     */
+    size_t GetFilterCount();
+
+    /**
+     * @brief Get the counters of the scan session operations, waits for the queued tasks.
+     */
+    Metrics GetMetrics();
+
+private:
+    class ScanCallback : public Bluetooth::BleCentralManagerCallback {
+    public:
+        explicit ScanCallback(PartnerDeviceScanEngine &owner) : owner_(owner) {}
+        ~ScanCallback() override = default;
+        void OnScanCallback(const Bluetooth::BleScanResult &result) override;
+        void OnFoundOrLostCallback(const Bluetooth::BleScanResult &result, uint8_t callbackType) override;
+        void OnBleBatchScanResultsEvent(const std::vector<Bluetooth::BleScanResult> &results) override;
+        void OnStartOrStopScanEvent(int resultCode, bool isStartScan) override {}
+
+    private:
+        PartnerDeviceScanEngine &owner_;
+    };
+
+    struct Filter {
+        FcmMacAddress address;
+        ScanResultCallback callback;
+    };
+
+    void ScheduleApply();
+    void ScheduleApply(uint32_t delayMs);
+    ReportMode SelectReportMode(size_t addressNum, size_t maxFoundLostFilterNum) const;
+    void Apply();
+    int StartScan(const std::set<FcmMacAddress> &addresses, const ScanParams &params, ReportMode reportMode);
+    void DispatchScanResult(const Bluetooth::BleScanResult &result, ScanEvent event);
+    void DispatchBatchScanResults(const std::vector<Bluetooth::BleScanResult> &results);
+
+    void RecordStart(bool isRestart);
+
+    IBleScanner::Factory scannerFactory_;
+    const uint32_t applyDelayMs_;
+    const uint32_t minRestartIntervalMs_;
+
+    std::mutex filterMutex_;
+    uint64_t nextFilterId_ = INVALID_FILTER_ID + 1;  // locked by filterMutex_
+    std::unordered_map<uint64_t, Filter> filters_;  // locked by filterMutex_
+    // address <-> ids of the filters, routes the scan results
+    std::unordered_map<FcmMacAddress, std::vector<uint64_t>> addressFilterIds_;  // locked by filterMutex_
+    ScanParams scanParams_;  // locked by filterMutex_
+    size_t maxFoundLostFilterNum_ = DEFAULT_MAX_FOUND_LOST_FILTER_NUM;  // locked by filterMutex_
+    // Whether a delayed apply has been submitted and not started yet.
+    std::atomic_bool isApplyScheduled_ = false;
+
+    // The scan session, only accessed in queue_.
+    std::shared_ptr<ScanCallback> scanCallback_ { nullptr };
+    std::unique_ptr<IBleScanner> scanner_ { nullptr };
+    std::set<FcmMacAddress> scanningAddresses_;
+    ScanParams scanningParams_;
+    ReportMode scanningReportMode_ = REPORT_MODE_CONTINUOUS;
+    int64_t lastStartMs_ = 0;
+    Metrics metrics_;
+    // The restart times in the last hour.
+    std::deque<int64_t> restartTimesMs_;
+    // Set when the controller rejects the found/lost settings, the continuous mode is used afterwards.
+    bool isFoundLostRejected_ = false;
+
+    std::unique_ptr<ffrt::queue> queue_ { nullptr };
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_SCAN_ENGINE_H
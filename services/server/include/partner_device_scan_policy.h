@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_SCAN_POLICY_H
+#define PARTNER_DEVICE_SCAN_POLICY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "ffrt_inner.h"
+#include "partner_device_scan_engine.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief Owns the parameters of the shared BLE scan session, derived from the screen, thermal and battery state of
+ * the system instead of the events received by each device.
+ *
+ *   screen on                   SCAN_MODE_OP_P10_60_600, results reported one by one
+ *   screen off                  SCAN_MODE_OP_P2_60_3000, results reported in a batch every 5s
+ *   hot or battery low          SCAN_MODE_OP_P2_60_3000, the batch delay is extended to 10s when the screen is off
+ *
+ * A state change is applied after the debounce window, the changes within the window, such as a flickering screen,
+ * are applied once and a change reverted within the window is not applied at all.
+ */
+class PartnerDeviceScanPolicy {
+public:
+    struct State {
+        bool isScreenOn = true;
+        int thermalLevel = 0;
+        bool isBatteryLow = false;
+    };
+
+    static constexpr uint32_t DEFAULT_DEBOUNCE_WINDOW_MS = 500;
+    // ThermalLevel::HOT of the thermal manager, the scan is throttled at and above it.
+    static constexpr int THERMAL_LEVEL_HOT = 3;
+    static constexpr uint32_t SCREEN_OFF_REPORT_DELAY_MS = 5 * 1000;  // 5s
+    static constexpr uint32_t THROTTLED_REPORT_DELAY_MS = 10 * 1000;  // 10s
+
+    static PartnerDeviceScanPolicy &GetInstance();
+
+    explicit PartnerDeviceScanPolicy(
+        PartnerDeviceScanEngine &engine, uint32_t debounceWindowMs = DEFAULT_DEBOUNCE_WINDOW_MS);
+    ~PartnerDeviceScanPolicy();
+
+    void SetScreenOn(bool isScreenOn);
+    void SetThermalLevel(int thermalLevel);
+    void SetBatteryLow(bool isBatteryLow);
+
+    /**
+     * @brief Set the debounce window of the state changes, takes effect from the next change.
+     */
+    void SetDebounceWindow(uint32_t debounceWindowMs);
+
+    /**
+     * @brief Apply the current state immediately and wait for it.
+     */
+    void Flush();
+
+    /**
+     * @brief Select the scan parameters of the state.
+     */
+    static PartnerDeviceScanEngine::ScanParams SelectScanParams(const State &state);
+
+private:
+    template <typename T>
+    void UpdateState(T State::*field, T value);
+    void ScheduleEvaluate();
+    void Evaluate();
+
+    PartnerDeviceScanEngine &engine_;
+    std::atomic_uint32_t debounceWindowMs_;
+
+    std::mutex stateMutex_;
+    State state_;  // locked by stateMutex_
+    // Whether a debounced evaluation has been submitted and not started yet.
+    std::atomic_bool isEvaluateScheduled_ = false;
+    // The parameters set to the engine, only accessed in queue_.
+    PartnerDeviceScanEngine::ScanParams appliedParams_;
+
+    std::unique_ptr<ffrt::queue> queue_ { nullptr };
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_SCAN_POLICY_H
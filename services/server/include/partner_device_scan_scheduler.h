@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_SCAN_SCHEDULER_H
+#define PARTNER_DEVICE_SCAN_SCHEDULER_H
+
+#include <array>
+#include <cstdint>
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The adaptive duty cycle of the BLE scan of a device, learned from the times the device was present.
+ *
+ * A day is divided into slots, a presence (found or ACL connected) raises the score of its slot once per day and the
+ * scores decay every day, so the pattern follows the recent days. In a likely slot the device is scanned
+ * continuously. Out of the likely slots the device is scanned for a window, a window without a presence is a miss
+ * and pauses the scan for a back-off, doubled per consecutive miss from the min back-off up to the max. A back-off
+ * ends early at the beginning of a likely slot, and a presence resets it.
+ *
+ * The scheduler owns no timer or clock, the caller passes the wall clock time in milliseconds since
+ * epoch, so it's deterministic. Not thread safe.
+ */
+class PartnerDeviceScanScheduler {
+public:
+    struct Config {
+        int64_t scanWindowMs = 2 * 60 * 1000;  // 2min
+        int64_t minBackoffMs = 1 * 60 * 1000;  // 1min
+        int64_t maxBackoffMs = 32 * 60 * 1000;  // 32min
+    };
+
+    static constexpr int64_t DAY_MS = 24 * 60 * 60 * 1000;
+    static constexpr int SLOT_NUM = 48;  // 30min per slot
+    // The score of a slot decays to 3/4 per day, the slot is likely when the device was present in it on the last 2
+    // days (1.3125), not after a single day (0.75) or when the 2 days are 3 days ago (0.98).
+    static constexpr float DAILY_DECAY = 0.75f;
+    static constexpr float LIKELY_SCORE = 1.25f;
+
+    PartnerDeviceScanScheduler() = default;
+    explicit PartnerDeviceScanScheduler(const Config &config) : config_(config) {}
+    ~PartnerDeviceScanScheduler() = default;
+
+    /**
+     * @brief Record a presence of the device, resets the back-off.
+     */
+    void OnPresence(int64_t nowMs);
+
+    /**
+     * @brief The scan window expired without a presence.
+     *
+     * @return Returns the time to pause the scan, 0 to scan another window immediately.
+     */
+    int64_t OnMiss(int64_t nowMs);
+
+    /**
+     * @brief Whether the device is likely present at the time, learned from the recent days.
+     */
+    bool IsLikely(int64_t nowMs) const;
+
+    int64_t GetScanWindowMs() const
+    {
+        return config_.scanWindowMs;
+    }
+
+    uint32_t GetMissNum() const
+    {
+        return missNum_;
+    }
+
+private:
+    static int GetSlot(int64_t nowMs);
+    float GetScore(int slot, int64_t day) const;
+    void Decay(int64_t day);
+
+    Config config_;
+    std::array<float, SLOT_NUM> scores_ {};
+    // The day when the scores were decayed last time.
+    int64_t scoreDay_ = 0;
+    // The last day when the score of the slot was raised, a slot is raised once per day.
+    std::array<int64_t, SLOT_NUM> presenceDays_ {};
+    uint32_t missNum_ = 0;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_SCAN_SCHEDULER_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_SNAPSHOT_H
+#define PARTNER_DEVICE_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OHOS {
+namespace FusionConnectivity {
+/**
+ * @brief The persisted fields of a bound partner device.
+ *
+ * The strings are views, into the caller's strings when encoding, or into the snapshot content when decoding.
+ */
+struct PartnerDeviceRecord {
+    std::string_view bundleName;
+    std::string_view abilityName;
+    std::string_view address;
+    uint32_t tokenId = 0;
+    int32_t addressType = 0;
+    bool hasRawAddressType = false;
+    int32_t rawAddressType = 0;
+    int64_t registerTimestamp = 0;
+    int64_t lostTimestamp = 0;  // 0 if the device is not lost
+    bool isUserEnabled = false;
+    bool isSupportBR = false;
+    bool isSupportBleAdvertiser = false;
+    bool isSupportMediaControl = false;
+    bool isSupportTelephonyControl = false;
+};
+
+/**
+ * @brief Binary snapshot of the partner device config.
+ *
+ * Layout, in the native byte order since the snapshot never leaves the device:
+ *   header        magic, version, record size, record count, string table size, checksum
+ *   records       record count * fixed-size records, the strings are (offset, length) into the string table
+ *   string table  the strings without terminators, the same bundle and ability names are stored once
+ *
+ * The checksum (FNV-1a) covers the records and the string table. Decoding validates the header, the checksum and
+ * every string range before returning any record, and then only points into the content, no field is allocated.
+ */
+class PartnerDeviceSnapshot {
+public:
+    static constexpr uint32_t MAGIC = 0x52444450;  // "PDDR"
+    static constexpr uint16_t VERSION = 1;
+
+    /**
+     * @brief Encode the records into the snapshot content.
+     */
+    static std::string Encode(const std::vector<PartnerDeviceRecord> &records);
+
+    /**
+     * @brief Decode the snapshot content, the strings of the records point into the content.
+     *
+     * @return Returns false if the content is not a valid snapshot of the current version, the records are untouched.
+     */
+    static bool Decode(std::string_view content, std::vector<PartnerDeviceRecord> &records);
+
+    /**
+     * @brief FNV-1a checksum of the content, independent of the platform and the standard library.
+     */
+    static uint64_t Checksum(std::string_view content);
+};
+
+/**
+ * @brief Read-only memory mapping of a snapshot file, unmapped on destruction.
+ */
+class PartnerDeviceSnapshotFile {
+public:
+    explicit PartnerDeviceSnapshotFile(const std::string &path);
+    ~PartnerDeviceSnapshotFile();
+    PartnerDeviceSnapshotFile(const PartnerDeviceSnapshotFile &) = delete;
+    PartnerDeviceSnapshotFile &operator=(const PartnerDeviceSnapshotFile &) = delete;
+
+    /**
+     * @brief Whether the file exists, is not empty and has been mapped.
+     */
+    bool IsMapped() const;
+
+    /**
+     * @brief Get the content of the file, valid until the object is destroyed.
+     */
+    std::string_view GetContent() const;
+
+private:
+    void *addr_ = nullptr;
+    size_t size_ = 0;
+};
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_SNAPSHOT_H
@@ -18,36 +18,160 @@
 #endif
 
 #include "device_agent_capability_ble_adv.h"
+#include <algorithm>
+#include <cinttypes>
+#include "datetime_ex.h"
+#include "fcm_mac_address.h"
 #include "log_util.h"
 #include "partner_device.h"
+#include "partner_device_scan_policy.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
 using namespace OHOS::Bluetooth;
+namespace {
+constexpr int64_t SEC_2_MILLISEC = 1000;
+// 批量上报时每批只分发设备的一条结果，时间窗口需要容纳两批上报
+static_assert(PartnerDevicePresenceFilter::Config().windowMs >=
+    2 * static_cast<int64_t>(PartnerDeviceScanPolicy::THROTTLED_REPORT_DELAY_MS),
+    "the presence window must cover two batch reports");
 
-void DeviceAgentCapabilityBleAdv::BluetoothScanCallback::OnScanCallback(const BleScanResult &result)
+// 设备出现规律按一天中的时段学习，使用系统时间
+int64_t GetWallTimeMs()
 {
-    auto ownerSptr = ownerWptr_.lock();
-    if (!ownerSptr) {
-        HILOGW("partnerDeviceSptr is nullptr");
-        return;
+    return GetSecondsSince1970ToNow() * SEC_2_MILLISEC;
+}
+}  // namespace
+
+void DeviceAgentCapabilityBleAdv::OnScanEvent(const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event)
+{
+    switch (event) {
+        case PartnerDeviceScanEngine::SCAN_EVENT_RESULT:
+            OnScanResult(result);
+            break;
+        case PartnerDeviceScanEngine::SCAN_EVENT_FOUND:
+            OnDeviceFound(result);
+            break;
+        case PartnerDeviceScanEngine::SCAN_EVENT_LOST:
+            OnDeviceLost(result);
+            break;
+        default:
+            break;
     }
-    HILOGI("find device: %{public}s", GetEncryptAddr(result.GetPeripheralDevice().GetDeviceAddr()).c_str());
+}
 
-    ownerSptr->funcs_.startExtension();
-    ownerSptr->StopBleScan();
+void DeviceAgentCapabilityBleAdv::OnScanResult(const BleScanResult &result)
+{
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        // 信号强度和出现次数满足要求才认为设备出现，避免边缘设备反复拉起extension
+        if (presenceFilter_.OnSighting(result.GetRssi(), GetTimerClockMs()) !=
+            PartnerDevicePresenceFilter::TRANSITION_ENTER) {
+            return;
+        }
+        EnterLocked();
+    }
+    HILOGI("find device: %{public}s, rssi: %{public}d",
+        GetEncryptAddr(result.GetPeripheralDevice().GetDeviceAddr()).c_str(), result.GetRssi());
+    funcs_.startExtension();
+    // 继续扫描以保持设备在位，若无ACL连接，设备退出后断开extension
+    ArmExitTimer();
+}
 
-    // 起3分钟定时器，若无ACL连接，断开extension
-    auto func = [ptr = ownerWptr_]() {
-        auto partnerDeviceSptr = ptr.lock();
-        if (partnerDeviceSptr) {
-            partnerDeviceSptr->funcs_.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
-            // 起10分钟定时器，功耗抑制方案
+void DeviceAgentCapabilityBleAdv::OnDeviceFound(const BleScanResult &result)
+{
+    HILOGI("device found: %{public}s, rssi: %{public}d",
+        GetEncryptAddr(result.GetPeripheralDevice().GetDeviceAddr()).c_str(), result.GetRssi());
+    // 控制器持续跟踪设备，设备丢失时上报，跟踪期间设备保持在位，不需要超时定时器
+    // 发现时信号不足则不作为跟踪，设备不在位，由扫描窗口退避后重新添加过滤条件再次发现
+    PartnerDevicePresenceFilter::Transition transition = PartnerDevicePresenceFilter::TRANSITION_NONE;
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        transition = presenceFilter_.OnFound(result.GetRssi(), GetTimerClockMs());
+        if (transition == PartnerDevicePresenceFilter::TRANSITION_ENTER) {
+            EnterLocked();
+        }
+    }
+    // 丢失后在退出延时内再次发现，extension仍在运行，不重复拉起
+    if (transition == PartnerDevicePresenceFilter::TRANSITION_ENTER) {
+        funcs_.startExtension();
+    }
+    ArmExitTimer();
+}
+
+void DeviceAgentCapabilityBleAdv::OnDeviceLost(const BleScanResult &result)
+{
+    HILOGI("device lost: %{public}s", GetEncryptAddr(result.GetPeripheralDevice().GetDeviceAddr()).c_str());
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        presenceFilter_.OnTrackStop(GetTimerClockMs());
+    }
+    ArmExitTimer();
+}
+
+void DeviceAgentCapabilityBleAdv::EnterLocked()
+{
+    scanScheduler_.OnPresence(GetWallTimeMs());
+    // 设备在位期间不按扫描窗口退避，设备退出时重新开始扫描窗口
+    StopDutyCycleTimerLocked();
+}
+
+void DeviceAgentCapabilityBleAdv::ArmExitTimer()
+{
+    int64_t exitTimeMs = -1;
+    int64_t exitSlackMs = 0;
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        exitTimeMs = presenceFilter_.GetExitTimeMs();
+        exitSlackMs = presenceFilter_.GetConfig().exitSlackMs;
+    }
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    if (exitTimeMs < 0) {
+        StopExitTimerLocked();
+        return;
+    }
+    // 定时器只创建一次，每次扫描到设备重新计时
+    if (scanTimer_ == nullptr) {
+        auto func = [ptr = weak_from_this()]() {
+            auto partnerDeviceSptr = ptr.lock();
+            if (partnerDeviceSptr) {
+                partnerDeviceSptr->OnExitTimeout();
+            };
         };
-    };
-    std::lock_guard<std::mutex> lock(ownerSptr->timerMutex_);
-    ownerSptr->scanTimer_ = std::make_unique<Timer>(func);
-    ownerSptr->scanTimer_->Start(ownerSptr->extensionKeepAliveTimeout_);
+        scanTimer_ = std::make_unique<Timer>(func);
+    }
+    // 退出允许延后，与同时丢失的其他设备在同一次唤醒中退出
+    scanTimer_->Restart(static_cast<int>(std::max<int64_t>(exitTimeMs - GetTimerClockMs(), 0)), false,
+        static_cast<int>(exitSlackMs));
+}
+
+void DeviceAgentCapabilityBleAdv::StopExitTimerLocked()
+{
+    if (scanTimer_ != nullptr) {
+        scanTimer_->Stop();
+    }
+}
+
+void DeviceAgentCapabilityBleAdv::OnExitTimeout()
+{
+    bool isExited = false;
+    std::string address;
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        isExited = presenceFilter_.OnTimeout(GetTimerClockMs()) == PartnerDevicePresenceFilter::TRANSITION_EXIT;
+        // 设备退出后按扫描调度的扫描窗口继续扫描
+        if (isExited && isScanStarted_ && scanFilterId_ != PartnerDeviceScanEngine::INVALID_FILTER_ID) {
+            ArmScanWindowLocked();
+        }
+        address = address_;
+    }
+    if (!isExited) {
+        // 设备仍被扫描结果或控制器跟踪保持在位，按新的退出时间重新计时
+        ArmExitTimer();
+        return;
+    }
+    HILOGI("device exits: %{public}s", GetEncryptAddr(address).c_str());
+    funcs_.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
 }
 
 void DeviceAgentCapabilityBleAdv::Init(const std::string &addr)
@@ -56,8 +180,7 @@ void DeviceAgentCapabilityBleAdv::Init(const std::string &addr)
     {
         std::lock_guard<std::mutex> lock(bleScanMutex_);
         address_ = addr;
-        bluetoothScanCallback_ = std::make_shared<BluetoothScanCallback>(weak_from_this());
-        bleCentralManager_ = std::make_unique<BleCentralManager>(bluetoothScanCallback_);
+        isInited_ = true;
     }
     StartBleScan();
 }
@@ -65,71 +188,179 @@ void DeviceAgentCapabilityBleAdv::Init(const std::string &addr)
 void DeviceAgentCapabilityBleAdv::Close()
 {
     HILOGI("Close ble capability");
+    StopBleScan();
     std::lock_guard<std::mutex> lock(bleScanMutex_);
-    if (bleCentralManager_) {
-        bleCentralManager_->StopScan();
-        isScanStarted_ = false;
-    }
-    bluetoothScanCallback_ = nullptr;
-    bleCentralManager_ = nullptr;
+    isInited_ = false;
 }
 
 void DeviceAgentCapabilityBleAdv::StartBleScan()
 {
     std::lock_guard<std::mutex> lock(bleScanMutex_);
-    if (!bleCentralManager_) {
+    if (!isInited_) {
         return;
     }
-    bleCentralManager_->StopScan();
-
-    BleScanSettings settings;
-    settings.SetScanMode(curScanMode_.load());
-    BleScanFilter filter;
-    filter.SetDeviceId(address_);
-    bleCentralManager_->StartScan(settings, std::vector<BleScanFilter>{filter});
     isScanStarted_ = true;
+    if (scanFilterId_ != PartnerDeviceScanEngine::INVALID_FILTER_ID) {
+        // 已添加过滤条件，设备不在位时由扫描窗口定时器继续调度
+        if (dutyCycleHandler_ == nullptr && !presenceFilter_.IsPresent()) {
+            ArmScanWindowLocked();
+        }
+        return;
+    }
+    // 处于退避暂停中，暂停结束后恢复扫描
+    if (dutyCycleHandler_ != nullptr) {
+        return;
+    }
+    ResumeBleScanLocked();
 }
 
-void DeviceAgentCapabilityBleAdv::StopBleScan()
+void DeviceAgentCapabilityBleAdv::ResumeBleScanLocked()
+{
+    // 扫描参数由扫描引擎统一设置，这里只添加本设备的过滤条件
+    FcmMacAddress address;
+    if (!FcmMacAddress::FromString(address_, address)) {
+        HILOGE("Invalid address");
+        return;
+    }
+    auto callback = [ptr = weak_from_this()](
+        const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+        auto ownerSptr = ptr.lock();
+        if (!ownerSptr) {
+            HILOGW("partnerDeviceSptr is nullptr");
+            return;
+        }
+        ownerSptr->OnScanEvent(result, event);
+    };
+    scanFilterId_ = PartnerDeviceScanEngine::GetInstance().AddFilter(address, callback);
+    ArmScanWindowLocked();
+}
+
+void DeviceAgentCapabilityBleAdv::RemoveScanFilterLocked()
+{
+    if (scanFilterId_ != PartnerDeviceScanEngine::INVALID_FILTER_ID) {
+        PartnerDeviceScanEngine::GetInstance().RemoveFilter(scanFilterId_);
+        scanFilterId_ = PartnerDeviceScanEngine::INVALID_FILTER_ID;
+    }
+}
+
+void DeviceAgentCapabilityBleAdv::ArmDutyCycleTimerLocked(
+    int64_t delayMs, void (DeviceAgentCapabilityBleAdv::*handler)())
+{
+    // 定时器只创建一次，扫描窗口和退避暂停复用同一个定时器
+    if (dutyCycleTimer_ == nullptr) {
+        auto func = [ptr = weak_from_this()]() {
+            auto ownerSptr = ptr.lock();
+            if (ownerSptr) {
+                ownerSptr->OnDutyCycleTimeout();
+            }
+        };
+        dutyCycleTimer_ = std::make_unique<Timer>(func);
+    }
+    dutyCycleHandler_ = handler;
+    dutyCycleTimer_->Restart(static_cast<int>(delayMs));
+}
+
+void DeviceAgentCapabilityBleAdv::StopDutyCycleTimerLocked()
+{
+    dutyCycleHandler_ = nullptr;
+    if (dutyCycleTimer_ != nullptr) {
+        dutyCycleTimer_->Stop();
+    }
+}
+
+void DeviceAgentCapabilityBleAdv::OnDutyCycleTimeout()
 {
     std::lock_guard<std::mutex> lock(bleScanMutex_);
-    if (bleCentralManager_) {
-        bleCentralManager_->StopScan();
+    // 定时器已取消或已重新计时，丢弃执行中的过期回调
+    if (dutyCycleHandler_ == nullptr || dutyCycleTimer_->IsStarted()) {
+        return;
+    }
+    auto handler = dutyCycleHandler_;
+    dutyCycleHandler_ = nullptr;
+    (this->*handler)();
+}
+
+void DeviceAgentCapabilityBleAdv::ArmScanWindowLocked()
+{
+    ArmDutyCycleTimerLocked(scanScheduler_.GetScanWindowMs(), &DeviceAgentCapabilityBleAdv::OnScanWindowExpiredLocked);
+}
+
+void DeviceAgentCapabilityBleAdv::OnScanWindowExpiredLocked()
+{
+    if (!isScanStarted_ || scanFilterId_ == PartnerDeviceScanEngine::INVALID_FILTER_ID) {
+        return;
     }
+    int64_t pauseMs = scanScheduler_.OnMiss(GetWallTimeMs());
+    if (pauseMs == 0) {
+        // 设备可能出现的时段，继续扫描
+        ArmScanWindowLocked();
+        return;
+    }
+    HILOGI("scan window missed %{public}u times, pause %{public}" PRId64 "ms",
+        scanScheduler_.GetMissNum(), pauseMs);
+    RemoveScanFilterLocked();
+    ArmDutyCycleTimerLocked(pauseMs, &DeviceAgentCapabilityBleAdv::OnScanPauseExpiredLocked);
+}
+
+void DeviceAgentCapabilityBleAdv::OnScanPauseExpiredLocked()
+{
+    if (!isScanStarted_ || scanFilterId_ != PartnerDeviceScanEngine::INVALID_FILTER_ID) {
+        return;
+    }
+    ResumeBleScanLocked();
+}
+
+void DeviceAgentCapabilityBleAdv::StopBleScan()
+{
+    std::lock_guard<std::mutex> lock(bleScanMutex_);
+    RemoveScanFilterLocked();
+    StopDutyCycleTimerLocked();
     isScanStarted_ = false;
 }
 
 void DeviceAgentCapabilityBleAdv::OnBluetoothDeviceAclConnected()
 {
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        scanScheduler_.OnPresence(GetWallTimeMs());
+        // 连接期间由BR能力管理extension，重新扫描时重新判断设备是否在位
+        presenceFilter_.Reset();
+    }
     StopBleScan();
 
     std::lock_guard<std::mutex> lock(timerMutex_);
-    scanTimer_ = nullptr;
+    StopExitTimerLocked();
 }
 
 void DeviceAgentCapabilityBleAdv::OnBluetoothDeviceAclDisconnected()
-{}
-
-void DeviceAgentCapabilityBleAdv::OnScreenOn()
 {
-    curScanMode_ = SCAN_MODE_OP_P10_60_600;
-    if (isScanStarted_.load()) {
-        // 更改参数，重启BLE扫描
-        StartBleScan();
-    }
+    // 断连后恢复扫描，BR能力的退出延时内再次发现设备时保持在位，链路丢失后不销毁再重新拉起extension
+    StartBleScan();
 }
 
+// 扫描参数由扫描策略根据系统亮灭屏状态统一设置，设备无需处理
+void DeviceAgentCapabilityBleAdv::OnScreenOn()
+{}
+
 void DeviceAgentCapabilityBleAdv::OnScreenOff()
+{}
+
+PartnerDeviceScanScheduler DeviceAgentCapabilityBleAdv::GetScanScheduler()
 {
-    curScanMode_ = SCAN_MODE_OP_P2_60_3000;
-    if (isScanStarted_.load()) {
-        // 更改参数，重启BLE扫描
-        StartBleScan();
-    }
+    std::lock_guard<std::mutex> lock(bleScanMutex_);
+    return scanScheduler_;
 }
 
 void DeviceAgentCapabilityBleAdv::OnExtensionDestroy()
 {
+    {
+        std::lock_guard<std::mutex> lock(bleScanMutex_);
+        presenceFilter_.Reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        StopExitTimerLocked();
+    }
     StartBleScan();
 }
 }  // namespace FusionConnectivity
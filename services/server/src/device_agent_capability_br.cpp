@@ -18,6 +18,7 @@
 #endif
 
 #include "device_agent_capability_br.h"
+#include <algorithm>
 #include "log_util.h"
 #include "bluetooth_host.h"
 #include "partner_device.h"
@@ -44,11 +45,17 @@ void DeviceAgentCapabilityBr::OnBluetoothDeviceAclConnected()
         return;
     }
 
-    funcs_.startExtension();
-
-    // ACL连接成功，停止该设备的连接超时定时器
-    std::lock_guard<std::mutex> lock(timerMutex_);
-    aclDisconnectTimer_ = nullptr;
+    PartnerDevicePresenceFilter::Transition transition = PartnerDevicePresenceFilter::TRANSITION_NONE;
+    {
+        // ACL连接成功，停止该设备的连接超时定时器
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        transition = presenceFilter_.OnTrackStart(GetTimerClockMs());
+        StopExitTimerLocked();
+    }
+    // 断连后在退出延时内重连，extension仍在运行，不重复拉起
+    if (transition == PartnerDevicePresenceFilter::TRANSITION_ENTER) {
+        funcs_.startExtension();
+    }
 }
 
 void DeviceAgentCapabilityBr::OnBluetoothDeviceAclDisconnected()
@@ -57,17 +64,59 @@ void DeviceAgentCapabilityBr::OnBluetoothDeviceAclDisconnected()
         return;
     }
 
-    // ACL断连3分钟后，销毁Extension，并重启开启BLE扫描
-    auto func = [ptr = weak_from_this()]() {
-        auto capabilitySptr = ptr.lock();
-        if (capabilitySptr) {
-            HILOGI("destroy extension");
-            capabilitySptr->funcs_.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
-        };
-    };
+    // ACL断连超过退出延时（默认3分钟）后，销毁Extension，并重启开启BLE扫描
     std::lock_guard<std::mutex> lock(timerMutex_);
-    aclDisconnectTimer_ = std::make_unique<Timer>(func);
-    aclDisconnectTimer_->Start(extensionKeepAliveTimeout_);
+    int64_t nowMs = GetTimerClockMs();
+    if (!presenceFilter_.IsPresent()) {
+        // ACL在能力初始化之前已连接
+        (void)presenceFilter_.OnTrackStart(nowMs);
+    }
+    presenceFilter_.OnTrackStop(nowMs);
+    ArmExitTimerLocked(nowMs);
+}
+
+void DeviceAgentCapabilityBr::ArmExitTimerLocked(int64_t nowMs)
+{
+    int64_t exitTimeMs = presenceFilter_.GetExitTimeMs();
+    if (exitTimeMs < 0) {
+        StopExitTimerLocked();
+        return;
+    }
+    // 定时器只创建一次，每次断连重新计时
+    if (aclDisconnectTimer_ == nullptr) {
+        auto func = [ptr = weak_from_this()]() {
+            auto capabilitySptr = ptr.lock();
+            if (capabilitySptr) {
+                capabilitySptr->OnExitTimeout();
+            };
+        };
+        aclDisconnectTimer_ = std::make_unique<Timer>(func);
+    }
+    // 退出允许延后，与同时丢失的其他设备在同一次唤醒中退出
+    aclDisconnectTimer_->Restart(static_cast<int>(std::max<int64_t>(exitTimeMs - nowMs, 0)), false,
+        static_cast<int>(presenceFilter_.GetConfig().exitSlackMs));
+}
+
+void DeviceAgentCapabilityBr::StopExitTimerLocked()
+{
+    if (aclDisconnectTimer_ != nullptr) {
+        aclDisconnectTimer_->Stop();
+    }
+}
+
+void DeviceAgentCapabilityBr::OnExitTimeout()
+{
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        int64_t nowMs = GetTimerClockMs();
+        if (presenceFilter_.OnTimeout(nowMs) != PartnerDevicePresenceFilter::TRANSITION_EXIT) {
+            // 已重连时不再退出，定时器提前触发时重新计时
+            ArmExitTimerLocked(nowMs);
+            return;
+        }
+    }
+    HILOGI("destroy extension");
+    funcs_.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
 }
 }  // namespace FusionConnectivity
 }  // namespace OHOS
@@ -22,35 +22,62 @@
 #include "log_util.h"
 #include "datetime_ex.h"
 #include "common_utils.h"
-#include "ffrt_inner.h"
-#include "device_agent_capability_ble_adv.h"
-#include "device_agent_capability_br.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
-namespace {
-enum BondState : int {
-    BOND_STATE_NONE = 0,
-    BOND_STATE_BONDING = 1,
-    BOND_STATE_BONDED = 2
-};
-}  // namespace
 using namespace OHOS::Bluetooth;
 
-std::shared_ptr<PartnerDevice> PartnerDevice::CreateInstance(const DeviceInfo &deviceInfo, DependencyFuncs funcs)
+std::shared_ptr<PartnerDevice> PartnerDevice::CreateInstance(const DeviceInfo &deviceInfo, DependencyFuncs funcs,
+    bool isPaired, bool isBluetoothOn)
 {
+    FcmMacAddress macAddress;
+    if (!FcmMacAddress::FromString(deviceInfo.deviceAddress.GetAddress(), macAddress)) {
+        HILOGE("invalid device address");
+        return nullptr;
+    }
     // The passkey pattern used here.
-    auto deviceSptr = std::make_shared<PartnerDevice>(PassKey(), deviceInfo, funcs);
-    deviceSptr->Init();
+    auto deviceSptr = std::make_shared<PartnerDevice>(PassKey(), deviceInfo, macAddress, funcs);
+    deviceSptr->Init(isPaired, isBluetoothOn);
     return deviceSptr;
 }
 
 PartnerDevice::~PartnerDevice()
 {}
 
-void PartnerDevice::UpdatePartnerDeviceIsAllowStarted(const DeviceInfo &info)
+PairedDevices PairedDevices::Get()
+{
+    PairedDevices pairedDevices;
+    std::vector<BluetoothRemoteDevice> devices;
+    int ret = BluetoothHost::GetDefaultHost().GetPairedDevices(BT_TRANSPORT_BREDR, devices);
+    if (ret != BT_NO_ERROR) {
+        HILOGE("get paired devices failed, ret: %{public}d", ret);
+        return pairedDevices;
+    }
+    pairedDevices.isValid = true;
+    for (const auto &device : devices) {
+        FcmMacAddress address;
+        if (FcmMacAddress::FromString(device.GetDeviceAddr(), address)) {
+            pairedDevices.addresses.insert(address);
+        }
+    }
+    return pairedDevices;
+}
+
+bool PairedDevices::Contains(const FcmMacAddress &address) const
+{
+    if (isValid) {
+        return addresses.count(address) > 0;
+    }
+    // 获取已配对设备列表失败时，逐个查询配对状态
+    int pairState = PAIR_NONE;
+    auto device = BluetoothHost::GetDefaultHost().GetRemoteDevice(
+        address.ToString(), Bluetooth::BTTransport::ADAPTER_BREDR);
+    device.GetPairState(pairState);
+    return pairState == PAIR_PAIRED;
+}
+
+void PartnerDevice::UpdatePartnerDeviceIsAllowStarted(const DeviceInfo &info, bool isPaired)
 {
-    bool isPaired = IsPairedDevice(info.deviceAddress.GetAddress());
     if (!isPaired || !info.isUserEnabled) {
         HILOGI("The partner device %{public}s is closed due to (isPaired: %{public}d, isUserEnabled: %{public}d)",
             GET_ENCRYPT_ADDR(info.deviceAddress), isPaired, info.isUserEnabled);
@@ -68,137 +95,135 @@ void PartnerDevice::SetUserEnableAbility(bool isEnabled)
         deviceInfo_.isUserEnabled = isEnabled;
     }
 
-    DeviceInfo info = GetDeviceInfo();
-    if (isEnabled) {
-        UpdatePartnerDeviceIsAllowStarted(info);
-        InitDeviceAgentCapability(info.deviceAddress.GetAddress(), info.capability.isSupportBleAdvertiser);
-    } else {
-        UpdatePartnerDeviceIsAllowStarted(info);
-        CloseDeviceAgentCapability(ABILITY_DESTROY_USER_CLOSED_ABILITY);
+    // 查询配对状态是IPC，在加锁前查询；用户关闭的设备无需查询配对状态
+    bool isPaired = isEnabled && IsPairedDevice(GetDeviceAddress().GetAddress());
+    bool isDestroyNeeded = false;
+    {
+        std::lock_guard<std::mutex> lock(runtimeMutex_);
+        DeviceInfo info = GetDeviceInfo();
+        // 并发设置时以最后一次设置为准，由其更新运行状态
+        if (info.isUserEnabled != isEnabled) {
+            return;
+        }
+        UpdatePartnerDeviceIsAllowStarted(info, isPaired);
+        isDestroyNeeded = UpdateRuntimeLocked();
+    }
+    if (isDestroyNeeded) {
+        DestroyExtension(ABILITY_DESTROY_USER_CLOSED_ABILITY);
     }
 }
 
-void PartnerDevice::SubscribeCommonEvent(const std::vector<std::string> &eventVec,
-    const std::vector<std::string> &permissionVec, std::shared_ptr<FcmCommonEventSubscriber> &eventSubscribe)
+void PartnerDevice::OnBluetoothTurnOn(bool isPaired)
 {
-    EventFwk::MatchingSkills matchingSkills;
-    for (const std::string &event : eventVec) {
-        matchingSkills.AddEvent(event);
+    bool isDestroyNeeded = false;
+    {
+        std::lock_guard<std::mutex> lock(runtimeMutex_);
+        isBluetoothOn_ = true;
+        UpdatePartnerDeviceIsAllowStarted(GetDeviceInfo(), isPaired);
+        isDestroyNeeded = UpdateRuntimeLocked();
     }
-    EventFwk::CommonEventSubscribeInfo subscribeInfo(matchingSkills);
-    for (const std::string &permission : permissionVec) {
-        subscribeInfo.SetPermission(permission);
-    }
-    auto func = [ptr = weak_from_this()](const OHOS::EventFwk::CommonEventData &data) {
-        ffrt::submit([ptr, data]() {
-            auto partnerDeviceSptr = ptr.lock();
-            if (partnerDeviceSptr) {
-                partnerDeviceSptr->OnCommonEventReceived(data);
-            }
-        });
-    };
-    eventSubscribe =
-        std::make_shared<FcmCommonEventSubscriber>(subscribeInfo, eventVec, func);
-    if (!EventFwk::CommonEventManager::SubscribeCommonEvent(eventSubscribe)) {
-        HILOGE("Subscribe common event failed");
-        // no need return
+    if (isDestroyNeeded) {
+        DestroyExtension(ABILITY_DESTROY_UNKNOWN_REASON);
     }
 }
 
-void PartnerDevice::BluetoothStateObserver::OnStateChanged(const int transport, const int status)
+void PartnerDevice::OnBluetoothTurnOff()
 {
-    auto ownerSptr = ownerWptr_.lock();
-    if (!ownerSptr) {
-        HILOGE("ownerSptr is nullptr");
-        return;
-    }
-
-    if (transport == BTTransport::ADAPTER_BREDR && status == BTStateID::STATE_TURN_ON) {
-        DeviceInfo info = ownerSptr->GetDeviceInfo();
-        ownerSptr->UpdatePartnerDeviceIsAllowStarted(info);
-        ownerSptr->InitDeviceAgentCapability(info.deviceAddress.GetAddress(), info.capability.isSupportBleAdvertiser);
+    bool isDestroyNeeded = false;
+    {
+        std::lock_guard<std::mutex> lock(runtimeMutex_);
+        isBluetoothOn_ = false;
+        isDestroyNeeded = UpdateRuntimeLocked();
     }
-    if (transport == BTTransport::ADAPTER_BLE && status == BTStateID::STATE_TURN_OFF) {
-        ownerSptr->CloseDeviceAgentCapability(ABILITY_DESTROY_BLUETOOTH_DISABLED);
+    if (isDestroyNeeded) {
+        DestroyExtension(ABILITY_DESTROY_BLUETOOTH_DISABLED);
     }
 }
 
-void PartnerDevice::Init()
+void PartnerDevice::Init(bool isPaired, bool isBluetoothOn)
 {
-    auto startExtension = [this]() {
-        HILOGI("start extension");
-        DeviceInfo info = GetDeviceInfo();
-        dependencyFuncs_.discoverExtension(info.bundleName, info.abilityName, info.deviceAddress);
-    };
-    auto destroyExtension = [this](int destroyReason) {
-        HILOGI("destroy extension");
-        DeviceInfo info = GetDeviceInfo();
-        dependencyFuncs_.destroyExtension(info.bundleName, info.abilityName, destroyReason);
-    };
-    IDeviceAgentCapability::DependencyFuncs funcs = {
-        .startExtension = startExtension,
-        .destroyExtension = destroyExtension,
-    };
-    deviceAgentCapabilityMap_[CAPABILITY_BLE_ADV_KEY] =
-        std::make_shared<DeviceAgentCapabilityBleAdv>(funcs, weak_from_this());
-    deviceAgentCapabilityMap_[CAPABILITY_BR_KEY] =
-        std::make_shared<DeviceAgentCapabilityBr>(funcs, weak_from_this());
-
+    std::lock_guard<std::mutex> lock(runtimeMutex_);
+    // 配对状态和蓝牙状态由调用者为同一批设备统一获取，创建设备时不再逐个查询
+    isBluetoothOn_ = isBluetoothOn;
     DeviceInfo info = GetDeviceInfo();
-    UpdatePartnerDeviceIsAllowStarted(info);
-    InitDeviceAgentCapability(info.deviceAddress.GetAddress(), info.capability.isSupportBleAdvertiser);
-
-    // 监听蓝牙开关状态
-    bluetoothStateObserver_ = std::make_shared<BluetoothStateObserver>(weak_from_this());
-    BluetoothHost::GetDefaultHost().RegisterObserver(bluetoothStateObserver_);
-    // 监听亮灭屏公共事件
-    std::vector<std::string> screenCommonEventVec = {
-        EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON,
-        EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF,
-    };
-    SubscribeCommonEvent(screenCommonEventVec, {}, screenEventSubscribe_);
-    // 监听蓝牙公共事件
-    std::vector<std::string> commonEventVec = {
-        COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC,
-        COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC,
-        COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC,
-    };
-    std::vector<std::string> permissionVec = {
-        "ohos.permission.ACCESS_BLUETOOTH",
-        "ohos.permission.MANAGE_BLUETOOTH",
-    };
-    SubscribeCommonEvent(commonEventVec, permissionVec, bluetoothEventSubscribe_);
+    UpdatePartnerDeviceIsAllowStarted(info, info.isUserEnabled && isPaired);
+    // 创建时没有运行状态，不会关闭
+    (void)UpdateRuntimeLocked();
 }
 
-void PartnerDevice::InitDeviceAgentCapability(const std::string &addr, bool isSupportBleAdvertiser)
+bool PartnerDevice::UpdateRuntimeLocked()
 {
-    if (isAllowed_.load()) {
-        deviceAgentCapabilityMap_[CAPABILITY_BR_KEY]->Init(addr);
-        if (isSupportBleAdvertiser) {
-            deviceAgentCapabilityMap_[CAPABILITY_BLE_ADV_KEY]->Init(addr);
-        }
+    bool isActive = isAllowed_.load() && isBluetoothOn_;
+
+    if (isActive && runtime_ == nullptr) {
+        runtime_ = CreateRuntime();
+    } else if (!isActive && runtime_ != nullptr) {
+        bool isExtensionStarted = CloseRuntime(runtime_);
+        runtime_ = nullptr;
+        return isExtensionStarted;
     }
+    return false;
 }
 
-void PartnerDevice::CloseDeviceAgentCapability(int destroyReason)
+void PartnerDevice::DestroyExtension(int destroyReason)
 {
-    for (auto &[_, deviceAgentAbility] : deviceAgentCapabilityMap_) {
-        deviceAgentAbility->Close();
-    }
     DeviceInfo info = GetDeviceInfo();
     dependencyFuncs_.destroyExtension(info.bundleName, info.abilityName, destroyReason);
 }
 
-void PartnerDevice::Close()
+std::shared_ptr<PartnerDevice::Runtime> PartnerDevice::CreateRuntime()
+{
+    DeviceInfo info = GetDeviceInfo();
+    HILOGI("activate the partner device %{public}s", GET_ENCRYPT_ADDR(info.deviceAddress));
+    auto startExtension = [ptr = weak_from_this()]() {
+        auto deviceSptr = ptr.lock();
+        if (!deviceSptr) {
+            return;
+        }
+        HILOGI("start extension");
+        DeviceInfo info = deviceSptr->GetDeviceInfo();
+        deviceSptr->dependencyFuncs_.discoverExtension(info.bundleName, info.abilityName, info.deviceAddress);
+    };
+    auto destroyExtension = [ptr = weak_from_this()](int destroyReason) {
+        auto deviceSptr = ptr.lock();
+        if (!deviceSptr) {
+            return;
+        }
+        HILOGI("destroy extension");
+        DeviceInfo info = deviceSptr->GetDeviceInfo();
+        deviceSptr->dependencyFuncs_.destroyExtension(info.bundleName, info.abilityName, destroyReason);
+    };
+    PartnerDevicePresenceEngine::Subscriber subscriber = {
+        .funcs = {
+            .startExtension = startExtension,
+            .destroyExtension = destroyExtension,
+        },
+        .isSupportBleAdvertiser = info.capability.isSupportBleAdvertiser,
+        .presenceConfig = info.presenceConfig,
+    };
+    // 绑定同一地址的设备共用一个在位引擎，扫描和ACL处理只执行一次
+    auto runtime = std::make_shared<Runtime>();
+    runtime->presenceEngine = PartnerDevicePresenceEngine::Acquire(key_.second);
+    runtime->subscriberId = runtime->presenceEngine->Subscribe(subscriber);
+    return runtime;
+}
+
+bool PartnerDevice::CloseRuntime(const std::shared_ptr<Runtime> &runtime)
 {
-    // 取消公共事件监听
-    if (bluetoothEventSubscribe_) {
-        EventFwk::CommonEventManager::UnSubscribeCommonEvent(bluetoothEventSubscribe_);
-        bluetoothEventSubscribe_ = nullptr;
+    HILOGI("deactivate the partner device %{public}s", GET_ENCRYPT_ADDR(GetDeviceAddress()));
+    if (runtime->presenceEngine) {
+        return runtime->presenceEngine->Unsubscribe(runtime->subscriberId);
     }
-    if (screenEventSubscribe_) {
-        EventFwk::CommonEventManager::UnSubscribeCommonEvent(screenEventSubscribe_);
-        screenEventSubscribe_ = nullptr;
+    return false;
+}
+
+void PartnerDevice::Close()
+{
+    std::lock_guard<std::mutex> lock(runtimeMutex_);
+    isAllowed_ = false;
+    if (runtime_) {
+        (void)CloseRuntime(runtime_);
+        runtime_ = nullptr;
     }
 }
 
@@ -210,99 +235,42 @@ bool PartnerDevice::IsPairedDevice(const std::string &address)
     return pairState == PAIR_PAIRED;
 }
 
-void PartnerDevice::OnBluetoothDeviceAclStateChange(const OHOS::EventFwk::CommonEventData &data, bool isConnect)
-{
-    AAFwk::Want want = data.GetWant();
-    std::string addr = want.GetStringParam("deviceAddr");
-    if (!IsValidAddress(addr)) {
-        HILOGE("Invalid address");
-        return;
-    }
-    HILOGI("%{public}s acl state change, isConnect: %{public}d", GetEncryptAddr(addr).c_str(), isConnect);
-    DeviceInfo deviceInfo = GetDeviceInfo();
-    if (deviceInfo.deviceAddress.GetAddress() != addr) {
-        return;
-    }
-
-    for (auto &[_, deviceAgentAbility] : deviceAgentCapabilityMap_) {
-        if (isConnect) {
-            deviceAgentAbility->OnBluetoothDeviceAclConnected();
-        } else {
-            deviceAgentAbility->OnBluetoothDeviceAclDisconnected();
-        }
-    }
-}
-
-void PartnerDevice::OnBluetoothDevicePairStateChange(const OHOS::EventFwk::CommonEventData &data)
+void PartnerDevice::OnBluetoothDevicePairStateChange(int state)
 {
-    AAFwk::Want want = data.GetWant();
-    std::string addr = want.GetStringParam("deviceAddr");
-    if (!IsValidAddress(addr)) {
-        HILOGE("Invalid address");
-        return;
-    }
-
-    DeviceInfo deviceInfo = GetDeviceInfo();
-    if (deviceInfo.deviceAddress.GetAddress() != addr) {
-        return;
-    }
-    int state = want.GetIntParam("state", BOND_STATE_NONE);
-    HILOGI("pair state change, %{public}s, state: %{public}d (0: BOND_NONE, 2: BONDED), isUserEnabled: %{public}d",
-        GetEncryptAddr(addr).c_str(), state, deviceInfo.isUserEnabled);
-
+    HILOGI("pair state change, %{public}s, state: %{public}d (0: BOND_NONE, 2: BONDED)",
+        GetEncryptAddr(key_.second.ToString()).c_str(), state);
     if (state == BOND_STATE_NONE) {
-        CloseDeviceAgentCapability(ABILITY_DESTROY_DEVICE_UNPAIRED);
-        isAllowed_ = false;
+        bool isDestroyNeeded = false;
+        {
+            std::lock_guard<std::mutex> lock(runtimeMutex_);
+            isAllowed_ = false;
+            isDestroyNeeded = UpdateRuntimeLocked();
+        }
+        if (isDestroyNeeded) {
+            DestroyExtension(ABILITY_DESTROY_DEVICE_UNPAIRED);
+        }
 
         UpdateLostTimestamp(GetDaysSince1970ToNow());
         if (dependencyFuncs_.updateConfig) {
-            dependencyFuncs_.updateConfig();
+            dependencyFuncs_.updateConfig(key_);
         }
     } else if (state == BOND_STATE_BONDED) {
-        if (deviceInfo.isUserEnabled) {
-            isAllowed_ = true;
-            InitDeviceAgentCapability(
-                deviceInfo.deviceAddress.GetAddress(), deviceInfo.capability.isSupportBleAdvertiser);
+        bool isDestroyNeeded = false;
+        {
+            std::lock_guard<std::mutex> lock(runtimeMutex_);
+            isAllowed_ = IsUserEnableAbility();
+            isDestroyNeeded = UpdateRuntimeLocked();
+        }
+        if (isDestroyNeeded) {
+            DestroyExtension(ABILITY_DESTROY_USER_CLOSED_ABILITY);
         }
 
         UpdateLostTimestamp(0);
         if (dependencyFuncs_.updateConfig) {
-            dependencyFuncs_.updateConfig();
+            dependencyFuncs_.updateConfig(key_);
         }
     }
 }
 
-void PartnerDevice::OnScreenStateChange(bool isScreenOn)
-{
-    for (auto &[_, deviceAgentAbility] : deviceAgentCapabilityMap_) {
-        if (isScreenOn) {
-            deviceAgentAbility->OnScreenOn();
-        } else {
-            deviceAgentAbility->OnScreenOff();
-        }
-    }
-}
-
-void PartnerDevice::OnCommonEventReceived(const OHOS::EventFwk::CommonEventData &data)
-{
-    auto want = data.GetWant();
-    std::string action = want.GetAction();
-    if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC) {
-        OnBluetoothDeviceAclStateChange(data, true);
-    }
-    if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC) {
-        OnBluetoothDeviceAclStateChange(data, false);
-    }
-    if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC) {
-        OnBluetoothDevicePairStateChange(data);
-    }
-    if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON) {
-        OnScreenStateChange(true);
-    }
-    if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF) {
-        OnScreenStateChange(false);
-    }
-}
-
 }  // namespace FusionConnectivity
 }  // namespace OHOS
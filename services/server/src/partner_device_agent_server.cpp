@@ -19,7 +19,9 @@
 
 #include "partner_device_agent_server.h"
 
+#include <cinttypes>
 #include <set>
+#include "hitrace_meter.h"
 #include "log.h"
 #include "log_util.h"
 #include "ipc_skeleton.h"
@@ -33,9 +35,14 @@
 #include "parameters.h"
 #include "common_utils.h"
 #include "datetime_ex.h"
+#include "file_ex.h"
 #include "ffrt_inner.h"
 #include "bluetooth_host.h"
 #include "partner_device_config.h"
+#include "partner_device_presence_engine.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_scan_policy.h"
+#include "timer_manager_ffrt.h"
 
 namespace OHOS {
 namespace FusionConnectivity {
@@ -55,6 +62,45 @@ namespace {
         "persist.fusion_connectivity.enable_partner_agent";
     const char *SYS_PARAM_ENABLE_PARTNER_AGENT_DISABLED = "0";
     const char *SYS_PARAM_ENABLE_PARTNER_AGENT_ENABLED = "1";
+    static constexpr const char *SYS_PARAM_CONFIG_WRITE_WINDOW =
+        "persist.fusion_connectivity.partner_agent_config_write_window_ms";
+    const int CONFIG_WRITE_WINDOW_MAX_MS = 10000;    // 10s
+    static constexpr const char *SYS_PARAM_MAX_DEVICES_PER_APP =
+        "persist.fusion_connectivity.partner_agent_max_devices_per_app";
+    static constexpr const char *SYS_PARAM_MAX_DEVICES_PER_USER =
+        "persist.fusion_connectivity.partner_agent_max_devices_per_user";
+    const int MAX_DEVICES_LIMIT = 100000;
+    // 控制器跟踪的设备数量上限，0表示不使用found/lost上报
+    static constexpr const char *SYS_PARAM_BLE_FOUND_LOST_FILTER_NUM =
+        "persist.fusion_connectivity.partner_agent_ble_found_lost_filter_num";
+    const int BLE_FOUND_LOST_FILTER_NUM_LIMIT = 256;
+    // 亮灭屏、温度和电量变化调整扫描参数的防抖窗口
+    static constexpr const char *SYS_PARAM_BLE_SCAN_DEBOUNCE_WINDOW =
+        "persist.fusion_connectivity.partner_agent_ble_scan_debounce_ms";
+    const int BLE_SCAN_DEBOUNCE_WINDOW_MAX_MS = 10000;    // 10s
+    // 设备在位判断的默认门限：进入和退出的信号强度、N次出现中的M次、设备退出的延时和允许的延后
+    static constexpr const char *SYS_PARAM_PRESENCE_ENTER_RSSI =
+        "persist.fusion_connectivity.partner_agent_presence_enter_rssi";
+    static constexpr const char *SYS_PARAM_PRESENCE_EXIT_RSSI =
+        "persist.fusion_connectivity.partner_agent_presence_exit_rssi";
+    static constexpr const char *SYS_PARAM_PRESENCE_SIGHTING_NUM =
+        "persist.fusion_connectivity.partner_agent_presence_sighting_num";
+    static constexpr const char *SYS_PARAM_PRESENCE_WINDOW_NUM =
+        "persist.fusion_connectivity.partner_agent_presence_window_num";
+    static constexpr const char *SYS_PARAM_PRESENCE_EXIT_DELAY =
+        "persist.fusion_connectivity.partner_agent_presence_exit_delay_ms";
+    static constexpr const char *SYS_PARAM_PRESENCE_EXIT_SLACK =
+        "persist.fusion_connectivity.partner_agent_presence_exit_slack_ms";
+    const int RSSI_MIN = -127;
+    const int RSSI_MAX = 20;
+    const int PRESENCE_WINDOW_NUM_LIMIT = 16;
+    const int PRESENCE_EXIT_DELAY_MAX_MS = 30 * 60 * 1000;    // 30min
+    const int PRESENCE_EXIT_SLACK_MAX_MS = 60 * 1000;    // 1min
+    // 设备配置加载完成前到达的请求最多等待的时间，超时返回未就绪，不长时间占用 binder 线程
+    const int64_t READY_WAIT_TIMEOUT_MS = 100;    // 100ms
+    constexpr const char *TRACE_PUBLISH = "PartnerDeviceAgentPublish";
+    constexpr const char *TRACE_READY = "PartnerDeviceAgentReady";
+    const int32_t TRACE_READY_TASK_ID = 0;
 }
 
 const bool REGISTER_RESULT =
@@ -63,7 +109,10 @@ const bool REGISTER_RESULT =
 struct PartnerDeviceAgentServer::impl {
 };
 
-PartnerDeviceAgentServer::PartnerDeviceAgentServer() : SystemAbility(PARTNER_DEVICE_AGENT_SYS_ABILITY_ID, true)
+PartnerDeviceAgentServer::PartnerDeviceAgentServer() : SystemAbility(PARTNER_DEVICE_AGENT_SYS_ABILITY_ID, true),
+    configPersister_([this](const std::set<PartnerDeviceMapKey> &dirtyKeys) {
+        AppendPartnerDeviceJournal(partnerDeviceMap_, dirtyKeys);
+    })
 {
     HILOGI("PartnerDeviceAgentServer enter");
     // 该注册仅仅为向sa_main进程注册（即需要向samgr注册请求的SA，onStart 调用Publish才真正完成SAMGR的注册）
@@ -126,7 +175,16 @@ int32_t PartnerDeviceAgentServer::CallbackEnter(uint32_t code)
         return FCM_ERR_API_NOT_SUPPORT;
     }
 
-    return PermissionManager::VerifyPermissions(it->second);
+    FcmErrCode ret = PermissionManager::VerifyPermissions(it->second);
+    if (ret != FCM_NO_ERROR) {
+        return ret;
+    }
+    // 设备配置在后台加载，加载完成前到达的请求短暂等待，仍未完成时由客户端稍后重试
+    if (!WaitReady(READY_WAIT_TIMEOUT_MS)) {
+        HILOGE("partner device agent is not ready, ipc code: %{public}u", code);
+        return FCM_ERR_SERVICE_NOT_READY;
+    }
+    return FCM_NO_ERROR;
 }
 
 int32_t PartnerDeviceAgentServer::CallbackExit([[maybe_unused]] uint32_t code, [[maybe_unused]] int32_t result)
@@ -140,13 +198,11 @@ PartnerDeviceAgentServer::~PartnerDeviceAgentServer()
 }
 
 std::shared_ptr<PartnerDevice> PartnerDeviceAgentServer::CreatePartnerDeviceInstance(
-    PartnerDevice::DeviceInfo &deviceInfo)
+    PartnerDevice::DeviceInfo &deviceInfo, bool isPaired, bool isBluetoothOn)
 {
-    auto updateConfig = [this]() {
-        // 切换线程环境
-        ffrt::submit([this]() {
-            UpdatePartnerDeviceConfig(partnerDeviceMap_);
-        });
+    deviceInfo.presenceConfig = presenceConfig_;
+    auto updateConfig = [this](const PartnerDeviceMapKey &key) {
+        configPersister_.MarkDirty(key);
     };
     auto discoverExtension = [this](std::string bundleName,
         std::string abilityName, PartnerDeviceAddress deviceAddress) {
@@ -161,25 +217,22 @@ std::shared_ptr<PartnerDevice> PartnerDeviceAgentServer::CreatePartnerDeviceInst
         .discoverExtension = discoverExtension,
         .destroyExtension = destroyExtension,
     };
-    return PartnerDevice::CreateInstance(deviceInfo, funcs);
+    return PartnerDevice::CreateInstance(deviceInfo, funcs, isPaired, isBluetoothOn);
 }
 
 int PartnerDeviceAgentServer::ChangeDeviceControlState(
-    const std::string &addr, bool isEnabled)
+    const FcmMacAddress &addr, bool isEnabled)
 {
     int ret = FCM_ERR_DEVICE_NOT_FOUND;
-    partnerDeviceMap_.Iterate(
-        [&addr, &isEnabled, &ret](const PartnerDeviceMapKey &key, std::shared_ptr<PartnerDevice> &deviceSptr) {
+    partnerDeviceMap_.IterateByAddress(
+        addr, [this, &addr, &isEnabled, &ret](uint32_t tokenId, const std::shared_ptr<PartnerDevice> &deviceSptr) {
         if (!deviceSptr) {
             return;
         }
-        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
-        if (deviceInfo.deviceAddress.GetAddress() == addr) {
-            deviceSptr->SetUserEnableAbility(isEnabled);
-            ret = FCM_NO_ERROR;
-        }
+        deviceSptr->SetUserEnableAbility(isEnabled);
+        configPersister_.MarkDirty(std::make_pair(tokenId, addr));
+        ret = FCM_NO_ERROR;
     });
-    UpdatePartnerDeviceConfig(partnerDeviceMap_);
     return ret;
 }
 
@@ -208,6 +261,11 @@ ErrCode PartnerDeviceAgentServer::BindDevice(
         AttemptUnloadPartnerAgent();
         return FCM_ERR_API_NOT_SUPPORT;
     }
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_INVALID_PARAM;
+    }
     // 检查设备是否配对
     if (!IsPairedDevice(deviceAddress)) {
         HILOGE("%{public}s device is not paired", GET_ENCRYPT_ADDR(deviceAddress));
@@ -215,30 +273,44 @@ ErrCode PartnerDeviceAgentServer::BindDevice(
         return FCM_ERR_DEVICE_NOT_PAIRED;
     }
     // 检查该设备是否已注册
-    if (IsDeviceBoundByCallingApp(deviceAddress)) {
+    if (IsDeviceBoundByCallingApp(macAddress)) {
         HILOGE("%{public}s device is already bound", GET_ENCRYPT_ADDR(deviceAddress));
         AttemptUnloadPartnerAgent();
         return FCM_ERR_DEVICE_ALREADY_BOUNDED;
     }
 
+    uint32_t tokenId = IPCSkeleton::GetCallingTokenID();
+    int32_t userId = INVALID_USER_ID;
+    (void)PermissionManager::GetHapUserId(tokenId, userId);
     HILOGI("%{public}s bind device %{public}s",
         PermissionManager::GetCallingName().c_str(), GET_ENCRYPT_ADDR(deviceAddress));
-    auto key = std::make_pair<uint32_t, std::string>(IPCSkeleton::GetCallingTokenID(), deviceAddress.GetAddress());
+    auto key = std::make_pair(tokenId, macAddress);
     PartnerDevice::DeviceInfo deviceInfo = {
         .bundleName = PermissionManager::GetCallingName(),
         .abilityName = partnerAgentExtensionAbilityName,
         .deviceAddress = deviceAddress,
-        .tokenId = IPCSkeleton::GetCallingTokenID(),
+        .tokenId = tokenId,
         .registerTimestamp = GetSecondsSince1970ToNow(),
         .lostTimestamp = 0,
         .capability = capability,
         .businessCapability = businessCapability,
     };
 
-    // 固化虚拟地址
-    auto deviceSptr = CreatePartnerDeviceInstance(deviceInfo);
-    partnerDeviceMap_.EnsureInsert(key, deviceSptr);
-    UpdatePartnerDeviceConfig(partnerDeviceMap_);
+    // 固化虚拟地址；蓝牙已打开且设备已配对，均已在上面检查
+    auto deviceSptr = CreatePartnerDeviceInstance(deviceInfo, true, true);
+    if (deviceSptr == nullptr) {
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_INTERNAL_ERROR;
+    }
+    // 检查应用和用户的设备配额并插入设备，并发绑定不会超出配额
+    if (!deviceQuota_.TryBind(partnerDeviceMap_, PartnerDeviceRegistry::Entry { key, userId, deviceSptr })) {
+        HILOGE("device quota reached, app devices: %{public}zu, user %{public}d devices: %{public}zu",
+            partnerDeviceMap_.CountByTokenId(tokenId), userId, partnerDeviceMap_.CountByUserId(userId));
+        deviceSptr->Close();
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_DEVICE_LIMIT_EXCEEDED;
+    }
+    configPersister_.MarkDirty(key);
     // 设置SA自启动标记
     SetParameter(SYS_PARAM_ENABLE_PARTNER_AGENT, SYS_PARAM_ENABLE_PARTNER_AGENT_ENABLED);
     return FCM_NO_ERROR;
@@ -261,8 +333,13 @@ ErrCode PartnerDeviceAgentServer::UnbindDevice(const PartnerDeviceAddress &devic
         AttemptUnloadPartnerAgent();
         return FCM_ERR_API_NOT_SUPPORT;
     }
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_INVALID_PARAM;
+    }
     // 检查设备是否已注册过
-    if (!IsDeviceBoundByCallingApp(deviceAddress)) {
+    if (!IsDeviceBoundByCallingApp(macAddress)) {
         HILOGE("%{public}s device is not bound", GET_ENCRYPT_ADDR(deviceAddress));
         AttemptUnloadPartnerAgent();
         return FCM_ERR_DEVICE_NOT_FOUND;
@@ -270,7 +347,7 @@ ErrCode PartnerDeviceAgentServer::UnbindDevice(const PartnerDeviceAddress &devic
 
     HILOGI("%{public}s unbind device %{public}s",
         PermissionManager::GetCallingName().c_str(), GET_ENCRYPT_ADDR(deviceAddress));
-    auto key = std::make_pair(IPCSkeleton::GetCallingTokenID(), deviceAddress.GetAddress());
+    auto key = std::make_pair(IPCSkeleton::GetCallingTokenID(), macAddress);
     std::shared_ptr<PartnerDevice> deviceSptr = nullptr;
     partnerDeviceMap_.Find(key, deviceSptr);
     if (deviceSptr) {
@@ -278,7 +355,11 @@ ErrCode PartnerDeviceAgentServer::UnbindDevice(const PartnerDeviceAddress &devic
     }
     // 清除虚拟MAC固化
     partnerDeviceMap_.Erase(key);
-    UpdatePartnerDeviceConfig(partnerDeviceMap_);
+    // 地址的最后一个绑定删除后不再需要该设备的扫描历史
+    if (!partnerDeviceMap_.IsAddressBound(key.second)) {
+        PartnerDevicePresenceEngine::ClearScanHistory(key.second);
+    }
+    configPersister_.MarkDirty(key);
     AttemptUnloadPartnerAgent();
     return FCM_NO_ERROR;
 }
@@ -291,9 +372,14 @@ ErrCode PartnerDeviceAgentServer::IsDeviceBound(const PartnerDeviceAddress &devi
         AttemptUnloadPartnerAgent();
         return FCM_ERR_API_NOT_SUPPORT;
     }
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_INVALID_PARAM;
+    }
 
     isBound = PermissionManager::IsSystemCaller() ?
-        IsDeviceBoundByAll(deviceAddress) : IsDeviceBoundByCallingApp(deviceAddress);
+        partnerDeviceMap_.IsAddressBound(macAddress) : IsDeviceBoundByCallingApp(macAddress);
 
     AttemptUnloadPartnerAgent();
     return FCM_NO_ERROR;
@@ -302,37 +388,29 @@ ErrCode PartnerDeviceAgentServer::IsDeviceBound(const PartnerDeviceAddress &devi
 ErrCode PartnerDeviceAgentServer::GetBoundDevices(std::vector<PartnerDeviceAddress> &deviceAddressVec)
 {
     uint32_t tokenId = IPCSkeleton::GetCallingTokenID();
-    partnerDeviceMap_.Iterate(
-        [tokenId, &deviceAddressVec](const PartnerDeviceMapKey &key, std::shared_ptr<PartnerDevice> &deviceSptr) {
-        if (key.first == tokenId && deviceSptr != nullptr) {
-            PartnerDevice::DeviceInfo info = deviceSptr->GetDeviceInfo();
-            deviceAddressVec.push_back(info.deviceAddress);
+    partnerDeviceMap_.IterateByTokenId(
+        tokenId, [&deviceAddressVec](const FcmMacAddress &address, const std::shared_ptr<PartnerDevice> &deviceSptr) {
+        if (deviceSptr != nullptr) {
+            deviceAddressVec.push_back(deviceSptr->GetDeviceAddress());
         }
     });
     return FCM_NO_ERROR;
 }
 
-bool PartnerDeviceAgentServer::IsDeviceBoundByCallingApp(const PartnerDeviceAddress &deviceAddress)
+bool PartnerDeviceAgentServer::ParseMacAddress(const PartnerDeviceAddress &deviceAddress, FcmMacAddress &macAddress)
 {
-    auto key = std::make_pair(IPCSkeleton::GetCallingTokenID(), deviceAddress.GetAddress());
-    std::shared_ptr<PartnerDevice> deviceSptr = nullptr;
-    bool isBound = partnerDeviceMap_.Find(key, deviceSptr);
-    return isBound;
+    if (!FcmMacAddress::FromString(deviceAddress.GetAddress(), macAddress)) {
+        HILOGE("invalid address");
+        return false;
+    }
+    return true;
 }
 
-bool PartnerDeviceAgentServer::IsDeviceBoundByAll(const PartnerDeviceAddress &deviceAddress)
+bool PartnerDeviceAgentServer::IsDeviceBoundByCallingApp(const FcmMacAddress &macAddress)
 {
-    bool isBound = false;
-    partnerDeviceMap_.Iterate(
-        [&deviceAddress, &isBound](const PartnerDeviceMapKey &key, std::shared_ptr<PartnerDevice> &deviceSptr) {
-        if (!deviceSptr) {
-            return;
-        }
-        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
-        if (deviceInfo.deviceAddress.GetAddress() == deviceAddress.GetAddress()) {
-            isBound = true;
-        }
-    });
+    auto key = std::make_pair(IPCSkeleton::GetCallingTokenID(), macAddress);
+    std::shared_ptr<PartnerDevice> deviceSptr = nullptr;
+    bool isBound = partnerDeviceMap_.Find(key, deviceSptr);
     return isBound;
 }
 
@@ -340,58 +418,162 @@ ErrCode PartnerDeviceAgentServer::EnableDeviceControl(const PartnerDeviceAddress
 {
     HILOGI("%{public}s enable device control %{public}s",
         PermissionManager::GetCallingName().c_str(), GET_ENCRYPT_ADDR(deviceAddress));
-    return ChangeDeviceControlState(deviceAddress.GetAddress(), true);
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        return FCM_ERR_INVALID_PARAM;
+    }
+    return ChangeDeviceControlState(macAddress, true);
 }
 
 ErrCode PartnerDeviceAgentServer::DisableDeviceControl(const PartnerDeviceAddress &deviceAddress)
 {
     HILOGI("%{public}s disable device control %{public}s",
         PermissionManager::GetCallingName().c_str(), GET_ENCRYPT_ADDR(deviceAddress));
-    return ChangeDeviceControlState(deviceAddress.GetAddress(), false);
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        return FCM_ERR_INVALID_PARAM;
+    }
+    return ChangeDeviceControlState(macAddress, false);
 }
 
 ErrCode PartnerDeviceAgentServer::IsDeviceControlEnabled(const PartnerDeviceAddress &deviceAddress, bool &isEnabled)
 {
     isEnabled = false;
-    partnerDeviceMap_.Iterate(
-        [&deviceAddress, &isEnabled](const PartnerDeviceMapKey &key, std::shared_ptr<PartnerDevice> &deviceSptr) {
+    FcmMacAddress macAddress;
+    if (!ParseMacAddress(deviceAddress, macAddress)) {
+        AttemptUnloadPartnerAgent();
+        return FCM_ERR_INVALID_PARAM;
+    }
+    partnerDeviceMap_.IterateByAddress(macAddress,
+        [&isEnabled](uint32_t tokenId, const std::shared_ptr<PartnerDevice> &deviceSptr) {
         if (!deviceSptr) {
             return;
         }
-        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
-        if (deviceInfo.deviceAddress.GetAddress() == deviceAddress.GetAddress()) {
-            isEnabled = deviceInfo.isUserEnabled;
-        }
+        isEnabled = deviceSptr->IsUserEnableAbility();
     });
 
     AttemptUnloadPartnerAgent();
     return FCM_NO_ERROR;
 }
 
-void PartnerDeviceAgentServer::Init()
+void PartnerDeviceAgentServer::InitParameters()
 {
-    CreatePartnerDeviceFunc func = [this](PartnerDevice::DeviceInfo &deviceInfo) {
-        return CreatePartnerDeviceInstance(deviceInfo);
+    int writeWindowMs = GetIntParameter(SYS_PARAM_CONFIG_WRITE_WINDOW,
+        static_cast<int>(PartnerDeviceConfigPersister::DEFAULT_COALESCE_WINDOW_MS), 0, CONFIG_WRITE_WINDOW_MAX_MS);
+    configPersister_.SetCoalesceWindow(static_cast<uint32_t>(writeWindowMs));
+    int maxDevicesPerApp = GetIntParameter(SYS_PARAM_MAX_DEVICES_PER_APP,
+        static_cast<int>(PartnerDeviceQuota::DEFAULT_MAX_DEVICES_PER_APP), 1, MAX_DEVICES_LIMIT);
+    int maxDevicesPerUser = GetIntParameter(SYS_PARAM_MAX_DEVICES_PER_USER,
+        static_cast<int>(PartnerDeviceQuota::DEFAULT_MAX_DEVICES_PER_USER), 1, MAX_DEVICES_LIMIT);
+    deviceQuota_ = PartnerDeviceQuota(static_cast<size_t>(maxDevicesPerApp), static_cast<size_t>(maxDevicesPerUser));
+    int foundLostFilterNum = GetIntParameter(SYS_PARAM_BLE_FOUND_LOST_FILTER_NUM,
+        static_cast<int>(PartnerDeviceScanEngine::DEFAULT_MAX_FOUND_LOST_FILTER_NUM), 0,
+        BLE_FOUND_LOST_FILTER_NUM_LIMIT);
+    PartnerDeviceScanEngine::GetInstance().SetMaxFoundLostFilterNum(static_cast<size_t>(foundLostFilterNum));
+    int scanDebounceWindowMs = GetIntParameter(SYS_PARAM_BLE_SCAN_DEBOUNCE_WINDOW,
+        static_cast<int>(PartnerDeviceScanPolicy::DEFAULT_DEBOUNCE_WINDOW_MS), 0, BLE_SCAN_DEBOUNCE_WINDOW_MAX_MS);
+    PartnerDeviceScanPolicy::GetInstance().SetDebounceWindow(static_cast<uint32_t>(scanDebounceWindowMs));
+    InitPresenceParameters();
+}
+
+void PartnerDeviceAgentServer::InitPresenceParameters()
+{
+    PartnerDevicePresenceFilter::Config config;
+    config.enterRssi = GetIntParameter(SYS_PARAM_PRESENCE_ENTER_RSSI, config.enterRssi, RSSI_MIN, RSSI_MAX);
+    config.exitRssi = GetIntParameter(SYS_PARAM_PRESENCE_EXIT_RSSI, config.exitRssi, RSSI_MIN, RSSI_MAX);
+    config.sightingNum = static_cast<uint32_t>(GetIntParameter(SYS_PARAM_PRESENCE_SIGHTING_NUM,
+        static_cast<int>(config.sightingNum), 1, PRESENCE_WINDOW_NUM_LIMIT));
+    config.windowNum = static_cast<uint32_t>(GetIntParameter(SYS_PARAM_PRESENCE_WINDOW_NUM,
+        static_cast<int>(config.windowNum), 1, PRESENCE_WINDOW_NUM_LIMIT));
+    config.exitDelayMs = GetIntParameter(SYS_PARAM_PRESENCE_EXIT_DELAY,
+        static_cast<int>(config.exitDelayMs), 0, PRESENCE_EXIT_DELAY_MAX_MS);
+    config.exitSlackMs = GetIntParameter(SYS_PARAM_PRESENCE_EXIT_SLACK,
+        static_cast<int>(config.exitSlackMs), 0, PRESENCE_EXIT_SLACK_MAX_MS);
+    if (!config.IsValid()) {
+        HILOGW("invalid presence parameters, use the default");
+        config = PartnerDevicePresenceFilter::Config();
+    }
+    presenceConfig_ = config;
+}
+
+bool PartnerDeviceAgentServer::Init()
+{
+    // 下电时不再开始后续步骤
+    if (isStopping_) {
+        return false;
+    }
+    // 先订阅公共事件再加载设备，避免错过设备查询配对状态之后的配对状态变化
+    eventDispatcher_.Subscribe();
+    if (isStopping_) {
+        return false;
+    }
+    CreatePartnerDeviceFunc func = [this](PartnerDevice::DeviceInfo &deviceInfo, bool isPaired, bool isBluetoothOn) {
+        return CreatePartnerDeviceInstance(deviceInfo, isPaired, isBluetoothOn);
     };
-    LoadPartnerDeviceConfig(partnerDeviceMap_, func);
+    LoadPartnerDeviceConfig(partnerDeviceMap_, deviceQuota_, func);
     if (partnerDeviceMap_.IsEmpty()) {
         AttemptUnloadPartnerAgent();
     }
+    return true;
+}
+
+void PartnerDeviceAgentServer::SetReady()
+{
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        isReady_ = true;
+    }
+    readyCondition_.notify_all();
+}
+
+bool PartnerDeviceAgentServer::WaitReady(int64_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(readyMutex_);
+    return readyCondition_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return isReady_; });
 }
 
 void PartnerDeviceAgentServer::OnStart()
 {
     HILOGI("PartnerDeviceAgentServer starting service.");
-    Init();
+    int64_t startMs = GetTickCount();
+    StartAsyncTrace(HITRACE_TAG_BLUETOOTH, TRACE_READY, TRACE_READY_TASK_ID);
+    InitParameters();
+    StartTrace(HITRACE_TAG_BLUETOOTH, TRACE_PUBLISH);
     bool res = Publish(this);
-    HILOGI("Publish result is %{public}d.", res);
+    FinishTrace(HITRACE_TAG_BLUETOOTH);
+    HILOGI("Publish result is %{public}d, cost %{public}" PRId64 " ms.", res, GetTickCount() - startMs);
+
+    // 先发布SA，避免客户端加载SA时等待设备配置加载，配置在后台任务中加载完成后再处理请求
+    initTask_ = ffrt::submit_h([this, startMs]() {
+        if (!Init()) {
+            HILOGW("partner device agent is stopped before ready");
+            FinishAsyncTrace(HITRACE_TAG_BLUETOOTH, TRACE_READY, TRACE_READY_TASK_ID);
+            return;
+        }
+        SetReady();
+        FinishAsyncTrace(HITRACE_TAG_BLUETOOTH, TRACE_READY, TRACE_READY_TASK_ID);
+        HILOGI("PartnerDeviceAgentServer is ready, cost %{public}" PRId64 " ms.", GetTickCount() - startMs);
+    }, {}, {}, ffrt::task_attr().name("fcm_partner_agent_init"));
     return;
 }
 
 void PartnerDeviceAgentServer::OnStop()
 {
     HILOGI("stopping service.");
-
+    // 通知后台加载任务停止，并等待任务结束，任务持有 this，不能在下电后继续运行
+    isStopping_ = true;
+    if (initTask_ != nullptr) {
+        ffrt::wait({ initTask_ });
+        initTask_ = nullptr;
+    }
+    eventDispatcher_.UnSubscribe();
+    // 加载未完成时没有处理过请求，配置没有变更，不写入加载了一部分的配置
+    if (!WaitReady(0)) {
+        HILOGW("partner device agent is stopped before ready, stop without flushing");
+        return;
+    }
+    // 下电前将未落盘的配置写入文件
+    configPersister_.Flush();
     return;
 }
 
@@ -408,6 +590,23 @@ int32_t PartnerDeviceAgentServer::OnIdle(const SystemAbilityOnDemandReason& idle
     return 0;
 }
 
+int PartnerDeviceAgentServer::Dump(int fd, const std::vector<std::u16string> &args)
+{
+    // 导出 JSON 格式的设备配置，用于 hidumper 调试
+    std::string content;
+    DumpPartnerDeviceConfig(partnerDeviceMap_, content);
+    content += "\n";
+    // 定时器唤醒次数，用于评估定时器合并的功耗收益
+    TimerManager::Stats timerStats = TimerManager::GetInstance()->GetStats();
+    content += "timer wakeups: " + std::to_string(timerStats.wakeupNum) + ", idle wakeups: " +
+        std::to_string(timerStats.idleWakeupNum) + ", fired timers: " + std::to_string(timerStats.firedNum) + "\n";
+    if (!SaveStringToFd(fd, content)) {
+        HILOGE("dump partner device config failed");
+        return ERR_INVALID_OPERATION;
+    }
+    return ERR_OK;
+}
+
 int32_t PartnerDeviceAgentServer::ConnectExtensionService(const std::string &bundleName, const std::string &abilityName)
 {
     std::string path_ = PARTNER_AGENT_EXTENSION_SERVICE_MODULE_NAME;
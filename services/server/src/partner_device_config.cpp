@@ -14,13 +14,25 @@
  */
 
 #include "partner_device_config.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
 #include "log.h"
+#include "log_util.h"
 #include "file_ex.h"
 #include "datetime_ex.h"
-#include "accesstoken_kit.h"
-#include "access_token_error.h"
 #include "common_utils.h"
-#include "cJSON.h"
+#include "fcm_json_stream.h"
+#include "ffrt_inner.h"
+#include "partner_device_journal.h"
+#include "partner_device_json.h"
+#include "partner_device_snapshot.h"
+#include "permission_manager.h"
 #include "bluetooth_host.h"
 #include "parameter.h"
 #include "parameters.h"
@@ -33,98 +45,145 @@ using namespace OHOS::Bluetooth;
 extern "C" {
 #endif
 
+// 旧版本的 JSON 配置文件，二进制快照不存在时从该文件迁移
 static constexpr const char *PARTNER_DEVICE_CONFIG_PATH =
         "/data/service/el1/public/partner_device_agent/partner_agent_device.xml";
-const int MAX_PARTNER_DEVICE_CONFIG_SIZE = 100;
+static constexpr const char *PARTNER_DEVICE_SNAPSHOT_PATH =
+        "/data/service/el1/public/partner_device_agent/partner_agent_device.bin";
+static constexpr const char *PARTNER_DEVICE_JOURNAL_PATH =
+        "/data/service/el1/public/partner_device_agent/partner_agent_device.journal";
+// 日志超过该大小后压缩为快照
+const size_t MAX_PARTNER_DEVICE_JOURNAL_SIZE = 16 * 1024;
 const int MAX_LOST_TIME_DAYS = 30;
+// 加载配置时每个 ffrt 任务校验的记录数
+const size_t VALIDATE_CHUNK_SIZE = 64;
 std::mutex g_configFileMutex;
+// 日志文件与当前快照匹配，且已知其大小时才允许追加，受 g_configFileMutex 保护
+bool g_isJournalValid = false;
+size_t g_journalSize = 0;
 
-static bool IsPairedDevice(const PartnerDeviceAddress &deviceAddress)
+static bool WriteFileSynced(const std::string &path, const std::string &content, int flags)
 {
-    int pairState = PAIR_NONE;
-    auto device = BluetoothHost::GetDefaultHost().GetRemoteDevice(
-        deviceAddress.GetAddress(), Bluetooth::BTTransport::ADAPTER_BREDR);
-    device.GetPairState(pairState);
-    return pairState == PAIR_PAIRED;
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        HILOGE("open config file failed, errno: %{public}d", errno);
+        return false;
+    }
+    bool ret = SaveStringToFd(fd, content) && fsync(fd) == 0;
+    if (!ret) {
+        HILOGE("write config file failed, errno: %{public}d", errno);
+    }
+    close(fd);
+    return ret;
 }
 
-static void JsonAddDeviceCapabilityToObject(cJSON *item, PartnerDevice::DeviceInfo &deviceInfo)
+// 先写临时文件并落盘，再原子替换目标文件，避免掉电或进程退出时文件被写坏
+static bool SaveFileAtomically(const std::string &path, const std::string &content)
 {
-    cJSON *capability = cJSON_CreateObject();
-    if (!capability) {
-        HILOGE("capability is nullptr");
-        return;
+    std::string tempPath = path + ".tmp";
+    if (!WriteFileSynced(tempPath, content, O_TRUNC)) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    if (rename(tempPath.c_str(), path.c_str()) != 0) {
+        HILOGE("rename temp config file failed, errno: %{public}d", errno);
+        unlink(tempPath.c_str());
+        return false;
     }
-    cJSON_AddBoolToObject(capability, "isSupportBR", deviceInfo.capability.isSupportBR);
-    cJSON_AddBoolToObject(capability, "isSupportBleAdvertiser", deviceInfo.capability.isSupportBleAdvertiser);
-    cJSON_AddItemToObject(item, "capability", capability);
+    return true;
 }
 
-static void JsonAddBusinessCapabilityToObject(cJSON *item, PartnerDevice::DeviceInfo &deviceInfo)
+// 写入快照并重置日志，调用者持有 g_configFileMutex
+// 新日志头记录新快照的校验值：快照替换前掉电，旧日志仍匹配旧快照；快照替换后掉电，旧日志不匹配新快照而被忽略
+static bool SaveSnapshotAndResetJournal(const std::string &content)
 {
-    cJSON *businessCapability = cJSON_CreateObject();
-    if (!businessCapability) {
-        HILOGE("businessCapability is nullptr");
-        return;
+    g_isJournalValid = false;
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendHeader(writer, content);
+    const std::string &header = writer.GetBuffer();
+    std::string journalTempPath = std::string(PARTNER_DEVICE_JOURNAL_PATH) + ".tmp";
+    if (!WriteFileSynced(journalTempPath, header, O_TRUNC)) {
+        unlink(journalTempPath.c_str());
+        return SaveFileAtomically(PARTNER_DEVICE_SNAPSHOT_PATH, content);
+    }
+    if (!SaveFileAtomically(PARTNER_DEVICE_SNAPSHOT_PATH, content)) {
+        unlink(journalTempPath.c_str());
+        return false;
     }
-    cJSON_AddBoolToObject(
-        businessCapability, "isSupportMediaControl", deviceInfo.businessCapability.isSupportMediaControl);
-    cJSON_AddBoolToObject(
-        businessCapability, "isSupportTelephonyControl", deviceInfo.businessCapability.isSupportTelephonyControl);
-    cJSON_AddItemToObject(item, "businessCapability", businessCapability);
+    // 快照已落盘，旧版本的 JSON 配置文件已迁移完成
+    (void)unlink(PARTNER_DEVICE_CONFIG_PATH);
+    if (rename(journalTempPath.c_str(), PARTNER_DEVICE_JOURNAL_PATH) != 0) {
+        HILOGE("rename temp journal file failed, errno: %{public}d", errno);
+        unlink(journalTempPath.c_str());
+        return true;
+    }
+    g_isJournalValid = true;
+    g_journalSize = header.size();
+    return true;
 }
 
-void UpdatePartnerDeviceConfig(PartnerDeviceMap &deviceMap)
-{
-    cJSON *root = cJSON_CreateArray();
-    FCM_CHECK_RETURN(root, "root is nullptr");
+// 校验通过的设备信息及其所属用户
+struct ValidatedDevice {
+    bool isValid = false;
+    int32_t userId = INVALID_USER_ID;
+    FcmMacAddress macAddress;
+    PartnerDevice::DeviceInfo deviceInfo;
+};
 
-    deviceMap.Iterate([root](const PartnerDeviceMapKey &key, std::shared_ptr<PartnerDevice> &deviceSptr) {
-        FCM_CHECK_RETURN(deviceSptr, "deviceSptr is nullptr");
-        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
+// 记录中的字符串指向 deviceInfo 和 address，使用记录期间两者不能修改
+static PartnerDeviceRecord MakeDeviceRecord(const PartnerDevice::DeviceInfo &deviceInfo, const std::string &address)
+{
+    PartnerDeviceRecord record;
+    record.bundleName = deviceInfo.bundleName;
+    record.abilityName = deviceInfo.abilityName;
+    record.address = address;
+    record.tokenId = deviceInfo.tokenId;
+    record.addressType = static_cast<int32_t>(deviceInfo.deviceAddress.GetAddressType());
+    record.hasRawAddressType = deviceInfo.deviceAddress.HasRawAddressType();
+    if (record.hasRawAddressType) {
+        record.rawAddressType = static_cast<int32_t>(deviceInfo.deviceAddress.GetRawAddressType());
+    }
+    record.registerTimestamp = deviceInfo.registerTimestamp;
+    record.lostTimestamp = deviceInfo.lostTimestamp;
+    record.isUserEnabled = deviceInfo.isUserEnabled;
+    record.isSupportBR = deviceInfo.capability.isSupportBR;
+    record.isSupportBleAdvertiser = deviceInfo.capability.isSupportBleAdvertiser;
+    record.isSupportMediaControl = deviceInfo.businessCapability.isSupportMediaControl;
+    record.isSupportTelephonyControl = deviceInfo.businessCapability.isSupportTelephonyControl;
+    return record;
+}
 
-        cJSON *item = cJSON_CreateObject();
-        cJSON_AddStringToObject(item, "version", "1.0");
-        cJSON_AddStringToObject(item, "bundleName", deviceInfo.bundleName.c_str());
-        cJSON_AddStringToObject(item, "abilityName", deviceInfo.abilityName.c_str());
-        {
-            cJSON *addressInfo = cJSON_CreateObject();
-            std::string address = deviceInfo.deviceAddress.GetAddress();
-            cJSON_AddStringToObject(addressInfo, "address", address.c_str());
-            cJSON_AddNumberToObject(
-                addressInfo, "addressType", static_cast<int>(deviceInfo.deviceAddress.GetAddressType()));
-            if (deviceInfo.deviceAddress.HasRawAddressType()) {
-                cJSON_AddNumberToObject(
-                    addressInfo, "rawAddressType", static_cast<int>(deviceInfo.deviceAddress.GetRawAddressType()));
-            }
-            cJSON_AddItemToObject(item, "addressInfo", addressInfo);
-        }
-        cJSON_AddNumberToObject(item, "tokenId", deviceInfo.tokenId);
-        cJSON_AddNumberToObject(item, "registerTimestamp", deviceInfo.registerTimestamp);
-        if (deviceInfo.lostTimestamp > 0) {
-            cJSON_AddNumberToObject(item, "lostTimestamp", deviceInfo.lostTimestamp);
-        }
-        cJSON_AddBoolToObject(item, "isUserEnabled", deviceInfo.isUserEnabled);
-        JsonAddDeviceCapabilityToObject(item, deviceInfo);
-        JsonAddBusinessCapabilityToObject(item, deviceInfo);
+static std::string EncodeDeviceInfos(const std::vector<PartnerDevice::DeviceInfo> &deviceInfos)
+{
+    std::vector<std::string> addresses;
+    addresses.reserve(deviceInfos.size());
+    for (const auto &deviceInfo : deviceInfos) {
+        addresses.push_back(deviceInfo.deviceAddress.GetAddress());
+    }
+    std::vector<PartnerDeviceRecord> records;
+    records.reserve(deviceInfos.size());
+    for (size_t i = 0; i < deviceInfos.size(); i++) {
+        records.push_back(MakeDeviceRecord(deviceInfos[i], addresses[i]));
+    }
+    return PartnerDeviceSnapshot::Encode(records);
+}
 
-        cJSON_AddItemToArray(root, item);
+void UpdatePartnerDeviceConfig(PartnerDeviceRegistry &deviceMap)
+{
+    std::vector<PartnerDevice::DeviceInfo> deviceInfos;
+    deviceInfos.reserve(deviceMap.Size());
+    deviceMap.Iterate([&deviceInfos](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &deviceSptr) {
+        FCM_CHECK_RETURN(deviceSptr, "deviceSptr is nullptr");
+        deviceInfos.push_back(deviceSptr->GetDeviceInfo());
     });
-
-    char *jsonString = cJSON_Print(root);
-    if (jsonString == nullptr) {
-        cJSON_Delete(root);
-        return;
-    }
+    std::string content = EncodeDeviceInfos(deviceInfos);
+    FCM_CHECK_RETURN(!content.empty(), "encode partner device config failed");
     {
         // 写文件持久化
         std::lock_guard<std::mutex> lock(g_configFileMutex);
-        SaveStringToFile(PARTNER_DEVICE_CONFIG_PATH, jsonString);
+        SaveSnapshotAndResetJournal(content);
     }
 
-    cJSON_free(jsonString);
-    cJSON_Delete(root);
-
     // 写配置参数，避免SA被无效拉起，导致应用页面加载时间变长
     std::string sizeStr = std::to_string(deviceMap.Size());
     SetParameter("persist.fusion_connectivity.partner_agent_devices", sizeStr.c_str());
@@ -134,206 +193,324 @@ void ClearPartnerDeviceConfig()
 {
     // 写文件持久化
     std::lock_guard<std::mutex> lock(g_configFileMutex);
-    SaveStringToFile(PARTNER_DEVICE_CONFIG_PATH, "[]");
+    SaveSnapshotAndResetJournal(PartnerDeviceSnapshot::Encode({}));
 }
 
-int ParseAddressInfoJsonObject(const cJSON *addressInfo, PartnerDeviceAddress &deviceAddress)
+void DumpPartnerDeviceConfig(PartnerDeviceRegistry &deviceMap, std::string &content)
 {
-    const cJSON *address = cJSON_GetObjectItemCaseSensitive(addressInfo, "address");
-    const cJSON *addressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "addressType");
-    // rawAddressType 是可选参数
-    const cJSON *rawAddressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "rawAddressType");
-    bool isCheckFail = !cJSON_IsString(address) || !cJSON_IsNumber(addressType) ||
-        (rawAddressType != nullptr && !cJSON_IsNumber(rawAddressType));
-    if (isCheckFail) {
-        HILOGE("Invalid addressInfo format.");
-        return FCM_ERR_INTERNAL_ERROR;
-    }
-    if (!IsValidAddress(address->valuestring)) {
-        HILOGE("Invalid address");
-        return FCM_ERR_INTERNAL_ERROR;
-    }
-    if (addressType->valueint < static_cast<int>(BluetoothAddressType::VIRTUAL) ||
-        addressType->valueint > static_cast<int>(BluetoothAddressType::REAL)) {
-        HILOGE("Invalid addressType: %{public}d", addressType->valueint);
-        return FCM_ERR_INTERNAL_ERROR;
+    // 调试导出使用与日志记录相同的 JSON 格式，导出内容可能被抓取，地址按日志规则脱敏，不导出tokenId
+    FcmJsonWriter writer;
+    writer.BeginArray();
+    deviceMap.Iterate([&writer](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &deviceSptr) {
+        FCM_CHECK_RETURN(deviceSptr, "deviceSptr is nullptr");
+        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
+        std::string address = GetEncryptAddr(deviceInfo.deviceAddress.GetAddress());
+        PartnerDeviceRecord record = MakeDeviceRecord(deviceInfo, address);
+        record.tokenId = 0;
+        PartnerDeviceJson::WriteDevice(writer, record);
+    });
+    writer.EndArray();
+    content = writer.GetBuffer();
+}
+
+void AppendPartnerDeviceJournal(PartnerDeviceRegistry &deviceMap, const std::set<PartnerDeviceMapKey> &dirtyKeys)
+{
+    // 每条记录只包含变更的设备，写入量与已绑定设备数量无关，所有记录写入同一个缓冲区
+    FcmJsonWriter writer;
+    for (const auto &key : dirtyKeys) {
+        std::shared_ptr<PartnerDevice> deviceSptr = nullptr;
+        if (!deviceMap.Find(key, deviceSptr) || deviceSptr == nullptr) {
+            PartnerDeviceJournal::AppendDelRecord(writer, key.first, key.second.ToString());
+            continue;
+        }
+        PartnerDevice::DeviceInfo deviceInfo = deviceSptr->GetDeviceInfo();
+        std::string address = deviceInfo.deviceAddress.GetAddress();
+        PartnerDeviceJournal::AppendPutRecord(writer, MakeDeviceRecord(deviceInfo, address));
     }
-    deviceAddress = PartnerDeviceAddress(
-        address->valuestring, static_cast<BluetoothAddressType>(addressType->valueint));
-    if (rawAddressType != nullptr) {
-        if (rawAddressType->valueint < static_cast<int>(BluetoothRawAddressType::PUBLIC) ||
-            rawAddressType->valueint > static_cast<int>(BluetoothRawAddressType::RANDOM)) {
-            HILOGE("Invalid rawAddressType: %{public}d", rawAddressType->valueint);
-            return FCM_ERR_INTERNAL_ERROR;
+    const std::string &records = writer.GetBuffer();
+
+    bool isNeedCompact = false;
+    {
+        std::lock_guard<std::mutex> lock(g_configFileMutex);
+        if (!g_isJournalValid || !WriteFileSynced(PARTNER_DEVICE_JOURNAL_PATH, records, O_APPEND)) {
+            isNeedCompact = true;
+        } else {
+            g_journalSize += records.size();
+            isNeedCompact = g_journalSize > MAX_PARTNER_DEVICE_JOURNAL_SIZE;
         }
-        deviceAddress = PartnerDeviceAddress(
-            address->valuestring,
-            static_cast<BluetoothAddressType>(addressType->valueint),
-            static_cast<BluetoothRawAddressType>(rawAddressType->valueint));
     }
-    return FCM_NO_ERROR;
+    if (isNeedCompact) {
+        // 日志不可用或超过阈值时，重写快照并重置日志
+        UpdatePartnerDeviceConfig(deviceMap);
+        return;
+    }
+    std::string sizeStr = std::to_string(deviceMap.Size());
+    SetParameter("persist.fusion_connectivity.partner_agent_devices", sizeStr.c_str());
 }
 
-int ParseDeviceCapability(const cJSON *capability, DeviceCapability &deviceCapability)
+static int MakePartnerDeviceAddress(const std::string &address, int addressType, bool hasRawAddressType,
+    int rawAddressType, PartnerDeviceAddress &deviceAddress)
 {
-    const cJSON *isSupportBR = cJSON_GetObjectItemCaseSensitive(capability, "isSupportBR");
-    const cJSON *isSupportBleAdvertiser = cJSON_GetObjectItemCaseSensitive(capability, "isSupportBleAdvertiser");
-    bool isCheckFail = !cJSON_IsBool(isSupportBR) || !cJSON_IsBool(isSupportBleAdvertiser);
-    if (isCheckFail) {
-        HILOGE("Invalid capability format.");
+    if (addressType < static_cast<int>(BluetoothAddressType::VIRTUAL) ||
+        addressType > static_cast<int>(BluetoothAddressType::REAL)) {
+        HILOGE("Invalid addressType: %{public}d", addressType);
         return FCM_ERR_INTERNAL_ERROR;
     }
-    deviceCapability.isSupportBR = static_cast<bool>(isSupportBR->valueint);
-    deviceCapability.isSupportBleAdvertiser = static_cast<bool>(isSupportBleAdvertiser->valueint);
-    return FCM_NO_ERROR;
-}
-
-int ParseBusinessCapability(const cJSON *businessCapabilityJson, BusinessCapability &businessCapability)
-{
-    const cJSON *isSupportMediaControl =
-        cJSON_GetObjectItemCaseSensitive(businessCapabilityJson, "isSupportMediaControl");
-    const cJSON *isSupportTelephonyControl =
-        cJSON_GetObjectItemCaseSensitive(businessCapabilityJson, "isSupportTelephonyControl");
-    bool isCheckFail = !cJSON_IsBool(isSupportMediaControl) || !cJSON_IsBool(isSupportTelephonyControl);
-    if (isCheckFail) {
-        HILOGE("Invalid business capability format.");
+    if (!hasRawAddressType) {
+        deviceAddress = PartnerDeviceAddress(address, static_cast<BluetoothAddressType>(addressType));
+        return FCM_NO_ERROR;
+    }
+    if (rawAddressType < static_cast<int>(BluetoothRawAddressType::PUBLIC) ||
+        rawAddressType > static_cast<int>(BluetoothRawAddressType::RANDOM)) {
+        HILOGE("Invalid rawAddressType: %{public}d", rawAddressType);
         return FCM_ERR_INTERNAL_ERROR;
     }
-    businessCapability.isSupportMediaControl = static_cast<bool>(isSupportMediaControl->valueint);
-    businessCapability.isSupportTelephonyControl = static_cast<bool>(isSupportTelephonyControl->valueint);
+    deviceAddress = PartnerDeviceAddress(address, static_cast<BluetoothAddressType>(addressType),
+        static_cast<BluetoothRawAddressType>(rawAddressType));
     return FCM_NO_ERROR;
 }
 
-static bool IsValidAppTokenId(uint32_t tokenId)
-{
-    OHOS::Security::AccessToken::HapTokenInfo hapTokenInfo;
-    int ret = OHOS::Security::AccessToken::AccessTokenKit::GetHapTokenInfo(tokenId, hapTokenInfo);
-    return ret != OHOS::Security::AccessToken::ERR_TOKENID_NOT_EXIST;
-}
-
-int ParseLostTimestamp(
-    const cJSON *lostTimestamp, const PartnerDeviceAddress &deviceAddress, PartnerDevice::DeviceInfo &deviceInfo)
+// lostTimestamp 为 0 表示设备未丢失
+int CheckLostTimestamp(int64_t lostTimestamp, const FcmMacAddress &macAddress,
+    const PairedDevices &pairedDevices, PartnerDevice::DeviceInfo &deviceInfo)
 {
-    if (cJSON_IsNumber(lostTimestamp)) {
+    if (lostTimestamp > 0) {
         int64_t now = GetDaysSince1970ToNow();
-        if (now - lostTimestamp->valueint > MAX_LOST_TIME_DAYS) {
+        if (now - lostTimestamp > MAX_LOST_TIME_DAYS) {
             HILOGE("The device has been unpaired for more than 30 days; delete it.");
             return FCM_ERR_INTERNAL_ERROR;
         }
-        deviceInfo.lostTimestamp = lostTimestamp->valueint;
-    } else {
-        deviceInfo.lostTimestamp = 0;
     }
+    deviceInfo.lostTimestamp = lostTimestamp;
     // 在SA下电期间，该设备已重新配对上
-    if (IsPairedDevice(deviceAddress)) {
+    if (pairedDevices.Contains(macAddress)) {
         deviceInfo.lostTimestamp = 0;
     }
     return FCM_NO_ERROR;
 }
 
-int ParsePartnerDeviceInfo(cJSON *root, int index, PartnerDevice::DeviceInfo &deviceInfo)
+static int ParsePartnerDeviceRecord(const PartnerDeviceRecord &record, const PairedDevices &pairedDevices,
+    PartnerDevice::DeviceInfo &deviceInfo, FcmMacAddress &macAddress)
 {
-    cJSON *item = cJSON_GetArrayItem(root, index);
-    FCM_CHECK_RETURN_RET(item, FCM_ERR_INTERNAL_ERROR, "Failed to get array item (%{public}d).", index);
-
-    const cJSON *version = cJSON_GetObjectItemCaseSensitive(item, "version");
-    const cJSON *bundleName = cJSON_GetObjectItemCaseSensitive(item, "bundleName");
-    const cJSON *abilityName = cJSON_GetObjectItemCaseSensitive(item, "abilityName");
-    const cJSON *addressInfo = cJSON_GetObjectItemCaseSensitive(item, "addressInfo");
-    const cJSON *tokenId = cJSON_GetObjectItemCaseSensitive(item, "tokenId");
-    const cJSON *registerTimestamp = cJSON_GetObjectItemCaseSensitive(item, "registerTimestamp");
-    const cJSON *lostTimestamp = cJSON_GetObjectItemCaseSensitive(item, "lostTimestamp");
-    const cJSON *capability = cJSON_GetObjectItemCaseSensitive(item, "capability");
-    const cJSON *businessCapabilityJson = cJSON_GetObjectItemCaseSensitive(item, "businessCapability");
-    const cJSON *isUserEnabled = cJSON_GetObjectItemCaseSensitive(item, "isUserEnabled");
-    // 检查字段是否存在
-    bool isCheckFail = !cJSON_IsString(version) || !cJSON_IsString(bundleName) || !cJSON_IsString(abilityName) ||
-        !cJSON_IsObject(addressInfo) || !cJSON_IsNumber(tokenId) || !cJSON_IsNumber(registerTimestamp) ||
-        !cJSON_IsObject(capability) || !cJSON_IsBool(isUserEnabled);
-    if (isCheckFail) {
-        HILOGE("Invalid JSON format.");
+    if (!FcmMacAddress::FromString(record.address, macAddress)) {
+        HILOGE("Invalid address");
         return FCM_ERR_INTERNAL_ERROR;
     }
-    // 解析 addressInfo 对象
     PartnerDeviceAddress deviceAddress;
-    if (ParseAddressInfoJsonObject(addressInfo, deviceAddress) != FCM_NO_ERROR) {
-        return FCM_ERR_INTERNAL_ERROR;
-    }
-    // 解析 capability 对象
-    DeviceCapability deviceCapability;
-    if (ParseDeviceCapability(capability, deviceCapability) != FCM_NO_ERROR) {
-        return FCM_ERR_INTERNAL_ERROR;
-    }
-    // 解析 businessCapability 对象
-    BusinessCapability businessCapability;
-    if (ParseBusinessCapability(businessCapabilityJson, businessCapability) != FCM_NO_ERROR) {
-        return FCM_ERR_INTERNAL_ERROR;
-    }
-    // 检查tokenid是否有效
-    if (!IsValidAppTokenId(tokenId->valueint)) {
-        HILOGE("Invalid tokenId: %{public}d, app is uninstall", tokenId->valueint);
+    if (MakePartnerDeviceAddress(std::string(record.address), record.addressType, record.hasRawAddressType,
+        record.rawAddressType, deviceAddress) != FCM_NO_ERROR) {
         return FCM_ERR_INTERNAL_ERROR;
     }
     // 检查 lostTimestamp 注册是否失效
-    if (ParseLostTimestamp(lostTimestamp, deviceAddress, deviceInfo) != FCM_NO_ERROR) {
+    if (CheckLostTimestamp(record.lostTimestamp, macAddress, pairedDevices, deviceInfo) != FCM_NO_ERROR) {
         return FCM_ERR_INTERNAL_ERROR;
     }
 
-    deviceInfo.bundleName = bundleName->valuestring;
-    deviceInfo.abilityName = abilityName->valuestring;
+    deviceInfo.bundleName = std::string(record.bundleName);
+    deviceInfo.abilityName = std::string(record.abilityName);
     deviceInfo.deviceAddress = deviceAddress;
-    deviceInfo.tokenId = tokenId->valueint;
-    deviceInfo.registerTimestamp = registerTimestamp->valueint;
-    deviceInfo.isUserEnabled = static_cast<bool>(isUserEnabled->valueint);
-    deviceInfo.capability = deviceCapability;
-    deviceInfo.businessCapability = businessCapability;
+    deviceInfo.tokenId = record.tokenId;
+    deviceInfo.registerTimestamp = record.registerTimestamp;
+    deviceInfo.isUserEnabled = record.isUserEnabled;
+    deviceInfo.capability.isSupportBR = record.isSupportBR;
+    deviceInfo.capability.isSupportBleAdvertiser = record.isSupportBleAdvertiser;
+    deviceInfo.businessCapability.isSupportMediaControl = record.isSupportMediaControl;
+    deviceInfo.businessCapability.isSupportTelephonyControl = record.isSupportTelephonyControl;
     return FCM_NO_ERROR;
 }
 
-void LoadPartnerDeviceConfig(PartnerDeviceMap &deviceMap, CreatePartnerDeviceFunc createPartnerDeviceFunc)
+// 合并快照记录与日志回放结果，被日志修改或删除的设备以日志为准
+static void MergeRecords(const std::vector<PartnerDeviceRecord> &records, const PartnerDeviceJournal::Overlay &overlay,
+    std::vector<PartnerDeviceRecord> &mergedRecords)
+{
+    mergedRecords.reserve(records.size() + overlay.size());
+    for (const auto &record : records) {
+        // 地址无效的记录不会被日志修改，保留到校验时丢弃
+        FcmMacAddress macAddress;
+        if (!FcmMacAddress::FromString(record.address, macAddress) ||
+            overlay.find(std::make_pair(record.tokenId, macAddress)) == overlay.end()) {
+            mergedRecords.push_back(record);
+        }
+    }
+    for (const auto &[key, deviceItem] : overlay) {
+        if (deviceItem.has_value()) {
+            mergedRecords.push_back(deviceItem->GetRecord());
+        }
+    }
+}
+
+// 并行查询应用所属的用户，每个应用只查询一次；应用已卸载时为 nullopt
+static std::unordered_map<uint32_t, std::optional<int32_t>> GetAppUserIds(
+    const std::vector<PartnerDeviceRecord> &records)
 {
-    std::string fileContent;
+    std::vector<uint32_t> tokenIds;
+    tokenIds.reserve(records.size());
+    for (const auto &record : records) {
+        tokenIds.push_back(record.tokenId);
+    }
+    std::sort(tokenIds.begin(), tokenIds.end());
+    tokenIds.erase(std::unique(tokenIds.begin(), tokenIds.end()), tokenIds.end());
+    std::vector<std::optional<int32_t>> userIds(tokenIds.size());
+    for (size_t i = 0; i < tokenIds.size(); i++) {
+        ffrt::submit([&tokenIds, &userIds, i]() {
+            int32_t userId = INVALID_USER_ID;
+            if (PermissionManager::GetHapUserId(tokenIds[i], userId)) {
+                userIds[i] = userId;
+            }
+        });
+    }
+    ffrt::wait();
+
+    std::unordered_map<uint32_t, std::optional<int32_t>> appUserIds;
+    for (size_t i = 0; i < tokenIds.size(); i++) {
+        if (!userIds[i].has_value()) {
+            HILOGE("Invalid tokenId: %{public}u, app is uninstall", tokenIds[i]);
+        }
+        appUserIds.emplace(tokenIds[i], userIds[i]);
+    }
+    return appUserIds;
+}
+
+// 按注册时间从早到晚排序后，在 ffrt 任务中分片并行校验记录，结果与排序后的记录一一对应
+static void ValidateRecords(std::vector<PartnerDeviceRecord> &records, const PairedDevices &pairedDevices,
+    std::vector<ValidatedDevice> &devices)
+{
+    std::stable_sort(records.begin(), records.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.registerTimestamp < rhs.registerTimestamp;
+    });
+    auto appUserIds = GetAppUserIds(records);
+    devices.resize(records.size());
+    for (size_t begin = 0; begin < records.size(); begin += VALIDATE_CHUNK_SIZE) {
+        size_t end = std::min(begin + VALIDATE_CHUNK_SIZE, records.size());
+        ffrt::submit([&records, &devices, &appUserIds, &pairedDevices, begin, end]() {
+            for (size_t i = begin; i < end; i++) {
+                const auto &userId = appUserIds.at(records[i].tokenId);
+                // 解析失败时清除虚拟MAC固化
+                if (!userId.has_value() ||
+                    ParsePartnerDeviceRecord(records[i], pairedDevices, devices[i].deviceInfo,
+                    devices[i].macAddress) != FCM_NO_ERROR) {
+                    continue;
+                }
+                devices[i].userId = userId.value();
+                devices[i].isValid = true;
+            }
+        });
+    }
+    ffrt::wait();
+}
+
+// 按注册时间从早到晚创建设备，超出应用或用户配额时丢弃后注册的设备，不影响其他应用和用户
+static void CreateDevices(std::vector<ValidatedDevice> &devices, const PartnerDeviceQuota &quota,
+    const PairedDevices &pairedDevices, bool isBluetoothOn, const CreatePartnerDeviceFunc &createPartnerDeviceFunc,
+    std::vector<PartnerDeviceRegistry::Entry> &entries)
+{
+    PartnerDeviceQuota::Counter quotaCounter(quota);
+    size_t overQuotaNum = 0;
+    entries.reserve(devices.size());
+    for (auto &device : devices) {
+        if (!device.isValid) {
+            continue;
+        }
+        if (!quotaCounter.TryAccept(device.deviceInfo.tokenId, device.userId)) {
+            overQuotaNum++;
+            continue;
+        }
+        // 蓝牙关闭或用户关闭的设备保持休眠，无需判断配对状态，蓝牙打开时按已配对设备列表重新判断
+        bool isPaired = isBluetoothOn && device.deviceInfo.isUserEnabled && pairedDevices.Contains(device.macAddress);
+        auto deviceSptr = createPartnerDeviceFunc(device.deviceInfo, isPaired, isBluetoothOn);
+        if (deviceSptr == nullptr) {
+            continue;
+        }
+        entries.push_back({ deviceSptr->GetKey(), device.userId, deviceSptr });
+    }
+    if (overQuotaNum > 0) {
+        HILOGW("drop %{public}zu partner devices over quota", overQuotaNum);
+    }
+}
+
+// 流式解析旧版本的 JSON 配置文件，用于迁移；记录中的字符串指向 items
+static bool ParseJsonRecords(std::string_view content, std::vector<PartnerDeviceJsonItem> &items,
+    std::vector<PartnerDeviceRecord> &records)
+{
+    FcmJsonReader reader(content);
+    if (reader.BeginArray()) {
+        PartnerDeviceJsonItem item;
+        while (reader.NextElement()) {
+            // 格式无效的设备跳过，与其他设备无关
+            if (PartnerDeviceJson::ReadDevice(reader, item)) {
+                items.push_back(item);
+            }
+        }
+    }
+    if (reader.HasError() || !reader.IsEnd()) {
+        HILOGE("parse partner device config failed");
+        return false;
+    }
+    records.reserve(items.size());
+    for (const auto &item : items) {
+        records.push_back(item.GetRecord());
+    }
+    return true;
+}
+
+void LoadPartnerDeviceConfig(PartnerDeviceRegistry &deviceMap, const PartnerDeviceQuota &quota,
+    CreatePartnerDeviceFunc createPartnerDeviceFunc)
+{
+    int64_t beginMs = GetTickCount();
+    std::unique_ptr<PartnerDeviceSnapshotFile> snapshotFile = nullptr;
+    std::string jsonContent;
+    std::string journalContent;
     {
         std::lock_guard<std::mutex> lock(g_configFileMutex);
-        bool ret = LoadStringFromFile(PARTNER_DEVICE_CONFIG_PATH, fileContent);
-        if (!ret) {
+        snapshotFile = std::make_unique<PartnerDeviceSnapshotFile>(PARTNER_DEVICE_SNAPSHOT_PATH);
+        // 二进制快照不存在时，从旧版本的 JSON 配置文件迁移
+        if (!snapshotFile->IsMapped() && !LoadStringFromFile(PARTNER_DEVICE_CONFIG_PATH, jsonContent)) {
             HILOGE("load partner device config failed");
             return;
         }
+        // 日志文件不存在时只加载快照
+        (void)LoadStringFromFile(PARTNER_DEVICE_JOURNAL_PATH, journalContent);
     }
-    // 解析 JSON 字符串
-    cJSON *root = cJSON_Parse(fileContent.c_str());
-    if (root == nullptr) {
-        const char *errorPtr = cJSON_GetErrorPtr();
-        if (errorPtr != NULL) {
-            HILOGE("parse partner device config failed, %{public}s", errorPtr);
-        }
-        ClearPartnerDeviceConfig();
-        return;
-    }
-    int size = cJSON_GetArraySize(root);
-    if (size > MAX_PARTNER_DEVICE_CONFIG_SIZE) {
-        HILOGE("partner device config size reach max, there may be resource leaks.");
+    // 快照记录直接指向映射的文件内容，JSON 记录指向 jsonItems
+    std::string_view content = snapshotFile->IsMapped() ? snapshotFile->GetContent() : std::string_view(jsonContent);
+    std::vector<PartnerDeviceJsonItem> jsonItems;
+    std::vector<PartnerDeviceRecord> records;
+    bool ret = snapshotFile->IsMapped() ?
+        PartnerDeviceSnapshot::Decode(content, records) : ParseJsonRecords(content, jsonItems, records);
+    if (!ret) {
+        HILOGE("decode partner device config failed");
+        snapshotFile = nullptr;
         ClearPartnerDeviceConfig();
-        cJSON_Delete(root);
         return;
     }
+    PartnerDeviceJournal::Overlay overlay;
+    int replayCount = PartnerDeviceJournal::Replay(content, journalContent, overlay);
+    std::vector<PartnerDeviceRecord> mergedRecords;
+    MergeRecords(records, overlay, mergedRecords);
+    int64_t decodeEndMs = GetTickCount();
 
-    for (int i = 0; i < size; i++) {
-        PartnerDevice::DeviceInfo deviceInfo;
-        int ret = ParsePartnerDeviceInfo(root, i, deviceInfo);
-        if (ret != FCM_NO_ERROR) {
-            // 清除虚拟MAC固化
-            continue;
-        }
-        auto key = std::make_pair(deviceInfo.tokenId, deviceInfo.deviceAddress.GetAddress());
-        deviceMap.EnsureInsert(key, createPartnerDeviceFunc(deviceInfo));
-    }
+    // 已配对设备列表和蓝牙状态只获取一次，校验和创建设备时不再逐个查询
+    PairedDevices pairedDevices = PairedDevices::Get();
+    bool isBluetoothOn = BluetoothHost::GetDefaultHost().GetBluetoothState() == BluetoothState::STATE_ON;
+    std::vector<ValidatedDevice> devices;
+    ValidateRecords(mergedRecords, pairedDevices, devices);
+    // 设备信息已拷贝，解除文件映射
+    snapshotFile = nullptr;
+    int64_t validateEndMs = GetTickCount();
+
+    std::vector<PartnerDeviceRegistry::Entry> entries;
+    CreateDevices(devices, quota, pairedDevices, isBluetoothOn, createPartnerDeviceFunc, entries);
+    // 一次性发布注册表快照
+    deviceMap.EnsureInsertBatch(entries);
+    int64_t createEndMs = GetTickCount();
+    HILOGI("load %{public}zu of %{public}zu partner devices, replay %{public}d journal records, "
+        "decode: %{public}" PRId64 " ms, validate: %{public}" PRId64 " ms, create: %{public}" PRId64 " ms",
+        entries.size(), mergedRecords.size(), replayCount, decodeEndMs - beginMs, validateEndMs - decodeEndMs,
+        createEndMs - validateEndMs);
 
-    // 释放内存
-    cJSON_Delete(root);
-    // 重新刷新配置文件
+    // 重新刷新配置文件，同时压缩日志，旧版本的 JSON 配置文件在此时迁移为二进制快照
     UpdatePartnerDeviceConfig(deviceMap);
+    HILOGI("update partner device config: %{public}" PRId64 " ms", GetTickCount() - createEndMs);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceConfigPersister"
+#endif
+
+#include "partner_device_config_persister.h"
+#include "log.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr uint64_t MILLISEC_2_MICROSEC = 1000;
+}  // namespace
+
+PartnerDeviceConfigPersister::PartnerDeviceConfigPersister(const PersistFunc &persistFunc, uint32_t coalesceWindowMs)
+    : persistFunc_(persistFunc), coalesceWindowMs_(coalesceWindowMs)
+{
+    queue_ = std::make_unique<ffrt::queue>("fcm_config_persister");
+}
+
+PartnerDeviceConfigPersister::~PartnerDeviceConfigPersister()
+{
+    // 析构队列时等待正在执行的写任务结束
+    queue_ = nullptr;
+}
+
+void PartnerDeviceConfigPersister::MarkDirty(const PartnerDeviceMapKey &key)
+{
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex_);
+        dirtyKeys_.insert(key);
+    }
+    ScheduleWrite();
+}
+
+void PartnerDeviceConfigPersister::ScheduleWrite()
+{
+    // 窗口内已有待执行的写任务，合并到该任务中
+    if (isScheduled_.exchange(true)) {
+        return;
+    }
+    ffrt::task_attr taskAttr;
+    taskAttr.name("fcm_config_write").delay(static_cast<uint64_t>(coalesceWindowMs_.load()) * MILLISEC_2_MICROSEC);
+    queue_->submit([this]() {
+        isScheduled_ = false;
+        WriteIfDirty();
+    }, taskAttr);
+}
+
+void PartnerDeviceConfigPersister::Flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex_);
+        if (dirtyKeys_.empty()) {
+            return;
+        }
+    }
+    // 在队列中执行，与延迟写任务串行
+    auto handle = queue_->submit_h([this]() {
+        WriteIfDirty();
+    });
+    if (handle == nullptr) {
+        HILOGE("ffrt queue submit failed");
+        return;
+    }
+    queue_->wait(handle);
+}
+
+void PartnerDeviceConfigPersister::SetCoalesceWindow(uint32_t coalesceWindowMs)
+{
+    coalesceWindowMs_ = coalesceWindowMs;
+}
+
+uint64_t PartnerDeviceConfigPersister::GetWriteCount() const
+{
+    return writeCount_.load();
+}
+
+void PartnerDeviceConfigPersister::WriteIfDirty()
+{
+    // 先取出脏数据，写入期间新的变更会触发下一次写入
+    std::set<PartnerDeviceMapKey> dirtyKeys;
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex_);
+        if (dirtyKeys_.empty()) {
+            return;
+        }
+        dirtyKeys.swap(dirtyKeys_);
+    }
+    if (persistFunc_) {
+        persistFunc_(dirtyKeys);
+    }
+    writeCount_++;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
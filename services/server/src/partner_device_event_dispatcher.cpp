@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceEventDispatcher"
+#endif
+
+#include "partner_device_event_dispatcher.h"
+#include "log.h"
+#include "log_util.h"
+#include "partner_device.h"
+#include "partner_device_presence_engine.h"
+#include "partner_device_scan_policy.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+using namespace OHOS::Bluetooth;
+
+namespace {
+// 热管理服务以 ThermalCommonEventCode::CODE_THERMAL_LEVEL_CHANGED 的值作为温度等级的参数名
+constexpr const char *THERMAL_LEVEL_PARAM = "0";
+constexpr int THERMAL_LEVEL_INVALID = -1;
+}  // namespace
+
+PartnerDeviceEventDispatcher::PartnerDeviceEventDispatcher(const PartnerDeviceRegistry &registry)
+    : registry_(registry)
+{
+    queue_ = std::make_unique<ffrt::queue>("fcm_partner_device_event");
+}
+
+void PartnerDeviceEventDispatcher::Subscribe()
+{
+    std::lock_guard<std::mutex> lock(subscribeMutex_);
+    if (bluetoothEventSubscribe_ == nullptr) {
+        // 监听蓝牙公共事件
+        std::vector<std::string> commonEventVec = {
+            COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC,
+            COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC,
+            COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC,
+        };
+        std::vector<std::string> permissionVec = {
+            "ohos.permission.ACCESS_BLUETOOTH",
+            "ohos.permission.MANAGE_BLUETOOTH",
+        };
+        SubscribeCommonEvent(commonEventVec, permissionVec, bluetoothEventSubscribe_);
+    }
+    if (screenEventSubscribe_ == nullptr) {
+        // 监听亮灭屏公共事件
+        std::vector<std::string> screenCommonEventVec = {
+            EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON,
+            EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF,
+        };
+        SubscribeCommonEvent(screenCommonEventVec, {}, screenEventSubscribe_);
+    }
+    if (powerEventSubscribe_ == nullptr) {
+        // 监听温度和电量公共事件，调整扫描参数
+        std::vector<std::string> powerCommonEventVec = {
+            EventFwk::CommonEventSupport::COMMON_EVENT_THERMAL_LEVEL_CHANGED,
+            EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_LOW,
+            EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_OKAY,
+        };
+        SubscribeCommonEvent(powerCommonEventVec, {}, powerEventSubscribe_);
+    }
+    if (bluetoothStateObserver_ == nullptr) {
+        // 监听蓝牙开关状态
+        bluetoothStateObserver_ = std::make_shared<BluetoothStateObserver>(*this);
+        BluetoothHost::GetDefaultHost().RegisterObserver(bluetoothStateObserver_);
+    }
+}
+
+void PartnerDeviceEventDispatcher::UnSubscribe()
+{
+    std::lock_guard<std::mutex> lock(subscribeMutex_);
+    if (bluetoothEventSubscribe_) {
+        EventFwk::CommonEventManager::UnSubscribeCommonEvent(bluetoothEventSubscribe_);
+        bluetoothEventSubscribe_ = nullptr;
+    }
+    if (screenEventSubscribe_) {
+        EventFwk::CommonEventManager::UnSubscribeCommonEvent(screenEventSubscribe_);
+        screenEventSubscribe_ = nullptr;
+    }
+    if (powerEventSubscribe_) {
+        EventFwk::CommonEventManager::UnSubscribeCommonEvent(powerEventSubscribe_);
+        powerEventSubscribe_ = nullptr;
+    }
+    if (bluetoothStateObserver_) {
+        BluetoothHost::GetDefaultHost().DeregisterObserver(bluetoothStateObserver_);
+        bluetoothStateObserver_ = nullptr;
+    }
+}
+
+void PartnerDeviceEventDispatcher::SubscribeCommonEvent(const std::vector<std::string> &eventVec,
+    const std::vector<std::string> &permissionVec, std::shared_ptr<FcmCommonEventSubscriber> &eventSubscribe)
+{
+    EventFwk::MatchingSkills matchingSkills;
+    for (const std::string &event : eventVec) {
+        matchingSkills.AddEvent(event);
+    }
+    EventFwk::CommonEventSubscribeInfo subscribeInfo(matchingSkills);
+    for (const std::string &permission : permissionVec) {
+        subscribeInfo.SetPermission(permission);
+    }
+    // 每个事件只拷贝一次，在一个任务中完成解析和分发
+    auto func = [this](const OHOS::EventFwk::CommonEventData &data) {
+        queue_->submit([this, data]() { Dispatch(data); });
+    };
+    eventSubscribe = std::make_shared<FcmCommonEventSubscriber>(subscribeInfo, eventVec, func);
+    if (!EventFwk::CommonEventManager::SubscribeCommonEvent(eventSubscribe)) {
+        HILOGE("Subscribe common event failed");
+        // no need return
+    }
+}
+
+void PartnerDeviceEventDispatcher::BluetoothStateObserver::OnStateChanged(const int transport, const int status)
+{
+    // 不阻塞蓝牙框架的回调线程，所有设备的处理在一个任务中完成
+    owner_.queue_->submit([&owner = owner_, transport, status]() {
+        owner.DispatchBluetoothStateChange(transport, status);
+    });
+}
+
+void PartnerDeviceEventDispatcher::Dispatch(const OHOS::EventFwk::CommonEventData &data)
+{
+    const AAFwk::Want &want = data.GetWant();
+    std::string action = want.GetAction();
+    if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_CONNECTED_REALMAC) {
+        DispatchAclStateChange(want, true);
+    } else if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_ACL_DISCONNECTED_REALMAC) {
+        DispatchAclStateChange(want, false);
+    } else if (action == COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC) {
+        DispatchPairStateChange(want);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON) {
+        DispatchScreenStateChange(true);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF) {
+        DispatchScreenStateChange(false);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_THERMAL_LEVEL_CHANGED) {
+        DispatchThermalLevelChange(want);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_LOW) {
+        PartnerDeviceScanPolicy::GetInstance().SetBatteryLow(true);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_OKAY) {
+        PartnerDeviceScanPolicy::GetInstance().SetBatteryLow(false);
+    }
+}
+
+void PartnerDeviceEventDispatcher::DispatchAclStateChange(const AAFwk::Want &want, bool isConnect)
+{
+    std::string addr = want.GetStringParam("deviceAddr");
+    FcmMacAddress macAddress;
+    if (!FcmMacAddress::FromString(addr, macAddress)) {
+        HILOGE("Invalid address");
+        return;
+    }
+    HILOGI("%{public}s acl state change, isConnect: %{public}d", GetEncryptAddr(addr).c_str(), isConnect);
+    // 绑定同一地址的所有设备共用一个在位引擎，只通知一次，休眠的设备没有引擎
+    auto engine = PartnerDevicePresenceEngine::Find(macAddress);
+    if (engine) {
+        engine->OnBluetoothDeviceAclStateChange(isConnect);
+    }
+}
+
+void PartnerDeviceEventDispatcher::DispatchPairStateChange(const AAFwk::Want &want)
+{
+    std::string addr = want.GetStringParam("deviceAddr");
+    FcmMacAddress macAddress;
+    if (!FcmMacAddress::FromString(addr, macAddress)) {
+        HILOGE("Invalid address");
+        return;
+    }
+    int state = want.GetIntParam("state", PartnerDevice::BOND_STATE_NONE);
+    registry_.IterateByAddress(macAddress,
+        [state](uint32_t tokenId, const PartnerDeviceRegistry::DeviceSptr &device) {
+        if (device) {
+            device->OnBluetoothDevicePairStateChange(state);
+        }
+    });
+}
+
+void PartnerDeviceEventDispatcher::DispatchScreenStateChange(bool isScreenOn)
+{
+    // 所有设备共用一个扫描会话，扫描参数只调整一次
+    PartnerDeviceScanPolicy::GetInstance().SetScreenOn(isScreenOn);
+    // 在同一个任务中通知所有在位引擎，每个物理设备只通知一次
+    PartnerDevicePresenceEngine::Iterate([isScreenOn](const PartnerDevicePresenceEngine::EngineSptr &engine) {
+        engine->OnScreenStateChange(isScreenOn);
+    });
+}
+
+void PartnerDeviceEventDispatcher::DispatchThermalLevelChange(const AAFwk::Want &want)
+{
+    int thermalLevel = want.GetIntParam(THERMAL_LEVEL_PARAM, THERMAL_LEVEL_INVALID);
+    if (thermalLevel == THERMAL_LEVEL_INVALID) {
+        HILOGE("Invalid thermal level");
+        return;
+    }
+    PartnerDeviceScanPolicy::GetInstance().SetThermalLevel(thermalLevel);
+}
+
+void PartnerDeviceEventDispatcher::DispatchBluetoothStateChange(int transport, int status)
+{
+    if (transport == BTTransport::ADAPTER_BREDR && status == BTStateID::STATE_TURN_ON) {
+        HILOGI("bluetooth turn on");
+        // 一次获取所有已配对设备，替代逐个设备查询配对状态
+        PairedDevices pairedDevices = PairedDevices::Get();
+        registry_.Iterate([&pairedDevices](const PartnerDeviceMapKey &key,
+            const PartnerDeviceRegistry::DeviceSptr &device) {
+            if (device) {
+                // 用户关闭的设备无需查询配对状态
+                device->OnBluetoothTurnOn(device->IsUserEnableAbility() && pairedDevices.Contains(key.second));
+            }
+        });
+    }
+    if (transport == BTTransport::ADAPTER_BLE && status == BTStateID::STATE_TURN_OFF) {
+        HILOGI("bluetooth turn off");
+        registry_.Iterate([](const PartnerDeviceMapKey &key, const PartnerDeviceRegistry::DeviceSptr &device) {
+            if (device) {
+                device->OnBluetoothTurnOff();
+            }
+        });
+    }
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
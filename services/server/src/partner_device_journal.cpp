@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceJournal"
+#endif
+
+#include "partner_device_journal.h"
+#include <cinttypes>
+#include <cstdio>
+#include "fcm_mac_address.h"
+#include "log.h"
+#include "partner_device_snapshot.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr const char *JOURNAL_OP_BASE = "base";
+constexpr const char *JOURNAL_OP_PUT = "put";
+constexpr const char *JOURNAL_OP_DEL = "del";
+constexpr size_t CHECKSUM_STRING_SIZE = 17;  // 16 hex chars and '\0'
+
+std::string ChecksumToString(uint64_t checksum)
+{
+    char buf[CHECKSUM_STRING_SIZE] = { 0 };
+    (void)snprintf(buf, sizeof(buf), "%016" PRIx64, checksum);
+    return buf;
+}
+
+// 一行日志记录中的字段，字段顺序不限
+struct JournalRecord {
+    std::string op;
+    std::string checksum;
+    std::optional<PartnerDeviceJsonItem> device;
+    int64_t tokenId = -1;
+    std::string address;
+};
+
+bool ReadRecord(std::string_view line, JournalRecord &record)
+{
+    FcmJsonReader reader(line);
+    if (!reader.BeginObject()) {
+        return false;
+    }
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        bool isRead = false;
+        if (key == "op") {
+            isRead = reader.ReadString(record.op);
+        } else if (key == "checksum") {
+            isRead = reader.ReadString(record.checksum);
+        } else if (key == "device") {
+            record.device.emplace();
+            isRead = PartnerDeviceJson::ReadDevice(reader, *record.device);
+        } else if (key == "tokenId") {
+            isRead = reader.ReadInt(record.tokenId);
+        } else if (key == "address") {
+            isRead = reader.ReadString(record.address);
+        } else {
+            isRead = reader.Skip();
+        }
+        if (!isRead) {
+            return false;
+        }
+    }
+    return !reader.HasError() && reader.IsEnd();
+}
+}  // namespace
+
+void PartnerDeviceJournal::AppendHeader(FcmJsonWriter &writer, std::string_view snapshotContent)
+{
+    writer.BeginObject();
+    writer.Key("op");
+    writer.String(JOURNAL_OP_BASE);
+    writer.Key("checksum");
+    writer.String(ChecksumToString(PartnerDeviceSnapshot::Checksum(snapshotContent)));
+    writer.EndObject();
+    writer.NewLine();
+}
+
+void PartnerDeviceJournal::AppendPutRecord(FcmJsonWriter &writer, const PartnerDeviceRecord &record)
+{
+    writer.BeginObject();
+    writer.Key("op");
+    writer.String(JOURNAL_OP_PUT);
+    writer.Key("device");
+    PartnerDeviceJson::WriteDevice(writer, record);
+    writer.EndObject();
+    writer.NewLine();
+}
+
+void PartnerDeviceJournal::AppendDelRecord(FcmJsonWriter &writer, uint32_t tokenId, std::string_view address)
+{
+    writer.BeginObject();
+    writer.Key("op");
+    writer.String(JOURNAL_OP_DEL);
+    writer.Key("tokenId");
+    writer.Int(tokenId);
+    writer.Key("address");
+    writer.String(address);
+    writer.EndObject();
+    writer.NewLine();
+}
+
+bool PartnerDeviceJournal::IsHeaderMatched(std::string_view line, std::string_view snapshotContent)
+{
+    JournalRecord header;
+    if (!ReadRecord(line, header) || header.op != JOURNAL_OP_BASE) {
+        return false;
+    }
+    return ChecksumToString(PartnerDeviceSnapshot::Checksum(snapshotContent)) == header.checksum;
+}
+
+bool PartnerDeviceJournal::ApplyRecord(std::string_view line, Overlay &overlay)
+{
+    JournalRecord record;
+    if (!ReadRecord(line, record)) {
+        return false;
+    }
+    PartnerDeviceMapKey key;
+    if (record.op == JOURNAL_OP_PUT) {
+        if (!record.device.has_value() || !FcmMacAddress::FromString(record.device->address, key.second)) {
+            return false;
+        }
+        key.first = record.device->fields.tokenId;
+        overlay[key] = std::move(record.device);
+        return true;
+    }
+    if (record.op == JOURNAL_OP_DEL) {
+        if (record.tokenId < 0 || record.tokenId > UINT32_MAX ||
+            !FcmMacAddress::FromString(record.address, key.second)) {
+            return false;
+        }
+        key.first = static_cast<uint32_t>(record.tokenId);
+        overlay[key] = std::nullopt;
+        return true;
+    }
+    return false;
+}
+
+int PartnerDeviceJournal::Replay(std::string_view snapshotContent, std::string_view journalContent, Overlay &overlay)
+{
+    size_t lineEnd = journalContent.find('\n');
+    if (lineEnd == std::string_view::npos) {
+        // 日志为空或日志头不完整
+        return 0;
+    }
+    if (!IsHeaderMatched(journalContent.substr(0, lineEnd), snapshotContent)) {
+        HILOGW("journal does not match the snapshot, ignore it");
+        return 0;
+    }
+
+    int count = 0;
+    size_t lineBegin = lineEnd + 1;
+    // 只回放以换行结尾的完整记录，丢弃掉电或进程退出时写了一半的记录
+    while ((lineEnd = journalContent.find('\n', lineBegin)) != std::string_view::npos) {
+        if (!ApplyRecord(journalContent.substr(lineBegin, lineEnd - lineBegin), overlay)) {
+            HILOGE("invalid journal record at %{public}zu, stop replay", lineBegin);
+            break;
+        }
+        count++;
+        lineBegin = lineEnd + 1;
+    }
+    return count;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
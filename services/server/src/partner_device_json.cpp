@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_json.h"
+#include <limits>
+#include <type_traits>
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr const char *DEVICE_ITEM_VERSION = "1.0";
+
+enum DeviceItemField : uint32_t {
+    FIELD_VERSION = 1 << 0,
+    FIELD_BUNDLE_NAME = 1 << 1,
+    FIELD_ABILITY_NAME = 1 << 2,
+    FIELD_ADDRESS = 1 << 3,
+    FIELD_ADDRESS_TYPE = 1 << 4,
+    FIELD_TOKEN_ID = 1 << 5,
+    FIELD_REGISTER_TIMESTAMP = 1 << 6,
+    FIELD_USER_ENABLED = 1 << 7,
+    FIELD_SUPPORT_BR = 1 << 8,
+    FIELD_SUPPORT_BLE_ADVERTISER = 1 << 9,
+    FIELD_SUPPORT_MEDIA_CONTROL = 1 << 10,
+    FIELD_SUPPORT_TELEPHONY_CONTROL = 1 << 11,
+    REQUIRED_FIELDS = (1 << 12) - 1,
+    // 可选字段
+    FIELD_RAW_ADDRESS_TYPE = 1 << 12,
+    FIELD_LOST_TIMESTAMP = 1 << 13,
+};
+
+// 以下读取函数在值的类型不符时跳过该值，不记录字段，由调用者检查必选字段是否齐全
+void ReadStringField(FcmJsonReader &reader, std::string &value, uint32_t field, uint32_t &fields)
+{
+    if (reader.ReadString(value)) {
+        fields |= field;
+        return;
+    }
+    (void)reader.Skip();
+}
+
+void ReadBoolField(FcmJsonReader &reader, bool &value, uint32_t field, uint32_t &fields)
+{
+    if (reader.ReadBool(value)) {
+        fields |= field;
+        return;
+    }
+    (void)reader.Skip();
+}
+
+template <typename T>
+void ReadIntField(FcmJsonReader &reader, T &value, uint32_t field, uint32_t &fields)
+{
+    int64_t number = 0;
+    if (!reader.ReadInt(number)) {
+        (void)reader.Skip();
+        return;
+    }
+    if constexpr (!std::is_same_v<T, int64_t>) {
+        if (number < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+            number > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+            return;
+        }
+    }
+    value = static_cast<T>(number);
+    fields |= field;
+}
+
+void ReadAddressInfo(FcmJsonReader &reader, PartnerDeviceJsonItem &item, uint32_t &fields)
+{
+    if (!reader.BeginObject()) {
+        (void)reader.Skip();
+        return;
+    }
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        if (key == "address") {
+            ReadStringField(reader, item.address, FIELD_ADDRESS, fields);
+        } else if (key == "addressType") {
+            ReadIntField(reader, item.fields.addressType, FIELD_ADDRESS_TYPE, fields);
+        } else if (key == "rawAddressType") {
+            ReadIntField(reader, item.fields.rawAddressType, FIELD_RAW_ADDRESS_TYPE, fields);
+        } else {
+            (void)reader.Skip();
+        }
+    }
+}
+
+void ReadCapability(FcmJsonReader &reader, PartnerDeviceJsonItem &item, uint32_t &fields)
+{
+    if (!reader.BeginObject()) {
+        (void)reader.Skip();
+        return;
+    }
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        if (key == "isSupportBR") {
+            ReadBoolField(reader, item.fields.isSupportBR, FIELD_SUPPORT_BR, fields);
+        } else if (key == "isSupportBleAdvertiser") {
+            ReadBoolField(reader, item.fields.isSupportBleAdvertiser, FIELD_SUPPORT_BLE_ADVERTISER, fields);
+        } else {
+            (void)reader.Skip();
+        }
+    }
+}
+
+void ReadBusinessCapability(FcmJsonReader &reader, PartnerDeviceJsonItem &item, uint32_t &fields)
+{
+    if (!reader.BeginObject()) {
+        (void)reader.Skip();
+        return;
+    }
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        if (key == "isSupportMediaControl") {
+            ReadBoolField(reader, item.fields.isSupportMediaControl, FIELD_SUPPORT_MEDIA_CONTROL, fields);
+        } else if (key == "isSupportTelephonyControl") {
+            ReadBoolField(reader, item.fields.isSupportTelephonyControl, FIELD_SUPPORT_TELEPHONY_CONTROL, fields);
+        } else {
+            (void)reader.Skip();
+        }
+    }
+}
+
+void ReadDeviceField(FcmJsonReader &reader, std::string_view key, PartnerDeviceJsonItem &item, uint32_t &fields)
+{
+    if (key == "version") {
+        // 只检查版本字段存在，版本号不参与解析
+        std::string version;
+        ReadStringField(reader, version, FIELD_VERSION, fields);
+    } else if (key == "bundleName") {
+        ReadStringField(reader, item.bundleName, FIELD_BUNDLE_NAME, fields);
+    } else if (key == "abilityName") {
+        ReadStringField(reader, item.abilityName, FIELD_ABILITY_NAME, fields);
+    } else if (key == "addressInfo") {
+        ReadAddressInfo(reader, item, fields);
+    } else if (key == "tokenId") {
+        ReadIntField(reader, item.fields.tokenId, FIELD_TOKEN_ID, fields);
+    } else if (key == "registerTimestamp") {
+        ReadIntField(reader, item.fields.registerTimestamp, FIELD_REGISTER_TIMESTAMP, fields);
+    } else if (key == "lostTimestamp") {
+        ReadIntField(reader, item.fields.lostTimestamp, FIELD_LOST_TIMESTAMP, fields);
+    } else if (key == "isUserEnabled") {
+        ReadBoolField(reader, item.fields.isUserEnabled, FIELD_USER_ENABLED, fields);
+    } else if (key == "capability") {
+        ReadCapability(reader, item, fields);
+    } else if (key == "businessCapability") {
+        ReadBusinessCapability(reader, item, fields);
+    } else {
+        (void)reader.Skip();
+    }
+}
+}  // namespace
+
+PartnerDeviceRecord PartnerDeviceJsonItem::GetRecord() const
+{
+    PartnerDeviceRecord record = fields;
+    record.bundleName = bundleName;
+    record.abilityName = abilityName;
+    record.address = address;
+    return record;
+}
+
+void PartnerDeviceJson::WriteDevice(FcmJsonWriter &writer, const PartnerDeviceRecord &record)
+{
+    writer.BeginObject();
+    writer.Key("version");
+    writer.String(DEVICE_ITEM_VERSION);
+    writer.Key("bundleName");
+    writer.String(record.bundleName);
+    writer.Key("abilityName");
+    writer.String(record.abilityName);
+    writer.Key("addressInfo");
+    writer.BeginObject();
+    writer.Key("address");
+    writer.String(record.address);
+    writer.Key("addressType");
+    writer.Int(record.addressType);
+    if (record.hasRawAddressType) {
+        writer.Key("rawAddressType");
+        writer.Int(record.rawAddressType);
+    }
+    writer.EndObject();
+    writer.Key("tokenId");
+    writer.Int(record.tokenId);
+    writer.Key("registerTimestamp");
+    writer.Int(record.registerTimestamp);
+    if (record.lostTimestamp > 0) {
+        writer.Key("lostTimestamp");
+        writer.Int(record.lostTimestamp);
+    }
+    writer.Key("isUserEnabled");
+    writer.Bool(record.isUserEnabled);
+    writer.Key("capability");
+    writer.BeginObject();
+    writer.Key("isSupportBR");
+    writer.Bool(record.isSupportBR);
+    writer.Key("isSupportBleAdvertiser");
+    writer.Bool(record.isSupportBleAdvertiser);
+    writer.EndObject();
+    writer.Key("businessCapability");
+    writer.BeginObject();
+    writer.Key("isSupportMediaControl");
+    writer.Bool(record.isSupportMediaControl);
+    writer.Key("isSupportTelephonyControl");
+    writer.Bool(record.isSupportTelephonyControl);
+    writer.EndObject();
+    writer.EndObject();
+}
+
+bool PartnerDeviceJson::ReadDevice(FcmJsonReader &reader, PartnerDeviceJsonItem &item)
+{
+    // 复用 item 中字符串的内存
+    item.fields = PartnerDeviceRecord();
+    if (!reader.BeginObject()) {
+        (void)reader.Skip();
+        return false;
+    }
+    uint32_t fields = 0;
+    std::string_view key;
+    while (reader.NextKey(key)) {
+        ReadDeviceField(reader, key, item, fields);
+    }
+    item.fields.hasRawAddressType = (fields & FIELD_RAW_ADDRESS_TYPE) != 0;
+    return !reader.HasError() && (fields & REQUIRED_FIELDS) == REQUIRED_FIELDS;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDevicePresenceEngine"
+#endif
+
+#include "partner_device_presence_engine.h"
+#include <cinttypes>
+#include <unordered_map>
+#include <vector>
+#include "device_agent_capability_ble_adv.h"
+#include "device_agent_capability_br.h"
+#include "log.h"
+#include "log_util.h"
+#include "partner_device.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+const std::string CAPABILITY_BLE_ADV_KEY = "CapabilityBleAdvKey";
+const std::string CAPABILITY_BR_KEY = "CapabilityBrKey";
+
+// 以物理地址索引的引擎，引擎由订阅的设备持有
+struct EngineRegistry {
+    std::mutex mutex;
+    std::unordered_map<FcmMacAddress, std::weak_ptr<PartnerDevicePresenceEngine>> engines;
+    // 引擎没有订阅者时保留的扫描历史，引擎再次被订阅时取出，地址的最后一个绑定删除时清除
+    std::unordered_map<FcmMacAddress, PartnerDeviceScanScheduler> scanHistories;
+};
+
+EngineRegistry &GetEngineRegistry()
+{
+    static EngineRegistry registry;
+    return registry;
+}
+
+PartnerDeviceScanScheduler TakeScanHistory(const FcmMacAddress &address)
+{
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.scanHistories.find(address);
+    if (it == registry.scanHistories.end()) {
+        return PartnerDeviceScanScheduler();
+    }
+    PartnerDeviceScanScheduler scanScheduler = it->second;
+    registry.scanHistories.erase(it);
+    return scanScheduler;
+}
+
+void KeepScanHistory(const FcmMacAddress &address, const PartnerDeviceScanScheduler &scanScheduler)
+{
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.scanHistories[address] = scanScheduler;
+}
+}  // namespace
+
+PartnerDevicePresenceEngine::EngineSptr PartnerDevicePresenceEngine::Acquire(const FcmMacAddress &address)
+{
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &engineWptr = registry.engines[address];
+    EngineSptr engine = engineWptr.lock();
+    if (engine == nullptr) {
+        engine = std::make_shared<PartnerDevicePresenceEngine>(address);
+        engineWptr = engine;
+    }
+    return engine;
+}
+
+PartnerDevicePresenceEngine::EngineSptr PartnerDevicePresenceEngine::Find(const FcmMacAddress &address)
+{
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.engines.find(address);
+    return it == registry.engines.end() ? nullptr : it->second.lock();
+}
+
+void PartnerDevicePresenceEngine::Iterate(const std::function<void(const EngineSptr &)> &func)
+{
+    std::vector<EngineSptr> engines;
+    {
+        EngineRegistry &registry = GetEngineRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        engines.reserve(registry.engines.size());
+        for (auto &[_, engineWptr] : registry.engines) {
+            EngineSptr engine = engineWptr.lock();
+            if (engine) {
+                engines.push_back(std::move(engine));
+            }
+        }
+    }
+    for (const auto &engine : engines) {
+        func(engine);
+    }
+}
+
+void PartnerDevicePresenceEngine::ClearScanHistory(const FcmMacAddress &address)
+{
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.scanHistories.erase(address);
+}
+
+PartnerDevicePresenceEngine::~PartnerDevicePresenceEngine()
+{
+    // 扫描历史已在最后一个订阅者退订时保留，此处不再写回，避免恢复已清除的历史
+    for (auto &[_, capability] : capabilityMap_) {
+        capability->Close();
+    }
+    EngineRegistry &registry = GetEngineRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.engines.find(address_);
+    // 同一地址可能已创建新的引擎
+    if (it != registry.engines.end() && it->second.expired()) {
+        registry.engines.erase(it);
+    }
+}
+
+uint64_t PartnerDevicePresenceEngine::Subscribe(const Subscriber &subscriber)
+{
+    uint64_t subscriberId = 0;
+    bool isExtensionStarted = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscriberId = nextSubscriberId_++;
+        subscribers_[subscriberId] = subscriber;
+        UpdateCapabilitiesLocked();
+        isExtensionStarted = stateMachine_.IsPresent();
+    }
+    HILOGI("%{public}s subscriber %{public}" PRIu64 " subscribed",
+        GetEncryptAddr(address_.ToString()).c_str(), subscriberId);
+    // 设备已在位，直接拉起新订阅者的extension
+    if (isExtensionStarted && subscriber.funcs.startExtension) {
+        subscriber.funcs.startExtension();
+    }
+    return subscriberId;
+}
+
+bool PartnerDevicePresenceEngine::Unsubscribe(uint64_t subscriberId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscribers_.erase(subscriberId) == 0) {
+        return false;
+    }
+    // 设备在位时，订阅者的extension已在订阅或设备进入时拉起；最后一个订阅者退订会重置状态机，需先取在位状态
+    bool isExtensionStarted = stateMachine_.IsPresent();
+    UpdateCapabilitiesLocked();
+    return isExtensionStarted;
+}
+
+size_t PartnerDevicePresenceEngine::GetSubscriberCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+void PartnerDevicePresenceEngine::UpdateCapabilitiesLocked()
+{
+    bool isSupportBleAdvertiser = false;
+    for (const auto &[_, subscriber] : subscribers_) {
+        isSupportBleAdvertiser = isSupportBleAdvertiser || subscriber.isSupportBleAdvertiser;
+    }
+    // 能力的回调不持有引擎，避免循环引用；能力的Init和Close不会同步回调
+    auto makeFuncs = [ptr = weak_from_this()](Event enterEvent, Event exitEvent) {
+        IDeviceAgentCapability::DependencyFuncs funcs = {
+            .startExtension = [ptr, enterEvent]() {
+                auto engine = ptr.lock();
+                if (engine) {
+                    engine->OnPresenceEvent(enterEvent, ABILITY_DESTROY_UNKNOWN_REASON);
+                }
+            },
+            .destroyExtension = [ptr, exitEvent](int destroyReason) {
+                auto engine = ptr.lock();
+                if (engine) {
+                    engine->OnPresenceEvent(exitEvent, destroyReason);
+                }
+            },
+        };
+        return funcs;
+    };
+    std::string addr = address_.ToString();
+    auto updateCapability = [this, &addr](const std::string &key, bool isNeeded, auto create) {
+        auto it = capabilityMap_.find(key);
+        if (isNeeded && it == capabilityMap_.end()) {
+            auto capability = create();
+            capability->Init(addr);
+            capabilityMap_[key] = capability;
+        } else if (!isNeeded && it != capabilityMap_.end()) {
+            it->second->Close();
+            SaveScanHistoryLocked(it->second);
+            capabilityMap_.erase(it);
+        }
+    };
+    bool isActive = !subscribers_.empty();
+    bool wasActive = capabilityMap_.find(CAPABILITY_BR_KEY) != capabilityMap_.end();
+    if (isActive && !wasActive) {
+        // 第一个订阅者取回地址的扫描历史，历史已被清除时从头学习
+        scanScheduler_ = TakeScanHistory(address_);
+    }
+    // 能力使用第一个订阅者的在位门限，各应用的门限来自同一份系统参数
+    PartnerDevicePresenceFilter::Config config =
+        isActive ? subscribers_.begin()->second.presenceConfig : PartnerDevicePresenceFilter::Config();
+    // BR能力的进入和退出对应ACL连接和链路丢失，BLE能力的进入和退出对应广播发现和丢失
+    updateCapability(CAPABILITY_BR_KEY, isActive, [&makeFuncs, &config]() {
+        auto funcs = makeFuncs(StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_LINK_LOST);
+        return std::make_shared<DeviceAgentCapabilityBr>(funcs, std::weak_ptr<PartnerDevice>(), config);
+    });
+    // BLE能力重新创建时沿用地址的扫描历史
+    updateCapability(CAPABILITY_BLE_ADV_KEY, isActive && isSupportBleAdvertiser, [this, &makeFuncs, &config]() {
+        auto funcs = makeFuncs(StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_LOST);
+        return std::make_shared<DeviceAgentCapabilityBleAdv>(funcs, std::weak_ptr<PartnerDevice>(), config,
+            scanScheduler_);
+    });
+    if (!isActive) {
+        // 最后一个订阅者的extension由设备自行销毁
+        stateMachine_ = StateMachine();
+    }
+    if (!isActive && wasActive) {
+        // 引擎仍存活时交还扫描历史，引擎释放后同一地址的新引擎不会错过历史
+        KeepScanHistory(address_, scanScheduler_);
+        scanScheduler_ = PartnerDeviceScanScheduler();
+    }
+}
+
+void PartnerDevicePresenceEngine::SaveScanHistoryLocked(const std::shared_ptr<IDeviceAgentCapability> &capability)
+{
+    auto bleAdv = std::dynamic_pointer_cast<DeviceAgentCapabilityBleAdv>(capability);
+    if (bleAdv != nullptr) {
+        scanScheduler_ = bleAdv->GetScanScheduler();
+    }
+}
+
+PartnerDevicePresenceEngine::CapabilityMap PartnerDevicePresenceEngine::GetCapabilities()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capabilityMap_;
+}
+
+void PartnerDevicePresenceEngine::OnPresenceEvent(Event event, int destroyReason)
+{
+    StateMachine::Action action = StateMachine::ACTION_NONE;
+    std::vector<IDeviceAgentCapability::DependencyFuncs> funcsVec;
+    CapabilityMap capabilityMap;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        StateMachine::State state = stateMachine_.GetState();
+        action = stateMachine_.OnEvent(event);
+        if (state != stateMachine_.GetState()) {
+            HILOGI("%{public}s %{public}s, %{public}s -> %{public}s", GetEncryptAddr(address_.ToString()).c_str(),
+                StateMachine::ToString(event), StateMachine::ToString(state),
+                StateMachine::ToString(stateMachine_.GetState()));
+        }
+        if (action == StateMachine::ACTION_NONE) {
+            return;
+        }
+        for (const auto &[_, subscriber] : subscribers_) {
+            funcsVec.push_back(subscriber.funcs);
+        }
+        capabilityMap = capabilityMap_;
+    }
+    if (action == StateMachine::ACTION_START) {
+        for (const auto &funcs : funcsVec) {
+            if (funcs.startExtension) {
+                funcs.startExtension();
+            }
+        }
+        return;
+    }
+    for (const auto &funcs : funcsVec) {
+        if (funcs.destroyExtension) {
+            funcs.destroyExtension(destroyReason);
+        }
+    }
+    // 设备退出后各能力重新开始发现设备
+    for (auto &[_, capability] : capabilityMap) {
+        capability->OnExtensionDestroy();
+    }
+}
+
+void PartnerDevicePresenceEngine::OnBluetoothDeviceAclStateChange(bool isConnect)
+{
+    // ACL事件直接驱动状态机，BR能力随后上报的进入事件不再重复拉起
+    OnPresenceEvent(isConnect ? StateMachine::EVENT_ACL_CONNECTED : StateMachine::EVENT_ACL_DISCONNECTED,
+        ABILITY_DESTROY_UNKNOWN_REASON);
+    for (auto &[_, capability] : GetCapabilities()) {
+        if (isConnect) {
+            capability->OnBluetoothDeviceAclConnected();
+        } else {
+            capability->OnBluetoothDeviceAclDisconnected();
+        }
+    }
+}
+
+void PartnerDevicePresenceEngine::OnScreenStateChange(bool isScreenOn)
+{
+    for (auto &[_, capability] : GetCapabilities()) {
+        if (isScreenOn) {
+            capability->OnScreenOn();
+        } else {
+            capability->OnScreenOff();
+        }
+    }
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
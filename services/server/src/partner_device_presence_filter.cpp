@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_presence_filter.h"
+#include <algorithm>
+
+namespace OHOS {
+namespace FusionConnectivity {
+PartnerDevicePresenceFilter::Transition PartnerDevicePresenceFilter::OnSighting(int rssi, int64_t nowMs)
+{
+    if (isPresent_) {
+        // 滞回：在位期间信号不弱于退出阈值即保持在位
+        if (rssi >= config_.exitRssi) {
+            keepTimeMs_ = nowMs;
+        }
+        return TRANSITION_NONE;
+    }
+
+    sightings_.push_back({ nowMs, rssi >= config_.enterRssi });
+    while (sightings_.size() > config_.windowNum ||
+        (!sightings_.empty() && nowMs - sightings_.front().timeMs > config_.windowMs)) {
+        sightings_.pop_front();
+    }
+    auto strongNum = std::count_if(sightings_.begin(), sightings_.end(),
+        [](const Sighting &sighting) { return sighting.isStrong; });
+    if (static_cast<uint32_t>(strongNum) < config_.sightingNum) {
+        return TRANSITION_NONE;
+    }
+    return Enter(nowMs);
+}
+
+PartnerDevicePresenceFilter::Transition PartnerDevicePresenceFilter::OnTrackStart(int64_t nowMs)
+{
+    isTracked_ = true;
+    keepTimeMs_ = nowMs;
+    return isPresent_ ? TRANSITION_NONE : Enter(nowMs);
+}
+
+PartnerDevicePresenceFilter::Transition PartnerDevicePresenceFilter::OnFound(int rssi, int64_t nowMs)
+{
+    // 与扫描结果相同的滞回：不在位时按进入阈值，在位期间按退出阈值
+    int thresholdRssi = isPresent_ ? config_.exitRssi : config_.enterRssi;
+    if (rssi < thresholdRssi) {
+        return OnSighting(rssi, nowMs);
+    }
+    return OnTrackStart(nowMs);
+}
+
+void PartnerDevicePresenceFilter::OnTrackStop(int64_t nowMs)
+{
+    if (!isTracked_) {
+        return;
+    }
+    isTracked_ = false;
+    keepTimeMs_ = nowMs;
+}
+
+PartnerDevicePresenceFilter::Transition PartnerDevicePresenceFilter::OnTimeout(int64_t nowMs)
+{
+    int64_t exitTimeMs = GetExitTimeMs();
+    if (exitTimeMs < 0 || nowMs < exitTimeMs) {
+        return TRANSITION_NONE;
+    }
+    Reset();
+    return TRANSITION_EXIT;
+}
+
+int64_t PartnerDevicePresenceFilter::GetExitTimeMs() const
+{
+    if (!isPresent_ || isTracked_) {
+        return -1;
+    }
+    return keepTimeMs_ + config_.exitDelayMs;
+}
+
+void PartnerDevicePresenceFilter::Reset()
+{
+    sightings_.clear();
+    isPresent_ = false;
+    isTracked_ = false;
+    keepTimeMs_ = 0;
+}
+
+PartnerDevicePresenceFilter::Transition PartnerDevicePresenceFilter::Enter(int64_t nowMs)
+{
+    sightings_.clear();
+    isPresent_ = true;
+    keepTimeMs_ = nowMs;
+    return TRANSITION_ENTER;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
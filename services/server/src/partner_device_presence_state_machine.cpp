@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_presence_state_machine.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+PartnerDevicePresenceStateMachine::Action PartnerDevicePresenceStateMachine::OnEvent(Event event)
+{
+    switch (event) {
+        case EVENT_BLE_SEEN:
+            isBleSeen_ = true;
+            if (state_ == STATE_ABSENT) {
+                state_ = STATE_SEEN;
+                return ACTION_START;
+            }
+            return ACTION_NONE;
+        case EVENT_BLE_LOST:
+            isBleSeen_ = false;
+            if (state_ == STATE_SEEN) {
+                state_ = STATE_ABSENT;
+                return ACTION_DESTROY;
+            }
+            return ACTION_NONE;
+        case EVENT_ACL_CONNECTED: {
+            // 连接期间BLE能力停止扫描，断连后重新判断BLE是否在位
+            isBleSeen_ = false;
+            bool isAbsent = state_ == STATE_ABSENT;
+            state_ = STATE_CONNECTED;
+            return isAbsent ? ACTION_START : ACTION_NONE;
+        }
+        case EVENT_ACL_DISCONNECTED:
+            if (state_ == STATE_CONNECTED) {
+                state_ = STATE_LINGER;
+            }
+            return ACTION_NONE;
+        case EVENT_LINK_LOST:
+            // BR能力在断连超过退出延时后上报，连接中的设备不会上报
+            if (state_ != STATE_LINGER) {
+                return ACTION_NONE;
+            }
+            if (isBleSeen_) {
+                state_ = STATE_SEEN;
+                return ACTION_NONE;
+            }
+            state_ = STATE_ABSENT;
+            return ACTION_DESTROY;
+        default:
+            return ACTION_NONE;
+    }
+}
+
+const char *PartnerDevicePresenceStateMachine::ToString(State state)
+{
+    switch (state) {
+        case STATE_ABSENT:
+            return "ABSENT";
+        case STATE_SEEN:
+            return "SEEN";
+        case STATE_CONNECTED:
+            return "CONNECTED";
+        case STATE_LINGER:
+            return "LINGER";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+const char *PartnerDevicePresenceStateMachine::ToString(Event event)
+{
+    switch (event) {
+        case EVENT_BLE_SEEN:
+            return "BLE_SEEN";
+        case EVENT_BLE_LOST:
+            return "BLE_LOST";
+        case EVENT_ACL_CONNECTED:
+            return "ACL_CONNECTED";
+        case EVENT_ACL_DISCONNECTED:
+            return "ACL_DISCONNECTED";
+        case EVENT_LINK_LOST:
+            return "LINK_LOST";
+        default:
+            return "UNKNOWN";
+    }
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
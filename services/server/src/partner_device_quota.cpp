@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_quota.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+PartnerDeviceQuota::PartnerDeviceQuota(size_t maxDevicesPerApp, size_t maxDevicesPerUser)
+    : maxDevicesPerApp_(maxDevicesPerApp), maxDevicesPerUser_(maxDevicesPerUser)
+{}
+
+size_t PartnerDeviceQuota::GetMaxDevicesPerApp() const
+{
+    return maxDevicesPerApp_;
+}
+
+size_t PartnerDeviceQuota::GetMaxDevicesPerUser() const
+{
+    return maxDevicesPerUser_;
+}
+
+bool PartnerDeviceQuota::TryBind(PartnerDeviceRegistry &registry, const PartnerDeviceRegistry::Entry &entry) const
+{
+    // 在注册表的写锁内基于最新快照检查配额，检查与插入之间没有其他写入
+    return registry.InsertIf(entry, [this, &entry](const PartnerDeviceRegistry::Snapshot &snapshot) {
+        auto tokenIt = snapshot.tokenIndex.find(entry.key.first);
+        size_t appCount = tokenIt != snapshot.tokenIndex.end() ? tokenIt->second->size() : 0;
+        auto userIt = snapshot.userDeviceCounts.find(entry.userId);
+        size_t userCount = userIt != snapshot.userDeviceCounts.end() ? userIt->second : 0;
+        return appCount < maxDevicesPerApp_ && userCount < maxDevicesPerUser_;
+    });
+}
+
+PartnerDeviceQuota::Counter::Counter(const PartnerDeviceQuota &quota) : quota_(quota)
+{}
+
+bool PartnerDeviceQuota::Counter::TryAccept(uint32_t tokenId, int32_t userId)
+{
+    size_t &appCount = appDeviceCounts_[tokenId];
+    size_t &userCount = userDeviceCounts_[userId];
+    if (appCount >= quota_.maxDevicesPerApp_ || userCount >= quota_.maxDevicesPerUser_) {
+        return false;
+    }
+    appCount++;
+    userCount++;
+    return true;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_registry.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+PartnerDeviceRegistry::PartnerDeviceRegistry() : snapshot_(std::make_shared<const Snapshot>())
+{}
+
+std::shared_ptr<const PartnerDeviceRegistry::Snapshot> PartnerDeviceRegistry::GetSnapshot() const
+{
+    return std::atomic_load(&snapshot_);
+}
+
+void PartnerDeviceRegistry::Publish(std::shared_ptr<const Snapshot> snapshot)
+{
+    std::atomic_store(&snapshot_, std::move(snapshot));
+}
+
+int PartnerDeviceRegistry::Size() const
+{
+    return static_cast<int>(GetSnapshot()->size);
+}
+
+bool PartnerDeviceRegistry::IsEmpty() const
+{
+    return GetSnapshot()->size == 0;
+}
+
+size_t PartnerDeviceRegistry::GetShardIndex(const FcmMacAddress &address)
+{
+    return std::hash<FcmMacAddress>()(address) % SHARD_NUM;
+}
+
+PartnerDeviceRegistry::AddressShard &PartnerDeviceRegistry::GetWritableShard(
+    Snapshot &snapshot, WriteContext &context, const FcmMacAddress &address)
+{
+    size_t index = GetShardIndex(address);
+    if (context.addressShards[index] == nullptr) {
+        // 分片与旧快照共享，首次写入前拷贝
+        const auto &shard = snapshot.addressShards[index];
+        context.addressShards[index] =
+            shard != nullptr ? std::make_shared<AddressShard>(*shard) : std::make_shared<AddressShard>();
+        snapshot.addressShards[index] = context.addressShards[index];
+    }
+    return *context.addressShards[index];
+}
+
+PartnerDeviceRegistry::TokenDevices &PartnerDeviceRegistry::GetWritableTokenDevices(
+    Snapshot &snapshot, WriteContext &context, uint32_t tokenId)
+{
+    auto &devices = context.tokenDevices[tokenId];
+    if (devices == nullptr) {
+        // 应用的设备与旧快照共享，首次写入前拷贝
+        auto it = snapshot.tokenIndex.find(tokenId);
+        devices = it != snapshot.tokenIndex.end() ?
+            std::make_shared<TokenDevices>(*it->second) : std::make_shared<TokenDevices>();
+        snapshot.tokenIndex[tokenId] = devices;
+    }
+    return *devices;
+}
+
+void PartnerDeviceRegistry::InsertIndex(Snapshot &snapshot, WriteContext &context, const Entry &entry)
+{
+    const auto &[tokenId, address] = entry.key;
+    TokenDevices &tokenDevices = GetWritableTokenDevices(snapshot, context, tokenId);
+    auto result = tokenDevices.insert_or_assign(address, entry.device);
+    GetWritableShard(snapshot, context, address)[address][tokenId] = entry.device;
+    if (!result.second) {
+        // 替换已有的设备，数量不变
+        return;
+    }
+    snapshot.size++;
+    auto userIt = snapshot.tokenUserIds.try_emplace(tokenId, entry.userId).first;
+    snapshot.userDeviceCounts[userIt->second]++;
+}
+
+void PartnerDeviceRegistry::EraseIndex(Snapshot &snapshot, WriteContext &context, const PartnerDeviceMapKey &key)
+{
+    const auto &[tokenId, address] = key;
+    TokenDevices &tokenDevices = GetWritableTokenDevices(snapshot, context, tokenId);
+    tokenDevices.erase(address);
+    bool isTokenEmpty = tokenDevices.empty();
+    if (isTokenEmpty) {
+        snapshot.tokenIndex.erase(tokenId);
+        context.tokenDevices.erase(tokenId);
+    }
+    AddressShard &shard = GetWritableShard(snapshot, context, address);
+    auto addressIt = shard.find(address);
+    if (addressIt != shard.end()) {
+        addressIt->second.erase(tokenId);
+        if (addressIt->second.empty()) {
+            shard.erase(addressIt);
+        }
+    }
+    snapshot.size--;
+    auto userIt = snapshot.tokenUserIds.find(tokenId);
+    if (userIt == snapshot.tokenUserIds.end()) {
+        return;
+    }
+    auto countIt = snapshot.userDeviceCounts.find(userIt->second);
+    if (countIt != snapshot.userDeviceCounts.end() && --countIt->second == 0) {
+        snapshot.userDeviceCounts.erase(countIt);
+    }
+    if (isTokenEmpty) {
+        snapshot.tokenUserIds.erase(userIt);
+    }
+}
+
+void PartnerDeviceRegistry::EnsureInsert(const PartnerDeviceMapKey &key, int32_t userId, const DeviceSptr &device)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto snapshot = std::make_shared<Snapshot>(*GetSnapshot());
+    WriteContext context;
+    InsertIndex(*snapshot, context, Entry { key, userId, device });
+    Publish(std::move(snapshot));
+}
+
+bool PartnerDeviceRegistry::InsertIf(const Entry &entry, const std::function<bool(const Snapshot &)> &check)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = GetSnapshot();
+    if (!check(*current)) {
+        return false;
+    }
+    auto snapshot = std::make_shared<Snapshot>(*current);
+    WriteContext context;
+    InsertIndex(*snapshot, context, entry);
+    Publish(std::move(snapshot));
+    return true;
+}
+
+void PartnerDeviceRegistry::EnsureInsertBatch(const std::vector<Entry> &entries)
+{
+    if (entries.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto snapshot = std::make_shared<Snapshot>(*GetSnapshot());
+    // 同一批次中每个分片最多拷贝一次
+    WriteContext context;
+    for (const auto &entry : entries) {
+        InsertIndex(*snapshot, context, entry);
+    }
+    Publish(std::move(snapshot));
+}
+
+void PartnerDeviceRegistry::Erase(const PartnerDeviceMapKey &key)
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto current = GetSnapshot();
+    auto it = current->tokenIndex.find(key.first);
+    if (it == current->tokenIndex.end() || it->second->find(key.second) == it->second->end()) {
+        return;
+    }
+    auto snapshot = std::make_shared<Snapshot>(*current);
+    WriteContext context;
+    EraseIndex(*snapshot, context, key);
+    Publish(std::move(snapshot));
+}
+
+void PartnerDeviceRegistry::Clear()
+{
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Publish(std::make_shared<const Snapshot>());
+}
+
+bool PartnerDeviceRegistry::Find(const PartnerDeviceMapKey &key, DeviceSptr &device) const
+{
+    auto snapshot = GetSnapshot();
+    auto tokenIt = snapshot->tokenIndex.find(key.first);
+    if (tokenIt == snapshot->tokenIndex.end()) {
+        return false;
+    }
+    auto it = tokenIt->second->find(key.second);
+    if (it == tokenIt->second->end()) {
+        return false;
+    }
+    device = it->second;
+    return true;
+}
+
+void PartnerDeviceRegistry::Iterate(
+    const std::function<void(const PartnerDeviceMapKey &, const DeviceSptr &)> &callback) const
+{
+    auto snapshot = GetSnapshot();
+    for (const auto &[tokenId, tokenDevices] : snapshot->tokenIndex) {
+        for (const auto &[address, device] : *tokenDevices) {
+            callback(std::make_pair(tokenId, address), device);
+        }
+    }
+}
+
+bool PartnerDeviceRegistry::IsAddressBound(const FcmMacAddress &address) const
+{
+    auto snapshot = GetSnapshot();
+    const auto &shard = snapshot->addressShards[GetShardIndex(address)];
+    return shard != nullptr && shard->find(address) != shard->end();
+}
+
+void PartnerDeviceRegistry::IterateByAddress(
+    const FcmMacAddress &address, const std::function<void(uint32_t, const DeviceSptr &)> &callback) const
+{
+    auto snapshot = GetSnapshot();
+    const auto &shard = snapshot->addressShards[GetShardIndex(address)];
+    if (shard == nullptr) {
+        return;
+    }
+    auto it = shard->find(address);
+    if (it == shard->end()) {
+        return;
+    }
+    for (const auto &[tokenId, device] : it->second) {
+        callback(tokenId, device);
+    }
+}
+
+void PartnerDeviceRegistry::IterateByTokenId(
+    uint32_t tokenId, const std::function<void(const FcmMacAddress &, const DeviceSptr &)> &callback) const
+{
+    auto snapshot = GetSnapshot();
+    auto it = snapshot->tokenIndex.find(tokenId);
+    if (it == snapshot->tokenIndex.end()) {
+        return;
+    }
+    for (const auto &[address, device] : *it->second) {
+        callback(address, device);
+    }
+}
+
+size_t PartnerDeviceRegistry::CountByTokenId(uint32_t tokenId) const
+{
+    auto snapshot = GetSnapshot();
+    auto it = snapshot->tokenIndex.find(tokenId);
+    return it != snapshot->tokenIndex.end() ? it->second->size() : 0;
+}
+
+size_t PartnerDeviceRegistry::CountByUserId(int32_t userId) const
+{
+    auto snapshot = GetSnapshot();
+    auto it = snapshot->userDeviceCounts.find(userId);
+    return it != snapshot->userDeviceCounts.end() ? it->second : 0;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScanEngine"
+#endif
+
+#include "partner_device_scan_engine.h"
+#include <algorithm>
+#include "datetime_ex.h"
+#include "log.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+using namespace OHOS::Bluetooth;
+
+namespace {
+constexpr uint64_t MILLISEC_2_MICROSEC = 1000;
+constexpr int64_t HOUR_2_MILLISEC = 60 * 60 * 1000;
+
+class BleCentralManagerScanner : public IBleScanner {
+public:
+    explicit BleCentralManagerScanner(std::shared_ptr<BleCentralManagerCallback> callback)
+        : bleCentralManager_(std::make_unique<BleCentralManager>(callback)) {}
+    ~BleCentralManagerScanner() override = default;
+
+    int StartScan(const BleScanSettings &settings, const std::vector<BleScanFilter> &filters) override
+    {
+        return bleCentralManager_->StartScan(settings, filters);
+    }
+
+    int StopScan() override
+    {
+        return bleCentralManager_->StopScan();
+    }
+
+private:
+    std::unique_ptr<BleCentralManager> bleCentralManager_;
+};
+}  // namespace
+
+PartnerDeviceScanEngine &PartnerDeviceScanEngine::GetInstance()
+{
+    static PartnerDeviceScanEngine instance([](std::shared_ptr<BleCentralManagerCallback> callback) {
+        return std::make_unique<BleCentralManagerScanner>(callback);
+    });
+    return instance;
+}
+
+PartnerDeviceScanEngine::PartnerDeviceScanEngine(const IBleScanner::Factory &scannerFactory, uint32_t applyDelayMs,
+    uint32_t minRestartIntervalMs)
+    : scannerFactory_(scannerFactory), applyDelayMs_(applyDelayMs), minRestartIntervalMs_(minRestartIntervalMs)
+{
+    queue_ = std::make_unique<ffrt::queue>("fcm_partner_device_scan");
+}
+
+PartnerDeviceScanEngine::~PartnerDeviceScanEngine()
+{
+    // 析构队列时等待正在执行的任务结束
+    queue_ = nullptr;
+    if (scanner_) {
+        scanner_->StopScan();
+    }
+}
+
+void PartnerDeviceScanEngine::ScanCallback::OnScanCallback(const BleScanResult &result)
+{
+    // 不阻塞蓝牙框架的回调线程
+    owner_.queue_->submit([&owner = owner_, result]() {
+        owner.DispatchScanResult(result, SCAN_EVENT_RESULT);
+    });
+}
+
+void PartnerDeviceScanEngine::ScanCallback::OnFoundOrLostCallback(const BleScanResult &result, uint8_t callbackType)
+{
+    ScanEvent event = SCAN_EVENT_RESULT;
+    if (callbackType == BLE_SCAN_CALLBACK_TYPE_FIRST_MATCH) {
+        event = SCAN_EVENT_FOUND;
+    } else if (callbackType == BLE_SCAN_CALLBACK_TYPE_LOST_MATCH) {
+        event = SCAN_EVENT_LOST;
+    } else {
+        HILOGW("unexpected callback type: %{public}u", callbackType);
+        return;
+    }
+    owner_.queue_->submit([&owner = owner_, result, event]() {
+        owner.DispatchScanResult(result, event);
+    });
+}
+
+void PartnerDeviceScanEngine::ScanCallback::OnBleBatchScanResultsEvent(const std::vector<BleScanResult> &results)
+{
+    owner_.queue_->submit([&owner = owner_, results]() {
+        owner.DispatchBatchScanResults(results);
+    });
+}
+
+uint64_t PartnerDeviceScanEngine::AddFilter(const FcmMacAddress &address, const ScanResultCallback &callback)
+{
+    uint64_t filterId = INVALID_FILTER_ID;
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        filterId = nextFilterId_++;
+        filters_[filterId] = { address, callback };
+        addressFilterIds_[address].push_back(filterId);
+    }
+    ScheduleApply();
+    return filterId;
+}
+
+void PartnerDeviceScanEngine::RemoveFilter(uint64_t filterId)
+{
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        auto it = filters_.find(filterId);
+        if (it == filters_.end()) {
+            return;
+        }
+        auto addressIt = addressFilterIds_.find(it->second.address);
+        if (addressIt != addressFilterIds_.end()) {
+            auto &filterIds = addressIt->second;
+            filterIds.erase(std::remove(filterIds.begin(), filterIds.end(), filterId), filterIds.end());
+            if (filterIds.empty()) {
+                addressFilterIds_.erase(addressIt);
+            }
+        }
+        filters_.erase(it);
+    }
+    ScheduleApply();
+}
+
+void PartnerDeviceScanEngine::SetScanParams(const ScanParams &params)
+{
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        if (scanParams_ == params) {
+            return;
+        }
+        scanParams_ = params;
+    }
+    ScheduleApply();
+}
+
+void PartnerDeviceScanEngine::SetMaxFoundLostFilterNum(size_t filterNum)
+{
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        if (maxFoundLostFilterNum_ == filterNum) {
+            return;
+        }
+        maxFoundLostFilterNum_ = filterNum;
+    }
+    ScheduleApply();
+}
+
+void PartnerDeviceScanEngine::Flush()
+{
+    // 在队列中执行，与延迟任务和扫描结果的分发串行
+    auto handle = queue_->submit_h([this]() {
+        Apply();
+    });
+    if (handle == nullptr) {
+        HILOGE("ffrt queue submit failed");
+        return;
+    }
+    queue_->wait(handle);
+}
+
+size_t PartnerDeviceScanEngine::GetFilterCount()
+{
+    std::lock_guard<std::mutex> lock(filterMutex_);
+    return filters_.size();
+}
+
+PartnerDeviceScanEngine::Metrics PartnerDeviceScanEngine::GetMetrics()
+{
+    // 统计数据只在队列中修改
+    Metrics metrics;
+    auto handle = queue_->submit_h([this, &metrics]() {
+        int64_t nowMs = GetTickCount();
+        while (!restartTimesMs_.empty() && nowMs - restartTimesMs_.front() >= HOUR_2_MILLISEC) {
+            restartTimesMs_.pop_front();
+        }
+        metrics = metrics_;
+        metrics.restartNumInLastHour = restartTimesMs_.size();
+    });
+    if (handle == nullptr) {
+        HILOGE("ffrt queue submit failed");
+        return metrics;
+    }
+    queue_->wait(handle);
+    return metrics;
+}
+
+void PartnerDeviceScanEngine::ScheduleApply()
+{
+    ScheduleApply(applyDelayMs_);
+}
+
+void PartnerDeviceScanEngine::ScheduleApply(uint32_t delayMs)
+{
+    // 延迟内已有待执行的任务，合并到该任务中
+    if (isApplyScheduled_.exchange(true)) {
+        return;
+    }
+    ffrt::task_attr taskAttr;
+    taskAttr.name("fcm_ble_scan_apply").delay(static_cast<uint64_t>(delayMs) * MILLISEC_2_MICROSEC);
+    queue_->submit([this]() {
+        isApplyScheduled_ = false;
+        Apply();
+    }, taskAttr);
+}
+
+PartnerDeviceScanEngine::ReportMode PartnerDeviceScanEngine::SelectReportMode(
+    size_t addressNum, size_t maxFoundLostFilterNum) const
+{
+    // 控制器能跟踪的设备数量有限，超出时或控制器不支持时使用持续上报
+    if (isFoundLostRejected_ || addressNum > maxFoundLostFilterNum) {
+        return REPORT_MODE_CONTINUOUS;
+    }
+    return REPORT_MODE_FOUND_LOST;
+}
+
+void PartnerDeviceScanEngine::Apply()
+{
+    std::set<FcmMacAddress> addresses;
+    ScanParams params;
+    size_t maxFoundLostFilterNum = 0;
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        for (const auto &[address, _] : addressFilterIds_) {
+            addresses.insert(address);
+        }
+        params = scanParams_;
+        maxFoundLostFilterNum = maxFoundLostFilterNum_;
+    }
+
+    if (addresses.empty()) {
+        // 没有设备需要扫描时停止扫描并释放扫描器
+        if (scanner_) {
+            HILOGI("stop ble scan");
+            scanner_->StopScan();
+            scanner_ = nullptr;
+            scanCallback_ = nullptr;
+            metrics_.stopNum++;
+        }
+        scanningAddresses_.clear();
+        return;
+    }
+    ReportMode reportMode = SelectReportMode(addresses.size(), maxFoundLostFilterNum);
+    // found/lost上报时控制器只在设备出现和丢失时上报，无需批量上报
+    ScanParams sessionParams = params;
+    if (reportMode == REPORT_MODE_FOUND_LOST) {
+        sessionParams.reportDelayMs = 0;
+    }
+    bool isRunning = scanner_ && !scanningAddresses_.empty();
+    if (isRunning && addresses == scanningAddresses_ && sessionParams == scanningParams_ &&
+        reportMode == scanningReportMode_) {
+        return;
+    }
+    if (isRunning) {
+        // 限制重新配置控制器的频率，间隔内的变化在间隔结束时一起生效
+        int64_t waitMs = lastStartMs_ + static_cast<int64_t>(minRestartIntervalMs_) - GetTickCount();
+        if (waitMs > 0) {
+            metrics_.rateLimitedNum++;
+            ScheduleApply(static_cast<uint32_t>(waitMs));
+            return;
+        }
+    }
+
+    if (scanner_) {
+        scanner_->StopScan();
+    } else {
+        scanCallback_ = std::make_shared<ScanCallback>(*this);
+        scanner_ = scannerFactory_(scanCallback_);
+        if (!scanner_) {
+            HILOGE("create ble scanner failed");
+            scanCallback_ = nullptr;
+            return;
+        }
+    }
+    int ret = StartScan(addresses, sessionParams, reportMode);
+    if (ret != BT_NO_ERROR && reportMode == REPORT_MODE_FOUND_LOST) {
+        HILOGW("found/lost scan is rejected, ret: %{public}d, fall back to continuous scan", ret);
+        isFoundLostRejected_ = true;
+        reportMode = REPORT_MODE_CONTINUOUS;
+        sessionParams = params;
+        ret = StartScan(addresses, sessionParams, reportMode);
+    }
+    if (ret != BT_NO_ERROR) {
+        HILOGE("start ble scan failed, ret: %{public}d", ret);
+        scanningAddresses_.clear();
+        return;
+    }
+    RecordStart(isRunning);
+    HILOGI("start ble scan, filter num: %{public}zu, scan mode: %{public}d, report mode: %{public}d, "
+        "report delay: %{public}u ms, restarts in last hour: %{public}zu", addresses.size(), sessionParams.scanMode,
+        reportMode, sessionParams.reportDelayMs, restartTimesMs_.size());
+    scanningAddresses_ = std::move(addresses);
+    scanningParams_ = sessionParams;
+    scanningReportMode_ = reportMode;
+}
+
+void PartnerDeviceScanEngine::RecordStart(bool isRestart)
+{
+    lastStartMs_ = GetTickCount();
+    if (!isRestart) {
+        metrics_.startNum++;
+        return;
+    }
+    metrics_.restartNum++;
+    restartTimesMs_.push_back(lastStartMs_);
+    while (lastStartMs_ - restartTimesMs_.front() >= HOUR_2_MILLISEC) {
+        restartTimesMs_.pop_front();
+    }
+}
+
+int PartnerDeviceScanEngine::StartScan(
+    const std::set<FcmMacAddress> &addresses, const ScanParams &params, ReportMode reportMode)
+{
+    BleScanSettings settings;
+    settings.SetScanMode(params.scanMode);
+    settings.SetReportDelay(static_cast<long>(params.reportDelayMs));
+    settings.SetCallbackType(reportMode == REPORT_MODE_FOUND_LOST ?
+        BLE_SCAN_CALLBACK_TYPE_FIRST_AND_LOST_MATCH : BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+    std::vector<BleScanFilter> filters(addresses.size());
+    size_t index = 0;
+    for (const auto &address : addresses) {
+        filters[index++].SetDeviceId(address.ToString());
+    }
+    return scanner_->StartScan(settings, filters);
+}
+
+void PartnerDeviceScanEngine::DispatchScanResult(const BleScanResult &result, ScanEvent event)
+{
+    FcmMacAddress address;
+    if (!FcmMacAddress::FromString(result.GetPeripheralDevice().GetDeviceAddr(), address)) {
+        HILOGE("Invalid address");
+        return;
+    }
+    std::vector<ScanResultCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        auto it = addressFilterIds_.find(address);
+        if (it == addressFilterIds_.end()) {
+            return;
+        }
+        for (uint64_t filterId : it->second) {
+            callbacks.push_back(filters_[filterId].callback);
+        }
+    }
+    // 回调中可能移除过滤条件，在锁外执行
+    for (const auto &callback : callbacks) {
+        callback(result, event);
+    }
+}
+
+void PartnerDeviceScanEngine::DispatchBatchScanResults(const std::vector<BleScanResult> &results)
+{
+    // 同一设备在一批结果中可能上报多次，只保留最近的一条
+    std::unordered_map<FcmMacAddress, size_t> latestIndexes;
+    std::vector<FcmMacAddress> addresses;
+    for (size_t i = 0; i < results.size(); i++) {
+        FcmMacAddress address;
+        if (!FcmMacAddress::FromString(results[i].GetPeripheralDevice().GetDeviceAddr(), address)) {
+            continue;
+        }
+        auto [it, isInserted] = latestIndexes.emplace(address, i);
+        if (isInserted) {
+            addresses.push_back(address);
+        } else {
+            it->second = i;
+        }
+    }
+
+    std::vector<std::pair<ScanResultCallback, size_t>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        for (const auto &address : addresses) {
+            auto it = addressFilterIds_.find(address);
+            if (it == addressFilterIds_.end()) {
+                continue;
+            }
+            for (uint64_t filterId : it->second) {
+                callbacks.emplace_back(filters_[filterId].callback, latestIndexes[address]);
+            }
+        }
+    }
+    HILOGD("batch results: %{public}zu, devices: %{public}zu", results.size(), addresses.size());
+    for (const auto &[callback, index] : callbacks) {
+        callback(results[index], SCAN_EVENT_RESULT);
+    }
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScanPolicy"
+#endif
+
+#include "partner_device_scan_policy.h"
+#include "log.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+using namespace OHOS::Bluetooth;
+
+namespace {
+constexpr uint64_t MILLISEC_2_MICROSEC = 1000;
+}  // namespace
+
+PartnerDeviceScanPolicy &PartnerDeviceScanPolicy::GetInstance()
+{
+    static PartnerDeviceScanPolicy instance(PartnerDeviceScanEngine::GetInstance());
+    return instance;
+}
+
+PartnerDeviceScanPolicy::PartnerDeviceScanPolicy(PartnerDeviceScanEngine &engine, uint32_t debounceWindowMs)
+    : engine_(engine), debounceWindowMs_(debounceWindowMs)
+{
+    queue_ = std::make_unique<ffrt::queue>("fcm_ble_scan_policy");
+}
+
+PartnerDeviceScanPolicy::~PartnerDeviceScanPolicy()
+{
+    // 析构队列时等待正在执行的任务结束
+    queue_ = nullptr;
+}
+
+void PartnerDeviceScanPolicy::SetScreenOn(bool isScreenOn)
+{
+    UpdateState(&State::isScreenOn, isScreenOn);
+}
+
+void PartnerDeviceScanPolicy::SetThermalLevel(int thermalLevel)
+{
+    UpdateState(&State::thermalLevel, thermalLevel);
+}
+
+void PartnerDeviceScanPolicy::SetBatteryLow(bool isBatteryLow)
+{
+    UpdateState(&State::isBatteryLow, isBatteryLow);
+}
+
+void PartnerDeviceScanPolicy::SetDebounceWindow(uint32_t debounceWindowMs)
+{
+    debounceWindowMs_ = debounceWindowMs;
+}
+
+void PartnerDeviceScanPolicy::Flush()
+{
+    auto handle = queue_->submit_h([this]() {
+        Evaluate();
+    });
+    if (handle == nullptr) {
+        HILOGE("ffrt queue submit failed");
+        return;
+    }
+    queue_->wait(handle);
+}
+
+PartnerDeviceScanEngine::ScanParams PartnerDeviceScanPolicy::SelectScanParams(const State &state)
+{
+    bool isThrottled = state.isBatteryLow || state.thermalLevel >= THERMAL_LEVEL_HOT;
+    PartnerDeviceScanEngine::ScanParams params;
+    params.scanMode = (state.isScreenOn && !isThrottled) ? SCAN_MODE_OP_P10_60_600 : SCAN_MODE_OP_P2_60_3000;
+    if (!state.isScreenOn) {
+        params.reportDelayMs = isThrottled ? THROTTLED_REPORT_DELAY_MS : SCREEN_OFF_REPORT_DELAY_MS;
+    }
+    return params;
+}
+
+template <typename T>
+void PartnerDeviceScanPolicy::UpdateState(T State::*field, T value)
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (state_.*field == value) {
+            return;
+        }
+        state_.*field = value;
+    }
+    ScheduleEvaluate();
+}
+
+void PartnerDeviceScanPolicy::ScheduleEvaluate()
+{
+    // 防抖窗口内已有待执行的任务，合并到该任务中
+    if (isEvaluateScheduled_.exchange(true)) {
+        return;
+    }
+    ffrt::task_attr taskAttr;
+    taskAttr.name("fcm_ble_scan_policy").delay(static_cast<uint64_t>(debounceWindowMs_.load()) * MILLISEC_2_MICROSEC);
+    queue_->submit([this]() {
+        isEvaluateScheduled_ = false;
+        Evaluate();
+    }, taskAttr);
+}
+
+void PartnerDeviceScanPolicy::Evaluate()
+{
+    State state;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        state = state_;
+    }
+    PartnerDeviceScanEngine::ScanParams params = SelectScanParams(state);
+    if (params == appliedParams_) {
+        return;
+    }
+    HILOGI("screen on: %{public}d, thermal level: %{public}d, battery low: %{public}d, scan mode: %{public}d, "
+        "report delay: %{public}u ms", state.isScreenOn, state.thermalLevel, state.isBatteryLow, params.scanMode,
+        params.reportDelayMs);
+    engine_.SetScanParams(params);
+    appliedParams_ = params;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
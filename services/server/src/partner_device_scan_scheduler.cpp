@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partner_device_scan_scheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr int64_t SLOT_MS = PartnerDeviceScanScheduler::DAY_MS / PartnerDeviceScanScheduler::SLOT_NUM;
+// 退避时间翻倍的次数上限，避免移位溢出
+constexpr uint32_t MAX_BACKOFF_SHIFT = 30;
+}  // namespace
+
+void PartnerDeviceScanScheduler::OnPresence(int64_t nowMs)
+{
+    missNum_ = 0;
+    int64_t day = nowMs / DAY_MS;
+    Decay(day);
+    int slot = GetSlot(nowMs);
+    // 每天每个时段只计一次，避免频繁连接断开抬高评分；day 从 1 开始计，0 表示从未出现
+    if (presenceDays_[slot] == day + 1) {
+        return;
+    }
+    presenceDays_[slot] = day + 1;
+    scores_[slot] += 1.0f;
+}
+
+int64_t PartnerDeviceScanScheduler::OnMiss(int64_t nowMs)
+{
+    // 设备可能出现的时段内持续扫描，不退避
+    if (IsLikely(nowMs)) {
+        return 0;
+    }
+    missNum_++;
+    uint32_t shift = std::min(missNum_ - 1, MAX_BACKOFF_SHIFT);
+    int64_t backoffMs = std::min(config_.minBackoffMs << shift, config_.maxBackoffMs);
+    // 退避不跨过设备可能出现的时段，在该时段开始时恢复扫描
+    int64_t slotBeginMs = nowMs - nowMs % SLOT_MS;
+    for (int64_t beginMs = slotBeginMs + SLOT_MS; beginMs < nowMs + backoffMs; beginMs += SLOT_MS) {
+        if (IsLikely(beginMs)) {
+            return beginMs - nowMs;
+        }
+    }
+    return backoffMs;
+}
+
+bool PartnerDeviceScanScheduler::IsLikely(int64_t nowMs) const
+{
+    return GetScore(GetSlot(nowMs), nowMs / DAY_MS) >= LIKELY_SCORE;
+}
+
+int PartnerDeviceScanScheduler::GetSlot(int64_t nowMs)
+{
+    int64_t dayMs = nowMs % DAY_MS;
+    if (dayMs < 0) {
+        dayMs += DAY_MS;
+    }
+    return static_cast<int>(dayMs / SLOT_MS);
+}
+
+float PartnerDeviceScanScheduler::GetScore(int slot, int64_t day) const
+{
+    if (day <= scoreDay_) {
+        return scores_[slot];
+    }
+    return scores_[slot] * std::pow(DAILY_DECAY, static_cast<float>(day - scoreDay_));
+}
+
+void PartnerDeviceScanScheduler::Decay(int64_t day)
+{
+    if (day <= scoreDay_) {
+        return;
+    }
+    float decay = std::pow(DAILY_DECAY, static_cast<float>(day - scoreDay_));
+    for (float &score : scores_) {
+        score *= decay;
+    }
+    scoreDay_ = day;
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceSnapshot"
+#endif
+
+#include "partner_device_snapshot.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include "log.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace {
+constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+enum SnapshotRecordFlag : uint32_t {
+    FLAG_HAS_RAW_ADDRESS_TYPE = 1 << 0,
+    FLAG_USER_ENABLED = 1 << 1,
+    FLAG_SUPPORT_BR = 1 << 2,
+    FLAG_SUPPORT_BLE_ADVERTISER = 1 << 3,
+    FLAG_SUPPORT_MEDIA_CONTROL = 1 << 4,
+    FLAG_SUPPORT_TELEPHONY_CONTROL = 1 << 5,
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t recordCount;
+    uint32_t stringTableSize;
+    uint64_t checksum;
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotRecord {
+    SnapshotString bundleName;
+    SnapshotString abilityName;
+    SnapshotString address;
+    uint32_t tokenId;
+    uint32_t flags;
+    int32_t addressType;
+    int32_t rawAddressType;
+    int64_t registerTimestamp;
+    int64_t lostTimestamp;
+};
+
+// 修改结构体布局时需要升级 VERSION
+static_assert(sizeof(SnapshotHeader) == 24, "snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 56, "snapshot record layout changed");
+
+uint32_t MakeFlags(const PartnerDeviceRecord &record)
+{
+    uint32_t flags = 0;
+    flags |= record.hasRawAddressType ? FLAG_HAS_RAW_ADDRESS_TYPE : 0;
+    flags |= record.isUserEnabled ? FLAG_USER_ENABLED : 0;
+    flags |= record.isSupportBR ? FLAG_SUPPORT_BR : 0;
+    flags |= record.isSupportBleAdvertiser ? FLAG_SUPPORT_BLE_ADVERTISER : 0;
+    flags |= record.isSupportMediaControl ? FLAG_SUPPORT_MEDIA_CONTROL : 0;
+    flags |= record.isSupportTelephonyControl ? FLAG_SUPPORT_TELEPHONY_CONTROL : 0;
+    return flags;
+}
+
+class StringTableBuilder {
+public:
+    SnapshotString Add(std::string_view str)
+    {
+        SnapshotString result = { static_cast<uint32_t>(table_.size()), static_cast<uint32_t>(str.size()) };
+        table_.append(str.data(), str.size());
+        return result;
+    }
+
+    // 同一应用绑定的设备共用包名和组件名，只存储一份
+    SnapshotString AddShared(std::string_view str)
+    {
+        auto iter = sharedStrings_.find(str);
+        if (iter != sharedStrings_.end()) {
+            return iter->second;
+        }
+        SnapshotString result = Add(str);
+        sharedStrings_.emplace(str, result);
+        return result;
+    }
+
+    const std::string &GetTable() const
+    {
+        return table_;
+    }
+
+private:
+    std::string table_;
+    // key 指向编码中的记录，在编码期间有效
+    std::unordered_map<std::string_view, SnapshotString> sharedStrings_;
+};
+
+bool GetString(std::string_view stringTable, const SnapshotString &str, std::string_view &result)
+{
+    if (str.offset > stringTable.size() || str.length > stringTable.size() - str.offset) {
+        return false;
+    }
+    result = stringTable.substr(str.offset, str.length);
+    return true;
+}
+}  // namespace
+
+uint64_t PartnerDeviceSnapshot::Checksum(std::string_view content)
+{
+    uint64_t checksum = FNV_OFFSET_BASIS;
+    for (unsigned char c : content) {
+        checksum = (checksum ^ c) * FNV_PRIME;
+    }
+    return checksum;
+}
+
+std::string PartnerDeviceSnapshot::Encode(const std::vector<PartnerDeviceRecord> &records)
+{
+    std::string content(sizeof(SnapshotHeader) + records.size() * sizeof(SnapshotRecord), '\0');
+    StringTableBuilder stringTable;
+    size_t offset = sizeof(SnapshotHeader);
+    for (const auto &record : records) {
+        SnapshotRecord snapshotRecord = {};
+        snapshotRecord.bundleName = stringTable.AddShared(record.bundleName);
+        snapshotRecord.abilityName = stringTable.AddShared(record.abilityName);
+        snapshotRecord.address = stringTable.Add(record.address);
+        snapshotRecord.tokenId = record.tokenId;
+        snapshotRecord.flags = MakeFlags(record);
+        snapshotRecord.addressType = record.addressType;
+        snapshotRecord.rawAddressType = record.rawAddressType;
+        snapshotRecord.registerTimestamp = record.registerTimestamp;
+        snapshotRecord.lostTimestamp = record.lostTimestamp;
+        (void)memcpy(&content[offset], &snapshotRecord, sizeof(snapshotRecord));
+        offset += sizeof(snapshotRecord);
+    }
+    if (records.size() > std::numeric_limits<uint32_t>::max() ||
+        stringTable.GetTable().size() > std::numeric_limits<uint32_t>::max()) {
+        HILOGE("snapshot is too large");
+        return "";
+    }
+    content += stringTable.GetTable();
+
+    SnapshotHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.recordCount = static_cast<uint32_t>(records.size());
+    header.stringTableSize = static_cast<uint32_t>(stringTable.GetTable().size());
+    header.checksum = Checksum(std::string_view(content).substr(sizeof(SnapshotHeader)));
+    (void)memcpy(&content[0], &header, sizeof(header));
+    return content;
+}
+
+bool PartnerDeviceSnapshot::Decode(std::string_view content, std::vector<PartnerDeviceRecord> &records)
+{
+    if (content.size() < sizeof(SnapshotHeader)) {
+        HILOGE("snapshot is truncated, size: %{public}zu", content.size());
+        return false;
+    }
+    SnapshotHeader header = {};
+    (void)memcpy(&header, content.data(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION || header.recordSize != sizeof(SnapshotRecord)) {
+        HILOGE("unsupported snapshot, magic: %{public}x, version: %{public}u", header.magic, header.version);
+        return false;
+    }
+    uint64_t recordsSize = static_cast<uint64_t>(header.recordCount) * sizeof(SnapshotRecord);
+    if (content.size() != sizeof(SnapshotHeader) + recordsSize + header.stringTableSize) {
+        HILOGE("snapshot size mismatch, size: %{public}zu", content.size());
+        return false;
+    }
+    if (Checksum(content.substr(sizeof(SnapshotHeader))) != header.checksum) {
+        HILOGE("snapshot checksum mismatch");
+        return false;
+    }
+
+    std::string_view stringTable = content.substr(sizeof(SnapshotHeader) + recordsSize);
+    std::vector<PartnerDeviceRecord> decodedRecords(header.recordCount);
+    const char *data = content.data() + sizeof(SnapshotHeader);
+    for (auto &record : decodedRecords) {
+        SnapshotRecord snapshotRecord = {};
+        (void)memcpy(&snapshotRecord, data, sizeof(snapshotRecord));
+        data += sizeof(snapshotRecord);
+        if (!GetString(stringTable, snapshotRecord.bundleName, record.bundleName) ||
+            !GetString(stringTable, snapshotRecord.abilityName, record.abilityName) ||
+            !GetString(stringTable, snapshotRecord.address, record.address)) {
+            HILOGE("snapshot string out of range");
+            return false;
+        }
+        record.tokenId = snapshotRecord.tokenId;
+        record.addressType = snapshotRecord.addressType;
+        record.hasRawAddressType = (snapshotRecord.flags & FLAG_HAS_RAW_ADDRESS_TYPE) != 0;
+        record.rawAddressType = snapshotRecord.rawAddressType;
+        record.registerTimestamp = snapshotRecord.registerTimestamp;
+        record.lostTimestamp = snapshotRecord.lostTimestamp;
+        record.isUserEnabled = (snapshotRecord.flags & FLAG_USER_ENABLED) != 0;
+        record.isSupportBR = (snapshotRecord.flags & FLAG_SUPPORT_BR) != 0;
+        record.isSupportBleAdvertiser = (snapshotRecord.flags & FLAG_SUPPORT_BLE_ADVERTISER) != 0;
+        record.isSupportMediaControl = (snapshotRecord.flags & FLAG_SUPPORT_MEDIA_CONTROL) != 0;
+        record.isSupportTelephonyControl = (snapshotRecord.flags & FLAG_SUPPORT_TELEPHONY_CONTROL) != 0;
+    }
+    records.swap(decodedRecords);
+    return true;
+}
+
+PartnerDeviceSnapshotFile::PartnerDeviceSnapshotFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        HILOGI("open snapshot file failed, errno: %{public}d", errno);
+        return;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+        HILOGE("snapshot file is empty, errno: %{public}d", errno);
+        close(fd);
+        return;
+    }
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    // 映射建立后即可关闭文件，文件被原子替换不影响已建立的映射
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        HILOGE("mmap snapshot file failed, errno: %{public}d", errno);
+        return;
+    }
+    addr_ = addr;
+    size_ = size;
+}
+
+PartnerDeviceSnapshotFile::~PartnerDeviceSnapshotFile()
+{
+    if (addr_ != nullptr) {
+        munmap(addr_, size_);
+    }
+}
+
+bool PartnerDeviceSnapshotFile::IsMapped() const
+{
+    return addr_ != nullptr;
+}
+
+std::string_view PartnerDeviceSnapshotFile::GetContent() const
+{
+    return std::string_view(static_cast<const char *>(addr_), size_);
+}
+}  // namespace FusionConnectivity
+}  // namespace OHOS
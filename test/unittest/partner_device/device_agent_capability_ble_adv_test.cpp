@@ -19,11 +19,17 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <string>
 #include <thread>
+#include <vector>
 #include "device_agent_capability_ble_adv.h"
+#include "fcm_scheduler.h"
 #include "partner_device.h"
+#include "timer_manager_ffrt.h"
 #include "log.h"
 #include "bluetooth_ble_central_manager.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_scan_policy.h"
 
 using namespace OHOS;
 using namespace OHOS::FusionConnectivity;
@@ -46,9 +52,11 @@ public:
     static void TearDownTestCase(void);
     void SetUp();
     void TearDown();
+    void CreateDeviceAgent(const PartnerDevicePresenceFilter::Config &config);
 
     std::shared_ptr<MockDependencyFuncs> funcs_;
     std::shared_ptr<DeviceAgentCapabilityBleAdv> deviceAgent_;
+    std::shared_ptr<FcmVirtualScheduler> scheduler_;
 };
 
 void DeviceAgentCapabilityBleAdvTest::SetUpTestCase(void)
@@ -57,19 +65,29 @@ void DeviceAgentCapabilityBleAdvTest::TearDownTestCase(void)
 {}
 void DeviceAgentCapabilityBleAdvTest::SetUp()
 {
+    // 定时器按虚拟时钟运行，由用例推进时间
+    scheduler_ = std::make_shared<FcmVirtualScheduler>();
+    TimerManager::GetInstance()->SetScheduler(scheduler_);
     funcs_ = std::make_shared<NiceMock<MockDependencyFuncs>>();
+    CreateDeviceAgent(PartnerDevicePresenceFilter::Config());
+}
 
+void DeviceAgentCapabilityBleAdvTest::CreateDeviceAgent(const PartnerDevicePresenceFilter::Config &config)
+{
     auto startExtension = [this]() { funcs_->startExtension(); };
     auto destroyExtension = [this](int reason) { funcs_->destroyExtension(reason); };
     IDeviceAgentCapability::DependencyFuncs realFuncs = {
         .startExtension = startExtension,
         .destroyExtension = destroyExtension,
     };
-    deviceAgent_ = std::make_shared<DeviceAgentCapabilityBleAdv>(realFuncs, std::weak_ptr<PartnerDevice>());
+    deviceAgent_ = std::make_shared<DeviceAgentCapabilityBleAdv>(realFuncs, std::weak_ptr<PartnerDevice>(), config);
 }
 
 void DeviceAgentCapabilityBleAdvTest::TearDown()
-{}
+{
+    deviceAgent_ = nullptr;
+    TimerManager::GetInstance()->SetScheduler(nullptr);
+}
 
 // 测试用例1：初始化测试
 /**
@@ -82,7 +100,7 @@ HWTEST_F(DeviceAgentCapabilityBleAdvTest, InitShouldStartScan, TestSize.Level0)
     EXPECT_CALL(*funcs_, startExtension()).Times(0);
     deviceAgent_->Init("00:11:22:33:44:55");
     EXPECT_EQ(deviceAgent_->address_, "00:11:22:33:44:55");
-    EXPECT_NE(deviceAgent_->bleCentralManager_, nullptr);
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
     EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
 }
 
@@ -95,7 +113,7 @@ HWTEST_F(DeviceAgentCapabilityBleAdvTest, InitShouldStartScan, TestSize.Level0)
 HWTEST_F(DeviceAgentCapabilityBleAdvTest, CloseShouldStopScan, TestSize.Level0) {
     deviceAgent_->Init("00:11:22:33:44:55");
     deviceAgent_->Close();
-    EXPECT_EQ(deviceAgent_->bleCentralManager_, nullptr);
+    EXPECT_EQ(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
     EXPECT_FALSE(deviceAgent_->isScanStarted_.load());
 }
 
@@ -106,50 +124,112 @@ HWTEST_F(DeviceAgentCapabilityBleAdvTest, CloseShouldStopScan, TestSize.Level0)
  * @tc.type: FUNC
  */
 HWTEST_F(DeviceAgentCapabilityBleAdvTest, ScanCallbackTest, TestSize.Level0) {
+    PartnerDevicePresenceFilter::Config config;
     deviceAgent_->Init("00:11:22:33:44:55");
-    deviceAgent_->extensionKeepAliveTimeout_ = 1;
-    Bluetooth::BleScanResult scanResult;
+    Bluetooth::BleScanResult weakResult;
+    weakResult.SetRssi(config.enterRssi - 1);
+    Bluetooth::BleScanResult strongResult;
+    strongResult.SetRssi(config.enterRssi);
 
     EXPECT_CALL(*funcs_, startExtension()).Times(1);
     EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_DEVICE_LOST)).Times(1);
 
-    deviceAgent_->bluetoothScanCallback_->OnScanCallback(scanResult);
+    // 信号弱于进入阈值，或强信号次数不足时不拉起extension
+    deviceAgent_->OnScanResult(weakResult);
+    deviceAgent_->OnScanResult(weakResult);
+    deviceAgent_->OnScanResult(strongResult);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
+    deviceAgent_->OnScanResult(strongResult);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
 
-    EXPECT_NE(deviceAgent_->scanTimer_, nullptr);
+    ASSERT_NE(deviceAgent_->scanTimer_, nullptr);
     EXPECT_TRUE(deviceAgent_->scanTimer_->IsStarted());
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    // 退出延时到达前不销毁extension，退出最多延后宽限时间
+    scheduler_->AdvanceBy(static_cast<uint64_t>(config.exitDelayMs) - 1);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    scheduler_->AdvanceBy(static_cast<uint64_t>(config.exitSlackMs) + 1);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
 }
 
-// 测试用例4：ACL连接测试
+// 测试用例4：found/lost上报测试
+/**
+ * @tc.name: FoundLostTest
+ * @tc.desc: 验证控制器上报发现且信号满足进入阈值时才拉起extension并保持扫描，上报丢失后经过退出延时断开extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBleAdvTest, FoundLostTest, TestSize.Level0) {
+    PartnerDevicePresenceFilter::Config config;
+    deviceAgent_->Init("00:11:22:33:44:55");
+    Bluetooth::BleScanResult weakResult;
+    weakResult.SetRssi(config.enterRssi - 1);
+    Bluetooth::BleScanResult scanResult;
+    scanResult.SetRssi(config.enterRssi);
+
+    EXPECT_CALL(*funcs_, startExtension()).Times(1);
+    EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_DEVICE_LOST)).Times(1);
+
+    // 信号不足的发现不拉起extension，之后的丢失也不启动退出定时器
+    deviceAgent_->OnScanEvent(weakResult, PartnerDeviceScanEngine::SCAN_EVENT_FOUND);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
+    deviceAgent_->OnScanEvent(weakResult, PartnerDeviceScanEngine::SCAN_EVENT_LOST);
+    EXPECT_TRUE(deviceAgent_->scanTimer_ == nullptr || !deviceAgent_->scanTimer_->IsStarted());
+
+    deviceAgent_->OnScanEvent(scanResult, PartnerDeviceScanEngine::SCAN_EVENT_FOUND);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    EXPECT_TRUE(deviceAgent_->scanTimer_ == nullptr || !deviceAgent_->scanTimer_->IsStarted());
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
+
+    deviceAgent_->OnScanEvent(scanResult, PartnerDeviceScanEngine::SCAN_EVENT_LOST);
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    scheduler_->AdvanceBy(static_cast<uint64_t>(config.exitDelayMs) - 1);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    scheduler_->AdvanceBy(static_cast<uint64_t>(config.exitSlackMs) + 1);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
+    deviceAgent_->Close();
+}
+
+// 测试用例5：ACL连接测试
 /**
  * @tc.name: AclConnectedTest
- * @tc.desc: 验证ACL连接时停止扫描
+ * @tc.desc: 验证ACL连接时停止扫描，断连后恢复扫描
  * @tc.type: FUNC
  */
 HWTEST_F(DeviceAgentCapabilityBleAdvTest, AclConnectedTest, TestSize.Level0) {
     deviceAgent_->Init("00:11:22:33:44:55");
     deviceAgent_->OnBluetoothDeviceAclConnected();
     EXPECT_FALSE(deviceAgent_->isScanStarted_.load());
-    EXPECT_EQ(deviceAgent_->scanTimer_, nullptr);
+    EXPECT_EQ(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    EXPECT_TRUE(deviceAgent_->scanTimer_ == nullptr || !deviceAgent_->scanTimer_->IsStarted());
+
+    deviceAgent_->OnBluetoothDeviceAclDisconnected();
+    EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    deviceAgent_->Close();
 }
 
-// 测试用例5：屏幕状态测试
+// 测试用例6：屏幕状态测试
 /**
  * @tc.name: ScreenStateChangeTest
- * @tc.desc: 验证屏幕状态变化时调整扫描模式
+ * @tc.desc: 验证亮灭屏时设备不重启扫描，扫描参数由扫描策略统一调整
  * @tc.type: FUNC
  */
 HWTEST_F(DeviceAgentCapabilityBleAdvTest, ScreenStateChangeTest, TestSize.Level0) {
     deviceAgent_->Init("00:11:22:33:44:55");
-
-    deviceAgent_->OnScreenOn();
-    EXPECT_EQ(deviceAgent_->curScanMode_.load(), Bluetooth::SCAN_MODE_OP_P10_60_600);
+    uint64_t scanFilterId = deviceAgent_->scanFilterId_;
 
     deviceAgent_->OnScreenOff();
-    EXPECT_EQ(deviceAgent_->curScanMode_.load(), Bluetooth::SCAN_MODE_OP_P2_60_3000);
+    EXPECT_EQ(deviceAgent_->scanFilterId_, scanFilterId);
+    EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
+
+    deviceAgent_->OnScreenOn();
+    EXPECT_EQ(deviceAgent_->scanFilterId_, scanFilterId);
+    EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
+    deviceAgent_->Close();
 }
 
-// 测试用例6：线程安全测试
+// 测试用例7：线程安全测试
 /**
  * @tc.name: ThreadSafetyTest
  * @tc.desc: 验证多线程环境下的扫描操作安全性
@@ -176,3 +256,89 @@ HWTEST_F(DeviceAgentCapabilityBleAdvTest, ThreadSafetyTest, TestSize.Level1) {
 
     EXPECT_FALSE(deviceAgent_->isScanStarted_.load());
 }
+
+// 测试用例8：扫描占空比测试
+/**
+ * @tc.name: DutyCycleTest
+ * @tc.desc: 验证扫描窗口内未发现设备时移除过滤条件退避，退避期间不重新扫描，退避结束后恢复扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBleAdvTest, DutyCycleTest, TestSize.Level0) {
+    deviceAgent_->Init("00:11:22:33:44:55");
+    ASSERT_NE(deviceAgent_->dutyCycleTimer_, nullptr);
+    Timer *dutyCycleTimer = deviceAgent_->dutyCycleTimer_.get();
+
+    // 定时器重新计时后，执行中的过期回调不生效
+    deviceAgent_->OnDutyCycleTimeout();
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+
+    // 模拟扫描窗口超时
+    dutyCycleTimer->Stop();
+    deviceAgent_->OnDutyCycleTimeout();
+    EXPECT_EQ(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    EXPECT_TRUE(deviceAgent_->isScanStarted_.load());
+    EXPECT_EQ(deviceAgent_->scanScheduler_.GetMissNum(), 1);
+
+    deviceAgent_->OnExtensionDestroy();
+    EXPECT_EQ(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+
+    // 模拟退避暂停超时，扫描窗口和退避暂停复用同一个定时器
+    dutyCycleTimer->Stop();
+    deviceAgent_->OnDutyCycleTimeout();
+    EXPECT_NE(deviceAgent_->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    EXPECT_EQ(deviceAgent_->dutyCycleTimer_.get(), dutyCycleTimer);
+
+    deviceAgent_->OnBluetoothDeviceAclConnected();
+    EXPECT_EQ(deviceAgent_->scanScheduler_.GetMissNum(), 0);
+    EXPECT_EQ(deviceAgent_->dutyCycleHandler_, nullptr);
+    EXPECT_FALSE(dutyCycleTimer->IsStarted());
+    deviceAgent_->Close();
+}
+
+// 测试用例9：found/lost抖动测试
+/**
+ * @tc.name: FoundLostFlappingTest
+ * @tc.desc: 验证设备丢失后在退出延时内再次出现，不重复拉起extension，也不断开extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBleAdvTest, FoundLostFlappingTest, TestSize.Level0) {
+    deviceAgent_->Init("00:11:22:33:44:55");
+    Bluetooth::BleScanResult scanResult;
+    scanResult.SetRssi(PartnerDevicePresenceFilter::Config().enterRssi);
+
+    EXPECT_CALL(*funcs_, startExtension()).Times(1);
+    EXPECT_CALL(*funcs_, destroyExtension(_)).Times(0);
+    for (int i = 0; i < 10; ++i) {
+        deviceAgent_->OnScanEvent(scanResult, PartnerDeviceScanEngine::SCAN_EVENT_FOUND);
+        deviceAgent_->OnScanEvent(scanResult, PartnerDeviceScanEngine::SCAN_EVENT_LOST);
+    }
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    ASSERT_NE(deviceAgent_->scanTimer_, nullptr);
+    EXPECT_TRUE(deviceAgent_->scanTimer_->IsStarted());
+    deviceAgent_->Close();
+}
+
+// 测试用例10：批量上报测试
+/**
+ * @tc.name: BatchedResultsShouldEnter
+ * @tc.desc: 验证降频扫描按10s批量上报，每批同一设备只分发一条结果，连续两批上报强信号时拉起extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBleAdvTest, BatchedResultsShouldEnter, TestSize.Level0) {
+    const std::string address = "00:11:22:33:44:55";
+    // 控制器的批量上报时刻有抖动
+    const uint64_t reportJitterMs = 1000;
+    deviceAgent_->Init(address);
+    Bluetooth::BleScanResult scanResult;
+    scanResult.SetPeripheralDevice(Bluetooth::BluetoothRemoteDevice(address, Bluetooth::BT_TRANSPORT_BLE));
+    scanResult.SetRssi(PartnerDevicePresenceFilter::Config().enterRssi);
+    std::vector<Bluetooth::BleScanResult> batch(PartnerDevicePresenceFilter::Config().sightingNum, scanResult);
+
+    EXPECT_CALL(*funcs_, startExtension()).Times(1);
+    PartnerDeviceScanEngine::GetInstance().DispatchBatchScanResults(batch);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
+    scheduler_->AdvanceBy(PartnerDeviceScanPolicy::THROTTLED_REPORT_DELAY_MS + reportJitterMs);
+    PartnerDeviceScanEngine::GetInstance().DispatchBatchScanResults(batch);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    deviceAgent_->Close();
+}
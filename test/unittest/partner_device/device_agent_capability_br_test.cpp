@@ -19,15 +19,27 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <random>
 #include <thread>
+#include <vector>
 #include "device_agent_capability_br.h"
+#include "fcm_scheduler.h"
 #include "partner_device.h"
+#include "timer_manager_ffrt.h"
 #include "log.h"
 
 using namespace OHOS::FusionConnectivity;
 using namespace testing;
 using namespace testing::ext;
 
+namespace {
+const int TIMER_DELAY_MS = 60 * 1000;
+const uint32_t CHURN_CYCLE_NUM = 10000;
+const uint64_t CHURN_MAX_CONNECTED_MS = 10 * 60 * 1000;  // 10min
+const uint64_t CHURN_MAX_GAP_MS = 6 * 60 * 1000;  // 6min，退出延时的两倍
+const uint64_t SEC_TO_MILLISEC = 1000;
+}  // namespace
+
 // Mock依赖函数接口
 class MockDependencyFuncs {
 public:
@@ -44,9 +56,11 @@ public:
     static void TearDownTestCase(void);
     void SetUp();
     void TearDown();
+    void CreateDeviceAgent(int64_t exitDelayMs);
 
     std::shared_ptr<MockDependencyFuncs> funcs_;
     std::shared_ptr<DeviceAgentCapabilityBr> deviceAgent_;
+    std::shared_ptr<FcmVirtualScheduler> scheduler_;
 };
 
 void DeviceAgentCapabilityBrTest::SetUpTestCase(void)
@@ -55,19 +69,32 @@ void DeviceAgentCapabilityBrTest::TearDownTestCase(void)
 {}
 void DeviceAgentCapabilityBrTest::SetUp()
 {
+    // 定时器按虚拟时钟运行，由用例推进时间
+    scheduler_ = std::make_shared<FcmVirtualScheduler>();
+    TimerManager::GetInstance()->SetScheduler(scheduler_);
     funcs_ = std::make_shared<NiceMock<MockDependencyFuncs>>();
+    CreateDeviceAgent(PartnerDevicePresenceFilter::Config().exitDelayMs);
+}
 
+void DeviceAgentCapabilityBrTest::CreateDeviceAgent(int64_t exitDelayMs)
+{
     auto startExtension = [this]() { funcs_->startExtension(); };
     auto destroyExtension = [this](int reason) { funcs_->destroyExtension(reason); };
     IDeviceAgentCapability::DependencyFuncs realFuncs = {
         .startExtension = startExtension,
         .destroyExtension = destroyExtension,
     };
-    deviceAgent_ = std::make_shared<DeviceAgentCapabilityBr>(realFuncs, std::weak_ptr<PartnerDevice>());
+    PartnerDevicePresenceFilter::Config config;
+    config.exitDelayMs = exitDelayMs;
+    config.exitSlackMs = 0;
+    deviceAgent_ = std::make_shared<DeviceAgentCapabilityBr>(realFuncs, std::weak_ptr<PartnerDevice>(), config);
 }
 
 void DeviceAgentCapabilityBrTest::TearDown()
-{}
+{
+    deviceAgent_ = nullptr;
+    TimerManager::GetInstance()->SetScheduler(nullptr);
+}
 
 /**
  * @tc.name: InitShouldSetIsInitTrue
@@ -113,11 +140,15 @@ HWTEST_F(DeviceAgentCapabilityBrTest, AclConnectedShouldResetTimer, TestSize.Lev
 {
     deviceAgent_->Init("00:11:22:33:44:55");
     deviceAgent_->aclDisconnectTimer_ = std::make_unique<Timer>([]() {});
+    deviceAgent_->aclDisconnectTimer_->Start(TIMER_DELAY_MS);
+    Timer *timer = deviceAgent_->aclDisconnectTimer_.get();
 
     EXPECT_CALL(*funcs_, startExtension()).Times(1);
     deviceAgent_->OnBluetoothDeviceAclConnected();
 
-    EXPECT_EQ(deviceAgent_->aclDisconnectTimer_, nullptr);
+    // 定时器停止后保留，下次断连时复用
+    EXPECT_EQ(deviceAgent_->aclDisconnectTimer_.get(), timer);
+    EXPECT_FALSE(timer->IsStarted());
 }
 
 /**
@@ -128,14 +159,19 @@ HWTEST_F(DeviceAgentCapabilityBrTest, AclConnectedShouldResetTimer, TestSize.Lev
 HWTEST_F(DeviceAgentCapabilityBrTest, AclDisconnectedShouldStartTimer, TestSize.Level0)
 {
     deviceAgent_->Init("00:11:22:33:44:55");
-    deviceAgent_->extensionKeepAliveTimeout_ = 1;
+    int64_t exitDelayMs = deviceAgent_->presenceFilter_.GetConfig().exitDelayMs;
 
     EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_DEVICE_LOST)).Times(1);
     deviceAgent_->OnBluetoothDeviceAclDisconnected();
 
     EXPECT_NE(deviceAgent_->aclDisconnectTimer_, nullptr);
     EXPECT_TRUE(deviceAgent_->aclDisconnectTimer_->IsStarted());
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // 退出延时到达前不销毁extension
+    scheduler_->AdvanceBy(static_cast<uint64_t>(exitDelayMs) - 1);
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+    scheduler_->AdvanceBy(1);
+    EXPECT_FALSE(deviceAgent_->presenceFilter_.IsPresent());
+    EXPECT_FALSE(deviceAgent_->aclDisconnectTimer_->IsStarted());
 }
 
 /**
@@ -162,9 +198,10 @@ HWTEST_F(DeviceAgentCapabilityBrTest, TimerThreadSafetyTest, TestSize.Level0)
     thread1.join();
     thread2.join();
 
-    // 验证定时器状态
-    EXPECT_TRUE(deviceAgent_->aclDisconnectTimer_ == nullptr ||
-               deviceAgent_->aclDisconnectTimer_->IsStarted());
+    // 验证定时器状态：定时器只在等待设备退出时运行
+    bool isTimerStarted = deviceAgent_->aclDisconnectTimer_ != nullptr &&
+        deviceAgent_->aclDisconnectTimer_->IsStarted();
+    EXPECT_EQ(isTimerStarted, deviceAgent_->presenceFilter_.GetExitTimeMs() >= 0);
 }
 
 /**
@@ -191,3 +228,64 @@ HWTEST_F(DeviceAgentCapabilityBrTest, ExtensionDestroyEventShouldDoNothing, Test
     EXPECT_CALL(*funcs_, destroyExtension(_)).Times(0);
     deviceAgent_->OnExtensionDestroy();
 }
+
+/**
+ * @tc.name: ReconnectWithinExitDelayShouldNotRestartExtension
+ * @tc.desc: 测试用例9：ACL断连后在退出延时内重连，不重复拉起extension，也不销毁extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBrTest, ReconnectWithinExitDelayShouldNotRestartExtension, TestSize.Level0)
+{
+    deviceAgent_->Init("00:11:22:33:44:55");
+
+    EXPECT_CALL(*funcs_, startExtension()).Times(1);
+    EXPECT_CALL(*funcs_, destroyExtension(_)).Times(0);
+    for (int i = 0; i < 10; ++i) {
+        deviceAgent_->OnBluetoothDeviceAclConnected();
+        deviceAgent_->OnBluetoothDeviceAclDisconnected();
+    }
+    deviceAgent_->OnBluetoothDeviceAclConnected();
+    ASSERT_NE(deviceAgent_->aclDisconnectTimer_, nullptr);
+    EXPECT_FALSE(deviceAgent_->aclDisconnectTimer_->IsStarted());
+    EXPECT_TRUE(deviceAgent_->presenceFilter_.IsPresent());
+}
+
+/**
+ * @tc.name: PresenceChurnShouldRunInVirtualTime
+ * @tc.desc: 测试用例10：按真实的3分钟退出延时模拟上万次连接断连，断连超过退出延时才销毁extension，重连时重新拉起
+ * @tc.type: FUNC
+ */
+HWTEST_F(DeviceAgentCapabilityBrTest, PresenceChurnShouldRunInVirtualTime, TestSize.Level1)
+{
+    deviceAgent_->Init("00:11:22:33:44:55");
+    uint64_t exitDelayMs = static_cast<uint64_t>(deviceAgent_->presenceFilter_.GetConfig().exitDelayMs);
+    std::mt19937 random(0);
+    std::vector<uint64_t> connectedMs(CHURN_CYCLE_NUM);
+    std::vector<uint64_t> gapMs(CHURN_CYCLE_NUM);
+    int expectedStartNum = 0;
+    int expectedDestroyNum = 0;
+    bool isPresent = false;
+    for (uint32_t i = 0; i < CHURN_CYCLE_NUM; i++) {
+        connectedMs[i] = (random() % (CHURN_MAX_CONNECTED_MS / SEC_TO_MILLISEC) + 1) * SEC_TO_MILLISEC;
+        gapMs[i] = (random() % (CHURN_MAX_GAP_MS / SEC_TO_MILLISEC) + 1) * SEC_TO_MILLISEC;
+        expectedStartNum += isPresent ? 0 : 1;
+        isPresent = gapMs[i] < exitDelayMs;
+        expectedDestroyNum += isPresent ? 0 : 1;
+    }
+    EXPECT_CALL(*funcs_, startExtension()).Times(expectedStartNum);
+    EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_DEVICE_LOST)).Times(expectedDestroyNum);
+
+    uint64_t beginMs = scheduler_->GetNowMs();
+    uint64_t simulatedMs = 0;
+    for (uint32_t i = 0; i < CHURN_CYCLE_NUM; i++) {
+        simulatedMs += connectedMs[i] + gapMs[i];
+        deviceAgent_->OnBluetoothDeviceAclConnected();
+        scheduler_->AdvanceBy(connectedMs[i]);
+        deviceAgent_->OnBluetoothDeviceAclDisconnected();
+        scheduler_->AdvanceBy(gapMs[i]);
+    }
+    // 模拟只推进虚拟时钟，退出延时的定时器不会堆积
+    EXPECT_EQ(scheduler_->GetNowMs() - beginMs, simulatedMs);
+    EXPECT_LE(scheduler_->GetTaskNum(), 1u);
+    EXPECT_EQ(deviceAgent_->presenceFilter_.IsPresent(), isPresent);
+}
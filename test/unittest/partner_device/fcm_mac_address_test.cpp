@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "FcmMacAddressTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "fcm_address_utils.h"
+#include "fcm_mac_address.h"
+#include "log.h"
+
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+int g_allocCount = 0;
+
+// 统计分配次数的分配器，只统计使用它的字符串和容器，不替换全局的 operator new
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        g_allocCount++;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *ptr, size_t n)
+    {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T> &, const CountingAllocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T> &, const CountingAllocator<U> &)
+{
+    return false;
+}
+
+using CountedString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+template <typename Address>
+using CountedMap = std::map<std::pair<uint32_t, Address>, int, std::less<std::pair<uint32_t, Address>>,
+    CountingAllocator<std::pair<const std::pair<uint32_t, Address>, int>>>;
+
+// 统计一段代码中计数字符串和容器的堆内存分配次数
+template <typename Func>
+int CountAllocations(Func func)
+{
+    g_allocCount = 0;
+    func();
+    return g_allocCount;
+}
+
+// 修改前 DeviceInfo 中参与比较的字段
+struct StringDeviceInfo {
+    CountedString bundleName = "com.example.partner.device.agent";
+    CountedString abilityName = "PartnerAgentExtensionAbility";
+    CountedString address = "00:11:22:33:44:55";
+};
+
+// 修改前逐字符 switch 的校验实现，作为对照
+bool LegacyIsValidAddress(const std::string &addr)
+{
+    const size_t addressLength = 17;
+    const size_t colonIndex = 2;
+    const size_t separatorUnit = 3;
+    if (addr.empty() || addr.length() != addressLength) {
+        return false;
+    }
+    for (size_t i = 0; i < addressLength; i++) {
+        char c = addr[i];
+        switch (i % separatorUnit) {
+            case 0:
+            case 1:
+                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
+                    break;
+                }
+                return false;
+            case colonIndex:
+            default:
+                if (c == ':') {
+                    break;
+                }
+                return false;
+        }
+    }
+    return true;
+}
+
+// 生成地址样本，非法样本在随机位置替换一个随机字符
+std::vector<std::string> MakeAddressSamples(size_t num, bool isValid)
+{
+    const char hexChars[] = "0123456789abcdefABCDEF";
+    const size_t hexCharNum = sizeof(hexChars) - 1;
+    std::mt19937 engine(num);
+    std::vector<std::string> samples;
+    while (samples.size() < num) {
+        std::string addr = "00:00:00:00:00:00";
+        for (size_t i = 0; i < addr.length(); i++) {
+            if (addr[i] != ':') {
+                addr[i] = hexChars[engine() % hexCharNum];
+            }
+        }
+        if (!isValid) {
+            addr[engine() % addr.length()] = static_cast<char>(engine() % 256);  // 256: all chars
+        }
+        if (LegacyIsValidAddress(addr) == isValid) {
+            samples.push_back(addr);
+        }
+    }
+    return samples;
+}
+
+}  // namespace
+
+class FcmMacAddressTest : public testing::Test {
+public:
+    FcmMacAddressTest() = default;
+    ~FcmMacAddressTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void FcmMacAddressTest::SetUpTestCase(void)
+{}
+void FcmMacAddressTest::TearDownTestCase(void)
+{}
+void FcmMacAddressTest::SetUp()
+{}
+void FcmMacAddressTest::TearDown()
+{}
+
+/**
+ * @tc.name: ParseAndFormat
+ * @tc.desc: 测试用例1：地址字符串解析与格式化，十六进制大小写不敏感
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmMacAddressTest, ParseAndFormat, TestSize.Level0)
+{
+    FcmMacAddress addr;
+    EXPECT_TRUE(FcmMacAddress::FromString("00:11:22:AA:bb:Cc", addr));
+    EXPECT_EQ(addr.GetValue(), 0x001122AABBCCULL);
+    EXPECT_EQ(addr.ToString(), "00:11:22:AA:BB:CC");
+    FcmMacAddress lowerAddr;
+    EXPECT_TRUE(FcmMacAddress::FromString("00:11:22:aa:bb:cc", lowerAddr));
+    EXPECT_EQ(addr, lowerAddr);
+
+    FcmMacAddress maxAddr(0xFFFFFFFFFFFFFFFFULL);
+    EXPECT_EQ(maxAddr.ToString(), "FF:FF:FF:FF:FF:FF");
+}
+
+/**
+ * @tc.name: ParseInvalidAddress
+ * @tc.desc: 测试用例2：非法地址字符串解析失败
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmMacAddressTest, ParseInvalidAddress, TestSize.Level0)
+{
+    FcmMacAddress addr;
+    EXPECT_FALSE(FcmMacAddress::FromString("", addr));
+    EXPECT_FALSE(FcmMacAddress::FromString("00:11:22:33:44", addr));
+    EXPECT_FALSE(FcmMacAddress::FromString("00:11:22:33:44:555", addr));
+    EXPECT_FALSE(FcmMacAddress::FromString("00-11-22-33-44-55", addr));
+    EXPECT_FALSE(FcmMacAddress::FromString("00:11:22:33:44:5G", addr));
+    EXPECT_FALSE(FcmMacAddress::FromString("0:011:22:33:44:55", addr));
+    // 解析失败时不修改输出的地址
+    EXPECT_EQ(addr, FcmMacAddress());
+}
+
+/**
+ * @tc.name: AllocationCount
+ * @tc.desc: 测试用例3：统计绑定、查询、事件分发路径修改前后的堆内存分配次数，修改后不分配
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmMacAddressTest, AllocationCount, TestSize.Level1)
+{
+    const uint32_t tokenId = 1;
+    const CountedString eventAddr = "00:11:22:33:44:55";
+    CountedMap<CountedString> stringMap = { { { tokenId, eventAddr }, 0 } };
+    const FcmMacAddress cachedAddr(0x001122334455ULL);
+    CountedMap<FcmMacAddress> macMap = { { { tokenId, cachedAddr }, 0 } };
+    StringDeviceInfo stringInfo;
+    bool isMatch = false;
+
+    // 绑定：构造注册表键值
+    int bindBefore = CountAllocations([&]() {
+        auto key = std::make_pair(tokenId, CountedString(stringInfo.address));
+        isMatch = !key.second.empty();
+    });
+    int bindAfter = CountAllocations([&]() {
+        auto key = std::make_pair(tokenId, FcmMacAddress());
+        isMatch = FcmMacAddress::FromString(eventAddr, key.second) && key.second == cachedAddr;
+    });
+    // 查询：拷贝地址构造键值后查找
+    int lookupBefore = CountAllocations([&]() {
+        CountedString address = stringInfo.address;
+        isMatch = stringMap.find(std::make_pair(tokenId, address)) != stringMap.end();
+    });
+    int lookupAfter = CountAllocations([&]() {
+        FcmMacAddress addr;
+        isMatch = FcmMacAddress::FromString(eventAddr, addr) &&
+            macMap.find(std::make_pair(tokenId, addr)) != macMap.end();
+    });
+    // 事件分发：修改前拷贝 DeviceInfo 后比较地址字符串
+    int eventBefore = CountAllocations([&]() {
+        StringDeviceInfo info = stringInfo;
+        isMatch = info.address == eventAddr;
+    });
+    int eventAfter = CountAllocations([&]() {
+        FcmMacAddress addr;
+        isMatch = FcmMacAddress::FromString(eventAddr, addr) && addr == cachedAddr;
+    });
+    EXPECT_TRUE(isMatch);
+
+    // 短字符串优化的长度与标准库实现有关，修改前的地址拷贝不一定分配，DeviceInfo 的拷贝一定分配
+    EXPECT_GE(bindBefore, bindAfter);
+    EXPECT_GE(lookupBefore, lookupAfter);
+    EXPECT_GT(eventBefore, eventAfter);
+    EXPECT_EQ(bindAfter, 0);
+    EXPECT_EQ(lookupAfter, 0);
+    EXPECT_EQ(eventAfter, 0);
+}
+
+/**
+ * @tc.name: ValidateConsistency
+ * @tc.desc: 测试用例4：查表校验与修改前的逐字符校验结果一致
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmMacAddressTest, ValidateConsistency, TestSize.Level0)
+{
+    const size_t sampleNum = 10000;
+    for (bool isValid : { true, false }) {
+        for (const auto &addr : MakeAddressSamples(sampleNum, isValid)) {
+            EXPECT_EQ(IsValidAddress(addr), isValid) << addr;
+        }
+    }
+    EXPECT_FALSE(IsValidAddress(""));
+    EXPECT_FALSE(IsValidAddress(std::string("00:11:22:33:44:5\0", 17)));
+    EXPECT_FALSE(IsValidAddress("00:11:22:33:44:55:"));
+
+    uint64_t value = 0;
+    EXPECT_TRUE(ParseAddress("Ff:00:aB:12:cD:9e", value));
+    EXPECT_EQ(value, 0xFF00AB12CD9EULL);
+}
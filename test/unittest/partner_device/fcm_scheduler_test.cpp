@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "FcmSchedulerTest"
+#endif
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "fcm_scheduler.h"
+#include "fcm_thread_util.h"
+#include "timer_manager.h"
+#include "timer_manager_ffrt.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const uint64_t EXIT_DELAY_MS = 3 * 60 * 1000;  // 3min，与退出延时相同
+const uint64_t HOUR_MS = 60 * 60 * 1000;
+}  // namespace
+
+class FcmSchedulerTest : public testing::Test {
+public:
+    FcmSchedulerTest() = default;
+    ~FcmSchedulerTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    std::shared_ptr<FcmVirtualScheduler> scheduler_;
+};
+
+void FcmSchedulerTest::SetUpTestCase(void)
+{}
+void FcmSchedulerTest::TearDownTestCase(void)
+{}
+void FcmSchedulerTest::SetUp()
+{
+    scheduler_ = std::make_shared<FcmVirtualScheduler>();
+}
+void FcmSchedulerTest::TearDown()
+{
+    FcmThreadUtil::GetInstance().SetScheduler(nullptr);
+}
+
+/**
+ * @tc.name: VirtualSchedulerShouldRunTasksInOrder
+ * @tc.desc: 测试用例1：虚拟时钟只在推进时执行到期任务，按到期时刻和提交顺序执行，取消的任务不执行
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmSchedulerTest, VirtualSchedulerShouldRunTasksInOrder, TestSize.Level0)
+{
+    std::vector<int> order;
+    std::vector<uint64_t> runMs;
+    auto post = [this, &order, &runMs](int id, uint64_t delayMs) {
+        return scheduler_->PostDelayTask([this, &order, &runMs, id]() {
+            order.push_back(id);
+            runMs.push_back(scheduler_->GetNowMs());
+        }, delayMs, "test");
+    };
+    post(1, 300);
+    post(2, 100);
+    post(3, 100);
+    FcmScheduler::TaskId cancelId = post(4, 200);
+    // 任务中提交的任务到期时在同一次推进中执行
+    scheduler_->PostDelayTask([&post]() { post(5, 50); }, 200, "test");
+    scheduler_->CancelTask(cancelId);
+    EXPECT_EQ(scheduler_->GetTaskNum(), 4u);
+    EXPECT_EQ(scheduler_->GetNextDueMs(), 100u);
+
+    EXPECT_EQ(scheduler_->AdvanceBy(99), 0u);
+    EXPECT_EQ(scheduler_->GetNowMs(), 99u);
+    EXPECT_EQ(scheduler_->AdvanceTo(260), 4u);
+    EXPECT_EQ(scheduler_->GetNowMs(), 260u);
+    EXPECT_EQ(scheduler_->AdvanceTo(0), 0u);
+    EXPECT_EQ(scheduler_->GetNowMs(), 260u);
+    EXPECT_EQ(scheduler_->AdvanceBy(HOUR_MS), 1u);
+    EXPECT_EQ(order, std::vector<int>({ 2, 3, 5, 1 }));
+    EXPECT_EQ(runMs, std::vector<uint64_t>({ 100, 100, 250, 300 }));
+    EXPECT_EQ(scheduler_->GetNextDueMs(), UINT64_MAX);
+}
+
+/**
+ * @tc.name: TimersShouldRunInVirtualTime
+ * @tc.desc: 测试用例2：定时器按虚拟时钟超时，3分钟的定时器不提前超时，1小时的周期定时器在毫秒级耗时内按次数超时
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmSchedulerTest, TimersShouldRunInVirtualTime, TestSize.Level0)
+{
+    TimerManager manager(TimerManager::DEFAULT_TICK_MS, scheduler_);
+    int exitNum = 0;
+    TimerNode exitNode;
+    exitNode.callback = [&exitNum]() { exitNum++; };
+    EXPECT_TRUE(manager.StartTimer(exitNode, static_cast<int>(EXIT_DELAY_MS), false));
+    scheduler_->AdvanceBy(EXIT_DELAY_MS - 1);
+    EXPECT_EQ(exitNum, 0);
+    EXPECT_TRUE(manager.IsTimerStarted(exitNode));
+    scheduler_->AdvanceBy(1);
+    EXPECT_EQ(exitNum, 1);
+    EXPECT_FALSE(manager.IsTimerStarted(exitNode));
+
+    const int periodMs = 1000;
+    uint64_t periodicNum = 0;
+    TimerNode periodicNode;
+    periodicNode.callback = [&periodicNum]() { periodicNum++; };
+    EXPECT_TRUE(manager.StartTimer(periodicNode, periodMs, true));
+    scheduler_->AdvanceBy(HOUR_MS);
+    EXPECT_EQ(periodicNum, HOUR_MS / periodMs);
+    manager.StopTimer(periodicNode);
+    // 周期定时器每次超时唤醒一次，加上退出定时器的一次
+    TimerManager::Stats stats = manager.GetStats();
+    EXPECT_EQ(stats.firedNum, HOUR_MS / periodMs + 1);
+    EXPECT_EQ(stats.wakeupNum, stats.firedNum + stats.idleWakeupNum);
+    EXPECT_EQ(manager.GetNowMs(), EXIT_DELAY_MS + HOUR_MS);
+}
+
+/**
+ * @tc.name: SetSchedulerShouldStopTimers
+ * @tc.desc: 测试用例3：替换调度器时停止已启动的定时器，之后的定时器按新时钟超时
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmSchedulerTest, SetSchedulerShouldStopTimers, TestSize.Level0)
+{
+    TimerManager manager(TimerManager::DEFAULT_TICK_MS, scheduler_);
+    int fireNum = 0;
+    TimerNode node;
+    node.callback = [&fireNum]() { fireNum++; };
+    EXPECT_TRUE(manager.StartTimer(node, static_cast<int>(EXIT_DELAY_MS), false));
+
+    auto newScheduler = std::make_shared<FcmVirtualScheduler>(HOUR_MS);
+    manager.SetScheduler(newScheduler);
+    EXPECT_FALSE(manager.IsTimerStarted(node));
+    EXPECT_EQ(scheduler_->GetTaskNum(), 0u);
+    EXPECT_EQ(manager.GetNowMs(), HOUR_MS);
+
+    EXPECT_TRUE(manager.StartTimer(node, static_cast<int>(EXIT_DELAY_MS), false));
+    scheduler_->AdvanceBy(HOUR_MS);
+    EXPECT_EQ(fireNum, 0);
+    newScheduler->AdvanceBy(EXIT_DELAY_MS);
+    EXPECT_EQ(fireNum, 1);
+}
+
+/**
+ * @tc.name: DelayTaskShouldRunInVirtualTime
+ * @tc.desc: 测试用例4：FcmThreadUtil的延时任务按虚拟时钟执行，同名任务替换旧任务，移除的任务不执行
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmSchedulerTest, DelayTaskShouldRunInVirtualTime, TestSize.Level0)
+{
+    FcmThreadUtil::GetInstance().SetScheduler(scheduler_);
+    std::vector<std::string> names;
+    auto post = [&names](const std::string &name, uint64_t delayMs) {
+        FcmThreadUtil::GetInstance().PostTask(THREAD_ID_MAIN, [&names, name]() { names.push_back(name); },
+            delayMs, name);
+    };
+    post("replaced", EXIT_DELAY_MS);
+    post("replaced", EXIT_DELAY_MS * 2);
+    post("removed", EXIT_DELAY_MS);
+    post("kept", EXIT_DELAY_MS);
+    FcmThreadUtil::GetInstance().RemoveTask(THREAD_ID_MAIN, "removed");
+
+    scheduler_->AdvanceBy(EXIT_DELAY_MS);
+    EXPECT_EQ(names, std::vector<std::string>({ "kept" }));
+    scheduler_->AdvanceBy(EXIT_DELAY_MS);
+    EXPECT_EQ(names, std::vector<std::string>({ "kept", "replaced" }));
+    EXPECT_EQ(scheduler_->GetTaskNum(), 0u);
+}
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "FcmTimingWheelTest"
+#endif
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "fcm_scheduler.h"
+#include "fcm_timing_wheel.h"
+#include "timer_manager.h"
+#include "timer_manager_ffrt.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const uint32_t BENCHMARK_TIMER_NUM = 100000;
+const int BENCHMARK_DELAY_MS = 3 * 60 * 1000;  // 3min，与退出延时相同
+const int TIMER_DELAY_MS = 20;
+const int TIMER_WAIT_MS = 200;
+
+class Lcg {
+public:
+    explicit Lcg(uint32_t seed) : seed_(seed) {}
+
+    uint64_t Next(uint64_t max)
+    {
+        seed_ = seed_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (seed_ >> 16) % max;
+    }
+
+private:
+    uint64_t seed_;
+};
+
+// 记录提交的延时任务数，每个定时器一个延时任务时提交数与定时器数相同
+class CountingScheduler : public FcmVirtualScheduler {
+public:
+    TaskId PostDelayTask(const std::function<void()> &task, uint64_t delayMs, const std::string &name) override
+    {
+        postNum_++;
+        return FcmVirtualScheduler::PostDelayTask(task, delayMs, name);
+    }
+
+    size_t GetPostNum() const
+    {
+        return postNum_;
+    }
+
+private:
+    size_t postNum_ = 0;
+};
+}  // namespace
+
+class FcmTimingWheelTest : public testing::Test {
+public:
+    FcmTimingWheelTest() = default;
+    ~FcmTimingWheelTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    std::shared_ptr<FcmVirtualScheduler> scheduler_;
+};
+
+void FcmTimingWheelTest::SetUpTestCase(void)
+{}
+void FcmTimingWheelTest::TearDownTestCase(void)
+{}
+void FcmTimingWheelTest::SetUp()
+{
+    // 定时器按虚拟时钟超时，推进时钟即可验证超时时刻，不依赖实际等待
+    scheduler_ = std::make_shared<FcmVirtualScheduler>();
+    TimerManager::GetInstance()->SetScheduler(scheduler_);
+}
+void FcmTimingWheelTest::TearDown()
+{
+    TimerManager::GetInstance()->SetScheduler(nullptr);
+}
+
+/**
+ * @tc.name: NodesShouldExpireAtTheirTicks
+ * @tc.desc: 测试用例1：各层和超出范围的节点都在超时时刻到期，按GetNextTick推进时不提前也不遗漏
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, NodesShouldExpireAtTheirTicks, TestSize.Level0)
+{
+    const uint64_t startTick = 12345;
+    const uint64_t wheelRange = 1ULL << (FcmTimingWheel::SLOT_BITS * FcmTimingWheel::LEVEL_NUM);
+    FcmTimingWheel wheel(startTick);
+    std::vector<FcmTimingWheel::Node> nodes(2000);
+    Lcg lcg(1);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        // 覆盖每一层的延时，以及超出时间轮范围的延时
+        uint64_t maxDelay = 1ULL << (FcmTimingWheel::SLOT_BITS * (i % FcmTimingWheel::LEVEL_NUM + 1));
+        uint64_t delay = (i % (FcmTimingWheel::LEVEL_NUM + 1) == 0) ? wheelRange + lcg.Next(wheelRange) :
+            lcg.Next(maxDelay);
+        wheel.Add(nodes[i], startTick + delay);
+    }
+    EXPECT_EQ(wheel.GetSize(), nodes.size());
+
+    size_t expiredNum = 0;
+    uint64_t lastExpireTick = 0;
+    while (wheel.GetSize() > 0) {
+        uint64_t nowTick = wheel.GetNextTick();
+        ASSERT_NE(nowTick, FcmTimingWheel::INVALID_TICK);
+        ASSERT_GE(nowTick, wheel.GetCurrentTick());
+        wheel.Advance(nowTick, [&](FcmTimingWheel::Node &node) {
+            EXPECT_EQ(node.expireTick, nowTick);
+            EXPECT_GE(node.expireTick, lastExpireTick);
+            EXPECT_FALSE(node.IsLinked());
+            lastExpireTick = node.expireTick;
+            expiredNum++;
+        });
+    }
+    EXPECT_EQ(expiredNum, nodes.size());
+    EXPECT_EQ(wheel.GetNextTick(), FcmTimingWheel::INVALID_TICK);
+}
+
+/**
+ * @tc.name: RemovedNodesShouldNotExpire
+ * @tc.desc: 测试用例2：移除的节点不再到期，重新加入后按新的时刻到期，过去的时刻在下一次推进时到期
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, RemovedNodesShouldNotExpire, TestSize.Level0)
+{
+    FcmTimingWheel wheel;
+    FcmTimingWheel::Node first;
+    FcmTimingWheel::Node second;
+    wheel.Add(first, 100);
+    wheel.Add(second, 5000);
+    wheel.Remove(first);
+    wheel.Remove(first);
+    EXPECT_FALSE(first.IsLinked());
+    EXPECT_EQ(wheel.GetSize(), 1);
+
+    // 重新加入，超时时刻已过去
+    wheel.Advance(200, [](FcmTimingWheel::Node &node) { FAIL(); });
+    wheel.Add(first, 50);
+    std::vector<FcmTimingWheel::Node *> expired;
+    wheel.Advance(201, [&expired](FcmTimingWheel::Node &node) { expired.push_back(&node); });
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired[0], &first);
+
+    wheel.Clear();
+    EXPECT_FALSE(second.IsLinked());
+    EXPECT_EQ(wheel.GetSize(), 0);
+}
+
+/**
+ * @tc.name: TimerShouldFireAndRestart
+ * @tc.desc: 测试用例3：定时器不早于设定时间超时，可在回调中重新计时，停止后不再超时
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, TimerShouldFireAndRestart, TestSize.Level0)
+{
+    std::vector<uint64_t> fireMs;
+    std::unique_ptr<Timer> timer = nullptr;
+    timer = std::make_unique<Timer>([&]() {
+        fireMs.push_back(scheduler_->GetNowMs());
+        if (fireMs.size() == 1) {
+            timer->Restart(TIMER_DELAY_MS);
+        }
+    });
+    EXPECT_TRUE(timer->Start(TIMER_DELAY_MS));
+    EXPECT_FALSE(timer->Start(TIMER_DELAY_MS));
+    EXPECT_TRUE(timer->IsStarted());
+    scheduler_->AdvanceBy(TIMER_DELAY_MS - 1);
+    EXPECT_TRUE(fireMs.empty());
+    scheduler_->AdvanceBy(TIMER_WAIT_MS);
+    const uint64_t delayMs = TIMER_DELAY_MS;
+    EXPECT_EQ(fireMs, std::vector<uint64_t>({ delayMs, delayMs * 2 }));
+    EXPECT_FALSE(timer->IsStarted());
+
+    timer->Start(TIMER_DELAY_MS);
+    timer->Stop();
+    scheduler_->AdvanceBy(TIMER_WAIT_MS);
+    EXPECT_EQ(fireMs.size(), 2u);
+    EXPECT_EQ(scheduler_->GetTaskNum(), 0u);
+}
+
+/**
+ * @tc.name: PeriodicTimerShouldRepeat
+ * @tc.desc: 测试用例4：周期定时器重复超时，在回调中停止后不再超时
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, PeriodicTimerShouldRepeat, TestSize.Level0)
+{
+    const size_t stopNum = 3;
+    std::vector<uint64_t> fireMs;
+    std::unique_ptr<Timer> timer = nullptr;
+    timer = std::make_unique<Timer>([&]() {
+        fireMs.push_back(scheduler_->GetNowMs());
+        if (fireMs.size() == stopNum) {
+            timer->Stop();
+        }
+    });
+    timer->Start(TIMER_DELAY_MS, true);
+    scheduler_->AdvanceBy(TIMER_WAIT_MS);
+    const uint64_t delayMs = TIMER_DELAY_MS;
+    EXPECT_EQ(fireMs, std::vector<uint64_t>({ delayMs, delayMs * 2, delayMs * 3 }));
+    EXPECT_FALSE(timer->IsStarted());
+}
+
+/**
+ * @tc.name: StartCancelShouldNotPostTaskPerTimer
+ * @tc.desc: 测试用例5：启动并取消10万个定时器，时间轮只提交一个驱动任务，旧实现每个定时器提交一个ffrt延时任务
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, StartCancelShouldNotPostTaskPerTimer, TestSize.Level1)
+{
+    auto scheduler = std::make_shared<CountingScheduler>();
+    TimerManager manager(TimerManager::DEFAULT_TICK_MS, scheduler);
+    std::vector<TimerNode> nodes(BENCHMARK_TIMER_NUM);
+    for (auto &node : nodes) {
+        EXPECT_TRUE(manager.StartTimer(node, BENCHMARK_DELAY_MS, false));
+    }
+    EXPECT_EQ(scheduler->GetPostNum(), 1u);
+    EXPECT_EQ(scheduler->GetTaskNum(), 1u);
+    for (auto &node : nodes) {
+        manager.StopTimer(node);
+    }
+    EXPECT_LE(scheduler->GetPostNum(), 1u);
+    scheduler->AdvanceBy(BENCHMARK_DELAY_MS);
+    EXPECT_EQ(manager.GetStats().firedNum, 0u);
+}
+
+/**
+ * @tc.name: SlackShouldExpireOpenWindows
+ * @tc.desc: 测试用例6：带宽限的节点在最早结束的窗口到期，推进时窗口已开始的节点一并超时，窗口未开始的节点不超时
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, SlackShouldExpireOpenWindows, TestSize.Level0)
+{
+    FcmTimingWheel wheel;
+    FcmTimingWheel::Node first;
+    FcmTimingWheel::Node second;
+    FcmTimingWheel::Node third;
+    FcmTimingWheel::Node exact;
+    wheel.Add(first, 100, 50);
+    wheel.Add(second, 120, 100);
+    wheel.Add(third, 160, 10);
+    wheel.Add(exact, 151);
+    std::vector<FcmTimingWheel::Node *> expired;
+    auto onExpired = [&expired](FcmTimingWheel::Node &node) { expired.push_back(&node); };
+
+    size_t dueNum = 0;
+    EXPECT_EQ(wheel.GetNextDueTick(&dueNum), 150u);
+    EXPECT_EQ(dueNum, 1u);
+    wheel.Advance(150, onExpired);
+    EXPECT_EQ(expired, std::vector<FcmTimingWheel::Node *>({ &first, &second }));
+
+    expired.clear();
+    EXPECT_EQ(wheel.GetNextDueTick(), 151u);
+    wheel.Advance(151, onExpired);
+    EXPECT_EQ(expired, std::vector<FcmTimingWheel::Node *>({ &exact }));
+    EXPECT_EQ(wheel.GetNextDueTick(), 170u);
+
+    // 窗口末端溢出时截断，不与空时间轮的INVALID_TICK混淆
+    FcmTimingWheel::Node far;
+    wheel.Add(far, UINT64_MAX - 1, UINT64_MAX);
+    EXPECT_EQ(wheel.GetDueTick(far), FcmTimingWheel::INVALID_TICK - 1);
+}
+
+/**
+ * @tc.name: SlackShouldBatchWakeups
+ * @tc.desc: 测试用例7：超时时刻相近的定时器带宽限时在一次唤醒中批量超时，超时时刻在各自的窗口内
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, SlackShouldBatchWakeups, TestSize.Level0)
+{
+    const uint64_t delayMs = TIMER_DELAY_MS;
+    const uint64_t timerNum = 8;
+    const uint64_t delayStepMs = 10;
+    const uint64_t slackMs = 200;
+    auto runTimers = [&](uint64_t timerSlackMs) {
+        auto scheduler = std::make_shared<FcmVirtualScheduler>();
+        TimerManager manager(TimerManager::DEFAULT_TICK_MS, scheduler);
+        std::vector<TimerNode> nodes(timerNum);
+        std::vector<uint64_t> fireMs(timerNum, 0);
+        for (uint64_t i = 0; i < timerNum; i++) {
+            nodes[i].callback = [&fireMs, &scheduler, i]() { fireMs[i] = scheduler->GetNowMs(); };
+            manager.StartTimer(nodes[i], static_cast<int>(delayMs + i * delayStepMs), false,
+                static_cast<int>(timerSlackMs));
+        }
+        scheduler->AdvanceBy(delayMs + timerNum * delayStepMs + slackMs + TIMER_WAIT_MS);
+        for (uint64_t i = 0; i < timerNum; i++) {
+            EXPECT_GE(fireMs[i], delayMs + i * delayStepMs);
+            EXPECT_LE(fireMs[i], delayMs + i * delayStepMs + timerSlackMs);
+        }
+        return manager.GetStats();
+    };
+
+    TimerManager::Stats exactStats = runTimers(0);
+    TimerManager::Stats slackStats = runTimers(slackMs);
+    EXPECT_EQ(exactStats.firedNum, timerNum);
+    EXPECT_EQ(slackStats.firedNum, timerNum);
+    EXPECT_EQ(exactStats.wakeupNum, timerNum);
+    // 所有窗口在第一个窗口结束前都已开始
+    EXPECT_EQ(slackStats.wakeupNum, 1u);
+}
+
+/**
+ * @tc.name: NextDueTickShouldBeEarliestExpiry
+ * @tc.desc: 测试用例8：GetNextDueTick返回最早结束的窗口和在该时刻到期的节点数，跳过高层槽位的级联时刻
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, NextDueTickShouldBeEarliestExpiry, TestSize.Level0)
+{
+    const uint64_t startTick = 4000;
+    const uint64_t maxDelay = 1ULL << (FcmTimingWheel::SLOT_BITS * (FcmTimingWheel::LEVEL_NUM - 1));
+    const uint32_t roundNum = 200;
+    const uint64_t maxSlack = 100;
+    FcmTimingWheel wheel(startTick);
+    std::vector<FcmTimingWheel::Node> nodes(64);
+    Lcg lcg(2);
+    for (uint32_t round = 0; round < roundNum; round++) {
+        // 随机加入、移除节点并推进，与逐个节点计算的结果比较
+        FcmTimingWheel::Node &node = nodes[lcg.Next(nodes.size())];
+        if (node.IsLinked()) {
+            wheel.Remove(node);
+        } else {
+            wheel.Add(node, wheel.GetCurrentTick() + lcg.Next(maxDelay), round % 2 == 0 ? lcg.Next(maxSlack) : 0);
+        }
+        uint64_t expectedTick = FcmTimingWheel::INVALID_TICK;
+        size_t expectedNum = 0;
+        for (auto &item : nodes) {
+            if (!item.IsLinked()) {
+                continue;
+            }
+            uint64_t tick = std::max(item.expireTick + item.slackTicks, wheel.GetCurrentTick());
+            expectedNum = tick < expectedTick ? 1 : expectedNum + (tick == expectedTick ? 1 : 0);
+            expectedTick = std::min(expectedTick, tick);
+        }
+        size_t dueNum = 0;
+        ASSERT_EQ(wheel.GetNextDueTick(&dueNum), expectedTick);
+        ASSERT_EQ(dueNum, expectedNum);
+        if (round % 4 == 0 && expectedTick != FcmTimingWheel::INVALID_TICK) {
+            wheel.Advance(expectedTick, [&expectedTick](FcmTimingWheel::Node &node) {
+                EXPECT_LE(node.expireTick, expectedTick);
+            });
+            for (auto &item : nodes) {
+                EXPECT_TRUE(!item.IsLinked() || item.expireTick > expectedTick);
+            }
+        }
+    }
+
+    // 只有一个3分钟的定时器时，级联时刻早于超时时刻，到期时刻仍是超时时刻
+    const uint64_t exitTicks = 18000;
+    FcmTimingWheel exitWheel(startTick);
+    FcmTimingWheel::Node exitNode;
+    exitWheel.Add(exitNode, startTick + exitTicks);
+    EXPECT_LT(exitWheel.GetNextTick(), startTick + exitTicks);
+    EXPECT_EQ(exitWheel.GetNextDueTick(), startTick + exitTicks);
+}
+
+/**
+ * @tc.name: TimersShouldWakeOnlyAtExpiry
+ * @tc.desc: 测试用例9：3分钟的定时器只唤醒一次，启动后停止的定时器不唤醒，停止最早的定时器后按下一个定时器唤醒
+ * @tc.type: FUNC
+ */
+HWTEST_F(FcmTimingWheelTest, TimersShouldWakeOnlyAtExpiry, TestSize.Level0)
+{
+    auto &scheduler = scheduler_;
+    TimerManager manager(TimerManager::DEFAULT_TICK_MS, scheduler);
+    int fireNum = 0;
+    TimerNode first;
+    TimerNode second;
+    first.callback = [&fireNum]() { fireNum++; };
+    second.callback = [&fireNum]() { fireNum++; };
+
+    EXPECT_TRUE(manager.StartTimer(first, BENCHMARK_DELAY_MS, false));
+    scheduler->AdvanceBy(BENCHMARK_DELAY_MS);
+    EXPECT_EQ(fireNum, 1);
+    EXPECT_EQ(manager.GetStats().wakeupNum, 1u);
+
+    // 断连后在退出延时内重连，定时器停止，驱动任务一并取消
+    EXPECT_TRUE(manager.StartTimer(first, BENCHMARK_DELAY_MS, false));
+    manager.StopTimer(first);
+    EXPECT_EQ(scheduler->GetTaskNum(), 0u);
+    scheduler->AdvanceBy(BENCHMARK_DELAY_MS);
+    EXPECT_EQ(manager.GetStats().wakeupNum, 1u);
+
+    EXPECT_TRUE(manager.StartTimer(first, BENCHMARK_DELAY_MS, false));
+    EXPECT_TRUE(manager.StartTimer(second, BENCHMARK_DELAY_MS * 2, false));
+    manager.StopTimer(first);
+    EXPECT_EQ(scheduler->GetNextDueMs(), scheduler->GetNowMs() + BENCHMARK_DELAY_MS * 2);
+    scheduler->AdvanceBy(BENCHMARK_DELAY_MS * 2);
+    EXPECT_EQ(fireNum, 2);
+    TimerManager::Stats stats = manager.GetStats();
+    EXPECT_EQ(stats.wakeupNum, 2u);
+    EXPECT_EQ(stats.idleWakeupNum, 0u);
+}
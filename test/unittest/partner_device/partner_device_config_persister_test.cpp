@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceConfigPersisterTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+#include "partner_device_config_persister.h"
+#include "log.h"
+
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t TEST_WINDOW_MS = 100;
+constexpr uint32_t LONG_WINDOW_MS = 10000;
+const PartnerDeviceMapKey KEY_1 = std::make_pair(1, FcmMacAddress(0x001122334455ULL));
+const PartnerDeviceMapKey KEY_2 = std::make_pair(2, FcmMacAddress(0x001122334466ULL));
+}  // namespace
+
+class PartnerDeviceConfigPersisterTest : public testing::Test {
+public:
+    PartnerDeviceConfigPersisterTest() = default;
+    ~PartnerDeviceConfigPersisterTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    PartnerDeviceConfigPersister::PersistFunc GetCountingPersistFunc()
+    {
+        return [this](const std::set<PartnerDeviceMapKey> &) { persistCount_++; };
+    }
+
+    std::atomic_int persistCount_ = 0;
+};
+
+void PartnerDeviceConfigPersisterTest::SetUpTestCase(void)
+{}
+void PartnerDeviceConfigPersisterTest::TearDownTestCase(void)
+{}
+void PartnerDeviceConfigPersisterTest::SetUp()
+{
+    persistCount_ = 0;
+}
+void PartnerDeviceConfigPersisterTest::TearDown()
+{}
+
+/**
+ * @tc.name: CoalesceBurstWithinWindow
+ * @tc.desc: 测试用例1：窗口内的多次变更合并为一次写入
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceConfigPersisterTest, CoalesceBurstWithinWindow, TestSize.Level0)
+{
+    PartnerDeviceConfigPersister persister(GetCountingPersistFunc(), TEST_WINDOW_MS);
+    const int markTimes = 1000;
+    for (int i = 0; i < markTimes; i++) {
+        persister.MarkDirty(KEY_1);
+    }
+    EXPECT_EQ(persistCount_.load(), 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_WINDOW_MS * 3));  // 3: wait for the window expired
+    EXPECT_EQ(persistCount_.load(), 1);
+    EXPECT_EQ(persister.GetWriteCount(), 1);
+
+    // 下一个窗口内的变更重新触发写入
+    persister.MarkDirty(KEY_2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_WINDOW_MS * 3));  // 3: wait for the window expired
+    EXPECT_EQ(persistCount_.load(), 2);
+}
+
+/**
+ * @tc.name: FlushWritesImmediately
+ * @tc.desc: 测试用例2：Flush立即写入未落盘的变更，无变更时不写入
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceConfigPersisterTest, FlushWritesImmediately, TestSize.Level0)
+{
+    PartnerDeviceConfigPersister persister(GetCountingPersistFunc(), LONG_WINDOW_MS);
+    persister.Flush();
+    EXPECT_EQ(persistCount_.load(), 0);
+
+    persister.MarkDirty(KEY_1);
+    persister.MarkDirty(KEY_2);
+    persister.Flush();
+    EXPECT_EQ(persistCount_.load(), 1);
+
+    persister.Flush();
+    EXPECT_EQ(persistCount_.load(), 1);
+}
+
+/**
+ * @tc.name: MarkDirtyNeverBlocks
+ * @tc.desc: 测试用例3：写入过程中标记变更不阻塞调用者，写入期间的变更在下一次写入中落盘
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceConfigPersisterTest, MarkDirtyNeverBlocks, TestSize.Level0)
+{
+    std::promise<void> writeStarted;
+    std::promise<void> writeReleased;
+    std::shared_future<void> releaseFuture = writeReleased.get_future().share();
+    std::set<PartnerDeviceMapKey> lastKeys;
+    PartnerDeviceConfigPersister persister([this, &writeStarted, releaseFuture, &lastKeys](
+        const std::set<PartnerDeviceMapKey> &dirtyKeys) {
+        // 第一次写入阻塞到测试放行，模拟耗时的磁盘写入
+        if (persistCount_.load() == 0) {
+            writeStarted.set_value();
+            releaseFuture.wait();
+        }
+        lastKeys = dirtyKeys;
+        persistCount_++;
+    }, 0);
+    persister.MarkDirty(KEY_1);
+    writeStarted.get_future().wait();
+
+    // 写入仍被阻塞，标记变更立即返回
+    const int markTimes = 100;
+    for (int i = 0; i < markTimes; i++) {
+        persister.MarkDirty(KEY_2);
+    }
+    EXPECT_EQ(persistCount_.load(), 0);
+    EXPECT_EQ(persister.GetWriteCount(), 0);
+
+    writeReleased.set_value();
+    persister.Flush();
+    EXPECT_EQ(persistCount_.load(), 2);
+    EXPECT_EQ(lastKeys, std::set<PartnerDeviceMapKey>({ KEY_2 }));
+}
+
+/**
+ * @tc.name: MergeDirtyKeys
+ * @tc.desc: 测试用例4：窗口内的变更设备去重后一次写入，已写入的设备不再重复写入
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceConfigPersisterTest, MergeDirtyKeys, TestSize.Level0)
+{
+    std::set<PartnerDeviceMapKey> lastKeys;
+    PartnerDeviceConfigPersister persister([&lastKeys](const std::set<PartnerDeviceMapKey> &dirtyKeys) {
+        lastKeys = dirtyKeys;
+    }, LONG_WINDOW_MS);
+
+    persister.MarkDirty(KEY_1);
+    persister.MarkDirty(KEY_2);
+    persister.MarkDirty(KEY_1);
+    persister.Flush();
+    EXPECT_EQ(persister.GetWriteCount(), 1);
+    EXPECT_EQ(lastKeys, std::set<PartnerDeviceMapKey>({ KEY_1, KEY_2 }));
+
+    persister.MarkDirty(KEY_2);
+    persister.Flush();
+    EXPECT_EQ(persister.GetWriteCount(), 2);
+    EXPECT_EQ(lastKeys, std::set<PartnerDeviceMapKey>({ KEY_2 }));
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceEventDispatcherTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "partner_device.h"
+#include "partner_device_event_dispatcher.h"
+#include "partner_device_registry.h"
+#include "partner_device_scan_policy.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const uint32_t SMALL_DEVICE_NUM = 10;
+const uint32_t LARGE_DEVICE_NUM = 1000;
+
+EventFwk::CommonEventData MakeDeviceEvent(const std::string &action, const FcmMacAddress &address)
+{
+    AAFwk::Want want;
+    want.SetAction(action);
+    want.SetParam("deviceAddr", address.ToString());
+    want.SetParam("state", static_cast<int>(PartnerDevice::BOND_STATE_NONE));
+    return EventFwk::CommonEventData(want);
+}
+}  // namespace
+
+class PartnerDeviceEventDispatcherTest : public testing::Test {
+public:
+    PartnerDeviceEventDispatcherTest() = default;
+    ~PartnerDeviceEventDispatcherTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    void BindDevices(uint32_t tokenId, uint32_t deviceNum);
+
+    PartnerDeviceRegistry registry_;
+    PartnerDevice::DependencyFuncs funcs_;
+    uint32_t updateConfigCount_ = 0;
+};
+
+void PartnerDeviceEventDispatcherTest::SetUpTestCase(void)
+{}
+void PartnerDeviceEventDispatcherTest::TearDownTestCase(void)
+{}
+void PartnerDeviceEventDispatcherTest::SetUp()
+{
+    updateConfigCount_ = 0;
+    funcs_ = {
+        .updateConfig = [this](const PartnerDeviceMapKey &) { updateConfigCount_++; },
+        .discoverExtension = [](std::string, std::string, PartnerDeviceAddress) {},
+        .destroyExtension = [](std::string, std::string, int) {},
+    };
+}
+void PartnerDeviceEventDispatcherTest::TearDown()
+{
+    registry_.Iterate([](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &device) {
+        device->Close();
+    });
+    registry_.Clear();
+}
+
+void PartnerDeviceEventDispatcherTest::BindDevices(uint32_t tokenId, uint32_t deviceNum)
+{
+    std::vector<PartnerDeviceRegistry::Entry> entries;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        // 用户关闭的设备保持休眠，不依赖蓝牙服务
+        auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(tokenId, i, false), funcs_, false, true);
+        entries.push_back({ device->GetKey(), 0, device });
+    }
+    registry_.EnsureInsertBatch(entries);
+}
+
+/**
+ * @tc.name: PairEventShouldOnlyReachDevicesOfTheAddress
+ * @tc.desc: 测试用例1：配对状态事件只分发给绑定该地址的设备，包括多个应用绑定的同一地址
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceEventDispatcherTest, PairEventShouldOnlyReachDevicesOfTheAddress, TestSize.Level0)
+{
+    BindDevices(TOKEN_ID, SMALL_DEVICE_NUM);
+    BindDevices(TOKEN_ID + 1, 1);
+    PartnerDeviceEventDispatcher dispatcher(registry_);
+
+    dispatcher.Dispatch(MakeDeviceEvent(
+        PartnerDeviceEventDispatcher::COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC, MakeAddress(0)));
+
+    // 两个应用绑定了同一地址
+    EXPECT_EQ(updateConfigCount_, 2u);
+    registry_.Iterate([](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &device) {
+        bool isLost = device->GetDeviceInfo().lostTimestamp > 0;
+        EXPECT_EQ(isLost, key.second == MakeAddress(0));
+    });
+}
+
+/**
+ * @tc.name: InvalidEventShouldBeIgnored
+ * @tc.desc: 测试用例2：地址非法或未绑定的设备事件不分发给任何设备
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceEventDispatcherTest, InvalidEventShouldBeIgnored, TestSize.Level0)
+{
+    BindDevices(TOKEN_ID, SMALL_DEVICE_NUM);
+    PartnerDeviceEventDispatcher dispatcher(registry_);
+
+    AAFwk::Want want;
+    want.SetAction(PartnerDeviceEventDispatcher::COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC);
+    want.SetParam("deviceAddr", std::string("invalid"));
+    dispatcher.Dispatch(EventFwk::CommonEventData(want));
+    dispatcher.Dispatch(MakeDeviceEvent(
+        PartnerDeviceEventDispatcher::COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC,
+        MakeAddress(SMALL_DEVICE_NUM)));
+    EXPECT_EQ(updateConfigCount_, 0u);
+}
+
+/**
+ * @tc.name: DeviceEventShouldNotReachOtherDevices
+ * @tc.desc: 测试用例3：绑定大量设备时，单个设备事件只分发给该地址的设备，不遍历其他设备
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceEventDispatcherTest, DeviceEventShouldNotReachOtherDevices, TestSize.Level1)
+{
+    BindDevices(TOKEN_ID, LARGE_DEVICE_NUM);
+    PartnerDeviceEventDispatcher dispatcher(registry_);
+    const uint32_t index = LARGE_DEVICE_NUM - 1;
+    dispatcher.Dispatch(MakeDeviceEvent(
+        PartnerDeviceEventDispatcher::COMMON_EVENT_BLUETOOTH_REMOTEDEVICE_PAIR_STATE_CHANGE_REALMAC,
+        MakeAddress(index)));
+
+    EXPECT_EQ(updateConfigCount_, 1u);
+    uint32_t lostNum = 0;
+    registry_.Iterate([&lostNum](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &device) {
+        if (device->GetDeviceInfo().lostTimestamp > 0) {
+            lostNum++;
+            EXPECT_EQ(key.second, MakeAddress(index));
+        }
+    });
+    EXPECT_EQ(lostNum, 1u);
+}
+
+/**
+ * @tc.name: BluetoothOffShouldReachAllDevicesInOneBatch
+ * @tc.desc: 测试用例4：蓝牙关闭在一个任务中通知所有设备，销毁所有运行态
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceEventDispatcherTest, BluetoothOffShouldReachAllDevicesInOneBatch, TestSize.Level0)
+{
+    BindDevices(TOKEN_ID, SMALL_DEVICE_NUM);
+    // 模拟已激活的设备
+    registry_.Iterate([](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &device) {
+        std::lock_guard<std::mutex> lock(device->runtimeMutex_);
+        device->isAllowed_ = true;
+        device->runtime_ = std::make_shared<PartnerDevice::Runtime>();
+    });
+    PartnerDeviceEventDispatcher dispatcher(registry_);
+
+    dispatcher.DispatchBluetoothStateChange(Bluetooth::BTTransport::ADAPTER_BLE, Bluetooth::BTStateID::STATE_TURN_OFF);
+    registry_.Iterate([](const PartnerDeviceMapKey &key, const std::shared_ptr<PartnerDevice> &device) {
+        EXPECT_EQ(device->GetRuntime(), nullptr);
+        EXPECT_TRUE(device->isAllowed_.load());
+    });
+}
+
+/**
+ * @tc.name: PowerEventsShouldUpdateScanPolicy
+ * @tc.desc: 测试用例5：亮灭屏、温度和电量事件更新扫描策略的状态
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceEventDispatcherTest, PowerEventsShouldUpdateScanPolicy, TestSize.Level0)
+{
+    PartnerDeviceEventDispatcher dispatcher(registry_);
+    auto makeEvent = [](const std::string &action) {
+        AAFwk::Want want;
+        want.SetAction(action);
+        return EventFwk::CommonEventData(want);
+    };
+    const int thermalLevel = PartnerDeviceScanPolicy::THERMAL_LEVEL_HOT;
+    AAFwk::Want thermalWant;
+    thermalWant.SetAction(EventFwk::CommonEventSupport::COMMON_EVENT_THERMAL_LEVEL_CHANGED);
+    thermalWant.SetParam("0", thermalLevel);
+
+    dispatcher.Dispatch(makeEvent(EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_OFF));
+    dispatcher.Dispatch(makeEvent(EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_LOW));
+    dispatcher.Dispatch(EventFwk::CommonEventData(thermalWant));
+    PartnerDeviceScanPolicy &policy = PartnerDeviceScanPolicy::GetInstance();
+    {
+        std::lock_guard<std::mutex> lock(policy.stateMutex_);
+        EXPECT_FALSE(policy.state_.isScreenOn);
+        EXPECT_TRUE(policy.state_.isBatteryLow);
+        EXPECT_EQ(policy.state_.thermalLevel, thermalLevel);
+    }
+
+    dispatcher.Dispatch(makeEvent(EventFwk::CommonEventSupport::COMMON_EVENT_SCREEN_ON));
+    dispatcher.Dispatch(makeEvent(EventFwk::CommonEventSupport::COMMON_EVENT_BATTERY_OKAY));
+    std::lock_guard<std::mutex> lock(policy.stateMutex_);
+    EXPECT_TRUE(policy.state_.isScreenOn);
+    EXPECT_FALSE(policy.state_.isBatteryLow);
+}
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceJournalTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "partner_device_journal.h"
+#include "partner_device_snapshot.h"
+#include "partner_device_test_utils.h"
+#include "fcm_json_stream.h"
+#include "fcm_mac_address.h"
+#include "log.h"
+
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+std::string MakeAddressString(uint32_t index)
+{
+    return MakeAddress(index).ToString();
+}
+
+// 记录中的地址指向 address，使用记录期间 address 不能修改
+PartnerDeviceRecord MakeDeviceRecord(const std::string &address, bool isUserEnabled = true)
+{
+    PartnerDeviceRecord record;
+    record.bundleName = "com.example.partner";
+    record.abilityName = "PartnerAgentExtensionAbility";
+    record.address = address;
+    record.tokenId = TOKEN_ID;
+    record.addressType = 1;
+    record.registerTimestamp = 1700000000;  // 1700000000: any timestamp
+    record.isUserEnabled = isUserEnabled;
+    return record;
+}
+
+std::string MakeSnapshot(uint32_t deviceNum)
+{
+    std::vector<std::string> addresses;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        addresses.push_back(MakeAddressString(i));
+    }
+    std::vector<PartnerDeviceRecord> records;
+    for (const auto &address : addresses) {
+        records.push_back(MakeDeviceRecord(address));
+    }
+    return PartnerDeviceSnapshot::Encode(records);
+}
+
+std::string MakeHeader(const std::string &snapshot)
+{
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendHeader(writer, snapshot);
+    return writer.GetBuffer();
+}
+
+std::string MakePutRecord(uint32_t index, bool isUserEnabled = true)
+{
+    std::string address = MakeAddressString(index);
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendPutRecord(writer, MakeDeviceRecord(address, isUserEnabled));
+    return writer.GetBuffer();
+}
+
+std::string MakeDelRecord(uint32_t tokenId, uint32_t index)
+{
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendDelRecord(writer, tokenId, MakeAddressString(index));
+    return writer.GetBuffer();
+}
+
+// 在快照设备集合上应用日志回放结果
+std::set<std::string> ApplyOverlay(uint32_t deviceNum, const PartnerDeviceJournal::Overlay &overlay)
+{
+    std::set<PartnerDeviceMapKey> keys;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        keys.insert(std::make_pair(TOKEN_ID, MakeAddress(i)));
+    }
+    for (const auto &[key, deviceItem] : overlay) {
+        if (deviceItem.has_value()) {
+            keys.insert(key);
+        } else {
+            keys.erase(key);
+        }
+    }
+    std::set<std::string> addressSet;
+    for (const auto &key : keys) {
+        addressSet.insert(key.second.ToString());
+    }
+    return addressSet;
+}
+}  // namespace
+
+class PartnerDeviceJournalTest : public testing::Test {
+public:
+    PartnerDeviceJournalTest() = default;
+    ~PartnerDeviceJournalTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDeviceJournalTest::SetUpTestCase(void)
+{}
+void PartnerDeviceJournalTest::TearDownTestCase(void)
+{}
+void PartnerDeviceJournalTest::SetUp()
+{}
+void PartnerDeviceJournalTest::TearDown()
+{}
+
+/**
+ * @tc.name: ReplayPutAndDel
+ * @tc.desc: 测试用例1：在快照上回放新增、修改、删除记录
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJournalTest, ReplayPutAndDel, TestSize.Level0)
+{
+    const uint32_t deviceNum = 3;
+    std::string snapshot = MakeSnapshot(deviceNum);
+    std::string journal = MakeHeader(snapshot);
+    journal += MakePutRecord(0, false);
+    journal += MakePutRecord(deviceNum);
+    journal += MakeDelRecord(TOKEN_ID, 1);
+    // 删除不存在的设备
+    journal += MakeDelRecord(TOKEN_ID + 1, 2);
+
+    PartnerDeviceJournal::Overlay overlay;
+    EXPECT_EQ(PartnerDeviceJournal::Replay(snapshot, journal, overlay), 4);
+    EXPECT_EQ(ApplyOverlay(deviceNum, overlay),
+        std::set<std::string>({ MakeAddressString(0), MakeAddressString(2), MakeAddressString(deviceNum) }));
+    auto iter = overlay.find(std::make_pair(TOKEN_ID, MakeAddress(0)));
+    ASSERT_NE(iter, overlay.end());
+    ASSERT_TRUE(iter->second.has_value());
+    EXPECT_FALSE(iter->second->fields.isUserEnabled);
+    EXPECT_EQ(iter->second->bundleName, "com.example.partner");
+}
+
+/**
+ * @tc.name: IgnoreMismatchedJournal
+ * @tc.desc: 测试用例2：日志头与快照不匹配时（压缩过程中掉电），忽略旧日志
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJournalTest, IgnoreMismatchedJournal, TestSize.Level0)
+{
+    std::string oldSnapshot = MakeSnapshot(1);
+    std::string newSnapshot = MakeSnapshot(2);
+    std::string journal = MakeHeader(oldSnapshot) + MakePutRecord(0, false);
+
+    PartnerDeviceJournal::Overlay overlay;
+    EXPECT_EQ(PartnerDeviceJournal::Replay(newSnapshot, journal, overlay), 0);
+    EXPECT_TRUE(overlay.empty());
+    // 空日志与只有半个日志头的日志
+    EXPECT_EQ(PartnerDeviceJournal::Replay(newSnapshot, "", overlay), 0);
+    std::string header = MakeHeader(newSnapshot);
+    EXPECT_EQ(PartnerDeviceJournal::Replay(newSnapshot, header.substr(0, header.size() / 2), overlay), 0);
+    EXPECT_TRUE(overlay.empty());
+}
+
+/**
+ * @tc.name: TruncatedJournalRecovery
+ * @tc.desc: 测试用例3：日志在随机位置被截断时，回放到最后一条完整记录
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJournalTest, TruncatedJournalRecovery, TestSize.Level0)
+{
+    const uint32_t deviceNum = 5;
+    const uint32_t recordNum = 40;
+    const uint32_t delInterval = 4;
+    std::string snapshot = MakeSnapshot(deviceNum);
+    std::string journal = MakeHeader(snapshot);
+    // recordEnds[k] 为前 k 条记录的结束位置，expectedSets[k] 为回放前 k 条记录后的设备集合
+    std::vector<size_t> recordEnds = { journal.size() };
+    std::vector<std::set<std::string>> expectedSets(1);
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        expectedSets[0].insert(MakeAddressString(i));
+    }
+    for (uint32_t i = 0; i < recordNum; i++) {
+        std::set<std::string> expected = expectedSets.back();
+        if (i % delInterval == delInterval - 1) {
+            journal += MakeDelRecord(TOKEN_ID, i);
+            expected.erase(MakeAddressString(i));
+        } else {
+            journal += MakePutRecord(i);
+            expected.insert(MakeAddressString(i));
+        }
+        recordEnds.push_back(journal.size());
+        expectedSets.push_back(expected);
+    }
+
+    const int truncateTimes = 500;
+    std::mt19937 engine(truncateTimes);
+    for (int i = 0; i < truncateTimes; i++) {
+        size_t offset = engine() % (journal.size() + 1);
+        size_t completeNum = 0;
+        while (completeNum + 1 < recordEnds.size() && recordEnds[completeNum + 1] <= offset) {
+            completeNum++;
+        }
+        PartnerDeviceJournal::Overlay overlay;
+        int replayCount = PartnerDeviceJournal::Replay(snapshot, journal.substr(0, offset), overlay);
+        if (offset < recordEnds[0]) {
+            EXPECT_EQ(replayCount, 0);
+        } else {
+            EXPECT_EQ(replayCount, static_cast<int>(completeNum)) << "offset: " << offset;
+        }
+        EXPECT_EQ(ApplyOverlay(deviceNum, overlay), expectedSets[completeNum]) << "offset: " << offset;
+    }
+}
+
+/**
+ * @tc.name: WriteBytesBenchmark
+ * @tc.desc: 测试用例4：设备数量增长时，日志每次变更的写入量保持不变，全量快照的写入量线性增长
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJournalTest, WriteBytesBenchmark, TestSize.Level1)
+{
+    const std::vector<uint32_t> deviceNumVec = { 10, 100, 1000 };
+    std::vector<size_t> journalBytesVec;
+    std::vector<size_t> snapshotBytesVec;
+    for (uint32_t deviceNum : deviceNumVec) {
+        size_t snapshotBytes = MakeSnapshot(deviceNum).size();
+        // 每次变更只追加变更设备的记录
+        size_t journalBytes = MakePutRecord(deviceNum - 1, false).size();
+        EXPECT_LT(journalBytes, snapshotBytes) << "devices: " << deviceNum;
+        journalBytesVec.push_back(journalBytes);
+        snapshotBytesVec.push_back(snapshotBytes);
+    }
+    EXPECT_EQ(journalBytesVec.front(), journalBytesVec.back());
+    // 快照随设备数量线性增长，1000 台设备时单条日志记录不到快照的 1%
+    EXPECT_GT(snapshotBytesVec.back(), snapshotBytesVec.front() * 50);  // 50: 100x devices minus the header
+    EXPECT_LT(journalBytesVec.back() * 100, snapshotBytesVec.back());  // 100: 1%
+}
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceJsonTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "cJSON.h"
+#include "fcm_json_stream.h"
+#include "fcm_mac_address.h"
+#include "partner_device_json.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const uint32_t APP_NUM = 10;
+
+// 统计 cJSON 堆内存的当前占用与峰值，通过 cJSON_InitHooks 接入
+std::atomic<size_t> g_currentBytes { 0 };
+std::atomic<size_t> g_peakBytes { 0 };
+constexpr size_t ALLOC_HEADER_SIZE = alignof(std::max_align_t);
+
+void *CountingMalloc(size_t size)
+{
+    char *ptr = static_cast<char *>(malloc(size + ALLOC_HEADER_SIZE));
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t *>(ptr) = size;
+    size_t current = g_currentBytes += size;
+    size_t peak = g_peakBytes.load();
+    while (current > peak && !g_peakBytes.compare_exchange_weak(peak, current)) {
+    }
+    return ptr + ALLOC_HEADER_SIZE;
+}
+
+void CountingFree(void *ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    char *base = static_cast<char *>(ptr) - ALLOC_HEADER_SIZE;
+    g_currentBytes -= *reinterpret_cast<size_t *>(base);
+    free(base);
+}
+
+// 返回 func 执行期间相对于执行前新增的 cJSON 堆内存峰值
+template <typename Func>
+size_t MeasurePeakBytes(Func &&func)
+{
+    size_t base = g_currentBytes.load();
+    g_peakBytes = base;
+    func();
+    return g_peakBytes.load() - base;
+}
+
+std::string WriteItems(const std::vector<PartnerDeviceJsonItem> &items)
+{
+    FcmJsonWriter writer;
+    writer.BeginArray();
+    for (const auto &item : items) {
+        PartnerDeviceJson::WriteDevice(writer, item.GetRecord());
+    }
+    writer.EndArray();
+    return writer.GetBuffer();
+}
+
+// 返回是否完整解析，格式无效的设备被跳过
+bool ReadItems(std::string_view content, std::vector<PartnerDeviceJsonItem> &items)
+{
+    FcmJsonReader reader(content);
+    if (!reader.BeginArray()) {
+        return false;
+    }
+    PartnerDeviceJsonItem item;
+    while (reader.NextElement()) {
+        if (PartnerDeviceJson::ReadDevice(reader, item)) {
+            items.push_back(item);
+        }
+    }
+    return !reader.HasError() && reader.IsEnd();
+}
+
+// 旧版本 partner_device_config.cpp 基于 cJSON 树的实现，作为对比基准
+std::string WriteItemsByCJson(const std::vector<PartnerDeviceJsonItem> &items)
+{
+    cJSON *root = cJSON_CreateArray();
+    for (const auto &device : items) {
+        cJSON *item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "version", "1.0");
+        cJSON_AddStringToObject(item, "bundleName", device.bundleName.c_str());
+        cJSON_AddStringToObject(item, "abilityName", device.abilityName.c_str());
+        cJSON *addressInfo = cJSON_CreateObject();
+        cJSON_AddStringToObject(addressInfo, "address", device.address.c_str());
+        cJSON_AddNumberToObject(addressInfo, "addressType", device.fields.addressType);
+        if (device.fields.hasRawAddressType) {
+            cJSON_AddNumberToObject(addressInfo, "rawAddressType", device.fields.rawAddressType);
+        }
+        cJSON_AddItemToObject(item, "addressInfo", addressInfo);
+        cJSON_AddNumberToObject(item, "tokenId", device.fields.tokenId);
+        cJSON_AddNumberToObject(item, "registerTimestamp", device.fields.registerTimestamp);
+        if (device.fields.lostTimestamp > 0) {
+            cJSON_AddNumberToObject(item, "lostTimestamp", device.fields.lostTimestamp);
+        }
+        cJSON_AddBoolToObject(item, "isUserEnabled", device.fields.isUserEnabled);
+        cJSON *capability = cJSON_CreateObject();
+        cJSON_AddBoolToObject(capability, "isSupportBR", device.fields.isSupportBR);
+        cJSON_AddBoolToObject(capability, "isSupportBleAdvertiser", device.fields.isSupportBleAdvertiser);
+        cJSON_AddItemToObject(item, "capability", capability);
+        cJSON *businessCapability = cJSON_CreateObject();
+        cJSON_AddBoolToObject(businessCapability, "isSupportMediaControl", device.fields.isSupportMediaControl);
+        cJSON_AddBoolToObject(
+            businessCapability, "isSupportTelephonyControl", device.fields.isSupportTelephonyControl);
+        cJSON_AddItemToObject(item, "businessCapability", businessCapability);
+        cJSON_AddItemToArray(root, item);
+    }
+    char *jsonString = cJSON_Print(root);
+    std::string content = jsonString;
+    cJSON_free(jsonString);
+    cJSON_Delete(root);
+    return content;
+}
+
+bool GetBool(const cJSON *object, const char *name)
+{
+    return cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(object, name));
+}
+
+void ReadItemsByCJson(const std::string &content, std::vector<PartnerDeviceJsonItem> &items)
+{
+    cJSON *root = cJSON_Parse(content.c_str());
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, root) {
+        PartnerDeviceJsonItem device;
+        const cJSON *addressInfo = cJSON_GetObjectItemCaseSensitive(item, "addressInfo");
+        const cJSON *rawAddressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "rawAddressType");
+        const cJSON *lostTimestamp = cJSON_GetObjectItemCaseSensitive(item, "lostTimestamp");
+        const cJSON *capability = cJSON_GetObjectItemCaseSensitive(item, "capability");
+        const cJSON *businessCapability = cJSON_GetObjectItemCaseSensitive(item, "businessCapability");
+        device.bundleName = cJSON_GetObjectItemCaseSensitive(item, "bundleName")->valuestring;
+        device.abilityName = cJSON_GetObjectItemCaseSensitive(item, "abilityName")->valuestring;
+        device.address = cJSON_GetObjectItemCaseSensitive(addressInfo, "address")->valuestring;
+        device.fields.tokenId =
+            static_cast<uint32_t>(cJSON_GetObjectItemCaseSensitive(item, "tokenId")->valuedouble);
+        device.fields.addressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "addressType")->valueint;
+        device.fields.hasRawAddressType = rawAddressType != nullptr;
+        device.fields.rawAddressType = rawAddressType != nullptr ? rawAddressType->valueint : 0;
+        device.fields.registerTimestamp =
+            static_cast<int64_t>(cJSON_GetObjectItemCaseSensitive(item, "registerTimestamp")->valuedouble);
+        device.fields.lostTimestamp =
+            lostTimestamp != nullptr ? static_cast<int64_t>(lostTimestamp->valuedouble) : 0;
+        device.fields.isUserEnabled = GetBool(item, "isUserEnabled");
+        device.fields.isSupportBR = GetBool(capability, "isSupportBR");
+        device.fields.isSupportBleAdvertiser = GetBool(capability, "isSupportBleAdvertiser");
+        device.fields.isSupportMediaControl = GetBool(businessCapability, "isSupportMediaControl");
+        device.fields.isSupportTelephonyControl = GetBool(businessCapability, "isSupportTelephonyControl");
+        items.push_back(std::move(device));
+    }
+    cJSON_Delete(root);
+}
+}  // namespace
+
+class PartnerDeviceJsonTest : public testing::Test {
+public:
+    PartnerDeviceJsonTest() = default;
+    ~PartnerDeviceJsonTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDeviceJsonTest::SetUpTestCase(void)
+{
+    cJSON_Hooks hooks = { CountingMalloc, CountingFree };
+    cJSON_InitHooks(&hooks);
+}
+void PartnerDeviceJsonTest::TearDownTestCase(void)
+{
+    cJSON_InitHooks(nullptr);
+}
+void PartnerDeviceJsonTest::SetUp()
+{}
+void PartnerDeviceJsonTest::TearDown()
+{}
+
+/**
+ * @tc.name: WriteReadRoundTrip
+ * @tc.desc: 测试用例1：流式写入的设备列表可被流式读取还原，且与 cJSON 的解析结果一致
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJsonTest, WriteReadRoundTrip, TestSize.Level0)
+{
+    const uint32_t deviceNum = 20;
+    std::vector<PartnerDeviceJsonItem> items = MakeDevices(deviceNum, APP_NUM);
+    std::string content = WriteItems(items);
+
+    std::vector<PartnerDeviceJsonItem> streamItems;
+    ASSERT_TRUE(ReadItems(content, streamItems));
+    std::vector<PartnerDeviceJsonItem> jsonItems;
+    ReadItemsByCJson(content, jsonItems);
+    ASSERT_EQ(streamItems.size(), items.size());
+    ASSERT_EQ(jsonItems.size(), items.size());
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        ExpectDeviceEq(streamItems[i], items[i]);
+        ExpectDeviceEq(jsonItems[i], items[i]);
+    }
+
+    // 兼容旧版本 cJSON 输出的带缩进格式
+    streamItems.clear();
+    ASSERT_TRUE(ReadItems(WriteItemsByCJson(items), streamItems));
+    ASSERT_EQ(streamItems.size(), items.size());
+    ExpectDeviceEq(streamItems.back(), items.back());
+}
+
+/**
+ * @tc.name: EscapeAndUnicode
+ * @tc.desc: 测试用例2：字符串的转义字符、控制字符与 \u 转义（含代理对）的写入与读取
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJsonTest, EscapeAndUnicode, TestSize.Level0)
+{
+    const std::string value = std::string("a\"b\\c\nd\re\tf") + '\x01' + "g/\xE4\xB8\xAD";
+    FcmJsonWriter writer;
+    writer.BeginArray();
+    writer.String(value);
+    writer.EndArray();
+    EXPECT_EQ(writer.GetBuffer(), "[\"a\\\"b\\\\c\\nd\\re\\tf\\u0001g/\xE4\xB8\xAD\"]");
+
+    FcmJsonReader reader(writer.GetBuffer());
+    std::string result;
+    ASSERT_TRUE(reader.BeginArray());
+    ASSERT_TRUE(reader.NextElement());
+    ASSERT_TRUE(reader.ReadString(result));
+    EXPECT_EQ(result, value);
+    EXPECT_FALSE(reader.NextElement());
+    EXPECT_TRUE(reader.IsEnd());
+
+    FcmJsonReader unicodeReader("[\"\\u00e9\\u4e2d\\ud83d\\ude00\\/\"]");
+    ASSERT_TRUE(unicodeReader.BeginArray());
+    ASSERT_TRUE(unicodeReader.NextElement());
+    ASSERT_TRUE(unicodeReader.ReadString(result));
+    EXPECT_EQ(result, "\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80/");
+
+    // 不成对的代理项与未转义的控制字符
+    for (const char *content : { "\"\\ud83d\"", "\"\\ude00\\u0041\"", "\"\\u12\"", "\"a\nb\"", "\"\\x\"" }) {
+        FcmJsonReader invalidReader(content);
+        EXPECT_FALSE(invalidReader.ReadString(result)) << content;
+        EXPECT_TRUE(invalidReader.HasError()) << content;
+    }
+}
+
+/**
+ * @tc.name: SkipInvalidDevice
+ * @tc.desc: 测试用例3：跳过未知字段与类型错误的字段，缺少必选字段的设备无效，但不影响后续设备的读取
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJsonTest, SkipInvalidDevice, TestSize.Level0)
+{
+    std::vector<PartnerDeviceJsonItem> items = MakeDevices(2, APP_NUM);  // 2: two valid devices
+    FcmJsonWriter writer;
+    writer.BeginArray();
+    PartnerDeviceJson::WriteDevice(writer, items[0].GetRecord());
+    // tokenId 类型错误，其余字段齐全
+    writer.BeginObject();
+    writer.Key("tokenId");
+    writer.String("1000");
+    writer.Key("unknown");
+    writer.BeginArray();
+    writer.BeginObject();
+    writer.Key("nested");
+    writer.BeginArray();
+    writer.Int(-1);
+    writer.Bool(false);
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+    // 不是对象的元素
+    writer.Int(1);
+    PartnerDeviceJson::WriteDevice(writer, items[1].GetRecord());
+    writer.EndArray();
+    // 在第一个设备中插入未知字段，并使用 cJSON 风格的浮点数格式
+    std::string content = writer.GetBuffer();
+    std::string registerTimestamp = "\"registerTimestamp\":" + std::to_string(REGISTER_TIMESTAMP);
+    size_t pos = content.find(registerTimestamp);
+    ASSERT_NE(pos, std::string::npos);
+    content.replace(pos, registerTimestamp.size(),
+        "\"extra\":{\"a\":[1,2.5e3,null,\"}\"]},\"registerTimestamp\":1.7e9");
+
+    std::vector<PartnerDeviceJsonItem> readItems;
+    ASSERT_TRUE(ReadItems(content, readItems));
+    ASSERT_EQ(readItems.size(), 2);  // 2: two valid devices
+    EXPECT_EQ(readItems[0].fields.registerTimestamp, REGISTER_TIMESTAMP);
+    ExpectDeviceEq(readItems[0], items[0]);
+    ExpectDeviceEq(readItems[1], items[1]);
+}
+
+/**
+ * @tc.name: TruncatedContent
+ * @tc.desc: 测试用例4：内容在任意位置被截断时，读取失败且不越界
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJsonTest, TruncatedContent, TestSize.Level0)
+{
+    std::string content = WriteItems(MakeDevices(3, APP_NUM));  // 3: any device number
+    for (size_t size = 0; size < content.size(); size++) {
+        // 拷贝到独立的内存，越界读取可被内存检查工具发现
+        std::string truncated = content.substr(0, size);
+        std::vector<PartnerDeviceJsonItem> items;
+        EXPECT_FALSE(ReadItems(truncated, items)) << "size: " << size;
+    }
+    std::vector<PartnerDeviceJsonItem> items;
+    EXPECT_TRUE(ReadItems(content, items));
+    EXPECT_EQ(items.size(), 3);  // 3: any device number
+}
+
+/**
+ * @tc.name: StreamMemoryShouldNotHoldTree
+ * @tc.desc: 测试用例5：100、1000、10000 台设备下，cJSON 树的堆内存峰值超过整个内容，流式读写不构建树
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceJsonTest, StreamMemoryShouldNotHoldTree, TestSize.Level1)
+{
+    const std::vector<uint32_t> deviceNumVec = { 100, 1000, 10000 };
+    for (uint32_t deviceNum : deviceNumVec) {
+        std::vector<PartnerDeviceJsonItem> items = MakeDevices(deviceNum, APP_NUM);
+        std::string jsonContent;
+        size_t jsonWritePeak = MeasurePeakBytes([&items, &jsonContent]() { jsonContent = WriteItemsByCJson(items); });
+        // 流式写入只分配输出缓冲区，不经过 cJSON
+        std::string streamContent;
+        size_t streamWritePeak = MeasurePeakBytes([&items, &streamContent]() { streamContent = WriteItems(items); });
+        EXPECT_EQ(streamWritePeak, 0);
+        EXPECT_GT(jsonWritePeak, streamContent.capacity()) << "devices: " << deviceNum;
+
+        std::vector<PartnerDeviceJsonItem> jsonItems;
+        std::vector<PartnerDeviceJsonItem> streamItems;
+        size_t jsonReadPeak = MeasurePeakBytes([&jsonContent, &jsonItems]() {
+            ReadItemsByCJson(jsonContent, jsonItems);
+        });
+        // 流式读取直接在内容上解析，每次只持有一台设备
+        bool isRead = false;
+        size_t streamReadPeak = MeasurePeakBytes([&streamContent, &streamItems, &isRead]() {
+            isRead = ReadItems(streamContent, streamItems);
+        });
+        ASSERT_TRUE(isRead);
+        EXPECT_EQ(streamReadPeak, 0);
+        EXPECT_GT(jsonReadPeak, jsonContent.size()) << "devices: " << deviceNum;
+        ASSERT_EQ(jsonItems.size(), items.size());
+        ASSERT_EQ(streamItems.size(), items.size());
+        ExpectDeviceEq(streamItems.front(), jsonItems.front());
+        ExpectDeviceEq(streamItems.back(), jsonItems.back());
+    }
+}
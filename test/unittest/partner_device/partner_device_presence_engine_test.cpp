@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDevicePresenceEngineTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "device_agent_capability_ble_adv.h"
+#include "device_agent_capability_br.h"
+#include "partner_device.h"
+#include "partner_device_presence_engine.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+// 5 个应用绑定同一个手表
+const uint32_t APP_NUM = 5;
+const uint32_t WATCH_INDEX = 0xaabbcc;
+const FcmMacAddress WATCH_ADDRESS = MakeAddress(WATCH_INDEX);
+
+// 第index个应用绑定手表，各应用的包名不同
+PartnerDevice::DeviceInfo MakeAppDeviceInfo(uint32_t index)
+{
+    PartnerDevice::DeviceInfo deviceInfo = MakeDeviceInfo(TOKEN_ID + index, WATCH_INDEX, true);
+    deviceInfo.bundleName += std::to_string(index);
+    return deviceInfo;
+}
+}  // namespace
+
+// Mock依赖函数接口，按应用记录extension的拉起和销毁
+class MockDependencyFuncs {
+public:
+    MOCK_METHOD(void, discoverExtension, (const std::string &), ());
+    MOCK_METHOD(void, destroyExtension, (const std::string &, int), ());
+};
+
+class PartnerDevicePresenceEngineTest : public testing::Test {
+public:
+    PartnerDevicePresenceEngineTest() = default;
+    ~PartnerDevicePresenceEngineTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    // 创建并激活绑定同一地址的设备
+    void BindDevices(uint32_t deviceNum);
+    void CloseDevices();
+    std::shared_ptr<DeviceAgentCapabilityBleAdv> GetBleAdv();
+
+    std::shared_ptr<MockDependencyFuncs> funcs_;
+    PartnerDevice::DependencyFuncs realFuncs_;
+    std::vector<std::shared_ptr<PartnerDevice>> devices_;
+};
+
+void PartnerDevicePresenceEngineTest::SetUpTestCase(void)
+{}
+void PartnerDevicePresenceEngineTest::TearDownTestCase(void)
+{}
+void PartnerDevicePresenceEngineTest::SetUp()
+{
+    funcs_ = std::make_shared<NiceMock<MockDependencyFuncs>>();
+    realFuncs_ = {
+        .updateConfig = [](const PartnerDeviceMapKey &) {},
+        .discoverExtension = [this](std::string bundleName, std::string, PartnerDeviceAddress) {
+            funcs_->discoverExtension(bundleName);
+        },
+        .destroyExtension = [this](std::string bundleName, std::string, int reason) {
+            funcs_->destroyExtension(bundleName, reason);
+        },
+    };
+}
+void PartnerDevicePresenceEngineTest::TearDown()
+{
+    CloseDevices();
+}
+
+void PartnerDevicePresenceEngineTest::BindDevices(uint32_t deviceNum)
+{
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        // 模拟已配对的设备
+        auto device = PartnerDevice::CreateInstance(MakeAppDeviceInfo(devices_.size()), realFuncs_, true, true);
+        devices_.push_back(device);
+    }
+}
+
+std::shared_ptr<DeviceAgentCapabilityBleAdv> PartnerDevicePresenceEngineTest::GetBleAdv()
+{
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    if (engine == nullptr) {
+        return nullptr;
+    }
+    for (auto &[_, capability] : engine->GetCapabilities()) {
+        if (auto bleAdv = std::dynamic_pointer_cast<DeviceAgentCapabilityBleAdv>(capability)) {
+            return bleAdv;
+        }
+    }
+    return nullptr;
+}
+
+void PartnerDevicePresenceEngineTest::CloseDevices()
+{
+    for (auto &device : devices_) {
+        device->Close();
+    }
+    devices_.clear();
+}
+
+/**
+ * @tc.name: AppsBindingOneAddressShouldShareOneScanSession
+ * @tc.desc: 测试用例1：5个应用绑定同一地址时只创建一个在位引擎和一个扫描过滤条件，最后一个应用关闭后释放
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, AppsBindingOneAddressShouldShareOneScanSession, TestSize.Level0)
+{
+    PartnerDeviceScanEngine &scanEngine = PartnerDeviceScanEngine::GetInstance();
+    size_t filterNum = scanEngine.GetFilterCount();
+    BindDevices(APP_NUM);
+
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+    EXPECT_EQ(engine->GetSubscriberCount(), APP_NUM);
+    EXPECT_EQ(engine->GetCapabilities().size(), 2);
+    for (auto &device : devices_) {
+        EXPECT_EQ(device->GetRuntime()->presenceEngine, engine);
+    }
+    EXPECT_EQ(scanEngine.GetFilterCount(), filterNum + 1);
+
+    engine = nullptr;
+    CloseDevices();
+    EXPECT_EQ(PartnerDevicePresenceEngine::Find(WATCH_ADDRESS), nullptr);
+    EXPECT_EQ(scanEngine.GetFilterCount(), filterNum);
+}
+
+/**
+ * @tc.name: AclEventShouldFanOutToAllApps
+ * @tc.desc: 测试用例2：一次ACL连接事件由引擎处理一次，拉起所有应用的extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, AclEventShouldFanOutToAllApps, TestSize.Level0)
+{
+    BindDevices(APP_NUM);
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+
+    for (uint32_t i = 0; i < APP_NUM; i++) {
+        EXPECT_CALL(*funcs_, discoverExtension(MakeAppDeviceInfo(i).bundleName)).Times(1);
+    }
+    engine->OnBluetoothDeviceAclStateChange(true);
+    // 重复的连接事件不重复拉起
+    engine->OnBluetoothDeviceAclStateChange(true);
+    EXPECT_EQ(engine->stateMachine_.GetState(), PartnerDevicePresenceStateMachine::STATE_CONNECTED);
+
+    // 断连超过退出延时后销毁所有应用的extension
+    engine->OnBluetoothDeviceAclStateChange(false);
+    EXPECT_CALL(*funcs_, destroyExtension(_, ABILITY_DESTROY_DEVICE_LOST)).Times(APP_NUM);
+    engine->OnPresenceEvent(PartnerDevicePresenceStateMachine::EVENT_LINK_LOST, ABILITY_DESTROY_DEVICE_LOST);
+    EXPECT_FALSE(engine->stateMachine_.IsPresent());
+}
+
+/**
+ * @tc.name: LateSubscriberShouldStartWhenPresent
+ * @tc.desc: 测试用例3：设备在位时新绑定的应用立即拉起extension，关闭的应用不再收到通知
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, LateSubscriberShouldStartWhenPresent, TestSize.Level0)
+{
+    BindDevices(1);
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+    engine->OnPresenceEvent(PartnerDevicePresenceStateMachine::EVENT_BLE_SEEN, ABILITY_DESTROY_UNKNOWN_REASON);
+
+    const std::string lateBundleName = MakeAppDeviceInfo(1).bundleName;
+    EXPECT_CALL(*funcs_, discoverExtension(lateBundleName)).Times(1);
+    BindDevices(1);
+    EXPECT_EQ(engine->GetSubscriberCount(), 2);
+
+    // 第一个应用关闭后只通知仍订阅的应用
+    devices_.front()->Close();
+    EXPECT_EQ(engine->GetSubscriberCount(), 1);
+    EXPECT_CALL(*funcs_, destroyExtension(lateBundleName, ABILITY_DESTROY_DEVICE_LOST)).Times(1);
+    engine->OnPresenceEvent(PartnerDevicePresenceStateMachine::EVENT_BLE_LOST, ABILITY_DESTROY_DEVICE_LOST);
+}
+
+/**
+ * @tc.name: BleCapabilityShouldFollowSubscribers
+ * @tc.desc: 测试用例4：只有支持BLE广播的应用订阅时才创建BLE能力
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, BleCapabilityShouldFollowSubscribers, TestSize.Level0)
+{
+    auto engine = PartnerDevicePresenceEngine::Acquire(WATCH_ADDRESS);
+    PartnerDevicePresenceEngine::Subscriber brSubscriber;
+    PartnerDevicePresenceEngine::Subscriber bleSubscriber;
+    bleSubscriber.isSupportBleAdvertiser = true;
+
+    uint64_t brId = engine->Subscribe(brSubscriber);
+    EXPECT_EQ(engine->GetCapabilities().size(), 1);
+    uint64_t bleId = engine->Subscribe(bleSubscriber);
+    EXPECT_EQ(engine->GetCapabilities().size(), 2);
+    engine->Unsubscribe(bleId);
+    EXPECT_EQ(engine->GetCapabilities().size(), 1);
+    engine->Unsubscribe(brId);
+    EXPECT_TRUE(engine->GetCapabilities().empty());
+}
+
+/**
+ * @tc.name: BrAndBleSignalsShouldStartOnce
+ * @tc.desc: 测试用例5：BLE发现后建立ACL连接，BR和BLE能力的进入事件只拉起一次extension，断连退出后只销毁一次
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, BrAndBleSignalsShouldStartOnce, TestSize.Level0)
+{
+    BindDevices(1);
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+    auto capabilities = engine->GetCapabilities();
+    ASSERT_EQ(capabilities.size(), 2);
+    IDeviceAgentCapability::DependencyFuncs brFuncs;
+    IDeviceAgentCapability::DependencyFuncs bleFuncs;
+    for (auto &[_, capability] : capabilities) {
+        if (auto br = std::dynamic_pointer_cast<DeviceAgentCapabilityBr>(capability)) {
+            brFuncs = br->funcs_;
+        } else if (auto bleAdv = std::dynamic_pointer_cast<DeviceAgentCapabilityBleAdv>(capability)) {
+            bleFuncs = bleAdv->funcs_;
+        }
+    }
+    ASSERT_TRUE(brFuncs.startExtension && bleFuncs.startExtension);
+
+    EXPECT_CALL(*funcs_, discoverExtension(_)).Times(1);
+    EXPECT_CALL(*funcs_, destroyExtension(_, _)).Times(1);
+    bleFuncs.startExtension();
+    engine->OnBluetoothDeviceAclStateChange(true);
+    brFuncs.startExtension();
+    // 连接期间BLE退出不销毁
+    bleFuncs.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
+    engine->OnBluetoothDeviceAclStateChange(false);
+    EXPECT_EQ(engine->stateMachine_.GetState(), PartnerDevicePresenceStateMachine::STATE_LINGER);
+    brFuncs.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
+    bleFuncs.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
+    EXPECT_EQ(engine->stateMachine_.GetState(), PartnerDevicePresenceStateMachine::STATE_ABSENT);
+}
+
+/**
+ * @tc.name: BleSightingAfterAclDropShouldKeepExtension
+ * @tc.desc: 测试用例6：ACL断连后BLE能力恢复扫描，退出延时内再次发现设备，链路丢失后保持在位，不销毁也不重新拉起extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, BleSightingAfterAclDropShouldKeepExtension, TestSize.Level0)
+{
+    BindDevices(1);
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+    std::shared_ptr<DeviceAgentCapabilityBr> br = nullptr;
+    std::shared_ptr<DeviceAgentCapabilityBleAdv> bleAdv = nullptr;
+    for (auto &[_, capability] : engine->GetCapabilities()) {
+        if (auto brCapability = std::dynamic_pointer_cast<DeviceAgentCapabilityBr>(capability)) {
+            br = brCapability;
+        } else if (auto bleCapability = std::dynamic_pointer_cast<DeviceAgentCapabilityBleAdv>(capability)) {
+            bleAdv = bleCapability;
+        }
+    }
+    ASSERT_TRUE(br != nullptr && bleAdv != nullptr);
+
+    EXPECT_CALL(*funcs_, discoverExtension(_)).Times(1);
+    EXPECT_CALL(*funcs_, destroyExtension(_, _)).Times(0);
+    engine->OnBluetoothDeviceAclStateChange(true);
+    EXPECT_EQ(bleAdv->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+    engine->OnBluetoothDeviceAclStateChange(false);
+    EXPECT_EQ(engine->stateMachine_.GetState(), PartnerDevicePresenceStateMachine::STATE_LINGER);
+    EXPECT_NE(bleAdv->scanFilterId_, PartnerDeviceScanEngine::INVALID_FILTER_ID);
+
+    Bluetooth::BleScanResult result;
+    result.SetRssi(bleAdv->presenceFilter_.GetConfig().enterRssi);
+    for (uint32_t i = 0; i < bleAdv->presenceFilter_.GetConfig().sightingNum; i++) {
+        bleAdv->OnScanEvent(result, PartnerDeviceScanEngine::SCAN_EVENT_RESULT);
+    }
+    // BR能力的退出延时到达，链路丢失
+    br->funcs_.destroyExtension(ABILITY_DESTROY_DEVICE_LOST);
+    EXPECT_EQ(engine->stateMachine_.GetState(), PartnerDevicePresenceStateMachine::STATE_SEEN);
+}
+
+/**
+ * @tc.name: ScanHistoryShouldSurviveBluetoothToggle
+ * @tc.desc: 测试用例7：蓝牙关闭时引擎和BLE能力释放，蓝牙打开后新的BLE能力沿用学习到的设备出现时段，解绑后清除
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, ScanHistoryShouldSurviveBluetoothToggle, TestSize.Level0)
+{
+    // 连续两天在同一时段出现，该时段成为设备可能出现的时段
+    const int64_t presenceMs = PartnerDeviceScanScheduler::DAY_MS * 100;
+    const int64_t nextDayMs = presenceMs + PartnerDeviceScanScheduler::DAY_MS;
+    BindDevices(1);
+    auto bleAdv = GetBleAdv();
+    ASSERT_NE(bleAdv, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(bleAdv->bleScanMutex_);
+        bleAdv->scanScheduler_.OnPresence(presenceMs);
+        bleAdv->scanScheduler_.OnPresence(nextDayMs);
+    }
+    ASSERT_TRUE(bleAdv->GetScanScheduler().IsLikely(nextDayMs));
+
+    devices_[0]->OnBluetoothTurnOff();
+    EXPECT_EQ(PartnerDevicePresenceEngine::Find(WATCH_ADDRESS), nullptr);
+    devices_[0]->OnBluetoothTurnOn(true);
+    auto newBleAdv = GetBleAdv();
+    ASSERT_NE(newBleAdv, nullptr);
+    EXPECT_NE(newBleAdv, bleAdv);
+    EXPECT_TRUE(newBleAdv->GetScanScheduler().IsLikely(nextDayMs));
+
+    // 地址的最后一个绑定删除后，重新绑定的设备从头学习
+    CloseDevices();
+    PartnerDevicePresenceEngine::ClearScanHistory(WATCH_ADDRESS);
+    BindDevices(1);
+    ASSERT_NE(GetBleAdv(), nullptr);
+    EXPECT_FALSE(GetBleAdv()->GetScanScheduler().IsLikely(nextDayMs));
+}
+
+/**
+ * @tc.name: ClearedScanHistoryShouldNotComeBack
+ * @tc.desc: 测试用例8：解绑时引擎仍被其他流程持有，清除的扫描历史不会在引擎再次订阅或释放后恢复
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceEngineTest, ClearedScanHistoryShouldNotComeBack, TestSize.Level0)
+{
+    const int64_t presenceMs = PartnerDeviceScanScheduler::DAY_MS * 100;
+    const int64_t nextDayMs = presenceMs + PartnerDeviceScanScheduler::DAY_MS;
+    auto learn = [this, presenceMs, nextDayMs]() {
+        auto bleAdv = GetBleAdv();
+        ASSERT_NE(bleAdv, nullptr);
+        std::lock_guard<std::mutex> lock(bleAdv->bleScanMutex_);
+        bleAdv->scanScheduler_.OnPresence(presenceMs);
+        bleAdv->scanScheduler_.OnPresence(nextDayMs);
+    };
+    BindDevices(1);
+    learn();
+    // 模拟遍历引擎的流程在解绑期间持有引擎
+    auto engine = PartnerDevicePresenceEngine::Find(WATCH_ADDRESS);
+    ASSERT_NE(engine, nullptr);
+    CloseDevices();
+    PartnerDevicePresenceEngine::ClearScanHistory(WATCH_ADDRESS);
+    BindDevices(1);
+    EXPECT_EQ(PartnerDevicePresenceEngine::Find(WATCH_ADDRESS), engine);
+    ASSERT_NE(GetBleAdv(), nullptr);
+    EXPECT_FALSE(GetBleAdv()->GetScanScheduler().IsLikely(nextDayMs));
+
+    learn();
+    CloseDevices();
+    PartnerDevicePresenceEngine::ClearScanHistory(WATCH_ADDRESS);
+    engine = nullptr;
+    EXPECT_EQ(PartnerDevicePresenceEngine::Find(WATCH_ADDRESS), nullptr);
+    BindDevices(1);
+    ASSERT_NE(GetBleAdv(), nullptr);
+    EXPECT_FALSE(GetBleAdv()->GetScanScheduler().IsLikely(nextDayMs));
+}
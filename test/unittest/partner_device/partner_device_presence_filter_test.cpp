@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDevicePresenceFilterTest"
+#endif
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <optional>
+#include <vector>
+#include "partner_device_presence_filter.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+constexpr int64_t SAMPLE_INTERVAL_MS = 1000;
+constexpr int64_t TRACE_DURATION_MS = 60 * 60 * 1000;  // 1h
+// 旧实现：扫描到设备即拉起extension并停止扫描，3分钟内无ACL连接则断开extension后重新扫描
+constexpr int64_t LEGACY_KEEP_ALIVE_MS = 3 * 60 * 1000;
+// 接收灵敏度，更弱的广播收不到
+constexpr int RECEIVER_SENSITIVITY = -100;
+
+// 合成的RSSI轨迹，每秒一个采样，nullopt表示该秒未收到广播
+using RssiTrace = std::vector<std::optional<int>>;
+
+class Lcg {
+public:
+    explicit Lcg(uint32_t seed) : seed_(seed) {}
+
+    // 返回 [min, max] 内的随机数
+    int Next(int min, int max)
+    {
+        seed_ = seed_ * 1103515245 + 12345;
+        return min + static_cast<int>((seed_ >> 16) % static_cast<uint32_t>(max - min + 1));
+    }
+
+private:
+    uint32_t seed_;
+};
+
+// 按 rssiAt 给出的每秒平均信号强度生成轨迹，叠加抖动和丢包，弱于接收灵敏度的广播丢弃
+RssiTrace MakeTrace(uint32_t seed, int jitter, int lossPercent, const std::function<int(int64_t)> &rssiAt)
+{
+    const int percent = 100;
+    Lcg lcg(seed);
+    RssiTrace trace;
+    for (int64_t timeMs = 0; timeMs < TRACE_DURATION_MS; timeMs += SAMPLE_INTERVAL_MS) {
+        int rssi = rssiAt(timeMs) + lcg.Next(-jitter, jitter);
+        if (lcg.Next(1, percent) <= lossPercent || rssi < RECEIVER_SENSITIVITY) {
+            trace.push_back(std::nullopt);
+        } else {
+            trace.push_back(rssi);
+        }
+    }
+    return trace;
+}
+
+// 回放轨迹，每秒检查一次退出（模拟定时器），返回extension拉起次数
+int ReplayWithFilter(const RssiTrace &trace, const PartnerDevicePresenceFilter::Config &config)
+{
+    PartnerDevicePresenceFilter filter(config);
+    int startNum = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        int64_t nowMs = static_cast<int64_t>(i) * SAMPLE_INTERVAL_MS;
+        (void)filter.OnTimeout(nowMs);
+        if (!trace[i].has_value()) {
+            continue;
+        }
+        if (filter.OnSighting(*trace[i], nowMs) == PartnerDevicePresenceFilter::TRANSITION_ENTER) {
+            startNum++;
+        }
+    }
+    return startNum;
+}
+
+// 按found/lost上报回放轨迹：控制器在未跟踪时收到广播即上报发现，连续 lostTimeoutMs 未收到广播上报丢失
+int ReplayFoundLostWithFilter(const RssiTrace &trace, const PartnerDevicePresenceFilter::Config &config,
+    int64_t lostTimeoutMs)
+{
+    PartnerDevicePresenceFilter filter(config);
+    int startNum = 0;
+    bool isTracking = false;
+    int64_t lastSeenMs = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        int64_t nowMs = static_cast<int64_t>(i) * SAMPLE_INTERVAL_MS;
+        if (isTracking && nowMs - lastSeenMs >= lostTimeoutMs) {
+            isTracking = false;
+            filter.OnTrackStop(nowMs);
+        }
+        (void)filter.OnTimeout(nowMs);
+        if (!trace[i].has_value()) {
+            continue;
+        }
+        lastSeenMs = nowMs;
+        if (!isTracking) {
+            isTracking = true;
+            startNum += filter.OnFound(*trace[i], nowMs) == PartnerDevicePresenceFilter::TRANSITION_ENTER ? 1 : 0;
+        }
+    }
+    return startNum;
+}
+
+int ReplayLegacy(const RssiTrace &trace)
+{
+    int startNum = 0;
+    bool isStarted = false;
+    int64_t startTimeMs = 0;
+    for (size_t i = 0; i < trace.size(); i++) {
+        int64_t nowMs = static_cast<int64_t>(i) * SAMPLE_INTERVAL_MS;
+        if (isStarted && nowMs - startTimeMs >= LEGACY_KEEP_ALIVE_MS) {
+            isStarted = false;
+        }
+        if (!isStarted && trace[i].has_value()) {
+            isStarted = true;
+            startTimeMs = nowMs;
+            startNum++;
+        }
+    }
+    return startNum;
+}
+}  // namespace
+
+class PartnerDevicePresenceFilterTest : public testing::Test {
+public:
+    PartnerDevicePresenceFilterTest() = default;
+    ~PartnerDevicePresenceFilterTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDevicePresenceFilterTest::SetUpTestCase(void)
+{}
+void PartnerDevicePresenceFilterTest::TearDownTestCase(void)
+{}
+void PartnerDevicePresenceFilterTest::SetUp()
+{}
+void PartnerDevicePresenceFilterTest::TearDown()
+{}
+
+// 测试用例1：N次出现中M次信号足够强才进入
+/**
+ * @tc.name: EnterShouldNeedSightingsInWindow
+ * @tc.desc: 验证信号弱于进入阈值的出现不计数，窗口外的出现过期
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceFilterTest, EnterShouldNeedSightingsInWindow, TestSize.Level0)
+{
+    PartnerDevicePresenceFilter::Config config;
+    PartnerDevicePresenceFilter filter(config);
+    const int strong = config.enterRssi;
+    const int weak = config.enterRssi - 1;
+
+    EXPECT_EQ(filter.OnSighting(strong, 0), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    // 第一次强信号已超出时间窗口
+    EXPECT_EQ(filter.OnSighting(strong, config.windowMs + 1), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.OnSighting(weak, config.windowMs + 2), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.OnSighting(weak, config.windowMs + 3), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.OnSighting(weak, config.windowMs + 4), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    // 第一次强信号已超出最近M次出现
+    EXPECT_EQ(filter.OnSighting(strong, config.windowMs + 5), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.OnSighting(strong, config.windowMs + 6), PartnerDevicePresenceFilter::TRANSITION_ENTER);
+    EXPECT_TRUE(filter.IsPresent());
+    EXPECT_EQ(filter.OnSighting(strong, config.windowMs + 7), PartnerDevicePresenceFilter::TRANSITION_NONE);
+}
+
+// 测试用例2：进入与退出的滞回
+/**
+ * @tc.name: ExitShouldUseHysteresis
+ * @tc.desc: 验证在位期间不弱于退出阈值的信号保持在位，超过退出延时后退出
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceFilterTest, ExitShouldUseHysteresis, TestSize.Level0)
+{
+    PartnerDevicePresenceFilter::Config config;
+    PartnerDevicePresenceFilter filter(config);
+    filter.OnSighting(config.enterRssi, 0);
+    ASSERT_EQ(filter.OnSighting(config.enterRssi, 1), PartnerDevicePresenceFilter::TRANSITION_ENTER);
+
+    // 介于进入和退出阈值之间的信号保持在位
+    int64_t keepMs = config.exitDelayMs / 2;
+    filter.OnSighting(config.exitRssi, keepMs);
+    EXPECT_EQ(filter.GetExitTimeMs(), keepMs + config.exitDelayMs);
+    filter.OnSighting(config.exitRssi - 1, keepMs + 1);
+    EXPECT_EQ(filter.GetExitTimeMs(), keepMs + config.exitDelayMs);
+
+    EXPECT_EQ(filter.OnTimeout(keepMs + config.exitDelayMs - 1), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.OnTimeout(keepMs + config.exitDelayMs), PartnerDevicePresenceFilter::TRANSITION_EXIT);
+    EXPECT_FALSE(filter.IsPresent());
+    EXPECT_EQ(filter.GetExitTimeMs(), -1);
+}
+
+// 测试用例3：跟踪期间保持在位
+/**
+ * @tc.name: TrackShouldHoldPresence
+ * @tc.desc: 验证跟踪开始即进入，跟踪期间不退出，跟踪停止后经过退出延时退出，延时内重新跟踪不重复进入
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceFilterTest, TrackShouldHoldPresence, TestSize.Level0)
+{
+    PartnerDevicePresenceFilter::Config config;
+    PartnerDevicePresenceFilter filter(config);
+    EXPECT_EQ(filter.OnTrackStart(0), PartnerDevicePresenceFilter::TRANSITION_ENTER);
+    EXPECT_EQ(filter.GetExitTimeMs(), -1);
+    EXPECT_EQ(filter.OnTimeout(config.exitDelayMs * 2), PartnerDevicePresenceFilter::TRANSITION_NONE);
+
+    int64_t stopMs = config.exitDelayMs * 2;
+    filter.OnTrackStop(stopMs);
+    EXPECT_EQ(filter.GetExitTimeMs(), stopMs + config.exitDelayMs);
+    EXPECT_EQ(filter.OnTrackStart(stopMs + 1), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    filter.OnTrackStop(stopMs + 2);
+    EXPECT_EQ(filter.OnTimeout(stopMs + 2 + config.exitDelayMs), PartnerDevicePresenceFilter::TRANSITION_EXIT);
+}
+
+// 测试用例4：RSSI轨迹回放
+/**
+ * @tc.name: ReplayShouldReduceExtensionStarts
+ * @tc.desc: 回放1小时的合成RSSI轨迹，对比旧实现与在位判断的extension拉起次数
+ * @tc.type: PERF
+ */
+HWTEST_F(PartnerDevicePresenceFilterTest, ReplayShouldReduceExtensionStarts, TestSize.Level1)
+{
+    const int64_t minuteMs = 60 * 1000;
+    const int farRssi = -110;
+    struct TestCase {
+        const char *name;
+        RssiTrace trace;
+        int maxStartNum;
+    };
+    std::vector<TestCase> testCases = {
+        // 设备一直在近处
+        { "near", MakeTrace(1, 5, 10, [](int64_t) { return -60; }), 1 },
+        // 设备在覆盖边缘，信号在退出阈值附近波动，偶尔强于进入阈值，大量丢包
+        { "edge", MakeTrace(2, 8, 50, [](int64_t) { return -88; }), 2 },
+        // 设备靠近停留20分钟后离开
+        { "pass by", MakeTrace(3, 5, 20, [minuteMs, farRssi](int64_t timeMs) {
+            const int64_t arriveMs = 10 * minuteMs;
+            const int64_t leaveMs = 30 * minuteMs;
+            return (timeMs >= arriveMs && timeMs < leaveMs) ? -65 : farRssi;
+        }), 1 },
+    };
+    PartnerDevicePresenceFilter::Config config;
+    for (const auto &testCase : testCases) {
+        int legacyStartNum = ReplayLegacy(testCase.trace);
+        int startNum = ReplayWithFilter(testCase.trace, config);
+        // 每条轨迹中设备都曾在近处，在位判断不能把它滤掉
+        EXPECT_GE(startNum, 1) << testCase.name;
+        EXPECT_LE(startNum, testCase.maxStartNum) << testCase.name;
+        EXPECT_LE(startNum, legacyStartNum) << testCase.name;
+    }
+}
+
+// 测试用例5：found/lost上报的信号门限
+/**
+ * @tc.name: FoundShouldNeedEnterRssi
+ * @tc.desc: 回放found/lost上报，验证发现时信号弱于进入阈值不进入，控制器也不作为跟踪来源；在位期间按退出阈值判断
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceFilterTest, FoundShouldNeedEnterRssi, TestSize.Level0)
+{
+    PartnerDevicePresenceFilter::Config config;
+    const int64_t lostTimeoutMs = 10 * 1000;
+    // 设备一直在覆盖边缘之外，每次发现的信号都弱于进入阈值
+    RssiTrace farTrace = MakeTrace(4, 3, 30, [&config](int64_t) { return config.enterRssi - 10; });
+    EXPECT_EQ(ReplayFoundLostWithFilter(farTrace, config, lostTimeoutMs), 0);
+    RssiTrace nearTrace = MakeTrace(5, 3, 30, [](int64_t) { return -60; });
+    EXPECT_EQ(ReplayFoundLostWithFilter(nearTrace, config, lostTimeoutMs), 1);
+
+    PartnerDevicePresenceFilter filter(config);
+    EXPECT_EQ(filter.OnFound(config.enterRssi - 1, 0), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_FALSE(filter.IsPresent());
+    // 未跟踪时上报的丢失不影响在位
+    filter.OnTrackStop(1);
+    EXPECT_EQ(filter.GetExitTimeMs(), -1);
+    EXPECT_EQ(filter.OnFound(config.enterRssi, 2), PartnerDevicePresenceFilter::TRANSITION_ENTER);
+    EXPECT_EQ(filter.GetExitTimeMs(), -1);
+
+    // 丢失后在退出延时内再次发现，信号不弱于退出阈值时恢复跟踪，更弱时不延长在位
+    int64_t lostMs = 3;
+    filter.OnTrackStop(lostMs);
+    EXPECT_EQ(filter.OnFound(config.exitRssi - 1, lostMs + 1), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.GetExitTimeMs(), lostMs + config.exitDelayMs);
+    EXPECT_EQ(filter.OnFound(config.exitRssi, lostMs + 2), PartnerDevicePresenceFilter::TRANSITION_NONE);
+    EXPECT_EQ(filter.GetExitTimeMs(), -1);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDevicePresenceStateMachineTest"
+#endif
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "partner_device_presence_state_machine.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+using StateMachine = PartnerDevicePresenceStateMachine;
+
+struct EventCase {
+    const char *name;
+    std::vector<StateMachine::Event> events;
+    StateMachine::State finalState;
+    int startNum;
+    int destroyNum;
+};
+
+// 各能力的事件可能交错、重复或乱序到达，每个在位周期只能拉起和销毁一次
+const std::vector<EventCase> EVENT_CASES = {
+    { "ble episode", { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_LOST },
+        StateMachine::STATE_ABSENT, 1, 1 },
+    { "ble repeated", { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_LOST,
+        StateMachine::EVENT_BLE_LOST }, StateMachine::STATE_ABSENT, 1, 1 },
+    { "ble then acl", { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_ACL_CONNECTED,
+        StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED, StateMachine::EVENT_LINK_LOST },
+        StateMachine::STATE_ABSENT, 1, 1 },
+    { "acl episode", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED,
+        StateMachine::EVENT_LINK_LOST }, StateMachine::STATE_ABSENT, 1, 1 },
+    { "reconnect in linger", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED,
+        StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED, StateMachine::EVENT_ACL_CONNECTED },
+        StateMachine::STATE_CONNECTED, 1, 0 },
+    { "ble lost while connected", { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_ACL_CONNECTED,
+        StateMachine::EVENT_BLE_LOST }, StateMachine::STATE_CONNECTED, 1, 0 },
+    { "ble lost in linger", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED,
+        StateMachine::EVENT_BLE_LOST }, StateMachine::STATE_LINGER, 1, 0 },
+    { "ble seen in linger", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED,
+        StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_LINK_LOST }, StateMachine::STATE_SEEN, 1, 0 },
+    { "ble seen then lost in linger", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED,
+        StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_LINK_LOST, StateMachine::EVENT_BLE_LOST },
+        StateMachine::STATE_ABSENT, 1, 1 },
+    { "link lost before connected", { StateMachine::EVENT_ACL_DISCONNECTED, StateMachine::EVENT_LINK_LOST },
+        StateMachine::STATE_ABSENT, 0, 0 },
+    { "link lost while connected", { StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_LINK_LOST },
+        StateMachine::STATE_CONNECTED, 1, 0 },
+    { "two episodes", { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_LOST, StateMachine::EVENT_ACL_CONNECTED,
+        StateMachine::EVENT_ACL_DISCONNECTED, StateMachine::EVENT_LINK_LOST }, StateMachine::STATE_ABSENT, 2, 2 },
+};
+}  // namespace
+
+class PartnerDevicePresenceStateMachineTest : public testing::Test {
+public:
+    PartnerDevicePresenceStateMachineTest() = default;
+    ~PartnerDevicePresenceStateMachineTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDevicePresenceStateMachineTest::SetUpTestCase(void)
+{}
+void PartnerDevicePresenceStateMachineTest::TearDownTestCase(void)
+{}
+void PartnerDevicePresenceStateMachineTest::SetUp()
+{}
+void PartnerDevicePresenceStateMachineTest::TearDown()
+{}
+
+/**
+ * @tc.name: EventSequencesShouldNotDuplicateIpc
+ * @tc.desc: 测试用例1：按事件序列表驱动状态机，拉起和销毁交替出现，次数和最终状态符合预期
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceStateMachineTest, EventSequencesShouldNotDuplicateIpc, TestSize.Level0)
+{
+    for (const auto &eventCase : EVENT_CASES) {
+        StateMachine stateMachine;
+        int startNum = 0;
+        int destroyNum = 0;
+        for (auto event : eventCase.events) {
+            StateMachine::Action action = stateMachine.OnEvent(event);
+            if (action == StateMachine::ACTION_START) {
+                startNum++;
+            } else if (action == StateMachine::ACTION_DESTROY) {
+                destroyNum++;
+            }
+            // 已拉起的extension销毁前不再拉起，未拉起的extension不销毁
+            EXPECT_TRUE(startNum == destroyNum || startNum == destroyNum + 1) << eventCase.name << " at "
+                << StateMachine::ToString(event);
+            EXPECT_EQ(stateMachine.IsPresent(), startNum == destroyNum + 1) << eventCase.name;
+        }
+        EXPECT_EQ(stateMachine.GetState(), eventCase.finalState) << eventCase.name;
+        EXPECT_EQ(startNum, eventCase.startNum) << eventCase.name;
+        EXPECT_EQ(destroyNum, eventCase.destroyNum) << eventCase.name;
+    }
+}
+
+/**
+ * @tc.name: AllEventPairsShouldNotDuplicateIpc
+ * @tc.desc: 测试用例2：从每个状态出发的任意两个事件序列都不会重复拉起或销毁
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDevicePresenceStateMachineTest, AllEventPairsShouldNotDuplicateIpc, TestSize.Level0)
+{
+    const std::vector<StateMachine::Event> allEvents = { StateMachine::EVENT_BLE_SEEN, StateMachine::EVENT_BLE_LOST,
+        StateMachine::EVENT_ACL_CONNECTED, StateMachine::EVENT_ACL_DISCONNECTED, StateMachine::EVENT_LINK_LOST };
+    // 穷举长度为4的事件序列
+    const size_t sequenceLen = 4;
+    size_t sequenceNum = 1;
+    for (size_t i = 0; i < sequenceLen; i++) {
+        sequenceNum *= allEvents.size();
+    }
+    for (size_t sequence = 0; sequence < sequenceNum; sequence++) {
+        StateMachine stateMachine;
+        bool isStarted = false;
+        size_t code = sequence;
+        for (size_t i = 0; i < sequenceLen; i++) {
+            StateMachine::Event event = allEvents[code % allEvents.size()];
+            code /= allEvents.size();
+            StateMachine::Action action = stateMachine.OnEvent(event);
+            EXPECT_FALSE(action == StateMachine::ACTION_START && isStarted) << "sequence " << sequence;
+            EXPECT_FALSE(action == StateMachine::ACTION_DESTROY && !isStarted) << "sequence " << sequence;
+            if (action != StateMachine::ACTION_NONE) {
+                isStarted = action == StateMachine::ACTION_START;
+            }
+            EXPECT_EQ(stateMachine.IsPresent(), isStarted) << "sequence " << sequence;
+        }
+    }
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceRegistryTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "partner_device_registry.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const FcmMacAddress ADDRESS_1(0x001122334455ULL);
+const FcmMacAddress ADDRESS_2(0x001122334466ULL);
+const FcmMacAddress ADDRESS_3(0x001122334477ULL);
+const int32_t USER_ID_1 = 100;
+const int32_t USER_ID_2 = 101;
+
+PartnerDeviceMapKey MakeKey(uint32_t index)
+{
+    const uint32_t appNum = 10;
+    return std::make_pair(index % appNum, MakeAddress(index));
+}
+
+void FillRegistry(PartnerDeviceRegistry &registry, uint32_t deviceNum)
+{
+    std::vector<PartnerDeviceRegistry::Entry> devices;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        devices.push_back({ MakeKey(i), USER_ID_1, nullptr });
+    }
+    registry.EnsureInsertBatch(devices);
+}
+
+// 多个读线程持续查询不变的设备，同时一个写线程周期性绑定/解绑其他设备，返回读线程查询失败的次数
+int RunContention(PartnerDeviceRegistry &registry, uint32_t deviceNum)
+{
+    const int readerNum = 4;
+    const int readTimes = 200000;
+    const uint32_t writeKeyNum = 100;
+    std::vector<PartnerDeviceMapKey> keyVec;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        keyVec.push_back(MakeKey(i));
+    }
+
+    std::atomic_bool isStopped = false;
+    std::thread writer([&registry, &isStopped, deviceNum, writeKeyNum]() {
+        uint32_t index = 0;
+        while (!isStopped.load()) {
+            PartnerDeviceMapKey key = MakeKey(deviceNum + index % writeKeyNum);
+            (index / writeKeyNum) % 2 == 0 ? registry.EnsureInsert(key, USER_ID_1, nullptr) : registry.Erase(key);
+            index++;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::atomic_int missNum = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < readerNum; i++) {
+        readers.emplace_back([&registry, &missNum, &keyVec]() {
+            PartnerDeviceRegistry::DeviceSptr device = nullptr;
+            for (int j = 0; j < readTimes; j++) {
+                missNum += registry.Find(keyVec[static_cast<size_t>(j) % keyVec.size()], device) ? 0 : 1;
+            }
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    isStopped = true;
+    writer.join();
+    return missNum.load();
+}
+}  // namespace
+
+class PartnerDeviceRegistryTest : public testing::Test {
+public:
+    PartnerDeviceRegistryTest() = default;
+    ~PartnerDeviceRegistryTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    PartnerDeviceRegistry registry_;
+};
+
+void PartnerDeviceRegistryTest::SetUpTestCase(void)
+{}
+void PartnerDeviceRegistryTest::TearDownTestCase(void)
+{}
+void PartnerDeviceRegistryTest::SetUp()
+{}
+void PartnerDeviceRegistryTest::TearDown()
+{
+    registry_.Clear();
+}
+
+/**
+ * @tc.name: InsertShouldUpdateIndex
+ * @tc.desc: 测试用例1：插入设备后，地址索引和应用索引同步更新
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, InsertShouldUpdateIndex, TestSize.Level0)
+{
+    registry_.EnsureInsert(std::make_pair(1, ADDRESS_1), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(2, ADDRESS_1), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(2, ADDRESS_2), USER_ID_1, nullptr);
+    // 重复插入不增加数量
+    registry_.EnsureInsert(std::make_pair(2, ADDRESS_2), USER_ID_1, nullptr);
+
+    EXPECT_EQ(registry_.Size(), 3);
+    EXPECT_TRUE(registry_.IsAddressBound(ADDRESS_1));
+    EXPECT_TRUE(registry_.IsAddressBound(ADDRESS_2));
+    EXPECT_FALSE(registry_.IsAddressBound(ADDRESS_3));
+
+    int count = 0;
+    registry_.IterateByAddress(ADDRESS_1,
+        [&count](uint32_t, const PartnerDeviceRegistry::DeviceSptr &) { count++; });
+    EXPECT_EQ(count, 2);
+
+    std::vector<FcmMacAddress> addrVec;
+    registry_.IterateByTokenId(2,
+        [&addrVec](const FcmMacAddress &address, const PartnerDeviceRegistry::DeviceSptr &) {
+        addrVec.push_back(address);
+    });
+    EXPECT_THAT(addrVec, ElementsAre(ADDRESS_1, ADDRESS_2));
+}
+
+/**
+ * @tc.name: EraseShouldUpdateIndex
+ * @tc.desc: 测试用例2：删除设备后，地址索引和应用索引同步更新
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, EraseShouldUpdateIndex, TestSize.Level0)
+{
+    registry_.EnsureInsert(std::make_pair(1, ADDRESS_1), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(2, ADDRESS_1), USER_ID_1, nullptr);
+
+    registry_.Erase(std::make_pair(1, ADDRESS_1));
+    EXPECT_TRUE(registry_.IsAddressBound(ADDRESS_1));
+    registry_.Erase(std::make_pair(2, ADDRESS_1));
+    EXPECT_FALSE(registry_.IsAddressBound(ADDRESS_1));
+    // 删除不存在的设备
+    registry_.Erase(std::make_pair(3, ADDRESS_1));
+
+    int count = 0;
+    registry_.IterateByTokenId(1, [&count](const FcmMacAddress &, const PartnerDeviceRegistry::DeviceSptr &) {
+        count++;
+    });
+    EXPECT_EQ(count, 0);
+    EXPECT_TRUE(registry_.IsEmpty());
+}
+
+/**
+ * @tc.name: CountShouldFollowInsertAndErase
+ * @tc.desc: 测试用例3：按应用和按用户统计的设备数量随绑定、解绑同步更新
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, CountShouldFollowInsertAndErase, TestSize.Level0)
+{
+    registry_.EnsureInsert(std::make_pair(1, ADDRESS_1), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(1, ADDRESS_2), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(2, ADDRESS_1), USER_ID_1, nullptr);
+    registry_.EnsureInsert(std::make_pair(3, ADDRESS_3), USER_ID_2, nullptr);
+    // 替换已有设备不重复计数
+    registry_.EnsureInsert(std::make_pair(1, ADDRESS_1), USER_ID_1, nullptr);
+
+    EXPECT_EQ(registry_.CountByTokenId(1), 2u);
+    EXPECT_EQ(registry_.CountByTokenId(2), 1u);
+    EXPECT_EQ(registry_.CountByTokenId(4), 0u);
+    EXPECT_EQ(registry_.CountByUserId(USER_ID_1), 3u);
+    EXPECT_EQ(registry_.CountByUserId(USER_ID_2), 1u);
+
+    registry_.Erase(std::make_pair(1, ADDRESS_1));
+    registry_.Erase(std::make_pair(3, ADDRESS_3));
+    EXPECT_EQ(registry_.CountByTokenId(1), 1u);
+    EXPECT_EQ(registry_.CountByUserId(USER_ID_1), 2u);
+    EXPECT_EQ(registry_.CountByUserId(USER_ID_2), 0u);
+    EXPECT_EQ(registry_.Size(), 2);
+}
+
+/**
+ * @tc.name: SnapshotShouldNotSeeLaterWrites
+ * @tc.desc: 测试用例4：写入只拷贝被修改的分片，已获取的旧快照内容保持不变
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, SnapshotShouldNotSeeLaterWrites, TestSize.Level0)
+{
+    const uint32_t deviceNum = 1000;
+    FillRegistry(registry_, deviceNum);
+    auto oldSnapshot = registry_.GetSnapshot();
+    registry_.Erase(MakeKey(0));
+    registry_.EnsureInsert(MakeKey(deviceNum), USER_ID_1, nullptr);
+    auto newSnapshot = registry_.GetSnapshot();
+
+    EXPECT_EQ(oldSnapshot->size, deviceNum);
+    EXPECT_EQ(oldSnapshot->tokenIndex.at(MakeKey(0).first)->count(MakeKey(0).second), 1u);
+    EXPECT_EQ(newSnapshot->tokenIndex.at(MakeKey(0).first)->count(MakeKey(0).second), 0u);
+    // 未修改的分片在新旧快照间共享
+    size_t sharedNum = 0;
+    for (size_t i = 0; i < PartnerDeviceRegistry::SHARD_NUM; i++) {
+        sharedNum += oldSnapshot->addressShards[i] == newSnapshot->addressShards[i] ? 1 : 0;
+    }
+    EXPECT_GE(sharedNum, PartnerDeviceRegistry::SHARD_NUM - 2);
+}
+
+/**
+ * @tc.name: AddressLookupShouldStayBalanced
+ * @tc.desc: 测试用例5：设备数量从10增长到10k，地址均匀分布到各分片，按地址查询只访问该地址绑定的设备
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, AddressLookupShouldStayBalanced, TestSize.Level1)
+{
+    const std::vector<uint32_t> deviceNumVec = { 10, 100, 1000, 10000 };
+    for (uint32_t deviceNum : deviceNumVec) {
+        PartnerDeviceRegistry registry;
+        FillRegistry(registry, deviceNum);
+        FcmMacAddress lastAddress = MakeAddress(deviceNum - 1);
+        EXPECT_TRUE(registry.IsAddressBound(lastAddress));
+        int visitNum = 0;
+        registry.IterateByAddress(lastAddress,
+            [&visitNum](uint32_t, const PartnerDeviceRegistry::DeviceSptr &) { visitNum++; });
+        EXPECT_EQ(visitNum, 1);
+
+        // 连续的地址均匀分布，最大的分片不超过平均值的两倍，查询耗时不随设备数量增长
+        auto snapshot = registry.GetSnapshot();
+        size_t maxShardSize = 0;
+        for (const auto &shard : snapshot->addressShards) {
+            maxShardSize = std::max(maxShardSize, shard == nullptr ? 0 : shard->size());
+        }
+        EXPECT_LE(maxShardSize, deviceNum * 2 / PartnerDeviceRegistry::SHARD_NUM + 1) << deviceNum;
+    }
+}
+
+/**
+ * @tc.name: ReadsShouldNotMissUnderContention
+ * @tc.desc: 测试用例6：多线程读写竞争下，读线程始终能查到未被修改的设备
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceRegistryTest, ReadsShouldNotMissUnderContention, TestSize.Level1)
+{
+    const uint32_t deviceNum = 1000;
+    FillRegistry(registry_, deviceNum);
+    EXPECT_EQ(RunContention(registry_, deviceNum), 0);
+    PartnerDeviceRegistry::DeviceSptr device = nullptr;
+    EXPECT_TRUE(registry_.Find(MakeKey(0), device));
+    EXPECT_TRUE(registry_.Find(MakeKey(deviceNum - 1), device));
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScaleTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "fcm_mac_address.h"
+#include "file_ex.h"
+#include "partner_device_journal.h"
+#include "partner_device_quota.h"
+#include "partner_device_registry.h"
+#include "partner_device_snapshot.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+constexpr const char *TEST_SNAPSHOT_PATH = "/data/local/tmp/partner_device_scale_test.bin";
+const uint32_t DEVICE_NUM = 10000;
+const uint32_t APP_NUM = 20;
+const int32_t USER_ID = 100;
+const uint32_t USER_NUM = 2;
+
+uint32_t GetTokenId(uint32_t index)
+{
+    return TOKEN_ID + index % APP_NUM;
+}
+
+// 前一半应用属于第一个用户，后一半应用属于第二个用户
+int32_t GetUserId(uint32_t tokenId)
+{
+    return USER_ID + static_cast<int32_t>((tokenId - TOKEN_ID) / (APP_NUM / USER_NUM));
+}
+
+PartnerDeviceMapKey MakeKey(uint32_t index)
+{
+    return std::make_pair(GetTokenId(index), MakeAddress(index));
+}
+
+PartnerDeviceRegistry::Entry MakeEntry(uint32_t tokenId, int32_t userId, uint32_t index)
+{
+    return PartnerDeviceRegistry::Entry { std::make_pair(tokenId, MakeAddress(index)), userId, nullptr };
+}
+}  // namespace
+
+class PartnerDeviceScaleTest : public testing::Test {
+public:
+    PartnerDeviceScaleTest() = default;
+    ~PartnerDeviceScaleTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDeviceScaleTest::SetUpTestCase(void)
+{}
+void PartnerDeviceScaleTest::TearDownTestCase(void)
+{}
+void PartnerDeviceScaleTest::SetUp()
+{}
+void PartnerDeviceScaleTest::TearDown()
+{
+    (void)unlink(TEST_SNAPSHOT_PATH);
+}
+
+/**
+ * @tc.name: QuotaShouldOnlyLimitTheOverQuotaApp
+ * @tc.desc: 测试用例1：应用达到配额后不能继续绑定，其他应用不受影响
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScaleTest, QuotaShouldOnlyLimitTheOverQuotaApp, TestSize.Level0)
+{
+    const size_t maxDevicesPerApp = 3;
+    const size_t maxDevicesPerUser = 5;
+    PartnerDeviceQuota quota(maxDevicesPerApp, maxDevicesPerUser);
+    PartnerDeviceRegistry registry;
+    for (uint32_t i = 0; i < maxDevicesPerApp; i++) {
+        ASSERT_TRUE(quota.TryBind(registry, MakeEntry(TOKEN_ID, USER_ID, i)));
+    }
+    EXPECT_FALSE(quota.TryBind(registry, MakeEntry(TOKEN_ID, USER_ID, maxDevicesPerApp)));
+    EXPECT_EQ(registry.CountByTokenId(TOKEN_ID), maxDevicesPerApp);
+    EXPECT_TRUE(quota.TryBind(registry, MakeEntry(TOKEN_ID + 1, USER_ID, 0)));
+    EXPECT_TRUE(quota.TryBind(registry, MakeEntry(TOKEN_ID + 1, USER_ID, 1)));
+    // 用户达到配额，该用户的其他应用也不能绑定，其他用户不受影响
+    EXPECT_FALSE(quota.TryBind(registry, MakeEntry(TOKEN_ID + 2, USER_ID, 0)));
+    EXPECT_TRUE(quota.TryBind(registry, MakeEntry(TOKEN_ID + 2, USER_ID + 1, 0)));
+    // 解绑后释放配额
+    registry.Erase(std::make_pair(TOKEN_ID, MakeAddress(0)));
+    EXPECT_TRUE(quota.TryBind(registry, MakeEntry(TOKEN_ID, USER_ID, 0)));
+}
+
+/**
+ * @tc.name: QuotaCounterShouldKeepEarliestDevices
+ * @tc.desc: 测试用例2：加载配置时按注册时间保留最早的设备，超出配额的设备被丢弃而不是清空整个配置
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScaleTest, QuotaCounterShouldKeepEarliestDevices, TestSize.Level0)
+{
+    const size_t maxDevicesPerApp = 100;
+    PartnerDeviceQuota quota(maxDevicesPerApp, PartnerDeviceQuota::DEFAULT_MAX_DEVICES_PER_USER);
+    PartnerDeviceQuota::Counter counter(quota);
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(DEVICE_NUM, APP_NUM);
+    std::stable_sort(devices.begin(), devices.end(),
+        [](const PartnerDeviceJsonItem &lhs, const PartnerDeviceJsonItem &rhs) {
+            return lhs.fields.registerTimestamp < rhs.fields.registerTimestamp;
+        });
+    std::vector<int64_t> acceptedTimestamps;
+    for (const auto &device : devices) {
+        if (counter.TryAccept(device.fields.tokenId, GetUserId(device.fields.tokenId))) {
+            acceptedTimestamps.push_back(device.fields.registerTimestamp);
+        }
+    }
+    ASSERT_EQ(acceptedTimestamps.size(), maxDevicesPerApp * APP_NUM);
+    EXPECT_EQ(acceptedTimestamps.back(), REGISTER_TIMESTAMP + static_cast<int64_t>(maxDevicesPerApp * APP_NUM) - 1);
+}
+
+/**
+ * @tc.name: BindTenThousandDevices
+ * @tc.desc: 测试用例3：20个应用、2个用户逐个绑定10k设备，按应用、用户和地址的索引与绑定结果一致
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScaleTest, BindTenThousandDevices, TestSize.Level1)
+{
+    PartnerDeviceQuota quota;
+    PartnerDeviceRegistry registry;
+    for (uint32_t i = 0; i < DEVICE_NUM; i++) {
+        PartnerDeviceMapKey key = MakeKey(i);
+        ASSERT_TRUE(quota.TryBind(registry, PartnerDeviceRegistry::Entry { key, GetUserId(key.first), nullptr }));
+    }
+    EXPECT_EQ(registry.Size(), static_cast<int>(DEVICE_NUM));
+    EXPECT_EQ(registry.CountByTokenId(TOKEN_ID), DEVICE_NUM / APP_NUM);
+    EXPECT_EQ(registry.CountByUserId(USER_ID), DEVICE_NUM / USER_NUM);
+    EXPECT_TRUE(registry.IsAddressBound(MakeKey(DEVICE_NUM - 1).second));
+}
+
+/**
+ * @tc.name: StartupWithTenThousandDevices
+ * @tc.desc: 测试用例4：10k设备的快照映射、日志回放、配额过滤后全部发布到注册表
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScaleTest, StartupWithTenThousandDevices, TestSize.Level1)
+{
+    const uint32_t journalRecordNum = 100;
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(DEVICE_NUM + journalRecordNum, APP_NUM);
+    std::vector<PartnerDeviceRecord> allRecords = MakeRecords(devices);
+    std::vector<PartnerDeviceRecord> snapshotRecords(allRecords.begin(), allRecords.begin() + DEVICE_NUM);
+    std::string snapshotContent = PartnerDeviceSnapshot::Encode(snapshotRecords);
+    ASSERT_TRUE(SaveStringToFile(TEST_SNAPSHOT_PATH, snapshotContent));
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendHeader(writer, snapshotContent);
+    for (uint32_t i = DEVICE_NUM; i < DEVICE_NUM + journalRecordNum; i++) {
+        PartnerDeviceJournal::AppendPutRecord(writer, allRecords[i]);
+    }
+    std::string journalContent = writer.GetBuffer();
+    snapshotRecords.clear();
+    snapshotRecords.shrink_to_fit();
+
+    PartnerDeviceRegistry registry;
+    {
+        // 与配置加载相同的步骤，设备对象的创建不计入
+        PartnerDeviceSnapshotFile snapshotFile(TEST_SNAPSHOT_PATH);
+        ASSERT_TRUE(snapshotFile.IsMapped());
+        std::vector<PartnerDeviceRecord> records;
+        ASSERT_TRUE(PartnerDeviceSnapshot::Decode(snapshotFile.GetContent(), records));
+        PartnerDeviceJournal::Overlay overlay;
+        EXPECT_EQ(PartnerDeviceJournal::Replay(snapshotFile.GetContent(), journalContent, overlay),
+            static_cast<int>(journalRecordNum));
+        for (const auto &[key, item] : overlay) {
+            records.push_back(item->GetRecord());
+        }
+        PartnerDeviceQuota::Counter counter((PartnerDeviceQuota()));
+        std::vector<PartnerDeviceRegistry::Entry> entries;
+        entries.reserve(records.size());
+        for (const auto &record : records) {
+            int32_t userId = GetUserId(record.tokenId);
+            if (counter.TryAccept(record.tokenId, userId)) {
+                entries.push_back({ std::make_pair(record.tokenId, ToMacAddress(record.address)), userId });
+            }
+        }
+        registry.EnsureInsertBatch(entries);
+    }
+    EXPECT_EQ(registry.Size(), static_cast<int>(DEVICE_NUM + journalRecordNum));
+    EXPECT_EQ(registry.CountByTokenId(TOKEN_ID), (DEVICE_NUM + journalRecordNum) / APP_NUM);
+    EXPECT_TRUE(registry.IsAddressBound(MakeAddress(DEVICE_NUM + journalRecordNum - 1)));
+}
+
+/**
+ * @tc.name: ConcurrentBindShouldNotExceedQuota
+ * @tc.desc: 测试用例5：多个线程并发绑定同一应用的设备，配额的检查与插入是原子的，绑定成功的设备数等于配额
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScaleTest, ConcurrentBindShouldNotExceedQuota, TestSize.Level1)
+{
+    const size_t maxDevicesPerApp = 100;
+    const uint32_t threadNum = 8;
+    const uint32_t bindNumPerThread = 50;
+    PartnerDeviceQuota quota(maxDevicesPerApp, PartnerDeviceQuota::DEFAULT_MAX_DEVICES_PER_USER);
+    PartnerDeviceRegistry registry;
+    std::atomic<size_t> boundNum { 0 };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadNum; t++) {
+        threads.emplace_back([&quota, &registry, &boundNum, t]() {
+            for (uint32_t i = 0; i < bindNumPerThread; i++) {
+                if (quota.TryBind(registry, MakeEntry(TOKEN_ID, USER_ID, t * bindNumPerThread + i))) {
+                    boundNum++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(boundNum.load(), maxDevicesPerApp);
+    EXPECT_EQ(registry.CountByTokenId(TOKEN_ID), maxDevicesPerApp);
+}
@@ -0,0 +1,570 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScanEngineTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace OHOS::Bluetooth;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const std::vector<uint32_t> DEVICE_NUMS = { 1, 10, 100 };
+const int SCAN_REJECTED_ERROR = -1;
+
+// 扫描器的操作记录，只在扫描引擎的队列中修改，Flush 之后读取
+struct FakeScannerStats {
+    int createNum = 0;
+    int startNum = 0;
+    int stopNum = 0;
+    bool isScanning = false;
+    size_t filterNum = 0;
+    int scanMode = 0;
+    uint8_t callbackType = 0;
+    long reportDelayMs = 0;
+    // 模拟控制器不支持found/lost上报
+    bool isFoundLostRejected = false;
+    std::shared_ptr<BleCentralManagerCallback> callback;
+};
+
+class FakeBleScanner : public IBleScanner {
+public:
+    explicit FakeBleScanner(FakeScannerStats &stats) : stats_(stats) {}
+    ~FakeBleScanner() override = default;
+
+    int StartScan(const BleScanSettings &settings, const std::vector<BleScanFilter> &filters) override
+    {
+        if (stats_.isFoundLostRejected && settings.GetCallbackType() != BLE_SCAN_CALLBACK_TYPE_ALL_MATCH) {
+            return SCAN_REJECTED_ERROR;
+        }
+        stats_.startNum++;
+        stats_.isScanning = true;
+        stats_.filterNum = filters.size();
+        stats_.scanMode = settings.GetScanMode();
+        stats_.callbackType = settings.GetCallbackType();
+        stats_.reportDelayMs = settings.GetReportDelayMillisValue();
+        return BT_NO_ERROR;
+    }
+
+    int StopScan() override
+    {
+        stats_.stopNum++;
+        stats_.isScanning = false;
+        return BT_NO_ERROR;
+    }
+
+private:
+    FakeScannerStats &stats_;
+};
+
+void IgnoreScanEvent(const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event)
+{}
+
+BleScanResult MakeScanResult(const FcmMacAddress &address, int rssi = 0)
+{
+    BleScanResult result;
+    result.SetPeripheralDevice(BluetoothRemoteDevice(address.ToString(), BT_TRANSPORT_BLE));
+    result.SetRssi(rssi);
+    return result;
+}
+
+struct SimulationResult {
+    // 蓝牙框架回调的次数，即应用处理器被唤醒的次数
+    int64_t wakeupNum = 0;
+    // 分发给设备的扫描结果数量
+    int64_t dispatchNum = 0;
+};
+
+// 模拟一小时内每个设备每秒广播一次，控制器按扫描参数逐条或批量上报
+SimulationResult SimulateOneHour(PartnerDeviceScanEngine &engine, FakeScannerStats &stats, uint32_t deviceNum)
+{
+    const int64_t simulationSec = 3600;
+    const int64_t msPerSec = 1000;
+    SimulationResult result;
+    std::vector<BleScanResult> batch;
+    int64_t lastReportMs = 0;
+    for (int64_t sec = 1; sec <= simulationSec; sec++) {
+        for (uint32_t i = 0; i < deviceNum; i++) {
+            if (stats.reportDelayMs == 0) {
+                stats.callback->OnScanCallback(MakeScanResult(MakeAddress(i)));
+                result.wakeupNum++;
+            } else {
+                batch.push_back(MakeScanResult(MakeAddress(i)));
+            }
+        }
+        int64_t nowMs = sec * msPerSec;
+        if (!batch.empty() && nowMs - lastReportMs >= stats.reportDelayMs) {
+            stats.callback->OnBleBatchScanResultsEvent(batch);
+            result.wakeupNum++;
+            batch.clear();
+            lastReportMs = nowMs;
+        }
+        engine.Flush();
+    }
+    return result;
+}
+}  // namespace
+
+class PartnerDeviceScanEngineTest : public testing::Test {
+public:
+    PartnerDeviceScanEngineTest() = default;
+    ~PartnerDeviceScanEngineTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    std::unique_ptr<PartnerDeviceScanEngine> CreateEngine(uint32_t minRestartIntervalMs = 0);
+    std::vector<uint64_t> AddFilters(PartnerDeviceScanEngine &engine, uint32_t deviceNum);
+
+    FakeScannerStats stats_;
+};
+
+void PartnerDeviceScanEngineTest::SetUpTestCase(void)
+{}
+void PartnerDeviceScanEngineTest::TearDownTestCase(void)
+{}
+void PartnerDeviceScanEngineTest::SetUp()
+{
+    stats_ = FakeScannerStats();
+}
+void PartnerDeviceScanEngineTest::TearDown()
+{}
+
+std::unique_ptr<PartnerDeviceScanEngine> PartnerDeviceScanEngineTest::CreateEngine(uint32_t minRestartIntervalMs)
+{
+    stats_ = FakeScannerStats();
+    auto factory = [this](std::shared_ptr<BleCentralManagerCallback> callback) {
+        stats_.createNum++;
+        stats_.callback = callback;
+        return std::make_unique<FakeBleScanner>(stats_);
+    };
+    return std::make_unique<PartnerDeviceScanEngine>(
+        factory, PartnerDeviceScanEngine::DEFAULT_APPLY_DELAY_MS, minRestartIntervalMs);
+}
+
+std::vector<uint64_t> PartnerDeviceScanEngineTest::AddFilters(PartnerDeviceScanEngine &engine, uint32_t deviceNum)
+{
+    std::vector<uint64_t> filterIds;
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        filterIds.push_back(engine.AddFilter(MakeAddress(i), IgnoreScanEvent));
+    }
+    return filterIds;
+}
+
+// 测试用例1：合并扫描测试
+/**
+ * @tc.name: AddFiltersShouldStartOneScanSession
+ * @tc.desc: 验证多个设备的过滤条件合并到一个扫描会话中，只启动一次扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, AddFiltersShouldStartOneScanSession, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        AddFilters(*engine, deviceNum);
+        engine->Flush();
+
+        EXPECT_EQ(engine->GetFilterCount(), deviceNum);
+        EXPECT_EQ(stats_.createNum, 1);
+        EXPECT_EQ(stats_.startNum, 1);
+        EXPECT_EQ(stats_.stopNum, 0);
+        EXPECT_TRUE(stats_.isScanning);
+        EXPECT_EQ(stats_.filterNum, deviceNum);
+    }
+}
+
+// 测试用例2：停止扫描测试
+/**
+ * @tc.name: RemoveFiltersShouldStopScanSession
+ * @tc.desc: 验证移除全部过滤条件后停止扫描并释放扫描器
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, RemoveFiltersShouldStopScanSession, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        auto filterIds = AddFilters(*engine, deviceNum);
+        engine->Flush();
+        for (uint64_t filterId : filterIds) {
+            engine->RemoveFilter(filterId);
+        }
+        engine->Flush();
+
+        EXPECT_EQ(engine->GetFilterCount(), 0);
+        EXPECT_EQ(stats_.startNum, 1);
+        EXPECT_EQ(stats_.stopNum, 1);
+        EXPECT_FALSE(stats_.isScanning);
+        EXPECT_EQ(engine->scanner_, nullptr);
+    }
+}
+
+// 测试用例3：增量更新测试
+/**
+ * @tc.name: DeviceFoundShouldRestartScanOnce
+ * @tc.desc: 验证一个设备被发现后移除其过滤条件，只重启一次扫描，其余设备继续扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, DeviceFoundShouldRestartScanOnce, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        auto filterIds = AddFilters(*engine, deviceNum);
+        engine->Flush();
+        engine->RemoveFilter(filterIds.front());
+        engine->RemoveFilter(filterIds.front());
+        engine->Flush();
+
+        EXPECT_EQ(stats_.createNum, 1);
+        EXPECT_EQ(stats_.stopNum, 1);
+        EXPECT_EQ(stats_.isScanning, deviceNum > 1);
+        EXPECT_EQ(stats_.startNum, deviceNum > 1 ? 2 : 1);
+        EXPECT_EQ(stats_.filterNum, deviceNum > 1 ? deviceNum - 1 : deviceNum);
+    }
+}
+
+// 测试用例4：过滤条件不变测试
+/**
+ * @tc.name: UnchangedFiltersShouldNotRestartScan
+ * @tc.desc: 验证过滤条件和扫描参数不变时不重启扫描，同一地址的多个过滤条件共用一个扫描过滤器
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, UnchangedFiltersShouldNotRestartScan, TestSize.Level0)
+{
+    auto engine = CreateEngine();
+    AddFilters(*engine, DEVICE_NUMS.back());
+    engine->Flush();
+    uint64_t filterId = engine->AddFilter(MakeAddress(0), IgnoreScanEvent);
+    engine->SetScanParams({ SCAN_MODE_OP_P10_60_600, 0 });
+    engine->Flush();
+    engine->RemoveFilter(filterId);
+    engine->Flush();
+
+    EXPECT_EQ(stats_.startNum, 1);
+    EXPECT_EQ(stats_.stopNum, 0);
+    EXPECT_EQ(stats_.filterNum, DEVICE_NUMS.back());
+}
+
+// 测试用例5：扫描参数测试
+/**
+ * @tc.name: SetScanParamsShouldRestartScan
+ * @tc.desc: 验证扫描参数变化时以新参数重启一次扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, SetScanParamsShouldRestartScan, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        AddFilters(*engine, deviceNum);
+        engine->Flush();
+        EXPECT_EQ(stats_.scanMode, SCAN_MODE_OP_P10_60_600);
+
+        engine->SetScanParams({ SCAN_MODE_OP_P2_60_3000, 0 });
+        engine->Flush();
+        EXPECT_EQ(stats_.startNum, 2);
+        EXPECT_EQ(stats_.stopNum, 1);
+        EXPECT_EQ(stats_.scanMode, SCAN_MODE_OP_P2_60_3000);
+    }
+}
+
+// 测试用例6：扫描结果分发测试
+/**
+ * @tc.name: ScanResultShouldBeRoutedByAddress
+ * @tc.desc: 验证扫描结果只分发给地址匹配的过滤条件
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, ScanResultShouldBeRoutedByAddress, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        std::vector<int> resultNums(deviceNum, 0);
+        for (uint32_t i = 0; i < deviceNum; i++) {
+            engine->AddFilter(MakeAddress(i),
+                [&resultNums, i](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+                EXPECT_EQ(event, PartnerDeviceScanEngine::SCAN_EVENT_RESULT);
+                resultNums[i]++;
+            });
+        }
+        engine->Flush();
+        ASSERT_NE(stats_.callback, nullptr);
+
+        for (uint32_t i = 0; i < deviceNum; i++) {
+            stats_.callback->OnScanCallback(MakeScanResult(MakeAddress(i)));
+        }
+        stats_.callback->OnScanCallback(MakeScanResult(MakeAddress(deviceNum)));
+        engine->Flush();
+
+        for (uint32_t i = 0; i < deviceNum; i++) {
+            EXPECT_EQ(resultNums[i], 1);
+        }
+    }
+}
+
+// 测试用例7：回调中移除过滤条件测试
+/**
+ * @tc.name: RemoveFilterInCallbackShouldStopScan
+ * @tc.desc: 验证在扫描结果回调中移除过滤条件，扫描随之停止
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, RemoveFilterInCallbackShouldStopScan, TestSize.Level0)
+{
+    auto engine = CreateEngine();
+    uint64_t filterId = PartnerDeviceScanEngine::INVALID_FILTER_ID;
+    filterId = engine->AddFilter(MakeAddress(0),
+        [&engine, &filterId](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+        engine->RemoveFilter(filterId);
+    });
+    engine->Flush();
+    stats_.callback->OnScanCallback(MakeScanResult(MakeAddress(0)));
+    engine->Flush();
+
+    EXPECT_EQ(engine->GetFilterCount(), 0);
+    EXPECT_EQ(stats_.stopNum, 1);
+    EXPECT_FALSE(stats_.isScanning);
+}
+
+// 测试用例8：上报模式选择测试
+/**
+ * @tc.name: ReportModeShouldFollowFilterNum
+ * @tc.desc: 验证设备数量在控制器跟踪上限内时使用found/lost上报，超出上限或关闭时使用持续上报
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, ReportModeShouldFollowFilterNum, TestSize.Level0)
+{
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        auto engine = CreateEngine();
+        AddFilters(*engine, deviceNum);
+        engine->Flush();
+        bool isFoundLost = deviceNum <= PartnerDeviceScanEngine::DEFAULT_MAX_FOUND_LOST_FILTER_NUM;
+        EXPECT_EQ(stats_.callbackType,
+            isFoundLost ? BLE_SCAN_CALLBACK_TYPE_FIRST_AND_LOST_MATCH : BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+
+        engine->SetMaxFoundLostFilterNum(0);
+        engine->Flush();
+        EXPECT_EQ(stats_.callbackType, BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+        EXPECT_EQ(stats_.startNum, isFoundLost ? 2 : 1);
+    }
+}
+
+// 测试用例9：控制器不支持found/lost上报测试
+/**
+ * @tc.name: RejectedFoundLostShouldFallBackToContinuous
+ * @tc.desc: 验证控制器拒绝found/lost上报时改用持续上报，之后不再尝试found/lost上报
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, RejectedFoundLostShouldFallBackToContinuous, TestSize.Level0)
+{
+    auto engine = CreateEngine();
+    stats_.isFoundLostRejected = true;
+    auto filterIds = AddFilters(*engine, 1);
+    engine->Flush();
+    EXPECT_TRUE(stats_.isScanning);
+    EXPECT_EQ(stats_.startNum, 1);
+    EXPECT_EQ(stats_.callbackType, BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+
+    stats_.isFoundLostRejected = false;
+    engine->AddFilter(MakeAddress(1), IgnoreScanEvent);
+    engine->Flush();
+    EXPECT_EQ(stats_.startNum, 2);
+    EXPECT_EQ(stats_.callbackType, BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+}
+
+// 测试用例10：found/lost事件分发测试
+/**
+ * @tc.name: FoundLostShouldBeRoutedByAddress
+ * @tc.desc: 验证控制器上报的设备出现和丢失事件只分发给地址匹配的过滤条件
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, FoundLostShouldBeRoutedByAddress, TestSize.Level0)
+{
+    auto engine = CreateEngine();
+    const uint32_t deviceNum = 10;
+    std::vector<std::vector<PartnerDeviceScanEngine::ScanEvent>> events(deviceNum);
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        engine->AddFilter(MakeAddress(i),
+            [&events, i](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+            events[i].push_back(event);
+        });
+    }
+    engine->Flush();
+    ASSERT_NE(stats_.callback, nullptr);
+    EXPECT_EQ(stats_.callbackType, BLE_SCAN_CALLBACK_TYPE_FIRST_AND_LOST_MATCH);
+
+    stats_.callback->OnFoundOrLostCallback(MakeScanResult(MakeAddress(1)), BLE_SCAN_CALLBACK_TYPE_FIRST_MATCH);
+    stats_.callback->OnFoundOrLostCallback(MakeScanResult(MakeAddress(1)), BLE_SCAN_CALLBACK_TYPE_LOST_MATCH);
+    stats_.callback->OnFoundOrLostCallback(MakeScanResult(MakeAddress(2)), BLE_SCAN_CALLBACK_TYPE_ALL_MATCH);
+    engine->Flush();
+
+    std::vector<PartnerDeviceScanEngine::ScanEvent> expectEvents = {
+        PartnerDeviceScanEngine::SCAN_EVENT_FOUND, PartnerDeviceScanEngine::SCAN_EVENT_LOST };
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        EXPECT_EQ(events[i], i == 1 ? expectEvents : std::vector<PartnerDeviceScanEngine::ScanEvent>());
+    }
+    // found/lost上报时设备出现后不移除过滤条件，扫描不重启
+    EXPECT_EQ(stats_.startNum, 1);
+}
+
+// 测试用例11：批量上报去重测试
+/**
+ * @tc.name: BatchResultsShouldBeDeduplicated
+ * @tc.desc: 验证批量上报的结果按地址去重，每个设备每批最多分发一次最近的结果
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, BatchResultsShouldBeDeduplicated, TestSize.Level0)
+{
+    const uint32_t reportDelayMs = 5000;
+    auto engine = CreateEngine();
+    engine->SetMaxFoundLostFilterNum(0);
+    engine->SetScanParams({ SCAN_MODE_OP_P2_60_3000, reportDelayMs });
+    const uint32_t deviceNum = 10;
+    std::vector<std::vector<int>> rssis(deviceNum);
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        engine->AddFilter(MakeAddress(i),
+            [&rssis, i](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+            EXPECT_EQ(event, PartnerDeviceScanEngine::SCAN_EVENT_RESULT);
+            rssis[i].push_back(result.GetRssi());
+        });
+    }
+    engine->Flush();
+    ASSERT_NE(stats_.callback, nullptr);
+    EXPECT_EQ(stats_.reportDelayMs, reportDelayMs);
+
+    std::vector<BleScanResult> batch = {
+        MakeScanResult(MakeAddress(0), -70), MakeScanResult(MakeAddress(1), -60),
+        MakeScanResult(MakeAddress(0), -65), MakeScanResult(MakeAddress(deviceNum), -50),
+        MakeScanResult(MakeAddress(1), -55), MakeScanResult(MakeAddress(0), -80),
+    };
+    stats_.callback->OnBleBatchScanResultsEvent(batch);
+    engine->Flush();
+
+    EXPECT_EQ(rssis[0], std::vector<int>({ -80 }));
+    EXPECT_EQ(rssis[1], std::vector<int>({ -55 }));
+    for (uint32_t i = 2; i < deviceNum; i++) {
+        EXPECT_TRUE(rssis[i].empty());
+    }
+}
+
+// 测试用例12：found/lost上报不批量测试
+/**
+ * @tc.name: FoundLostShouldIgnoreReportDelay
+ * @tc.desc: 验证found/lost上报时不使用批量上报，设置上报延迟不重启扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, FoundLostShouldIgnoreReportDelay, TestSize.Level0)
+{
+    auto engine = CreateEngine();
+    AddFilters(*engine, 1);
+    engine->Flush();
+    engine->SetScanParams({ SCAN_MODE_OP_P10_60_600, 5000 });
+    engine->Flush();
+
+    EXPECT_EQ(stats_.startNum, 1);
+    EXPECT_EQ(stats_.callbackType, BLE_SCAN_CALLBACK_TYPE_FIRST_AND_LOST_MATCH);
+    EXPECT_EQ(stats_.reportDelayMs, 0);
+}
+
+// 测试用例13：灭屏批量上报唤醒次数测试
+/**
+ * @tc.name: ScreenOffBatchShouldReduceWakeupsPerHour
+ * @tc.desc: 模拟一小时内设备持续广播，对比逐条上报和批量上报的回调次数
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, ScreenOffBatchShouldReduceWakeupsPerHour, TestSize.Level1)
+{
+    const uint32_t reportDelayMs = 5000;
+    const int64_t batchNumPerHour = 3600 * 1000 / reportDelayMs;
+    for (uint32_t deviceNum : DEVICE_NUMS) {
+        SimulationResult results[2];
+        for (int isBatch = 0; isBatch < 2; isBatch++) {
+            auto engine = CreateEngine();
+            engine->SetMaxFoundLostFilterNum(0);
+            engine->SetScanParams({ SCAN_MODE_OP_P2_60_3000, isBatch ? reportDelayMs : 0 });
+            int64_t dispatchNum = 0;
+            for (uint32_t i = 0; i < deviceNum; i++) {
+                engine->AddFilter(MakeAddress(i),
+                    [&dispatchNum](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {
+                    dispatchNum++;
+                });
+            }
+            engine->Flush();
+            ASSERT_NE(stats_.callback, nullptr);
+            results[isBatch] = SimulateOneHour(*engine, stats_, deviceNum);
+            results[isBatch].dispatchNum = dispatchNum;
+        }
+        EXPECT_EQ(results[0].wakeupNum, static_cast<int64_t>(deviceNum) * 3600);
+        EXPECT_EQ(results[0].dispatchNum, static_cast<int64_t>(deviceNum) * 3600);
+        EXPECT_EQ(results[1].wakeupNum, batchNumPerHour);
+        EXPECT_EQ(results[1].dispatchNum, static_cast<int64_t>(deviceNum) * batchNumPerHour);
+    }
+}
+
+// 测试用例14：重启频率限制测试
+/**
+ * @tc.name: RestartShouldBeRateLimited
+ * @tc.desc: 验证最小重启间隔内的多次变化在间隔结束时合并为一次重启，并记录重启次数
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanEngineTest, RestartShouldBeRateLimited, TestSize.Level1)
+{
+    const uint32_t minRestartIntervalMs = 100;
+    auto engine = CreateEngine(minRestartIntervalMs);
+    auto filterIds = AddFilters(*engine, DEVICE_NUMS.back());
+    engine->Flush();
+    EXPECT_EQ(stats_.startNum, 1);
+
+    engine->RemoveFilter(filterIds[0]);
+    engine->Flush();
+    engine->SetScanParams({ SCAN_MODE_OP_P2_60_3000, 0 });
+    engine->Flush();
+    engine->RemoveFilter(filterIds[1]);
+    engine->Flush();
+    EXPECT_EQ(stats_.startNum, 1);
+    PartnerDeviceScanEngine::Metrics metrics = engine->GetMetrics();
+    EXPECT_EQ(metrics.restartNum, 0);
+    EXPECT_GT(metrics.rateLimitedNum, 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(minRestartIntervalMs * 2));
+    engine->Flush();
+    EXPECT_EQ(stats_.startNum, 2);
+    EXPECT_EQ(stats_.scanMode, SCAN_MODE_OP_P2_60_3000);
+    EXPECT_EQ(stats_.filterNum, DEVICE_NUMS.back() - 2);
+    metrics = engine->GetMetrics();
+    EXPECT_EQ(metrics.startNum, 1);
+    EXPECT_EQ(metrics.restartNum, 1);
+    EXPECT_EQ(metrics.restartNumInLastHour, 1);
+
+    for (uint64_t filterId : filterIds) {
+        engine->RemoveFilter(filterId);
+    }
+    engine->Flush();
+    EXPECT_FALSE(stats_.isScanning);
+    EXPECT_EQ(engine->GetMetrics().stopNum, 1);
+}
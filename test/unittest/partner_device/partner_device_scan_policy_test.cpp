@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScanPolicyTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "partner_device_scan_engine.h"
+#include "partner_device_scan_policy.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::Bluetooth;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+const uint32_t DEVICE_NUM = 100;
+// 足够长的防抖窗口，由 Flush 模拟窗口结束
+const uint32_t DEBOUNCE_WINDOW_MS = 60 * 1000;
+
+class CountingBleScanner : public IBleScanner {
+public:
+    CountingBleScanner(int &startNum, int &stopNum) : startNum_(startNum), stopNum_(stopNum) {}
+    ~CountingBleScanner() override = default;
+
+    int StartScan(const BleScanSettings &settings, const std::vector<BleScanFilter> &filters) override
+    {
+        startNum_++;
+        return BT_NO_ERROR;
+    }
+
+    int StopScan() override
+    {
+        stopNum_++;
+        return BT_NO_ERROR;
+    }
+
+private:
+    int &startNum_;
+    int &stopNum_;
+};
+
+PartnerDeviceScanPolicy::State MakeState(bool isScreenOn, int thermalLevel, bool isBatteryLow)
+{
+    PartnerDeviceScanPolicy::State state;
+    state.isScreenOn = isScreenOn;
+    state.thermalLevel = thermalLevel;
+    state.isBatteryLow = isBatteryLow;
+    return state;
+}
+}  // namespace
+
+class PartnerDeviceScanPolicyTest : public testing::Test {
+public:
+    PartnerDeviceScanPolicyTest() = default;
+    ~PartnerDeviceScanPolicyTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    void FlushAll();
+
+    int startNum_ = 0;
+    int stopNum_ = 0;
+    std::unique_ptr<PartnerDeviceScanEngine> engine_;
+    std::unique_ptr<PartnerDeviceScanPolicy> policy_;
+};
+
+void PartnerDeviceScanPolicyTest::SetUpTestCase(void)
+{}
+void PartnerDeviceScanPolicyTest::TearDownTestCase(void)
+{}
+void PartnerDeviceScanPolicyTest::SetUp()
+{
+    startNum_ = 0;
+    stopNum_ = 0;
+    auto factory = [this](std::shared_ptr<BleCentralManagerCallback> callback) {
+        return std::make_unique<CountingBleScanner>(startNum_, stopNum_);
+    };
+    engine_ = std::make_unique<PartnerDeviceScanEngine>(factory, PartnerDeviceScanEngine::DEFAULT_APPLY_DELAY_MS, 0);
+    policy_ = std::make_unique<PartnerDeviceScanPolicy>(*engine_, DEBOUNCE_WINDOW_MS);
+    for (uint32_t i = 0; i < DEVICE_NUM; i++) {
+        engine_->AddFilter(FcmMacAddress(i + 1),
+            [](const BleScanResult &result, PartnerDeviceScanEngine::ScanEvent event) {});
+    }
+    engine_->Flush();
+}
+void PartnerDeviceScanPolicyTest::TearDown()
+{
+    policy_ = nullptr;
+    engine_ = nullptr;
+}
+
+void PartnerDeviceScanPolicyTest::FlushAll()
+{
+    policy_->Flush();
+    engine_->Flush();
+}
+
+// 测试用例1：扫描参数选择测试
+/**
+ * @tc.name: SelectScanParamsTest
+ * @tc.desc: 验证亮灭屏、温度和电量状态对应的扫描参数
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanPolicyTest, SelectScanParamsTest, TestSize.Level0)
+{
+    const int normal = 1;
+    const int hot = PartnerDeviceScanPolicy::THERMAL_LEVEL_HOT;
+    const uint32_t screenOffDelay = PartnerDeviceScanPolicy::SCREEN_OFF_REPORT_DELAY_MS;
+    const uint32_t throttledDelay = PartnerDeviceScanPolicy::THROTTLED_REPORT_DELAY_MS;
+    struct TestCase {
+        PartnerDeviceScanPolicy::State state;
+        PartnerDeviceScanEngine::ScanParams params;
+    };
+    std::vector<TestCase> testCases = {
+        { MakeState(true, normal, false), { SCAN_MODE_OP_P10_60_600, 0 } },
+        { MakeState(false, normal, false), { SCAN_MODE_OP_P2_60_3000, screenOffDelay } },
+        { MakeState(true, hot, false), { SCAN_MODE_OP_P2_60_3000, 0 } },
+        { MakeState(true, normal, true), { SCAN_MODE_OP_P2_60_3000, 0 } },
+        { MakeState(false, hot, false), { SCAN_MODE_OP_P2_60_3000, throttledDelay } },
+        { MakeState(false, normal, true), { SCAN_MODE_OP_P2_60_3000, throttledDelay } },
+    };
+    for (const auto &testCase : testCases) {
+        EXPECT_EQ(PartnerDeviceScanPolicy::SelectScanParams(testCase.state), testCase.params);
+    }
+}
+
+// 测试用例2：状态变化合并测试
+/**
+ * @tc.name: TransitionsShouldRestartScanOnce
+ * @tc.desc: 验证防抖窗口内的灭屏、高温和低电量变化只重启一次扫描，与设备数量无关
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanPolicyTest, TransitionsShouldRestartScanOnce, TestSize.Level0)
+{
+    EXPECT_EQ(startNum_, 1);
+    policy_->SetScreenOn(false);
+    policy_->SetThermalLevel(PartnerDeviceScanPolicy::THERMAL_LEVEL_HOT);
+    policy_->SetBatteryLow(true);
+    FlushAll();
+
+    EXPECT_EQ(startNum_, 2);
+    EXPECT_EQ(stopNum_, 1);
+    PartnerDeviceScanEngine::ScanParams expectParams = {
+        SCAN_MODE_OP_P2_60_3000, PartnerDeviceScanPolicy::THROTTLED_REPORT_DELAY_MS };
+    EXPECT_EQ(engine_->scanningParams_, expectParams);
+    EXPECT_EQ(engine_->GetMetrics().restartNum, 1);
+}
+
+// 测试用例3：屏幕闪烁测试
+/**
+ * @tc.name: ScreenFlickerShouldBeDebounced
+ * @tc.desc: 验证防抖窗口内亮灭屏来回切换不重启扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanPolicyTest, ScreenFlickerShouldBeDebounced, TestSize.Level0)
+{
+    const int flickerNum = 10;
+    for (int i = 0; i < flickerNum; i++) {
+        policy_->SetScreenOn(false);
+        policy_->SetScreenOn(true);
+    }
+    FlushAll();
+    EXPECT_EQ(startNum_, 1);
+    EXPECT_EQ(stopNum_, 0);
+
+    policy_->SetScreenOn(false);
+    FlushAll();
+    EXPECT_EQ(startNum_, 2);
+    EXPECT_EQ(engine_->scanningParams_.reportDelayMs, PartnerDeviceScanPolicy::SCREEN_OFF_REPORT_DELAY_MS);
+}
+
+// 测试用例4：状态不变测试
+/**
+ * @tc.name: UnchangedParamsShouldNotRestartScan
+ * @tc.desc: 验证状态变化但扫描参数不变时不重启扫描
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanPolicyTest, UnchangedParamsShouldNotRestartScan, TestSize.Level0)
+{
+    policy_->SetBatteryLow(true);
+    FlushAll();
+    EXPECT_EQ(startNum_, 2);
+
+    // 低电量时已降低扫描频率，高温不改变亮屏时的扫描参数
+    policy_->SetThermalLevel(PartnerDeviceScanPolicy::THERMAL_LEVEL_HOT);
+    FlushAll();
+    EXPECT_EQ(startNum_, 2);
+    EXPECT_EQ(engine_->GetMetrics().restartNum, 1);
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceScanSchedulerTest"
+#endif
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "partner_device_scan_scheduler.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+constexpr int64_t MIN_MS = 60 * 1000;
+constexpr int64_t HOUR_MIN = 60;
+constexpr int64_t DAY_MIN = 24 * HOUR_MIN;
+constexpr int64_t SIMULATION_DAYS = 14;
+constexpr uint32_t MAX_JITTER_MIN = 20;
+constexpr int64_t IRREGULAR_VISIT_PERIOD_DAYS = 5;
+
+int64_t At(int64_t day, int64_t hour, int64_t minute)
+{
+    return ((day * DAY_MIN) + (hour * HOUR_MIN) + minute) * MIN_MS;
+}
+
+// 设备在位的时间段，单位为分钟
+struct Visit {
+    int64_t beginMin = 0;
+    int64_t endMin = 0;
+};
+
+// 每天早晚两次规律出现，出现时间有随机抖动，另有不规律的午间出现，线性同余生成器保证结果可复现
+std::vector<Visit> MakeVisits()
+{
+    uint32_t seed = 12345;
+    auto jitter = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int64_t>((seed >> 16) % MAX_JITTER_MIN);
+    };
+    std::vector<Visit> visits;
+    for (int64_t day = 0; day < SIMULATION_DAYS; day++) {
+        int64_t dayBeginMin = day * DAY_MIN;
+        visits.push_back({ dayBeginMin + 8 * HOUR_MIN + jitter(), dayBeginMin + 9 * HOUR_MIN });
+        if (day % IRREGULAR_VISIT_PERIOD_DAYS == 2) {
+            visits.push_back({ dayBeginMin + 13 * HOUR_MIN + jitter(), dayBeginMin + 14 * HOUR_MIN });
+        }
+        visits.push_back({ dayBeginMin + 18 * HOUR_MIN + jitter(), dayBeginMin + 22 * HOUR_MIN });
+    }
+    return visits;
+}
+
+struct SimulationResult {
+    int64_t radioOnMin = 0;
+    // 每次出现的发现时延，未发现的按在位时长计
+    std::vector<int64_t> latencyMin;
+
+    int64_t GetMedianLatencyMin()
+    {
+        std::sort(latencyMin.begin(), latencyMin.end());
+        return latencyMin.empty() ? 0 : latencyMin[latencyMin.size() / 2];
+    }
+
+    int64_t GetMaxLatencyMin() const
+    {
+        return latencyMin.empty() ? 0 : *std::max_element(latencyMin.begin(), latencyMin.end());
+    }
+};
+
+// 按分钟步进模拟：设备不在连接状态时扫描，扫描到设备后连接并停止扫描，设备离开后重新扫描。
+// 基线方案持续扫描，自适应方案按扫描调度的扫描窗口和退避时间扫描。
+SimulationResult Simulate(const std::vector<Visit> &visits, bool isAdaptive)
+{
+    PartnerDeviceScanScheduler scheduler;
+    const int64_t windowMin = scheduler.GetScanWindowMs() / MIN_MS;
+    SimulationResult result;
+    bool isScanning = true;
+    bool isConnected = false;
+    int64_t timerMin = windowMin;
+    size_t visit = 0;
+    for (int64_t now = 0; now < SIMULATION_DAYS * DAY_MIN; now++) {
+        while (visit < visits.size() && now >= visits[visit].endMin) {
+            if (isConnected) {
+                isConnected = false;
+                isScanning = true;
+                timerMin = now + windowMin;
+            } else {
+                result.latencyMin.push_back(visits[visit].endMin - visits[visit].beginMin);
+            }
+            visit++;
+        }
+        if (isAdaptive && !isConnected && now >= timerMin) {
+            if (!isScanning) {
+                isScanning = true;
+                timerMin = now + windowMin;
+            } else {
+                int64_t pauseMin = scheduler.OnMiss(now * MIN_MS) / MIN_MS;
+                isScanning = pauseMin == 0;
+                timerMin = now + (isScanning ? windowMin : pauseMin);
+            }
+        }
+        bool isPresent = visit < visits.size() && now >= visits[visit].beginMin;
+        if (isPresent && isScanning) {
+            result.latencyMin.push_back(now - visits[visit].beginMin);
+            scheduler.OnPresence(now * MIN_MS);
+            isConnected = true;
+            isScanning = false;
+        }
+        result.radioOnMin += isScanning ? 1 : 0;
+    }
+    return result;
+}
+}  // namespace
+
+class PartnerDeviceScanSchedulerTest : public testing::Test {
+public:
+    PartnerDeviceScanSchedulerTest() = default;
+    ~PartnerDeviceScanSchedulerTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDeviceScanSchedulerTest::SetUpTestCase(void)
+{}
+void PartnerDeviceScanSchedulerTest::TearDownTestCase(void)
+{}
+void PartnerDeviceScanSchedulerTest::SetUp()
+{}
+void PartnerDeviceScanSchedulerTest::TearDown()
+{}
+
+// 测试用例1：无历史记录时指数退避
+/**
+ * @tc.name: BackoffShouldDoubleUpToMax
+ * @tc.desc: 验证连续未发现设备时，退避时间从最小值翻倍增长到最大值
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanSchedulerTest, BackoffShouldDoubleUpToMax, TestSize.Level0)
+{
+    PartnerDeviceScanScheduler scheduler;
+    std::vector<int64_t> expectMin = { 1, 2, 4, 8, 16, 32, 32, 32 };
+    int64_t now = At(0, 0, 0);
+    for (int64_t pauseMin : expectMin) {
+        int64_t pauseMs = scheduler.OnMiss(now);
+        EXPECT_EQ(pauseMs, pauseMin * MIN_MS);
+        now += pauseMs + scheduler.GetScanWindowMs();
+    }
+    EXPECT_EQ(scheduler.GetMissNum(), expectMin.size());
+}
+
+// 测试用例2：发现设备后重置退避
+/**
+ * @tc.name: PresenceShouldResetBackoff
+ * @tc.desc: 验证发现设备后退避时间恢复为最小值
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanSchedulerTest, PresenceShouldResetBackoff, TestSize.Level0)
+{
+    PartnerDeviceScanScheduler scheduler;
+    for (int i = 0; i < 4; i++) {
+        scheduler.OnMiss(At(0, 1, i * 10));
+    }
+    scheduler.OnPresence(At(0, 2, 0));
+    EXPECT_EQ(scheduler.GetMissNum(), 0);
+    EXPECT_EQ(scheduler.OnMiss(At(0, 3, 0)), MIN_MS);
+}
+
+// 测试用例3：学习设备出现的时段
+/**
+ * @tc.name: RepeatedPresenceShouldLearnLikelyWindow
+ * @tc.desc: 验证设备连续两天在同一时段出现后，该时段不退避，同一天内多次出现只计一次
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanSchedulerTest, RepeatedPresenceShouldLearnLikelyWindow, TestSize.Level0)
+{
+    PartnerDeviceScanScheduler scheduler;
+    scheduler.OnPresence(At(0, 8, 5));
+    scheduler.OnPresence(At(0, 8, 10));
+    scheduler.OnPresence(At(0, 8, 20));
+    EXPECT_FALSE(scheduler.IsLikely(At(1, 8, 10)));
+
+    scheduler.OnPresence(At(1, 8, 10));
+    EXPECT_TRUE(scheduler.IsLikely(At(2, 8, 0)));
+    EXPECT_FALSE(scheduler.IsLikely(At(2, 14, 0)));
+    EXPECT_EQ(scheduler.OnMiss(At(2, 8, 0)), 0);
+    EXPECT_EQ(scheduler.GetMissNum(), 0);
+}
+
+// 测试用例4：退避在可能出现的时段开始时结束，且学习结果按天衰减
+/**
+ * @tc.name: BackoffShouldEndAtLikelyWindow
+ * @tc.desc: 验证退避时间不跨过设备可能出现的时段，设备多天未出现后该时段不再视为可能出现
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceScanSchedulerTest, BackoffShouldEndAtLikelyWindow, TestSize.Level0)
+{
+    PartnerDeviceScanScheduler scheduler;
+    scheduler.OnPresence(At(0, 8, 10));
+    scheduler.OnPresence(At(1, 8, 10));
+    for (int i = 0; i < 5; i++) {
+        scheduler.OnMiss(At(2, 7, i));
+    }
+    // 第6次退避为32分钟，在8点结束
+    EXPECT_EQ(scheduler.OnMiss(At(2, 7, 50)), 10 * MIN_MS);
+
+    EXPECT_TRUE(scheduler.IsLikely(At(2, 8, 0)));
+    EXPECT_FALSE(scheduler.IsLikely(At(3, 8, 0)));
+}
+
+// 测试用例5：14天确定性仿真
+/**
+ * @tc.name: AdaptiveScanShouldReduceRadioTime
+ * @tc.desc: 模拟14天的设备出现规律，对比持续扫描与自适应扫描的射频开启时长和发现时延中位数
+ * @tc.type: PERF
+ */
+HWTEST_F(PartnerDeviceScanSchedulerTest, AdaptiveScanShouldReduceRadioTime, TestSize.Level1)
+{
+    std::vector<Visit> visits = MakeVisits();
+    SimulationResult baseline = Simulate(visits, false);
+    SimulationResult adaptive = Simulate(visits, true);
+    ASSERT_EQ(baseline.latencyMin.size(), visits.size());
+    ASSERT_EQ(adaptive.latencyMin.size(), visits.size());
+    int64_t baselineMedian = baseline.GetMedianLatencyMin();
+    int64_t adaptiveMedian = adaptive.GetMedianLatencyMin();
+    // 自适应扫描的退避不超过最短的一次出现，每次出现都能被发现
+    int64_t shortestVisitMin = DAY_MIN;
+    for (const Visit &visit : visits) {
+        shortestVisitMin = std::min(shortestVisitMin, visit.endMin - visit.beginMin);
+    }
+    EXPECT_LT(adaptive.GetMaxLatencyMin(), shortestVisitMin);
+    EXPECT_LT(adaptive.radioOnMin * 2, baseline.radioOnMin);
+    EXPECT_LE(adaptiveMedian, baselineMedian);
+}
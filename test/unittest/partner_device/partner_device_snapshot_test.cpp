@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceSnapshotTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "cJSON.h"
+#include "fcm_json_stream.h"
+#include "fcm_mac_address.h"
+#include "file_ex.h"
+#include "partner_device_journal.h"
+#include "partner_device_snapshot.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+constexpr const char *TEST_SNAPSHOT_PATH = "/data/local/tmp/partner_device_snapshot_test.bin";
+const uint32_t APP_NUM = 10;
+
+// 旧版本 partner_device_config.cpp 的 cJSON 实现，作为对比基准
+cJSON *MakeDeviceItem(const PartnerDeviceJsonItem &device)
+{
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddStringToObject(item, "version", "1.0");
+    cJSON_AddStringToObject(item, "bundleName", device.bundleName.c_str());
+    cJSON_AddStringToObject(item, "abilityName", device.abilityName.c_str());
+    cJSON *addressInfo = cJSON_CreateObject();
+    cJSON_AddStringToObject(addressInfo, "address", device.address.c_str());
+    cJSON_AddNumberToObject(addressInfo, "addressType", device.fields.addressType);
+    if (device.fields.hasRawAddressType) {
+        cJSON_AddNumberToObject(addressInfo, "rawAddressType", device.fields.rawAddressType);
+    }
+    cJSON_AddItemToObject(item, "addressInfo", addressInfo);
+    cJSON_AddNumberToObject(item, "tokenId", device.fields.tokenId);
+    cJSON_AddNumberToObject(item, "registerTimestamp", device.fields.registerTimestamp);
+    if (device.fields.lostTimestamp > 0) {
+        cJSON_AddNumberToObject(item, "lostTimestamp", device.fields.lostTimestamp);
+    }
+    cJSON_AddBoolToObject(item, "isUserEnabled", device.fields.isUserEnabled);
+    cJSON *capability = cJSON_CreateObject();
+    cJSON_AddBoolToObject(capability, "isSupportBR", device.fields.isSupportBR);
+    cJSON_AddBoolToObject(capability, "isSupportBleAdvertiser", device.fields.isSupportBleAdvertiser);
+    cJSON_AddItemToObject(item, "capability", capability);
+    cJSON *businessCapability = cJSON_CreateObject();
+    cJSON_AddBoolToObject(businessCapability, "isSupportMediaControl", device.fields.isSupportMediaControl);
+    cJSON_AddBoolToObject(businessCapability, "isSupportTelephonyControl", device.fields.isSupportTelephonyControl);
+    cJSON_AddItemToObject(item, "businessCapability", businessCapability);
+    return item;
+}
+
+std::string SaveJson(const std::vector<PartnerDeviceJsonItem> &devices)
+{
+    cJSON *root = cJSON_CreateArray();
+    for (const auto &device : devices) {
+        cJSON_AddItemToArray(root, MakeDeviceItem(device));
+    }
+    char *jsonString = cJSON_Print(root);
+    std::string content = jsonString;
+    cJSON_free(jsonString);
+    cJSON_Delete(root);
+    return content;
+}
+
+bool GetBool(const cJSON *object, const char *name)
+{
+    return cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(object, name));
+}
+
+std::vector<PartnerDeviceJsonItem> LoadJson(const std::string &content)
+{
+    std::vector<PartnerDeviceJsonItem> devices;
+    cJSON *root = cJSON_Parse(content.c_str());
+    const cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, root) {
+        PartnerDeviceJsonItem device;
+        const cJSON *addressInfo = cJSON_GetObjectItemCaseSensitive(item, "addressInfo");
+        const cJSON *rawAddressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "rawAddressType");
+        const cJSON *lostTimestamp = cJSON_GetObjectItemCaseSensitive(item, "lostTimestamp");
+        const cJSON *capability = cJSON_GetObjectItemCaseSensitive(item, "capability");
+        const cJSON *businessCapability = cJSON_GetObjectItemCaseSensitive(item, "businessCapability");
+        device.bundleName = cJSON_GetObjectItemCaseSensitive(item, "bundleName")->valuestring;
+        device.abilityName = cJSON_GetObjectItemCaseSensitive(item, "abilityName")->valuestring;
+        device.address = cJSON_GetObjectItemCaseSensitive(addressInfo, "address")->valuestring;
+        device.fields.tokenId = static_cast<uint32_t>(cJSON_GetObjectItemCaseSensitive(item, "tokenId")->valuedouble);
+        device.fields.addressType = cJSON_GetObjectItemCaseSensitive(addressInfo, "addressType")->valueint;
+        device.fields.hasRawAddressType = rawAddressType != nullptr;
+        device.fields.rawAddressType = rawAddressType != nullptr ? rawAddressType->valueint : 0;
+        device.fields.registerTimestamp =
+            static_cast<int64_t>(cJSON_GetObjectItemCaseSensitive(item, "registerTimestamp")->valuedouble);
+        device.fields.lostTimestamp = lostTimestamp != nullptr ? static_cast<int64_t>(lostTimestamp->valuedouble) : 0;
+        device.fields.isUserEnabled = GetBool(item, "isUserEnabled");
+        device.fields.isSupportBR = GetBool(capability, "isSupportBR");
+        device.fields.isSupportBleAdvertiser = GetBool(capability, "isSupportBleAdvertiser");
+        device.fields.isSupportMediaControl = GetBool(businessCapability, "isSupportMediaControl");
+        device.fields.isSupportTelephonyControl = GetBool(businessCapability, "isSupportTelephonyControl");
+        devices.push_back(std::move(device));
+    }
+    cJSON_Delete(root);
+    return devices;
+}
+
+std::vector<PartnerDeviceJsonItem> LoadSnapshotFile(const std::string &path)
+{
+    std::vector<PartnerDeviceJsonItem> devices;
+    PartnerDeviceSnapshotFile snapshotFile(path);
+    std::vector<PartnerDeviceRecord> records;
+    if (!snapshotFile.IsMapped() || !PartnerDeviceSnapshot::Decode(snapshotFile.GetContent(), records)) {
+        return devices;
+    }
+    devices.reserve(records.size());
+    for (const auto &record : records) {
+        devices.push_back(ToDevice(record));
+    }
+    return devices;
+}
+}  // namespace
+
+class PartnerDeviceSnapshotTest : public testing::Test {
+public:
+    PartnerDeviceSnapshotTest() = default;
+    ~PartnerDeviceSnapshotTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void PartnerDeviceSnapshotTest::SetUpTestCase(void)
+{}
+void PartnerDeviceSnapshotTest::TearDownTestCase(void)
+{}
+void PartnerDeviceSnapshotTest::SetUp()
+{}
+void PartnerDeviceSnapshotTest::TearDown()
+{
+    unlink(TEST_SNAPSHOT_PATH);
+}
+
+/**
+ * @tc.name: EncodeDecodeRoundTrip
+ * @tc.desc: 测试用例1：编码后解码得到相同的记录，解码的字符串直接指向快照内容，相同的包名只存储一份
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceSnapshotTest, EncodeDecodeRoundTrip, TestSize.Level0)
+{
+    const uint32_t deviceNum = 100;
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(deviceNum, APP_NUM);
+    std::string content = PartnerDeviceSnapshot::Encode(MakeRecords(devices));
+
+    std::vector<PartnerDeviceRecord> records;
+    ASSERT_TRUE(PartnerDeviceSnapshot::Decode(content, records));
+    ASSERT_EQ(records.size(), devices.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        ExpectDeviceEq(ToDevice(records[i]), devices[i]);
+        EXPECT_GE(records[i].address.data(), content.data());
+        EXPECT_LE(records[i].address.data() + records[i].address.size(), content.data() + content.size());
+    }
+    EXPECT_EQ(records[0].bundleName.data(), records[APP_NUM].bundleName.data());
+    EXPECT_EQ(records[0].abilityName.data(), records[1].abilityName.data());
+
+    // 空快照
+    content = PartnerDeviceSnapshot::Encode({});
+    EXPECT_TRUE(PartnerDeviceSnapshot::Decode(content, records));
+    EXPECT_TRUE(records.empty());
+}
+
+/**
+ * @tc.name: RejectCorruptedSnapshot
+ * @tc.desc: 测试用例2：快照任意字节被修改或被截断时解码失败，且不输出任何记录
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceSnapshotTest, RejectCorruptedSnapshot, TestSize.Level0)
+{
+    const uint32_t deviceNum = 3;
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(deviceNum, APP_NUM);
+    const std::string content = PartnerDeviceSnapshot::Encode(MakeRecords(devices));
+    std::vector<PartnerDeviceRecord> records;
+    for (size_t i = 0; i < content.size(); i++) {
+        std::string corrupted = content;
+        corrupted[i] = static_cast<char>(corrupted[i] ^ 0x01);
+        EXPECT_FALSE(PartnerDeviceSnapshot::Decode(corrupted, records)) << "offset: " << i;
+        EXPECT_FALSE(PartnerDeviceSnapshot::Decode(std::string_view(content).substr(0, i), records)) << "size: " << i;
+    }
+    EXPECT_TRUE(records.empty());
+    // 旧版本的 JSON 配置文件不是快照
+    EXPECT_FALSE(PartnerDeviceSnapshot::Decode(SaveJson(devices), records));
+    EXPECT_TRUE(records.empty());
+}
+
+/**
+ * @tc.name: LoadMappedSnapshotFile
+ * @tc.desc: 测试用例3：通过 mmap 加载快照文件，文件不存在或为空时映射失败
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceSnapshotTest, LoadMappedSnapshotFile, TestSize.Level0)
+{
+    const uint32_t deviceNum = 10;
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(deviceNum, APP_NUM);
+    ASSERT_TRUE(SaveStringToFile(TEST_SNAPSHOT_PATH, PartnerDeviceSnapshot::Encode(MakeRecords(devices))));
+    std::vector<PartnerDeviceJsonItem> loadedDevices = LoadSnapshotFile(TEST_SNAPSHOT_PATH);
+    ASSERT_EQ(loadedDevices.size(), devices.size());
+    for (size_t i = 0; i < devices.size(); i++) {
+        ExpectDeviceEq(loadedDevices[i], devices[i]);
+    }
+
+    ASSERT_TRUE(SaveStringToFile(TEST_SNAPSHOT_PATH, ""));
+    EXPECT_FALSE(PartnerDeviceSnapshotFile(TEST_SNAPSHOT_PATH).IsMapped());
+    unlink(TEST_SNAPSHOT_PATH);
+    EXPECT_FALSE(PartnerDeviceSnapshotFile(TEST_SNAPSHOT_PATH).IsMapped());
+}
+
+/**
+ * @tc.name: ReplayJournalOverSnapshot
+ * @tc.desc: 测试用例4：日志头记录二进制快照的校验值，回放结果覆盖快照中对应的设备
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceSnapshotTest, ReplayJournalOverSnapshot, TestSize.Level0)
+{
+    const uint32_t deviceNum = 3;
+    std::vector<PartnerDeviceJsonItem> devices = MakeDevices(deviceNum + 1, APP_NUM);
+    std::string content = PartnerDeviceSnapshot::Encode(MakeRecords(
+        std::vector<PartnerDeviceJsonItem>(devices.begin(), devices.begin() + deviceNum)));
+    // 记录中的字符串指向 putDevices
+    std::vector<PartnerDeviceJsonItem> putDevices = { devices[deviceNum] };
+    std::vector<PartnerDeviceRecord> putRecords = MakeRecords(putDevices);
+    FcmJsonWriter writer;
+    PartnerDeviceJournal::AppendHeader(writer, content);
+    PartnerDeviceJournal::AppendPutRecord(writer, putRecords[0]);
+    PartnerDeviceJournal::AppendDelRecord(writer, devices[0].fields.tokenId, devices[0].address);
+    std::string journal = writer.GetBuffer();
+
+    PartnerDeviceJournal::Overlay overlay;
+    EXPECT_EQ(PartnerDeviceJournal::Replay(content, journal, overlay), 2);  // 2: one put and one del record
+    ASSERT_EQ(overlay.size(), 2);  // 2: one put and one del record
+    auto key = std::make_pair(devices[0].fields.tokenId, ToMacAddress(devices[0].address));
+    ASSERT_EQ(overlay.count(key), 1);
+    EXPECT_FALSE(overlay[key].has_value());
+    key = std::make_pair(devices[deviceNum].fields.tokenId, ToMacAddress(devices[deviceNum].address));
+    ASSERT_EQ(overlay.count(key), 1);
+    ASSERT_TRUE(overlay[key].has_value());
+    ExpectDeviceEq(ToDevice(overlay[key]->GetRecord()), devices[deviceNum]);
+
+    // 快照重写后旧日志不再生效
+    overlay.clear();
+    std::string newContent = PartnerDeviceSnapshot::Encode(MakeRecords(devices));
+    EXPECT_EQ(PartnerDeviceJournal::Replay(newContent, journal, overlay), 0);
+    EXPECT_TRUE(overlay.empty());
+}
+
+/**
+ * @tc.name: SnapshotShouldMatchJson
+ * @tc.desc: 测试用例5：100、1000、10000 条记录下，二进制快照与 cJSON 加载出相同的设备，且快照文件更小
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceSnapshotTest, SnapshotShouldMatchJson, TestSize.Level1)
+{
+    const std::vector<uint32_t> deviceNumVec = { 100, 1000, 10000 };
+    for (uint32_t deviceNum : deviceNumVec) {
+        std::vector<PartnerDeviceJsonItem> devices = MakeDevices(deviceNum, APP_NUM);
+        std::string jsonContent = SaveJson(devices);
+        std::string snapshotContent = PartnerDeviceSnapshot::Encode(MakeRecords(devices));
+        ASSERT_TRUE(SaveStringToFile(TEST_SNAPSHOT_PATH, snapshotContent));
+
+        std::vector<PartnerDeviceJsonItem> jsonDevices = LoadJson(jsonContent);
+        std::vector<PartnerDeviceJsonItem> snapshotDevices = LoadSnapshotFile(TEST_SNAPSHOT_PATH);
+        ASSERT_EQ(jsonDevices.size(), devices.size());
+        ASSERT_EQ(snapshotDevices.size(), devices.size());
+        ExpectDeviceEq(snapshotDevices.front(), jsonDevices.front());
+        ExpectDeviceEq(snapshotDevices.back(), jsonDevices.back());
+        EXPECT_LT(snapshotContent.size(), jsonContent.size()) << "devices: " << deviceNum;
+    }
+}
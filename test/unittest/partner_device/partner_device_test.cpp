@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LOG_TAG
+#define LOG_TAG "PartnerDeviceTest"
+#endif
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "partner_device.h"
+#include "partner_device_config.h"
+#include "partner_device_presence_engine.h"
+#include "partner_device_registry.h"
+#include "partner_device_test_utils.h"
+#include "log.h"
+#include "log_util.h"
+
+using namespace OHOS;
+using namespace OHOS::FusionConnectivity;
+using namespace OHOS::FusionConnectivity::PartnerDeviceTestUtils;
+using namespace testing;
+using namespace testing::ext;
+
+namespace {
+// 100 个设备中 90 个被用户关闭
+const uint32_t DEVICE_NUM = 100;
+const uint32_t ENABLED_DEVICE_NUM = 10;
+}  // namespace
+
+// Mock依赖函数接口
+class MockDependencyFuncs {
+public:
+    MOCK_METHOD(void, updateConfig, (), ());
+    MOCK_METHOD(void, discoverExtension, (), ());
+    MOCK_METHOD(void, destroyExtension, (int), ());
+};
+
+class PartnerDeviceTest : public testing::Test {
+public:
+    PartnerDeviceTest() = default;
+    ~PartnerDeviceTest() override = default;
+
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+
+    std::shared_ptr<MockDependencyFuncs> funcs_;
+    PartnerDevice::DependencyFuncs realFuncs_;
+};
+
+void PartnerDeviceTest::SetUpTestCase(void)
+{}
+void PartnerDeviceTest::TearDownTestCase(void)
+{}
+void PartnerDeviceTest::SetUp()
+{
+    funcs_ = std::make_shared<NiceMock<MockDependencyFuncs>>();
+    realFuncs_ = {
+        .updateConfig = [this](const PartnerDeviceMapKey &) { funcs_->updateConfig(); },
+        .discoverExtension = [this](std::string, std::string, PartnerDeviceAddress) {
+            funcs_->discoverExtension();
+        },
+        .destroyExtension = [this](std::string, std::string, int reason) { funcs_->destroyExtension(reason); },
+    };
+}
+void PartnerDeviceTest::TearDown()
+{}
+
+/**
+ * @tc.name: DisabledDeviceShouldStayDormant
+ * @tc.desc: 测试用例1：用户关闭的设备不创建运行态
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, DisabledDeviceShouldStayDormant, TestSize.Level0)
+{
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, false), realFuncs_, true, true);
+    ASSERT_NE(device, nullptr);
+    EXPECT_FALSE(device->isAllowed_.load());
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    device->Close();
+}
+
+/**
+ * @tc.name: DisableShouldDestroyRuntime
+ * @tc.desc: 测试用例2：用户关闭在位的设备时销毁运行态并销毁已拉起的extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, DisableShouldDestroyRuntime, TestSize.Level0)
+{
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, true), realFuncs_, true, true);
+    ASSERT_NE(device, nullptr);
+    auto runtime = device->GetRuntime();
+    ASSERT_NE(runtime, nullptr);
+    // 设备在位，extension已被拉起
+    EXPECT_CALL(*funcs_, discoverExtension()).Times(1);
+    runtime->presenceEngine->OnBluetoothDeviceAclStateChange(true);
+
+    EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_USER_CLOSED_ABILITY)).Times(1);
+    device->SetUserEnableAbility(false);
+    EXPECT_FALSE(device->IsUserEnableAbility());
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    device->Close();
+}
+
+/**
+ * @tc.name: BluetoothOffShouldDestroyRuntime
+ * @tc.desc: 测试用例3：蓝牙关闭时销毁运行态和已拉起的extension，仍允许启动的设备在蓝牙打开时重新激活
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, BluetoothOffShouldDestroyRuntime, TestSize.Level0)
+{
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, true), realFuncs_, true, true);
+    ASSERT_NE(device, nullptr);
+    auto runtime = device->GetRuntime();
+    ASSERT_NE(runtime, nullptr);
+    runtime->presenceEngine->OnBluetoothDeviceAclStateChange(true);
+
+    EXPECT_CALL(*funcs_, destroyExtension(ABILITY_DESTROY_BLUETOOTH_DISABLED)).Times(1);
+    device->OnBluetoothTurnOff();
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    EXPECT_TRUE(device->isAllowed_.load());
+    device->Close();
+}
+
+/**
+ * @tc.name: BluetoothOnShouldFollowPairState
+ * @tc.desc: 测试用例4：蓝牙打开时按已配对设备列表中的配对状态激活或保持休眠
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, BluetoothOnShouldFollowPairState, TestSize.Level0)
+{
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, false), realFuncs_, false, true);
+    ASSERT_NE(device, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(device->deviceInfoMutex_);
+        device->deviceInfo_.isUserEnabled = true;
+    }
+
+    device->OnBluetoothTurnOn(true);
+    EXPECT_TRUE(device->isAllowed_.load());
+    EXPECT_NE(device->GetRuntime(), nullptr);
+
+    // 蓝牙关闭期间设备已取消配对
+    device->OnBluetoothTurnOff();
+    device->OnBluetoothTurnOn(false);
+    EXPECT_FALSE(device->isAllowed_.load());
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    device->Close();
+}
+
+/**
+ * @tc.name: StartupWithMostDevicesDisabled
+ * @tc.desc: 测试用例5：100 个设备中 90 个被用户关闭，只有开启的设备创建运行态
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, StartupWithMostDevicesDisabled, TestSize.Level1)
+{
+    std::vector<std::shared_ptr<PartnerDevice>> devices;
+    devices.reserve(DEVICE_NUM);
+    for (uint32_t i = 0; i < DEVICE_NUM; i++) {
+        devices.push_back(PartnerDevice::CreateInstance(
+            MakeDeviceInfo(TOKEN_ID, i, i < ENABLED_DEVICE_NUM), realFuncs_, true, true));
+        ASSERT_NE(devices.back(), nullptr);
+    }
+    for (uint32_t i = 0; i < DEVICE_NUM; i++) {
+        EXPECT_EQ(devices[i]->GetRuntime() != nullptr, i < ENABLED_DEVICE_NUM) << "index: " << i;
+    }
+    for (auto &device : devices) {
+        device->Close();
+    }
+}
+
+/**
+ * @tc.name: CreateShouldUseSampledStates
+ * @tc.desc: 测试用例6：创建设备时按调用者统一获取的配对状态和蓝牙状态激活，不逐个查询
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, CreateShouldUseSampledStates, TestSize.Level0)
+{
+    // 蓝牙关闭时创建的设备保持休眠，蓝牙打开后激活
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, true), realFuncs_, true, false);
+    ASSERT_NE(device, nullptr);
+    EXPECT_TRUE(device->isAllowed_.load());
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    device->OnBluetoothTurnOn(true);
+    EXPECT_NE(device->GetRuntime(), nullptr);
+    device->Close();
+
+    auto unpairedDevice = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 1, true), realFuncs_, false, true);
+    ASSERT_NE(unpairedDevice, nullptr);
+    EXPECT_FALSE(unpairedDevice->isAllowed_.load());
+    EXPECT_EQ(unpairedDevice->GetRuntime(), nullptr);
+    unpairedDevice->Close();
+
+    auto pairedDevice = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 2, true), realFuncs_, true, true);
+    ASSERT_NE(pairedDevice, nullptr);
+    EXPECT_NE(pairedDevice->GetRuntime(), nullptr);
+    pairedDevice->Close();
+}
+
+/**
+ * @tc.name: DumpShouldMaskDevices
+ * @tc.desc: 测试用例7：调试导出的设备地址脱敏，不导出tokenId
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, DumpShouldMaskDevices, TestSize.Level0)
+{
+    PartnerDevice::DeviceInfo deviceInfo = MakeDeviceInfo(TOKEN_ID, 0, false);
+    auto device = PartnerDevice::CreateInstance(deviceInfo, realFuncs_, false, true);
+    ASSERT_NE(device, nullptr);
+    PartnerDeviceRegistry registry;
+    registry.EnsureInsert(device->GetKey(), 0, device);
+
+    std::string content;
+    DumpPartnerDeviceConfig(registry, content);
+    const std::string address = deviceInfo.deviceAddress.GetAddress();
+    EXPECT_EQ(content.find(address), std::string::npos);
+    EXPECT_NE(content.find(GetEncryptAddr(address)), std::string::npos);
+    EXPECT_EQ(content.find(std::to_string(TOKEN_ID)), std::string::npos);
+    device->Close();
+}
+
+/**
+ * @tc.name: DisableAbsentDeviceShouldNotDestroyExtension
+ * @tc.desc: 测试用例8：设备不在位时extension未被拉起，用户关闭设备只销毁运行态，不销毁extension
+ * @tc.type: FUNC
+ */
+HWTEST_F(PartnerDeviceTest, DisableAbsentDeviceShouldNotDestroyExtension, TestSize.Level0)
+{
+    auto device = PartnerDevice::CreateInstance(MakeDeviceInfo(TOKEN_ID, 0, true), realFuncs_, true, true);
+    ASSERT_NE(device, nullptr);
+    ASSERT_NE(device->GetRuntime(), nullptr);
+
+    EXPECT_CALL(*funcs_, destroyExtension(_)).Times(0);
+    device->SetUserEnableAbility(false);
+    EXPECT_EQ(device->GetRuntime(), nullptr);
+    device->OnBluetoothTurnOff();
+    device->Close();
+}
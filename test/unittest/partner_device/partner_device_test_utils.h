@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PARTNER_DEVICE_TEST_UTILS_H
+#define PARTNER_DEVICE_TEST_UTILS_H
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "fcm_mac_address.h"
+#include "partner_device.h"
+#include "partner_device_json.h"
+#include "partner_device_snapshot.h"
+
+namespace OHOS {
+namespace FusionConnectivity {
+namespace PartnerDeviceTestUtils {
+/**
+ * @brief The token id of the app which binds the test devices.
+ */
+constexpr uint32_t TOKEN_ID = 1000;
+constexpr int64_t REGISTER_TIMESTAMP = 1700000000;  // 1700000000: any timestamp
+
+/**
+ * @brief The address of the test device of the index, 00:11:XX:XX:XX:XX.
+ */
+inline FcmMacAddress MakeAddress(uint32_t index)
+{
+    const uint64_t addressPrefix = 0x001100000000ULL;
+    return FcmMacAddress(addressPrefix | index);
+}
+
+/**
+ * @brief A device bound by the app at the real address of the index, supporting BR and the BLE advertiser.
+ */
+inline PartnerDevice::DeviceInfo MakeDeviceInfo(uint32_t tokenId, uint32_t index, bool isUserEnabled)
+{
+    PartnerDevice::DeviceInfo deviceInfo = {
+        .bundleName = "com.example.partner",
+        .abilityName = "PartnerAgentExtensionAbility",
+        .deviceAddress = PartnerDeviceAddress(MakeAddress(index).ToString(), BluetoothAddressType::REAL),
+        .tokenId = tokenId,
+        .isUserEnabled = isUserEnabled,
+    };
+    deviceInfo.capability.isSupportBR = true;
+    deviceInfo.capability.isSupportBleAdvertiser = true;
+    return deviceInfo;
+}
+
+/**
+ * @brief Parse the address string written by the test, the string must be valid.
+ */
+inline FcmMacAddress ToMacAddress(std::string_view address)
+{
+    FcmMacAddress macAddress;
+    EXPECT_TRUE(FcmMacAddress::FromString(address, macAddress)) << address;
+    return macAddress;
+}
+
+/**
+ * @brief The devices bound by appNum apps, the device i is bound by the app TOKEN_ID + i % appNum at
+ * REGISTER_TIMESTAMP + i, and the optional fields are set on a part of the devices.
+ */
+inline std::vector<PartnerDeviceJsonItem> MakeDevices(uint32_t deviceNum, uint32_t appNum)
+{
+    std::vector<PartnerDeviceJsonItem> devices(deviceNum);
+    for (uint32_t i = 0; i < deviceNum; i++) {
+        PartnerDeviceJsonItem &device = devices[i];
+        device.bundleName = "com.example.partner" + std::to_string(i % appNum);
+        device.abilityName = "PartnerAgentExtensionAbility";
+        device.address = MakeAddress(i).ToString();
+        device.fields.tokenId = TOKEN_ID + i % appNum;
+        device.fields.addressType = static_cast<int32_t>(i % 2);  // 2: virtual or real address
+        device.fields.hasRawAddressType = (i % 3) == 0;  // 3: one third of the devices have the raw address type
+        device.fields.rawAddressType = device.fields.hasRawAddressType ? 1 : 0;
+        device.fields.registerTimestamp = REGISTER_TIMESTAMP + i;
+        device.fields.lostTimestamp = (i % 5) == 0 ? i : 0;  // 5: one fifth of the devices are lost
+        device.fields.isUserEnabled = (i % 2) == 0;  // 2: half of the devices are enabled
+        device.fields.isSupportBR = true;
+        device.fields.isSupportBleAdvertiser = (i % 2) == 1;  // 2: half of the devices support the advertiser
+        device.fields.isSupportMediaControl = (i % 4) < 2;  // 4, 2: half of the devices support the media control
+        device.fields.isSupportTelephonyControl = (i % 7) == 0;  // 7: a few devices support the telephony control
+    }
+    return devices;
+}
+
+/**
+ * @brief The records of the devices, the strings point into the devices.
+ */
+inline std::vector<PartnerDeviceRecord> MakeRecords(const std::vector<PartnerDeviceJsonItem> &devices)
+{
+    std::vector<PartnerDeviceRecord> records;
+    records.reserve(devices.size());
+    for (const auto &device : devices) {
+        records.push_back(device.GetRecord());
+    }
+    return records;
+}
+
+/**
+ * @brief Copy the record into a device owning the strings.
+ */
+inline PartnerDeviceJsonItem ToDevice(const PartnerDeviceRecord &record)
+{
+    PartnerDeviceJsonItem device;
+    device.bundleName = std::string(record.bundleName);
+    device.abilityName = std::string(record.abilityName);
+    device.address = std::string(record.address);
+    device.fields = record;
+    device.fields.bundleName = {};
+    device.fields.abilityName = {};
+    device.fields.address = {};
+    return device;
+}
+
+inline void ExpectDeviceEq(const PartnerDeviceJsonItem &actual, const PartnerDeviceJsonItem &expected)
+{
+    EXPECT_EQ(actual.bundleName, expected.bundleName);
+    EXPECT_EQ(actual.abilityName, expected.abilityName);
+    EXPECT_EQ(actual.address, expected.address);
+    EXPECT_EQ(actual.fields.tokenId, expected.fields.tokenId);
+    EXPECT_EQ(actual.fields.addressType, expected.fields.addressType);
+    EXPECT_EQ(actual.fields.hasRawAddressType, expected.fields.hasRawAddressType);
+    EXPECT_EQ(actual.fields.rawAddressType, expected.fields.rawAddressType);
+    EXPECT_EQ(actual.fields.registerTimestamp, expected.fields.registerTimestamp);
+    EXPECT_EQ(actual.fields.lostTimestamp, expected.fields.lostTimestamp);
+    EXPECT_EQ(actual.fields.isUserEnabled, expected.fields.isUserEnabled);
+    EXPECT_EQ(actual.fields.isSupportBR, expected.fields.isSupportBR);
+    EXPECT_EQ(actual.fields.isSupportBleAdvertiser, expected.fields.isSupportBleAdvertiser);
+    EXPECT_EQ(actual.fields.isSupportMediaControl, expected.fields.isSupportMediaControl);
+    EXPECT_EQ(actual.fields.isSupportTelephonyControl, expected.fields.isSupportTelephonyControl);
+}
+}  // namespace PartnerDeviceTestUtils
+}  // namespace FusionConnectivity
+}  // namespace OHOS
+#endif  // PARTNER_DEVICE_TEST_UTILS_H